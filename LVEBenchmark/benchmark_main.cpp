@@ -0,0 +1,96 @@
+#include "stress_benchmark.h"
+
+//std
+#include <cstdlib>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+// 用法: LVEBenchmark [--objects 100,1000,10000] [--meshes M] [--triangles T] [--distribution grid|box|cluster] [--occluders N]
+//                    [--seconds S] [--warmup N] [--size WxH] [--frames-in-flight N] [--seed N]
+//                    [--camera-path file] [--output summary.csv] [--per-frame frames.csv] [--culling on|off] [--occlusion on|off]
+//                    [--gpu-culling on|off]
+static std::vector<uint32_t> parseCountList(const std::string& value) {
+    std::vector<uint32_t> counts;
+    std::stringstream stream{ value };
+    std::string item;
+    while (std::getline(stream, item, ',')) {
+        counts.push_back(static_cast<uint32_t>(std::stoul(item)));
+    }
+    return counts;
+}
+
+static lve::SceneDistribution parseDistribution(const std::string& value) {
+    if (value == "grid") return lve::SceneDistribution::Grid;
+    if (value == "box") return lve::SceneDistribution::UniformBox;
+    if (value == "cluster") return lve::SceneDistribution::Clustered;
+    throw std::runtime_error("unknown distribution: " + value);
+}
+
+static lve::BenchmarkOptions parseBenchmarkOptions(int argc, char** argv) {
+    lve::BenchmarkOptions options{};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (i + 1 >= argc) {
+            throw std::runtime_error("missing value for argument: " + arg);
+        }
+        std::string value = argv[++i];
+        if (arg == "--objects") options.objectCounts = parseCountList(value);
+        else if (arg == "--meshes") options.scene.uniqueMeshCount = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--triangles") options.scene.trianglesPerMesh = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--distribution") options.scene.distribution = parseDistribution(value);
+        else if (arg == "--seed") options.scene.seed = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--occluders") options.scene.occluderCount = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--seconds") options.sessionSeconds = std::stod(value);
+        else if (arg == "--warmup") options.warmupFrames = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--frames-in-flight") options.framesInFlight = static_cast<uint32_t>(std::stoul(value));
+        else if (arg == "--camera-path") options.cameraPathFile = value;
+        else if (arg == "--output") options.summaryCsvPath = value;
+        else if (arg == "--per-frame") options.perFrameCsvPath = value;
+        else if (arg == "--culling") {
+            if (value != "on" && value != "off") {
+                throw std::runtime_error("culling must be on or off: " + value);
+            }
+            options.frustumCulling = value == "on";
+        }
+        else if (arg == "--occlusion") {
+            if (value != "on" && value != "off") {
+                throw std::runtime_error("occlusion must be on or off: " + value);
+            }
+            options.occlusionCulling = value == "on";
+        }
+        else if (arg == "--gpu-culling") {
+            if (value != "on" && value != "off") {
+                throw std::runtime_error("gpu-culling must be on or off: " + value);
+            }
+            options.gpuOcclusionCulling = value == "on";
+        }
+        else if (arg == "--size") {
+            size_t x = value.find('x');
+            if (x == std::string::npos) {
+                throw std::runtime_error("size must look like 1280x720: " + value);
+            }
+            options.width = static_cast<uint32_t>(std::stoul(value.substr(0, x)));
+            options.height = static_cast<uint32_t>(std::stoul(value.substr(x + 1)));
+        }
+        else {
+            throw std::runtime_error("unknown argument: " + arg);
+        }
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+    try {
+        lve::StressBenchmark benchmark{ parseBenchmarkOptions(argc, argv) };
+        benchmark.run();
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+
+    return EXIT_SUCCESS;
+}
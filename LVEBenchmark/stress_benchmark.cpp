@@ -0,0 +1,318 @@
+#include "stress_benchmark.h"
+
+#include "lve_buffer.h"
+#include "lve_camera.h"
+#include "lve_camera_path.h"
+#include "lve_hiz_culler.h"
+#include "lve_occlusion_culler.h"
+#include "lve_profiler.h"
+#include "lve_scene_index.h"
+#include "lve_transform_system.h"
+#include "lve_utils.hpp"
+#include "simple_render_system.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+
+namespace lve {
+
+	//与 FirstApp 使用的着色器布局一致
+	struct GlobalUbo {
+		glm::mat4 projectionView{ 1.f };
+		glm::vec3 lightDirection = glm::normalize(glm::vec3{ 1.f, -3.f, -1.f });
+	};
+
+	template <typename Getter>
+	static BenchmarkMetric summarize(const std::vector<FrameStatsSample>& samples, Getter getter) {
+		BenchmarkMetric metric{};
+		if (samples.empty()) {
+			return metric;
+		}
+		std::vector<double> values;
+		values.reserve(samples.size());
+		double total = 0.0;
+		for (const auto& sample : samples) {
+			values.push_back(getter(sample));
+			total += values.back();
+		}
+		std::sort(values.begin(), values.end());
+		metric.average = total / static_cast<double>(values.size());
+		metric.p50 = percentileOfSorted(values, 0.50);
+		metric.p95 = percentileOfSorted(values, 0.95);
+		metric.p99 = percentileOfSorted(values, 0.99);
+		metric.max = values.back();
+		return metric;
+	}
+
+	StressBenchmark::StressBenchmark(const BenchmarkOptions& options)
+		: options{ options },
+		lveRenderer{ lveDevice, VkExtent2D{ options.width, options.height }, options.framesInFlight }
+	{
+		LVE_PROFILE_THREAD("Main");
+		globalPool =
+			LVEDescriptorPool::Builder(lveDevice)
+			.setMaxSets(lveRenderer.getFramesInFlight())
+			.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, lveRenderer.getFramesInFlight())
+			.build();
+	}
+
+	StressBenchmark::~StressBenchmark() {}
+
+	std::vector<BenchmarkSessionResult> StressBenchmark::run() {
+		std::vector<std::unique_ptr<LVEBuffer>> uboBuffers(lveRenderer.getFramesInFlight());
+		for (auto& uboBuffer : uboBuffers) {
+			uboBuffer = std::make_unique<LVEBuffer>(
+				lveDevice,
+				sizeof(GlobalUbo),
+				1,
+				VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			uboBuffer->map();
+		}
+
+		auto globalSetLayout =
+			LVEDescriptorSetLayout::Builder(lveDevice)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+			.build();
+
+		std::vector<VkDescriptorSet> globalDescriptorSets(lveRenderer.getFramesInFlight());
+		for (size_t i = 0; i < globalDescriptorSets.size(); i++) {
+			auto bufferInfo = uboBuffers[i]->descriptorInfo();
+			LVEDescriptorWriter(*globalSetLayout, *globalPool)
+				.writeBuffer(0, &bufferInfo)
+				.build(globalDescriptorSets[i]);
+		}
+
+		SimpleRenderSystem simpleRenderSystem{
+			lveDevice,
+			pipelineRegistry,
+			lveRenderer.getPipelineTarget(),
+			globalSetLayout->getDescriptorSetLayout() };
+		std::unique_ptr<LVEHiZCuller> hizCuller;
+		if (options.gpuOcclusionCulling) {
+			if (!LVEHiZCuller::isSupported(lveDevice)) {
+				throw std::runtime_error("gpu culling requires drawIndirectFirstInstance and the compiled hiz_*.spv shaders!");
+			}
+			hizCuller = std::make_unique<LVEHiZCuller>(
+				lveDevice,
+				pipelineRegistry,
+				lveRenderer.getPipelineTarget(),
+				globalSetLayout->getDescriptorSetLayout(),
+				lveRenderer.getFramesInFlight());
+		}
+		//管线编译不能算进计时
+		pipelineRegistry.waitIdle();
+
+		if (!options.perFrameCsvPath.empty()) {
+			perFrameRows.push_back("objects,frame,frame_ms,cpu_ms,gpu_ms,draw_calls,triangles,upload_bytes,visible_objects,culled_objects");
+		}
+
+		std::vector<BenchmarkSessionResult> results;
+		for (uint32_t objectCount : options.objectCounts) {
+			results.push_back(runSession(objectCount, simpleRenderSystem, hizCuller.get(), globalDescriptorSets, uboBuffers));
+
+			const auto& result = results.back();
+			std::cout << "objects " << result.objectCount
+				<< ": frames " << result.frameCount
+				<< ", cpu avg/p95/p99 " << result.cpuTimeMs.average << "/" << result.cpuTimeMs.p95 << "/" << result.cpuTimeMs.p99 << " ms"
+				<< ", gpu avg/p95/p99 " << result.gpuTimeMs.average << "/" << result.gpuTimeMs.p95 << "/" << result.gpuTimeMs.p99 << " ms"
+				<< std::endl;
+		}
+
+		writeSummary(results);
+		if (!options.perFrameCsvPath.empty()) {
+			std::ofstream file{ options.perFrameCsvPath, std::ios::trunc };
+			if (!file.is_open()) {
+				throw std::runtime_error("failed to open benchmark output: " + options.perFrameCsvPath);
+			}
+			for (const auto& row : perFrameRows) {
+				file << row << '\n';
+			}
+		}
+		return results;
+	}
+
+	BenchmarkSessionResult StressBenchmark::runSession(
+		uint32_t objectCount,
+		SimpleRenderSystem& renderSystem,
+		LVEHiZCuller* hizCuller,
+		const std::vector<VkDescriptorSet>& globalDescriptorSets,
+		std::vector<std::unique_ptr<LVEBuffer>>& uboBuffers)
+	{
+		LVE_PROFILE_FUNCTION();
+		StressSceneConfig sceneConfig = options.scene;
+		sceneConfig.objectCount = objectCount;
+		//场景是静态的，矩阵只在第一帧批量计算一次
+		LVEWorld world;
+		LVETransformSystem transformSystem{ &jobSystem };
+		LVESceneGenerator::generate(lveDevice, sceneConfig, world, transformSystem);
+		LVESceneIndex sceneIndex{ &jobSystem };
+		LVEOcclusionCuller occlusionCuller{ &jobSystem };
+		std::vector<uint8_t> visibleSlots;
+		if (options.frustumCulling || hizCuller != nullptr) {
+			sceneIndex.registerEntities(world);
+		}
+		//可见性历史是按上一轮场景的槽位记录的
+		if (hizCuller != nullptr) {
+			hizCuller->resetVisibility();
+		}
+
+		float sceneRadius = LVESceneGenerator::sceneRadius(sceneConfig);
+		glm::vec3 sceneCenter = LVESceneGenerator::sceneCenter();
+		LVECameraPath cameraPath = options.cameraPathFile.empty()
+			? LVECameraPath::createOrbit(sceneCenter, sceneRadius * 1.2f, -sceneRadius * 0.3f, 20.f)
+			: LVECameraPath::loadFromFile(options.cameraPathFile);
+		cameraPath.setLooping(true);
+
+		LVECamera camera{};
+		camera.setPerspectiveProjection(glm::radians(50.f), lveRenderer.getAspectRatio(), 0.1f, sceneRadius * 4.f);
+
+		std::vector<FrameStatsSample> samples;
+		float cameraTime = 0.f;
+		uint32_t frameNumber = 0;
+		auto sessionStart = std::chrono::steady_clock::now();
+		double elapsedSeconds = 0.0;
+
+		while (frameNumber < options.warmupFrames || elapsedSeconds < options.sessionSeconds) {
+			LVE_PROFILE_SCOPE("Frame");
+			CameraKeyframe keyframe = cameraPath.sample(cameraTime);
+			camera.setViewYXZ(keyframe.position, keyframe.rotation);
+			cameraTime += options.fixedTimestep;
+
+			transformSystem.update();
+			bool cpuCulling = options.frustumCulling && hizCuller == nullptr;
+			uint32_t visibleCount = transformSystem.size();
+			if (hizCuller != nullptr) {
+				sceneIndex.update(transformSystem);
+			}
+			else if (cpuCulling) {
+				sceneIndex.update(transformSystem);
+				glm::mat4 projectionView = camera.getProjection() * camera.getView();
+				visibleCount = sceneIndex.cullFrustum(projectionView, transformSystem.size(), visibleSlots);
+				if (options.occlusionCulling) {
+					occlusionCuller.beginFrame(projectionView);
+					occlusionCuller.addOccluders(world, transformSystem, &visibleSlots);
+					occlusionCuller.rasterize();
+					visibleCount -= occlusionCuller.cullVisibility(sceneIndex, visibleSlots);
+				}
+			}
+
+			bool frameSubmitted = false;
+			if (auto commandBuffer = lveRenderer.beginFrame()) {
+				int frameIndex = lveRenderer.getFrameIndex();
+				FrameInfo frameInfo{
+					frameIndex,
+					options.fixedTimestep,
+					commandBuffer,
+					camera,
+					globalDescriptorSets[frameIndex],
+					&lveRenderer.getGpuProfiler(),
+					&lveRenderer.getFrameStats(),
+					&transformSystem,
+					cpuCulling ? &visibleSlots : nullptr };
+
+				GlobalUbo ubo{};
+				ubo.projectionView = camera.getProjection() * camera.getView();
+				uboBuffers[frameIndex]->writeToBuffer(&ubo);
+				uboBuffers[frameIndex]->flush();
+
+				if (hizCuller != nullptr) {
+					hizCuller->beginFrame(frameInfo, world, sceneIndex);
+					lveRenderer.beginSwapChainRenderPass(commandBuffer);
+					hizCuller->drawEarly(frameInfo);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+					hizCuller->cullLate(frameInfo, lveRenderer.getCurrentDepthTarget());
+					lveRenderer.beginSwapChainRenderPass(commandBuffer, RenderPassLoad::Load);
+					hizCuller->drawLate(frameInfo);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+				}
+				else {
+					lveRenderer.getFrameStats().setCullingCounts(visibleCount, transformSystem.size() - visibleCount);
+					lveRenderer.beginSwapChainRenderPass(commandBuffer);
+					renderSystem.renderEntities(frameInfo, world);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+				}
+				lveRenderer.endFrame();
+				frameSubmitted = true;
+			}
+
+			//交换链重建时没有提交帧，getLastFrame 还是上一帧的数据，不能再记一次
+			if (frameSubmitted) {
+				frameNumber++;
+				if (frameNumber == options.warmupFrames) {
+					sessionStart = std::chrono::steady_clock::now();
+				}
+			}
+			if (frameSubmitted && frameNumber > options.warmupFrames) {
+				const FrameStatsSample& sample = lveRenderer.getFrameStats().getLastFrame();
+				samples.push_back(sample);
+				if (!options.perFrameCsvPath.empty()) {
+					std::ostringstream row;
+					row << objectCount << ',' << samples.size() - 1 << ',' << sample.frameTimeMs << ',' << sample.cpuTimeMs
+						<< ',' << sample.gpuTimeMs << ',' << sample.drawCalls << ',' << sample.triangles << ',' << sample.uploadBytes
+						<< ',' << sample.visibleObjects << ',' << sample.culledObjects;
+					perFrameRows.push_back(row.str());
+				}
+			}
+			if (frameNumber > options.warmupFrames) {
+				elapsedSeconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - sessionStart).count();
+			}
+		}
+		//让这一轮的帧全部执行完，下一轮从空闲的 GPU 开始
+		lveDevice.waitForTimelineValue(lveDevice.getLastSubmittedTimelineValue());
+
+		BenchmarkSessionResult result{};
+		result.objectCount = objectCount;
+		result.frameCount = static_cast<uint32_t>(samples.size());
+		result.durationSeconds = elapsedSeconds;
+		result.frameTimeMs = summarize(samples, [](const FrameStatsSample& s) { return s.frameTimeMs; });
+		result.cpuTimeMs = summarize(samples, [](const FrameStatsSample& s) { return s.cpuTimeMs; });
+		//GPU 时间戳晚 framesInFlight 帧读回，前几个样本可能还是上一轮的值，跳过它们
+		std::vector<FrameStatsSample> gpuSamples(
+			samples.begin() + std::min<size_t>(samples.size(), lveRenderer.getFramesInFlight()), samples.end());
+		result.gpuTimeMs = summarize(gpuSamples, [](const FrameStatsSample& s) { return s.gpuTimeMs; });
+		result.drawCallsPerFrame = summarize(samples, [](const FrameStatsSample& s) { return static_cast<double>(s.drawCalls); }).average;
+		result.trianglesPerFrame = summarize(samples, [](const FrameStatsSample& s) { return static_cast<double>(s.triangles); }).average;
+		return result;
+	}
+
+	void StressBenchmark::writeSummary(const std::vector<BenchmarkSessionResult>& results) const {
+		if (options.summaryCsvPath.empty()) {
+			return;
+		}
+		std::ofstream file{ options.summaryCsvPath, std::ios::trunc };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open benchmark output: " + options.summaryCsvPath);
+		}
+
+		file << "objects,meshes,triangles_per_mesh,frames,duration_s,draw_calls,triangles";
+		for (const char* metric : { "frame_ms", "cpu_ms", "gpu_ms" }) {
+			for (const char* stat : { "avg", "p50", "p95", "p99", "max" }) {
+				file << ',' << metric << '_' << stat;
+			}
+		}
+		file << '\n';
+
+		for (const auto& result : results) {
+			file << result.objectCount << ',' << options.scene.uniqueMeshCount << ',' << options.scene.trianglesPerMesh
+				<< ',' << result.frameCount << ',' << result.durationSeconds
+				<< ',' << result.drawCallsPerFrame << ',' << result.trianglesPerFrame;
+			for (const BenchmarkMetric* metric : { &result.frameTimeMs, &result.cpuTimeMs, &result.gpuTimeMs }) {
+				file << ',' << metric->average << ',' << metric->p50 << ',' << metric->p95
+					<< ',' << metric->p99 << ',' << metric->max;
+			}
+			file << '\n';
+		}
+	}
+
+}  // namespace lve
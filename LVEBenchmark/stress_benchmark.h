@@ -0,0 +1,89 @@
+#pragma once
+
+#include "lve_descriptors.h"
+#include "lve_device.h"
+#include "lve_frame_stats.h"
+#include "lve_job_system.h"
+#include "lve_pipeline_registry.h"
+#include "lve_renderer.h"
+#include "lve_scene_generator.h"
+
+// std
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+	class LVEHiZCuller;
+	class SimpleRenderSystem;
+
+	struct BenchmarkOptions {
+		std::vector<uint32_t> objectCounts{ 100, 1000, 10000 };	//每个数量跑一轮
+		StressSceneConfig scene{};			//objectCount 会被上面的数量覆盖
+		double sessionSeconds = 10.0;		//每轮计时的时长（真实时间）
+		uint32_t warmupFrames = 60;			//每轮开始前不计时的帧，让管线、缓存和驱动进入稳定状态
+		uint32_t width = 1280;
+		uint32_t height = 720;
+		uint32_t framesInFlight = 2;
+		float fixedTimestep = 1.f / 60.f;	//相机路径按固定步长前进，不同机器上每帧画面相同
+		std::string cameraPathFile;			//为空时绕场景转一圈
+		bool frustumCulling = true;			//用 LVESceneIndex 剔除视锥外的物体，关掉可以对比剔除前的开销
+		bool occlusionCulling = true;		//用软件光栅化的遮挡体剔除被挡住的物体，需要 frustumCulling 并且场景里有遮挡体
+		bool gpuOcclusionCulling = false;	//用 LVEHiZCuller 在 GPU 上做视锥和 Hi-Z 遮挡剔除，开启时忽略上面两项
+		std::string summaryCsvPath = "lve_benchmark.csv";
+		std::string perFrameCsvPath;		//为空时不输出逐帧数据
+	};
+
+	struct BenchmarkMetric {
+		double average = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	struct BenchmarkSessionResult {
+		uint32_t objectCount = 0;
+		uint32_t frameCount = 0;
+		double durationSeconds = 0.0;
+		BenchmarkMetric frameTimeMs;
+		BenchmarkMetric cpuTimeMs;
+		BenchmarkMetric gpuTimeMs;
+		double drawCallsPerFrame = 0.0;
+		double trianglesPerFrame = 0.0;
+	};
+
+	//压力测试基准：无窗口渲染程序化生成的场景，按固定时长计时，输出 CPU 和 GPU 每帧耗时
+	class StressBenchmark {
+	public:
+		explicit StressBenchmark(const BenchmarkOptions& options);
+		~StressBenchmark();
+
+		StressBenchmark(const StressBenchmark&) = delete;
+		StressBenchmark& operator=(const StressBenchmark&) = delete;
+
+		std::vector<BenchmarkSessionResult> run();
+
+	private:
+		BenchmarkSessionResult runSession(
+			uint32_t objectCount,
+			SimpleRenderSystem& renderSystem,
+			LVEHiZCuller* hizCuller,
+			const std::vector<VkDescriptorSet>& globalDescriptorSets,
+			std::vector<std::unique_ptr<LVEBuffer>>& uboBuffers);
+		void writeSummary(const std::vector<BenchmarkSessionResult>& results) const;
+
+		BenchmarkOptions options;
+
+		// 注意：声明的顺序很重要，设备最后析构
+		LVEDevice lveDevice{};
+		LVERenderer lveRenderer;
+		LVEJobSystem jobSystem{};
+		LVEPipelineRegistry pipelineRegistry{ lveDevice, jobSystem };
+		std::unique_ptr<LVEDescriptorPool> globalPool{};
+
+		std::vector<std::string> perFrameRows;
+	};
+
+}  // namespace lve
@@ -0,0 +1,574 @@
+#include "micro_benchmark.h"
+
+#include "lve_buffer.h"
+#include "lve_bvh.h"
+#include "lve_camera.h"
+#include "lve_device.h"
+#include "lve_draw_sort.h"
+#include "lve_ecs.h"
+#include "lve_game_object.h"
+#include "lve_model.h"
+#include "lve_occlusion_culler.h"
+#include "lve_transform_system.h"
+#include "lve_utils.hpp"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/constants.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+#define GLM_ENABLE_EXPERIMENTAL
+#include <glm/gtx/hash.hpp>
+
+// std
+#include <algorithm>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <random>
+#include <stdexcept>
+
+namespace lve {
+
+	//每次迭代改变一点输入，防止编译器把整个循环体当成常量折叠掉
+	static float nextAngle(float& angle) {
+		angle += 0.001f;
+		if (angle > glm::two_pi<float>()) {
+			angle -= glm::two_pi<float>();
+		}
+		return angle;
+	}
+
+	// ---------------------------------------------------------------------------
+	// LVEModel::Builder::loadModel
+	// ---------------------------------------------------------------------------
+
+	//生成 gridSize x gridSize 的起伏网格，带法线和纹理坐标，共 2 * gridSize^2 个三角形。
+	//相邻面共享顶点，loadModel 的去重哈希表会被真正用到
+	static std::string writeSyntheticObj(int64_t gridSize) {
+		//同一个尺寸只写一次，进程退出时删除写过的临时文件
+		struct SyntheticObjFiles {
+			std::map<int64_t, std::string> paths;
+			~SyntheticObjFiles() {
+				for (const auto& [size, path] : paths) {
+					std::error_code error;
+					std::filesystem::remove(path, error);
+				}
+			}
+		};
+		static SyntheticObjFiles cache;
+		auto found = cache.paths.find(gridSize);
+		if (found != cache.paths.end()) {
+			return found->second;
+		}
+
+		std::filesystem::path path =
+			std::filesystem::temp_directory_path() / ("lve_micro_grid_" + std::to_string(gridSize) + ".obj");
+		std::ofstream file{ path, std::ios::trunc };
+		if (!file) {
+			throw std::runtime_error("failed to write synthetic obj: " + path.string());
+		}
+		int64_t side = gridSize + 1;
+		for (int64_t z = 0; z < side; z++) {
+			for (int64_t x = 0; x < side; x++) {
+				float fx = static_cast<float>(x) / static_cast<float>(gridSize);
+				float fz = static_cast<float>(z) / static_cast<float>(gridSize);
+				float height = 0.1f * glm::sin(fx * 12.f) * glm::cos(fz * 9.f);
+				file << "v " << fx << " " << height << " " << fz << "\n";
+				file << "vt " << fx << " " << fz << "\n";
+				file << "vn 0 1 0\n";
+			}
+		}
+		for (int64_t z = 0; z < gridSize; z++) {
+			for (int64_t x = 0; x < gridSize; x++) {
+				int64_t a = z * side + x + 1;	// OBJ 索引从 1 开始
+				int64_t b = a + 1;
+				int64_t c = a + side;
+				int64_t d = c + 1;
+				file << "f " << a << "/" << a << "/" << a << " " << c << "/" << c << "/" << c << " " << b << "/" << b << "/" << b << "\n";
+				file << "f " << b << "/" << b << "/" << b << " " << c << "/" << c << "/" << c << " " << d << "/" << d << "/" << d << "\n";
+			}
+		}
+		cache.paths.emplace(gridSize, path.string());
+		return path.string();
+	}
+
+	static void BM_LoadModelObj(MicroBenchmarkState& state) {
+		std::string path = writeSyntheticObj(state.range(0));
+		uint64_t triangles = 0;
+		while (state.keepRunning()) {
+			LVEModel::Builder builder{};
+			builder.loadModel(path);
+			triangles += builder.indices.size() / 3;
+			doNotOptimize(builder.vertices.data());
+		}
+		state.setItemsProcessed(triangles);
+	}
+	LVE_MICRO_BENCHMARK(BM_LoadModelObj)->arg(16)->arg(64)->arg(256);
+
+	// ---------------------------------------------------------------------------
+	// 顶点哈希（lve_utils.hpp 的 hashCombine）
+	// ---------------------------------------------------------------------------
+
+	static std::vector<LVEModel::Vertex> makeRandomVertices(size_t count) {
+		std::mt19937 rng{ 1234 };
+		std::uniform_real_distribution<float> dist{ -1.f, 1.f };
+		std::vector<LVEModel::Vertex> vertices(count);
+		for (auto& vertex : vertices) {
+			vertex.position = { dist(rng), dist(rng), dist(rng) };
+			vertex.color = { dist(rng), dist(rng), dist(rng) };
+			vertex.normal = { dist(rng), dist(rng), dist(rng) };
+			vertex.uv = { dist(rng), dist(rng) };
+		}
+		return vertices;
+	}
+
+	static void BM_VertexHash(MicroBenchmarkState& state) {
+		std::vector<LVEModel::Vertex> vertices = makeRandomVertices(4096);
+		std::hash<LVEModel::Vertex> hasher{};
+		uint64_t hashed = 0;
+		while (state.keepRunning()) {
+			size_t combined = 0;
+			for (const auto& vertex : vertices) {
+				combined ^= hasher(vertex);
+			}
+			doNotOptimize(combined);
+			hashed += vertices.size();
+		}
+		state.setItemsProcessed(hashed);
+	}
+	LVE_MICRO_BENCHMARK(BM_VertexHash);
+
+	static void BM_HashCombineVec3(MicroBenchmarkState& state) {
+		glm::vec3 value{ 0.25f, -0.5f, 0.75f };
+		while (state.keepRunning()) {
+			size_t seed = 0;
+			hashCombine(seed, value);
+			doNotOptimize(seed);
+			value.x += 1e-4f;
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+	LVE_MICRO_BENCHMARK(BM_HashCombineVec3);
+
+	// ---------------------------------------------------------------------------
+	// TransformComponent
+	// ---------------------------------------------------------------------------
+
+	static void BM_TransformMat4(MicroBenchmarkState& state) {
+		TransformComponent transform{};
+		transform.translation = { 1.f, 2.f, 3.f };
+		transform.scale = { 1.5f, 0.5f, 2.f };
+		float angle = 0.f;
+		while (state.keepRunning()) {
+			transform.rotation = { angle, nextAngle(angle) * 0.5f, angle * 0.25f };
+			glm::mat4 matrix = transform.mat4();
+			doNotOptimize(matrix);
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+	LVE_MICRO_BENCHMARK(BM_TransformMat4);
+
+	static void BM_TransformNormalMatrix(MicroBenchmarkState& state) {
+		TransformComponent transform{};
+		transform.scale = { 1.5f, 0.5f, 2.f };
+		float angle = 0.f;
+		while (state.keepRunning()) {
+			transform.rotation = { angle, nextAngle(angle) * 0.5f, angle * 0.25f };
+			glm::mat3 matrix = transform.normalMatrix();
+			doNotOptimize(matrix);
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+	LVE_MICRO_BENCHMARK(BM_TransformNormalMatrix);
+
+	//每次迭代把所有槽位标脏再 update()，对应整个场景都在动的最坏情况；
+	//与上面两个基准按 items/s 对比即可看出批量计算的收益
+	static void BM_TransformSystemUpdate(MicroBenchmarkState& state) {
+		static LVEJobSystem jobSystem{};
+		uint32_t objectCount = static_cast<uint32_t>(state.range(0));
+		LVETransformSystem transformSystem{ &jobSystem };
+		std::vector<TransformComponent> transforms(objectCount);
+		for (uint32_t i = 0; i < objectCount; i++) {
+			transforms[i].translation = { static_cast<float>(i), 0.f, 0.f };
+			transforms[i].scale = { 1.5f, 0.5f, 2.f };
+			transformSystem.add(transforms[i]);
+		}
+		float angle = 0.f;
+		while (state.keepRunning()) {
+			state.pauseTiming();
+			float rotation = nextAngle(angle);
+			for (uint32_t i = 0; i < objectCount; i++) {
+				transforms[i].rotation = { rotation, rotation * 0.5f, rotation * 0.25f };
+				transformSystem.set(i, transforms[i]);
+			}
+			state.resumeTiming();
+			transformSystem.update();
+			doNotOptimize(transformSystem.getModelMatrix(0));
+		}
+		state.setItemsProcessed(state.iterations() * objectCount);
+	}
+	LVE_MICRO_BENCHMARK(BM_TransformSystemUpdate)->arg(1024)->arg(16384)->arg(131072);
+
+	// ---------------------------------------------------------------------------
+	// 每帧修改所有物体旋转的更新系统：std::vector<LVEGameObject> 对比 LVEWorld。
+	// 两边都把修改写进 LVETransformSystem，和渲染时真正生效的路径一致
+	// ---------------------------------------------------------------------------
+
+	static void BM_GameObjectVectorUpdate(MicroBenchmarkState& state) {
+		LVETransformSystem transformSystem{};
+		std::vector<LVEGameObject> gameObjects;
+		for (int64_t i = 0; i < state.range(0); i++) {
+			gameObjects.push_back(LVEGameObject::createGameObject());
+		}
+		transformSystem.registerObjects(gameObjects);
+		while (state.keepRunning()) {
+			for (auto& gameObject : gameObjects) {
+				gameObject.transform.rotation.y += 0.001f;
+				transformSystem.markDirty(gameObject);
+			}
+			clobberMemory();
+		}
+		state.setItemsProcessed(state.iterations() * gameObjects.size());
+	}
+	LVE_MICRO_BENCHMARK(BM_GameObjectVectorUpdate)->arg(1000)->arg(100000)->arg(1000000);
+
+	//实体只带模型和槽位组件，变换本身只存在 LVETransformSystem 里
+	static void BM_WorldEachUpdate(MicroBenchmarkState& state) {
+		LVETransformSystem transformSystem{};
+		LVEWorld world;
+		for (int64_t i = 0; i < state.range(0); i++) {
+			world.createEntity(ModelComponent{}, TransformSlotComponent{ transformSystem.add(TransformComponent{}) });
+		}
+		while (state.keepRunning()) {
+			world.each<TransformSlotComponent>([&](LVEEntity, TransformSlotComponent& slot) {
+				TransformComponent transform = transformSystem.get(slot.slot);
+				transform.rotation.y += 0.001f;
+				transformSystem.set(slot.slot, transform);
+			});
+			clobberMemory();
+		}
+		state.setItemsProcessed(state.iterations() * world.getEntityCount());
+	}
+	LVE_MICRO_BENCHMARK(BM_WorldEachUpdate)->arg(1000)->arg(100000)->arg(1000000);
+
+	//LVETransformSystem::set 不是线程安全的，并行遍历只读矩阵、按槽位写各自的世界包围盒（与 LVESceneIndex 刷新包围盒相同）
+	static void BM_WorldParallelEachBounds(MicroBenchmarkState& state) {
+		static LVEJobSystem jobSystem{};
+		LVETransformSystem transformSystem{};
+		LVEWorld world;
+		for (int64_t i = 0; i < state.range(0); i++) {
+			TransformComponent transform{};
+			transform.translation = { static_cast<float>(i % 1024), 0.f, static_cast<float>(i / 1024) };
+			world.createEntity(ModelComponent{}, TransformSlotComponent{ transformSystem.add(transform) });
+		}
+		transformSystem.update();
+		LVEAabb localBounds{ glm::vec3{ -0.5f }, glm::vec3{ 0.5f } };
+		std::vector<LVEAabb> worldBounds(transformSystem.size());
+		while (state.keepRunning()) {
+			world.parallelEach<TransformSlotComponent>(jobSystem, [&](LVEEntity, TransformSlotComponent& slot) {
+				worldBounds[slot.slot] = localBounds.transformed(transformSystem.getModelMatrix(slot.slot));
+			});
+			doNotOptimize(worldBounds.data());
+		}
+		state.setItemsProcessed(state.iterations() * world.getEntityCount());
+	}
+	LVE_MICRO_BENCHMARK(BM_WorldParallelEachBounds)->arg(100000)->arg(1000000);
+
+	// ---------------------------------------------------------------------------
+	// LVEBvh：视锥剔除和射线拾取，对比线性遍历
+	// ---------------------------------------------------------------------------
+
+	//边长约 100 的立方体里随机放置的单位大小物体，相机在中心朝 +z 看，大约能看到八分之一
+	static std::vector<LVEAabb> makeRandomBounds(size_t count) {
+		std::mt19937 rng{ 42 };
+		std::uniform_real_distribution<float> position{ -50.f, 50.f };
+		std::uniform_real_distribution<float> size{ 0.2f, 1.f };
+		std::vector<LVEAabb> bounds(count);
+		for (auto& box : bounds) {
+			glm::vec3 center{ position(rng), position(rng), position(rng) };
+			glm::vec3 extent{ size(rng), size(rng), size(rng) };
+			box = LVEAabb{ center - extent, center + extent };
+		}
+		return bounds;
+	}
+
+	static LVEFrustum benchmarkFrustum() {
+		LVECamera camera{};
+		camera.setPerspectiveProjection(glm::radians(50.f), 16.f / 9.f, 0.1f, 100.f);
+		camera.setViewYXZ({ 0.f, 0.f, 0.f }, { 0.f, 0.f, 0.f });
+		return LVEFrustum::fromMatrix(camera.getProjection() * camera.getView());
+	}
+
+	static void BM_LinearFrustumCull(MicroBenchmarkState& state) {
+		std::vector<LVEAabb> bounds = makeRandomBounds(static_cast<size_t>(state.range(0)));
+		LVEFrustum frustum = benchmarkFrustum();
+		std::vector<uint32_t> visible;
+		while (state.keepRunning()) {
+			visible.clear();
+			for (uint32_t i = 0; i < bounds.size(); i++) {
+				if (frustum.intersects(bounds[i])) {
+					visible.push_back(i);
+				}
+			}
+			doNotOptimize(visible.data());
+		}
+		state.setItemsProcessed(state.iterations() * state.range(0));
+	}
+	LVE_MICRO_BENCHMARK(BM_LinearFrustumCull)->arg(1000)->arg(100000);
+
+	static void BM_BvhFrustumCull(MicroBenchmarkState& state) {
+		std::vector<LVEAabb> bounds = makeRandomBounds(static_cast<size_t>(state.range(0)));
+		LVEBvh bvh{};
+		for (uint32_t i = 0; i < bounds.size(); i++) {
+			bvh.insert(bounds[i], i);
+		}
+		bvh.rebuild();
+		LVEFrustum frustum = benchmarkFrustum();
+		std::vector<uint32_t> visible;
+		while (state.keepRunning()) {
+			visible.clear();
+			bvh.queryFrustum(frustum, visible);
+			doNotOptimize(visible.data());
+		}
+		state.setItemsProcessed(state.iterations() * state.range(0));
+	}
+	LVE_MICRO_BENCHMARK(BM_BvhFrustumCull)->arg(1000)->arg(100000);
+
+	static void BM_BvhRaycast(MicroBenchmarkState& state) {
+		std::vector<LVEAabb> bounds = makeRandomBounds(static_cast<size_t>(state.range(0)));
+		LVEBvh bvh{};
+		for (uint32_t i = 0; i < bounds.size(); i++) {
+			bvh.insert(bounds[i], i);
+		}
+		bvh.rebuild();
+		float angle = 0.f;
+		while (state.keepRunning()) {
+			nextAngle(angle);
+			LVEBvhRayHit hit{};
+			bvh.raycast({ 0.f, 0.f, -60.f }, { glm::sin(angle) * 0.3f, glm::cos(angle) * 0.3f, 1.f }, 200.f, hit);
+			doNotOptimize(hit);
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+	LVE_MICRO_BENCHMARK(BM_BvhRaycast)->arg(100000);
+
+	//每帧 1% 的物体移动一小段。没有 jobSystem 时重建在 maintain() 中同步完成，结果包含分摊下来的重建开销
+	static void BM_BvhRefit(MicroBenchmarkState& state) {
+		std::vector<LVEAabb> bounds = makeRandomBounds(static_cast<size_t>(state.range(0)));
+		LVEBvh bvh{};
+		std::vector<uint32_t> proxies(bounds.size());
+		for (uint32_t i = 0; i < bounds.size(); i++) {
+			proxies[i] = bvh.insert(bounds[i], i);
+		}
+		bvh.rebuild();
+		size_t movedPerFrame = std::max<size_t>(bounds.size() / 100, 1);
+		size_t cursor = 0;
+		float angle = 0.f;
+		while (state.keepRunning()) {
+			glm::vec3 offset{ glm::sin(nextAngle(angle)) * 0.5f, 0.f, 0.f };
+			for (size_t i = 0; i < movedPerFrame; i++) {
+				cursor = (cursor + 7919) % bounds.size();
+				bvh.update(proxies[cursor], LVEAabb{ bounds[cursor].min + offset, bounds[cursor].max + offset });
+			}
+			bvh.maintain();
+		}
+		state.setItemsProcessed(state.iterations() * movedPerFrame);
+	}
+	LVE_MICRO_BENCHMARK(BM_BvhRefit)->arg(100000);
+
+	// ---------------------------------------------------------------------------
+	// LVEOcclusionCuller：软件光栅化遮挡体和逐物体的遮挡测试
+	// ---------------------------------------------------------------------------
+
+	//相机在 z = -60 朝 +z 看，state.range(0) 面随机摆放的竖直墙体
+	static void addBenchmarkWalls(LVEOcclusionCuller& culler, int64_t wallCount) {
+		static const LVEOccluderMesh box = LVEOccluderMesh::createBox();
+		std::mt19937 rng{ 7 };
+		std::uniform_real_distribution<float> unit{ 0.f, 1.f };
+		for (int64_t i = 0; i < wallCount; i++) {
+			glm::mat4 model{ 1.f };
+			model = glm::translate(model, glm::vec3{ unit(rng) * 40.f - 20.f, 0.f, unit(rng) * 40.f - 20.f });
+			model = glm::rotate(model, unit(rng) * glm::pi<float>(), glm::vec3{ 0.f, 1.f, 0.f });
+			model = glm::scale(model, glm::vec3{ 6.f + 8.f * unit(rng), 44.f, 0.8f });
+			culler.addOccluder(box, model);
+		}
+	}
+
+	static glm::mat4 occlusionBenchmarkProjectionView() {
+		LVECamera camera{};
+		camera.setPerspectiveProjection(glm::radians(50.f), 16.f / 9.f, 0.1f, 200.f);
+		camera.setViewYXZ({ 0.f, 0.f, -60.f }, { 0.f, 0.f, 0.f });
+		return camera.getProjection() * camera.getView();
+	}
+
+	static void BM_OcclusionRasterize(MicroBenchmarkState& state) {
+		static LVEJobSystem jobSystem{};
+		LVEOcclusionCuller culler{ state.range(1) != 0 ? &jobSystem : nullptr };
+		culler.beginFrame(occlusionBenchmarkProjectionView());
+		addBenchmarkWalls(culler, state.range(0));
+		while (state.keepRunning()) {
+			culler.rasterize();
+			doNotOptimize(culler.getDepthBuffer().data());
+		}
+		state.setItemsProcessed(state.iterations() * culler.getOccluderTriangleCount());
+	}
+	LVE_MICRO_BENCHMARK(BM_OcclusionRasterize)->args({ 40, 0 })->args({ 40, 1 });
+
+	static void BM_OcclusionTest(MicroBenchmarkState& state) {
+		LVEOcclusionCuller culler{};
+		culler.beginFrame(occlusionBenchmarkProjectionView());
+		addBenchmarkWalls(culler, 40);
+		culler.rasterize();
+		std::vector<LVEAabb> bounds = makeRandomBounds(static_cast<size_t>(state.range(0)));
+		for (auto& box : bounds) {
+			box.min *= 0.4f;
+			box.max *= 0.4f;
+		}
+		uint32_t occluded = 0;
+		while (state.keepRunning()) {
+			occluded = 0;
+			for (const auto& box : bounds) {
+				occluded += culler.isOccluded(box) ? 1 : 0;
+			}
+			doNotOptimize(occluded);
+		}
+		state.setItemsProcessed(state.iterations() * state.range(0));
+	}
+	LVE_MICRO_BENCHMARK(BM_OcclusionTest)->arg(10000);
+
+	// ---------------------------------------------------------------------------
+	// LVEDrawSorter：绘制排序键的基数排序，和 std::stable_sort 对比
+	// ---------------------------------------------------------------------------
+
+	//4 种管线、64 个网格、随机深度，接近普通场景里键的分布
+	static std::vector<LVEDrawKey> makeRandomDrawKeys(size_t count) {
+		std::mt19937 rng{ 11 };
+		std::uniform_int_distribution<uint32_t> pipeline{ 0, 3 };
+		std::uniform_int_distribution<uint32_t> mesh{ 0, 63 };
+		std::uniform_real_distribution<float> depth{ 0.1f, 200.f };
+		std::vector<LVEDrawKey> keys(count);
+		for (size_t i = 0; i < count; i++) {
+			keys[i] = { LVEDrawSorter::makeOpaqueKey(pipeline(rng), 0, mesh(rng), depth(rng)), static_cast<uint32_t>(i) };
+		}
+		return keys;
+	}
+
+	static void BM_DrawKeyRadixSort(MicroBenchmarkState& state) {
+		const std::vector<LVEDrawKey> source = makeRandomDrawKeys(static_cast<size_t>(state.range(0)));
+		std::vector<LVEDrawKey> keys;
+		LVEDrawSorter sorter{};
+		while (state.keepRunning()) {
+			keys = source;
+			sorter.sort(keys);
+			doNotOptimize(keys.data());
+		}
+		state.setItemsProcessed(state.iterations() * state.range(0));
+	}
+	LVE_MICRO_BENCHMARK(BM_DrawKeyRadixSort)->arg(1000)->arg(10000)->arg(100000);
+
+	static void BM_DrawKeyStdSort(MicroBenchmarkState& state) {
+		const std::vector<LVEDrawKey> source = makeRandomDrawKeys(static_cast<size_t>(state.range(0)));
+		std::vector<LVEDrawKey> keys;
+		while (state.keepRunning()) {
+			keys = source;
+			std::stable_sort(keys.begin(), keys.end(), [](const LVEDrawKey& a, const LVEDrawKey& b) { return a.key < b.key; });
+			doNotOptimize(keys.data());
+		}
+		state.setItemsProcessed(state.iterations() * state.range(0));
+	}
+	LVE_MICRO_BENCHMARK(BM_DrawKeyStdSort)->arg(1000)->arg(10000)->arg(100000);
+
+	// ---------------------------------------------------------------------------
+	// LVECamera
+	// ---------------------------------------------------------------------------
+
+	static void BM_CameraSetViewYXZ(MicroBenchmarkState& state) {
+		LVECamera camera{};
+		float angle = 0.f;
+		while (state.keepRunning()) {
+			camera.setViewYXZ({ 0.f, -1.f, -2.5f }, { angle * 0.3f, nextAngle(angle), 0.f });
+			doNotOptimize(camera.getView());
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+	LVE_MICRO_BENCHMARK(BM_CameraSetViewYXZ);
+
+	static void BM_CameraSetPerspectiveProjection(MicroBenchmarkState& state) {
+		LVECamera camera{};
+		float aspect = 1.f;
+		while (state.keepRunning()) {
+			aspect = aspect > 3.f ? 1.f : aspect + 1e-4f;
+			camera.setPerspectiveProjection(glm::radians(50.f), aspect, 0.1f, 100.f);
+			doNotOptimize(camera.getProjection());
+		}
+		state.setItemsProcessed(state.iterations());
+	}
+	LVE_MICRO_BENCHMARK(BM_CameraSetPerspectiveProjection);
+
+	// ---------------------------------------------------------------------------
+	// LVEBuffer 写入/刷新（需要 GPU，使用无窗口的设备）
+	// ---------------------------------------------------------------------------
+
+	//第一次用到时才创建设备，只有 CPU 的基准不需要 Vulkan
+	static LVEDevice* benchmarkDevice(std::string& error) {
+		static std::unique_ptr<LVEDevice> device;
+		static std::string creationError;
+		static bool attempted = false;
+		if (!attempted) {
+			attempted = true;
+			try {
+				device = std::make_unique<LVEDevice>();
+			}
+			catch (const std::exception& e) {
+				creationError = e.what();
+			}
+		}
+		error = creationError;
+		return device.get();
+	}
+
+	//flush 只在非一致性内存上有实际开销，这里不要求 HOST_COHERENT，由驱动选择第一个可映射的内存类型
+	static void runBufferBenchmark(MicroBenchmarkState& state, bool withFlush) {
+		std::string error;
+		LVEDevice* device = benchmarkDevice(error);
+		if (device == nullptr) {
+			state.skipWithError("no Vulkan device: " + error);
+			return;
+		}
+		VkDeviceSize size = static_cast<VkDeviceSize>(state.range(0));
+		LVEBuffer buffer{
+			*device,
+			size,
+			1,
+			VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT };
+		buffer.map();
+		std::vector<char> source(static_cast<size_t>(size), 0x5a);
+
+		while (state.keepRunning()) {
+			source[0]++;
+			buffer.writeToBuffer(source.data());
+			if (withFlush) {
+				buffer.flush();
+			}
+			clobberMemory();
+		}
+		device->takeUploadedBytes();
+		state.setBytesProcessed(state.iterations() * size);
+	}
+
+	static void BM_BufferWrite(MicroBenchmarkState& state) {
+		runBufferBenchmark(state, false);
+	}
+	LVE_MICRO_BENCHMARK(BM_BufferWrite)->arg(256)->arg(64 << 10)->arg(4 << 20);
+
+	static void BM_BufferWriteFlush(MicroBenchmarkState& state) {
+		runBufferBenchmark(state, true);
+	}
+	LVE_MICRO_BENCHMARK(BM_BufferWriteFlush)->arg(256)->arg(64 << 10)->arg(4 << 20);
+
+}  // namespace lve
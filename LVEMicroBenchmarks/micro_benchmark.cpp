@@ -0,0 +1,338 @@
+#include "micro_benchmark.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#if defined(_WIN32)
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
+namespace lve {
+
+	//当前线程的 CPU 时间（秒），与 Google Benchmark 的 cpu_time 含义一致
+	static double threadCpuSeconds() {
+#if defined(_WIN32)
+		FILETIME creationTime, exitTime, kernelTime, userTime;
+		if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+			return 0.0;
+		}
+		auto toTicks = [](const FILETIME& time) {
+			return (static_cast<uint64_t>(time.dwHighDateTime) << 32) | time.dwLowDateTime;
+		};
+		return static_cast<double>(toTicks(kernelTime) + toTicks(userTime)) * 1e-7;
+#else
+		timespec spec{};
+		clock_gettime(CLOCK_THREAD_CPUTIME_ID, &spec);
+		return static_cast<double>(spec.tv_sec) + static_cast<double>(spec.tv_nsec) * 1e-9;
+#endif
+	}
+
+	void MicroBenchmarkState::pauseTiming() {
+		if (!timing) {
+			return;
+		}
+		timing = false;
+		realSeconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - realStart).count();
+		cpuSeconds += threadCpuSeconds() - cpuStart;
+	}
+
+	void MicroBenchmarkState::resumeTiming() {
+		if (timing) {
+			return;
+		}
+		timing = true;
+		cpuStart = threadCpuSeconds();
+		realStart = std::chrono::steady_clock::now();
+	}
+
+	//函数内的静态变量，避免不同翻译单元的注册顺序问题
+	static std::vector<std::unique_ptr<MicroBenchmark>>& microBenchmarkRegistry() {
+		static std::vector<std::unique_ptr<MicroBenchmark>> registry;
+		return registry;
+	}
+
+	MicroBenchmark* registerMicroBenchmark(const std::string& name, MicroBenchmarkFunction function) {
+		auto& registry = microBenchmarkRegistry();
+		registry.push_back(std::make_unique<MicroBenchmark>(name, std::move(function)));
+		return registry.back().get();
+	}
+
+	//一次运行（或聚合）的结果，字段对应 Google Benchmark JSON 的 benchmarks 数组
+	struct MicroBenchmarkResult {
+		std::string name;
+		std::string runName;
+		std::string runType = "iteration";
+		std::string aggregateName;
+		uint32_t repetitionIndex = 0;
+		uint64_t iterations = 0;
+		double realTimeNs = 0.0;
+		double cpuTimeNs = 0.0;
+		double itemsPerSecond = 0.0;
+		double bytesPerSecond = 0.0;
+		std::string errorMessage;
+	};
+
+	class MicroBenchmarkRunner {
+	public:
+		explicit MicroBenchmarkRunner(const MicroBenchmarkOptions& options) : options{ options } {}
+
+		int run() {
+			for (const auto& benchmark : microBenchmarkRegistry()) {
+				std::vector<std::vector<int64_t>> argSets = benchmark->getArgSets();
+				if (argSets.empty()) {
+					argSets.push_back({});
+				}
+				for (const auto& args : argSets) {
+					std::string name = benchmark->getName();
+					for (int64_t arg : args) {
+						name += "/" + std::to_string(arg);
+					}
+					if (!options.filter.empty() && name.find(options.filter) == std::string::npos) {
+						continue;
+					}
+					runBenchmark(name, *benchmark, args);
+				}
+			}
+			if (!options.outputPath.empty()) {
+				writeJson(options.outputPath);
+			}
+			return failed ? 1 : 0;
+		}
+
+	private:
+		MicroBenchmarkState runOnce(const MicroBenchmark& benchmark, const std::vector<int64_t>& args, uint64_t iterations) {
+			MicroBenchmarkState state{ iterations, args };
+			benchmark.getFunction()(state);
+			state.pauseTiming();
+			if (state.errorMessage.empty() && state.completedIterations != iterations) {
+				state.errorMessage = "benchmark did not run keepRunning() loop to completion";
+				failed = true;
+			}
+			return state;
+		}
+
+		//从 1 次开始按耗时外推迭代次数，直到单次运行超过 minTimeSeconds
+		uint64_t calibrate(const MicroBenchmark& benchmark, const std::vector<int64_t>& args, MicroBenchmarkState& lastState) {
+			constexpr uint64_t MAX_ITERATIONS = 1000000000;
+			uint64_t iterations = 1;
+			while (true) {
+				lastState = runOnce(benchmark, args, iterations);
+				if (!lastState.errorMessage.empty() ||
+					lastState.realSeconds >= options.minTimeSeconds ||
+					iterations >= MAX_ITERATIONS) {
+					return iterations;
+				}
+				double multiplier = options.minTimeSeconds * 1.4 / std::max(lastState.realSeconds, 1e-9);
+				if (lastState.realSeconds / options.minTimeSeconds <= 0.1) {
+					multiplier = std::min(multiplier, 10.0);
+				}
+				uint64_t next = static_cast<uint64_t>(std::ceil(static_cast<double>(iterations) * std::max(multiplier, 1.0)));
+				iterations = std::min(std::max(next, iterations + 1), MAX_ITERATIONS);
+			}
+		}
+
+		MicroBenchmarkResult makeResult(const std::string& name, const MicroBenchmarkState& state, uint32_t repetition) const {
+			MicroBenchmarkResult result{};
+			result.name = name;
+			result.runName = name;
+			result.repetitionIndex = repetition;
+			result.iterations = state.completedIterations;
+			result.errorMessage = state.errorMessage;
+			if (state.completedIterations > 0) {
+				double count = static_cast<double>(state.completedIterations);
+				result.realTimeNs = state.realSeconds * 1e9 / count;
+				result.cpuTimeNs = state.cpuSeconds * 1e9 / count;
+			}
+			if (state.realSeconds > 0.0) {
+				result.itemsPerSecond = static_cast<double>(state.itemsProcessed) / state.realSeconds;
+				result.bytesPerSecond = static_cast<double>(state.bytesProcessed) / state.realSeconds;
+			}
+			return result;
+		}
+
+		void runBenchmark(const std::string& name, const MicroBenchmark& benchmark, const std::vector<int64_t>& args) {
+			MicroBenchmarkState state{ 0, args };
+			uint64_t iterations = calibrate(benchmark, args, state);
+
+			std::vector<MicroBenchmarkResult> runs;
+			uint32_t repetitions = std::max(options.repetitions, 1u);
+			for (uint32_t repetition = 0; repetition < repetitions; repetition++) {
+				//校准的最后一次已经满足最短时间，直接作为第一次重复
+				if (repetition > 0 && state.errorMessage.empty()) {
+					state = runOnce(benchmark, args, iterations);
+				}
+				runs.push_back(makeResult(name, state, repetition));
+				printResult(runs.back());
+				results.push_back(runs.back());
+				if (!state.errorMessage.empty()) {
+					return;
+				}
+			}
+			if (runs.size() > 1) {
+				addAggregates(name, runs);
+			}
+		}
+
+		void addAggregates(const std::string& name, const std::vector<MicroBenchmarkResult>& runs) {
+			auto aggregate = [&](const std::string& aggregateName, auto reduce) {
+				MicroBenchmarkResult result{};
+				result.name = name + "_" + aggregateName;
+				result.runName = name;
+				result.runType = "aggregate";
+				result.aggregateName = aggregateName;
+				result.iterations = static_cast<uint64_t>(runs.size());
+				result.realTimeNs = reduce([](const MicroBenchmarkResult& r) { return r.realTimeNs; });
+				result.cpuTimeNs = reduce([](const MicroBenchmarkResult& r) { return r.cpuTimeNs; });
+				result.itemsPerSecond = reduce([](const MicroBenchmarkResult& r) { return r.itemsPerSecond; });
+				result.bytesPerSecond = reduce([](const MicroBenchmarkResult& r) { return r.bytesPerSecond; });
+				printResult(result);
+				results.push_back(result);
+			};
+			auto collect = [&](auto getter) {
+				std::vector<double> values;
+				for (const auto& run : runs) {
+					values.push_back(getter(run));
+				}
+				return values;
+			};
+			auto mean = [&](auto getter) {
+				double total = 0.0;
+				for (double value : collect(getter)) total += value;
+				return total / static_cast<double>(runs.size());
+			};
+			aggregate("mean", mean);
+			aggregate("median", [&](auto getter) {
+				std::vector<double> values = collect(getter);
+				std::sort(values.begin(), values.end());
+				size_t middle = values.size() / 2;
+				return values.size() % 2 ? values[middle] : 0.5 * (values[middle - 1] + values[middle]);
+			});
+			aggregate("stddev", [&](auto getter) {
+				double average = mean(getter);
+				double sum = 0.0;
+				for (double value : collect(getter)) sum += (value - average) * (value - average);
+				return std::sqrt(sum / static_cast<double>(runs.size() - 1));
+			});
+		}
+
+		void printResult(const MicroBenchmarkResult& result) const {
+			if (!printedHeader) {
+				std::cout << std::left << std::setw(48) << "Benchmark" << std::right
+					<< std::setw(16) << "Time" << std::setw(16) << "CPU" << std::setw(14) << "Iterations" << "\n"
+					<< std::string(94, '-') << "\n";
+				printedHeader = true;
+			}
+			std::cout << std::left << std::setw(48) << result.name << std::right;
+			if (!result.errorMessage.empty()) {
+				std::cout << " ERROR OCCURRED: '" << result.errorMessage << "'\n";
+				return;
+			}
+			std::cout << std::fixed << std::setprecision(1)
+				<< std::setw(13) << result.realTimeNs << " ns"
+				<< std::setw(13) << result.cpuTimeNs << " ns"
+				<< std::setw(14) << result.iterations;
+			if (result.itemsPerSecond > 0.0) {
+				std::cout << std::setprecision(3) << "  items/s=" << result.itemsPerSecond;
+			}
+			if (result.bytesPerSecond > 0.0) {
+				std::cout << std::setprecision(3) << "  bytes/s=" << result.bytesPerSecond;
+			}
+			std::cout << "\n";
+		}
+
+		static std::string escapeJson(const std::string& text) {
+			std::string escaped;
+			for (char c : text) {
+				if (c == '"' || c == '\\') {
+					escaped += '\\';
+					escaped += c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20) {
+					char buffer[8];
+					std::snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+					escaped += buffer;
+				}
+				else {
+					escaped += c;
+				}
+			}
+			return escaped;
+		}
+
+		//与 Google Benchmark 的 --benchmark_format=json 相同的结构，可以直接用 compare.py 比较
+		void writeJson(const std::string& path) const {
+			std::ofstream file{ path, std::ios::trunc };
+			if (!file) {
+				throw std::runtime_error("failed to open benchmark output file: " + path);
+			}
+			std::time_t now = std::time(nullptr);
+			char date[64]{};
+			std::strftime(date, sizeof(date), "%Y-%m-%dT%H:%M:%S", std::localtime(&now));
+
+			file << std::setprecision(10);
+			file << "{\n  \"context\": {\n"
+				<< "    \"date\": \"" << date << "\",\n"
+				<< "    \"num_cpus\": " << std::thread::hardware_concurrency() << ",\n"
+#if defined(NDEBUG)
+				<< "    \"library_build_type\": \"release\"\n"
+#else
+				<< "    \"library_build_type\": \"debug\"\n"
+#endif
+				<< "  },\n  \"benchmarks\": [";
+			for (size_t i = 0; i < results.size(); i++) {
+				const auto& result = results[i];
+				file << (i == 0 ? "\n" : ",\n") << "    {\n"
+					<< "      \"name\": \"" << escapeJson(result.name) << "\",\n"
+					<< "      \"run_name\": \"" << escapeJson(result.runName) << "\",\n"
+					<< "      \"run_type\": \"" << result.runType << "\",\n"
+					<< "      \"repetitions\": " << std::max(options.repetitions, 1u) << ",\n";
+				if (result.runType == "aggregate") {
+					file << "      \"aggregate_name\": \"" << result.aggregateName << "\",\n";
+				}
+				else {
+					file << "      \"repetition_index\": " << result.repetitionIndex << ",\n";
+				}
+				if (!result.errorMessage.empty()) {
+					file << "      \"error_occurred\": true,\n"
+						<< "      \"error_message\": \"" << escapeJson(result.errorMessage) << "\",\n";
+				}
+				file << "      \"iterations\": " << result.iterations << ",\n"
+					<< "      \"real_time\": " << result.realTimeNs << ",\n"
+					<< "      \"cpu_time\": " << result.cpuTimeNs << ",\n";
+				if (result.itemsPerSecond > 0.0) {
+					file << "      \"items_per_second\": " << result.itemsPerSecond << ",\n";
+				}
+				if (result.bytesPerSecond > 0.0) {
+					file << "      \"bytes_per_second\": " << result.bytesPerSecond << ",\n";
+				}
+				file << "      \"time_unit\": \"ns\"\n    }";
+			}
+			file << "\n  ]\n}\n";
+		}
+
+		MicroBenchmarkOptions options;
+		std::vector<MicroBenchmarkResult> results;
+		mutable bool printedHeader = false;
+		bool failed = false;
+	};
+
+	int runMicroBenchmarks(const MicroBenchmarkOptions& options) {
+		MicroBenchmarkRunner runner{ options };
+		return runner.run();
+	}
+}  // namespace lve
@@ -0,0 +1,135 @@
+#pragma once
+
+//std
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+namespace lve {
+	//仿照 Google Benchmark 的最小实现：自动选择迭代次数、重复多次取统计量，
+	//结果可以写成 Google Benchmark 兼容的 JSON，方便用现成的脚本比较两次运行
+	class MicroBenchmarkState {
+	public:
+		MicroBenchmarkState(uint64_t iterations, const std::vector<int64_t>& args)
+			: maxIterations{ iterations }, args{ args } {}
+
+		//用法：while (state.keepRunning()) { ... }
+		//第一次调用时开始计时，最后一次调用时停止计时
+		bool keepRunning() {
+			if (!started) {
+				started = true;
+				resumeTiming();
+			}
+			if (completedIterations < maxIterations && errorMessage.empty()) {
+				completedIterations++;
+				return true;
+			}
+			pauseTiming();
+			return false;
+		}
+
+		//循环里准备数据的部分可以不计入时间
+		void pauseTiming();
+		void resumeTiming();
+
+		int64_t range(size_t index = 0) const { return index < args.size() ? args[index] : 0; }
+		uint64_t iterations() const { return maxIterations; }
+
+		void setItemsProcessed(uint64_t items) { itemsProcessed = items; }
+		void setBytesProcessed(uint64_t bytes) { bytesProcessed = bytes; }
+		//环境不满足（比如没有 GPU）时跳过，结果里会带上错误信息
+		void skipWithError(const std::string& message) { errorMessage = message; }
+
+	private:
+		friend class MicroBenchmarkRunner;
+
+		uint64_t maxIterations;
+		uint64_t completedIterations = 0;
+		std::vector<int64_t> args;
+		bool started = false;
+		bool timing = false;
+
+		std::chrono::steady_clock::time_point realStart{};
+		double cpuStart = 0.0;
+		double realSeconds = 0.0;
+		double cpuSeconds = 0.0;
+
+		uint64_t itemsProcessed = 0;
+		uint64_t bytesProcessed = 0;
+		std::string errorMessage;
+	};
+
+	using MicroBenchmarkFunction = std::function<void(MicroBenchmarkState&)>;
+
+	//注册表里的一项，arg() 可以链式调用，每个参数组合生成一个 "name/arg" 的基准
+	class MicroBenchmark {
+	public:
+		MicroBenchmark(std::string name, MicroBenchmarkFunction function)
+			: name{ std::move(name) }, function{ std::move(function) } {}
+
+		MicroBenchmark* arg(int64_t value) {
+			argSets.push_back({ value });
+			return this;
+		}
+		MicroBenchmark* args(std::vector<int64_t> values) {
+			argSets.push_back(std::move(values));
+			return this;
+		}
+
+		const std::string& getName() const { return name; }
+		const MicroBenchmarkFunction& getFunction() const { return function; }
+		const std::vector<std::vector<int64_t>>& getArgSets() const { return argSets; }
+
+	private:
+		std::string name;
+		MicroBenchmarkFunction function;
+		std::vector<std::vector<int64_t>> argSets;
+	};
+
+	MicroBenchmark* registerMicroBenchmark(const std::string& name, MicroBenchmarkFunction function);
+
+	struct MicroBenchmarkOptions {
+		std::string filter;					//名字里包含这个子串的基准才运行，空表示全部
+		std::string outputPath;				//非空时写出 JSON 结果
+		double minTimeSeconds = 0.5;		//每次重复至少运行这么久
+		uint32_t repetitions = 3;			//大于 1 时额外输出 mean/median/stddev
+	};
+
+	//运行所有注册的基准，控制台打印表格。skipWithError 只记录在结果里，
+	//基准本身用法错误（没有跑完 keepRunning 循环）时返回非 0
+	int runMicroBenchmarks(const MicroBenchmarkOptions& options);
+
+	//阻止编译器把被测结果当成死代码删掉
+	template <typename T>
+	inline void doNotOptimize(const T& value) {
+#if defined(_MSC_VER)
+		static const void* volatile sink;
+		sink = &value;
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : "r,m"(value) : "memory");
+#endif
+	}
+
+	inline void clobberMemory() {
+#if defined(_MSC_VER)
+		_ReadWriteBarrier();
+#else
+		asm volatile("" : : : "memory");
+#endif
+	}
+}  // namespace lve
+
+#define LVE_MICRO_BENCHMARK_CONCAT_INNER(a, b) a##b
+#define LVE_MICRO_BENCHMARK_CONCAT(a, b) LVE_MICRO_BENCHMARK_CONCAT_INNER(a, b)
+
+//在命名空间作用域注册一个 void(MicroBenchmarkState&) 函数，可以接着写 ->arg(...)
+#define LVE_MICRO_BENCHMARK(function) \
+	static ::lve::MicroBenchmark* LVE_MICRO_BENCHMARK_CONCAT(lveMicroBenchmark_, __LINE__) = \
+		::lve::registerMicroBenchmark(#function, function)
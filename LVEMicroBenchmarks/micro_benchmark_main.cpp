@@ -0,0 +1,47 @@
+#include "micro_benchmark.h"
+
+//std
+#include <cstdlib>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+// 参数与 Google Benchmark 相同，CI 可以直接复用现有的调用方式和比较脚本：
+// LVEMicroBenchmarks [--benchmark_filter=substr] [--benchmark_out=results.json]
+//                    [--benchmark_min_time=seconds] [--benchmark_repetitions=N]
+static lve::MicroBenchmarkOptions parseMicroBenchmarkOptions(int argc, char** argv) {
+    lve::MicroBenchmarkOptions options{};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        size_t equals = arg.find('=');
+        if (equals == std::string::npos) {
+            throw std::runtime_error("arguments must look like --name=value: " + arg);
+        }
+        std::string name = arg.substr(0, equals);
+        std::string value = arg.substr(equals + 1);
+        if (name == "--benchmark_filter") options.filter = value;
+        else if (name == "--benchmark_out") options.outputPath = value;
+        else if (name == "--benchmark_min_time") options.minTimeSeconds = std::stod(value);
+        else if (name == "--benchmark_repetitions") options.repetitions = static_cast<uint32_t>(std::stoul(value));
+        else if (name == "--benchmark_out_format") {
+            if (value != "json") {
+                throw std::runtime_error("only json output is supported: " + value);
+            }
+        }
+        else {
+            throw std::runtime_error("unknown argument: " + arg);
+        }
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+    try {
+        return lve::runMicroBenchmarks(parseMicroBenchmarkOptions(argc, argv)) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+    }
+    catch (const std::exception& e) {
+        std::cerr << e.what() << std::endl;
+
+        return EXIT_FAILURE;
+    }
+}
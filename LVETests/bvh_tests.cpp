@@ -0,0 +1,151 @@
+#include "lve_test.h"
+
+#include "lve_bvh.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+namespace lve {
+
+	namespace {
+		//边长 100 的立方体里随机放置的盒子，坐标取整数，射线起点经常正好落在 slab 平面上
+		std::vector<LVEAabb> makeRandomBounds(size_t count, uint32_t seed) {
+			std::mt19937 rng{ seed };
+			std::uniform_int_distribution<int> position{ -50, 50 };
+			std::uniform_int_distribution<int> size{ 1, 4 };
+			std::vector<LVEAabb> bounds(count);
+			for (auto& box : bounds) {
+				glm::vec3 min{ position(rng), position(rng), position(rng) };
+				box = LVEAabb{ min, min + glm::vec3{ size(rng), size(rng), size(rng) } };
+			}
+			return bounds;
+		}
+
+		std::vector<uint32_t> sorted(std::vector<uint32_t> values) {
+			std::sort(values.begin(), values.end());
+			return values;
+		}
+
+		//alive 为 false 的下标已经从树里删除
+		template <typename Predicate>
+		std::vector<uint32_t> bruteForce(const std::vector<LVEAabb>& bounds, const std::vector<bool>& alive, Predicate predicate) {
+			std::vector<uint32_t> result;
+			for (uint32_t i = 0; i < bounds.size(); i++) {
+				if (alive[i] && predicate(bounds[i])) {
+					result.push_back(i);
+				}
+			}
+			return result;
+		}
+
+		bool bruteForceRaycast(
+			const std::vector<LVEAabb>& bounds, const std::vector<bool>& alive,
+			const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float& closest)
+		{
+			glm::vec3 invDirection = 1.f / direction;
+			bool found = false;
+			closest = maxDistance;
+			for (uint32_t i = 0; i < bounds.size(); i++) {
+				float distance;
+				if (alive[i] && intersectRayAabb(origin, invDirection, bounds[i], closest, distance)) {
+					closest = distance;
+					found = true;
+				}
+			}
+			return found;
+		}
+	}
+
+	//插入、移动、删除之后，四种查询都必须和逐个测试所有盒子的结果完全相同（用户数据就是盒子下标）
+	LVE_TEST(BvhQueriesMatchBruteForce) {
+		std::vector<LVEAabb> bounds = makeRandomBounds(2000, 7);
+		std::vector<bool> alive(bounds.size(), true);
+		std::vector<uint32_t> proxies(bounds.size());
+		LVEBvh bvh{};
+		for (uint32_t i = 0; i < bounds.size(); i++) {
+			proxies[i] = bvh.insert(bounds[i], i);
+		}
+		bvh.rebuild();
+
+		std::mt19937 rng{ 11 };
+		std::uniform_real_distribution<float> offset{ -3.f, 3.f };
+		for (uint32_t i = 0; i < bounds.size(); i += 5) {
+			glm::vec3 delta{ offset(rng), offset(rng), offset(rng) };
+			bounds[i] = LVEAabb{ bounds[i].min + delta, bounds[i].max + delta };
+			bvh.update(proxies[i], bounds[i]);
+		}
+		for (uint32_t i = 3; i < bounds.size(); i += 17) {
+			bvh.remove(proxies[i]);
+			alive[i] = false;
+		}
+		bvh.maintain();
+
+		glm::mat4 projection = glm::perspective(glm::radians(60.f), 1.5f, 0.1f, 80.f);
+		for (glm::vec3 eye : { glm::vec3{ 0.f }, glm::vec3{ -60.f, 10.f, -60.f }, glm::vec3{ 20.f, -5.f, 30.f } }) {
+			LVEFrustum frustum = LVEFrustum::fromMatrix(projection * glm::lookAt(eye, glm::vec3{ 5.f, 0.f, 0.f }, glm::vec3{ 0.f, 1.f, 0.f }));
+			std::vector<uint32_t> result;
+			bvh.queryFrustum(frustum, result);
+			LVE_CHECK(sorted(result) == bruteForce(bounds, alive, [&](const LVEAabb& box) { return frustum.intersects(box); }));
+		}
+
+		std::uniform_real_distribution<float> point{ -55.f, 55.f };
+		for (int query = 0; query < 50; query++) {
+			glm::vec3 center{ point(rng), point(rng), point(rng) };
+			LVEAabb region{ center - glm::vec3{ 8.f }, center + glm::vec3{ 8.f } };
+			std::vector<uint32_t> result;
+			bvh.queryAabb(region, result);
+			LVE_CHECK(sorted(result) == bruteForce(bounds, alive, [&](const LVEAabb& box) { return box.overlaps(region); }));
+
+			result.clear();
+			bvh.queryRadius(center, 10.f, result);
+			LVE_CHECK(sorted(result) == bruteForce(bounds, alive, [&](const LVEAabb& box) { return intersectSphereAabb(center, 10.f, box); }));
+		}
+
+		//一半的射线沿坐标轴，起点坐标取整数
+		for (int query = 0; query < 200; query++) {
+			glm::vec3 origin{ std::round(point(rng)), std::round(point(rng)), std::round(point(rng)) };
+			glm::vec3 direction{ offset(rng), offset(rng), offset(rng) };
+			if (query % 2 == 0) {
+				direction = glm::vec3{ 0.f };
+				direction[query / 2 % 3] = query % 4 == 0 ? 1.f : -1.f;
+			}
+			LVEBvhRayHit hit{};
+			float expectedDistance;
+			bool expected = bruteForceRaycast(bounds, alive, origin, direction, 200.f, expectedDistance);
+			LVE_CHECK(bvh.raycast(origin, direction, 200.f, hit) == expected);
+			if (expected) {
+				LVE_CHECK(hit.distance == expectedDistance);
+				LVE_CHECK(alive[hit.userData]);
+			}
+		}
+	}
+
+	//方向分量为 0 且起点正好在 slab 平面上时，1/0 的倒数会让 0 * inf 得到 NaN，边界上的起点也要算命中
+	LVE_TEST(BvhRaycastParallelToSlabPlane) {
+		LVEBvh bvh{};
+		bvh.insert(LVEAabb{ glm::vec3{ 0.f }, glm::vec3{ 1.f } }, 42);
+		bvh.rebuild();
+
+		LVEBvhRayHit hit{};
+		//沿 +x，起点在 y = 0 和 z = 1 的平面上，擦着盒子的棱进入
+		LVE_CHECK(bvh.raycast(glm::vec3{ -1.f, 0.f, 1.f }, glm::vec3{ 1.f, 0.f, 0.f }, 10.f, hit));
+		LVE_CHECK(hit.userData == 42);
+		LVE_CHECK(hit.distance == 1.f);
+		//反方向的 -0 也一样
+		LVE_CHECK(bvh.raycast(glm::vec3{ 2.f, 0.f, 0.5f }, glm::vec3{ -1.f, -0.f, 0.f }, 10.f, hit));
+		LVE_CHECK(hit.distance == 1.f);
+		//平行于 slab 但在 slab 外面
+		LVE_CHECK(!bvh.raycast(glm::vec3{ -1.f, 1.5f, 0.5f }, glm::vec3{ 1.f, 0.f, 0.f }, 10.f, hit));
+		LVE_CHECK(!bvh.raycast(glm::vec3{ 0.5f, 0.5f, -1.f }, glm::vec3{ 0.f, 0.f, -1.f }, 10.f, hit));
+	}
+
+}  // namespace lve
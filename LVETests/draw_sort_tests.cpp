@@ -0,0 +1,87 @@
+#include "lve_test.h"
+
+#include "lve_draw_sort.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <random>
+#include <vector>
+
+namespace lve {
+
+	namespace {
+		//keyMask 之外的位取 fixedBits，用来控制哪些字节上所有键都相同
+		std::vector<LVEDrawKey> makeKeys(size_t count, uint64_t keyMask, uint64_t fixedBits, uint32_t seed) {
+			std::mt19937_64 rng{ seed };
+			std::vector<LVEDrawKey> keys(count);
+			for (uint32_t i = 0; i < count; i++) {
+				keys[i] = LVEDrawKey{ (rng() & keyMask) | (fixedBits & ~keyMask), i };
+			}
+			return keys;
+		}
+
+		bool sortsLikeStableSort(LVEDrawSorter& sorter, std::vector<LVEDrawKey> keys) {
+			std::vector<LVEDrawKey> expected = keys;
+			std::stable_sort(expected.begin(), expected.end(), [](const LVEDrawKey& a, const LVEDrawKey& b) { return a.key < b.key; });
+			sorter.sort(keys);
+			return std::equal(keys.begin(), keys.end(), expected.begin(), expected.end(),
+				[](const LVEDrawKey& a, const LVEDrawKey& b) { return a.key == b.key && a.index == b.index; });
+		}
+	}
+
+	LVE_TEST(DrawSorterMatchesStableSort) {
+		//同一个排序器反复使用，覆盖阈值两侧和结果落在 scratch 之后的下一次排序
+		LVEDrawSorter sorter{};
+		const uint32_t threshold = LVEDrawSorter::RADIX_SORT_THRESHOLD;
+		for (size_t count : { size_t{ 0 }, size_t{ 1 }, size_t{ 17 }, size_t{ threshold - 1 }, size_t{ threshold }, size_t{ threshold + 1 }, size_t{ 5000 } }) {
+			LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(count, ~uint64_t{ 0 }, 0, static_cast<uint32_t>(count))));
+			//只有几种键，大量相等的键必须保持原来的顺序
+			LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(count, 0x0300000000000003ull, 0, static_cast<uint32_t>(count) + 1)));
+		}
+	}
+
+	LVE_TEST(DrawSorterSkipsConstantBytes) {
+		LVEDrawSorter sorter{};
+		const uint64_t fixed = 0xABCDEF0123456789ull;
+		//低 3 个字节不同：执行 3 趟，结果落在 scratch 里
+		LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(1000, 0xFFFFFFull, fixed, 1)));
+		//低 2 个字节不同：执行 2 趟，结果回到原数组
+		LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(1000, 0xFFFFull, fixed, 2)));
+		//只有中间的一个字节不同，前后的趟都跳过
+		LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(1000, 0xFF000000ull, fixed, 3)));
+		//高字节不同、低字节相同，正如只有管线和材质不同的绘制
+		LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(1000, 0xFFFF000000000000ull, fixed, 4)));
+		//所有键都相同时一趟也不执行，顺序不变
+		LVE_CHECK(sortsLikeStableSort(sorter, makeKeys(1000, 0, fixed, 5)));
+	}
+
+	LVE_TEST(DrawSorterQuantizesDepthMonotonically) {
+		LVE_CHECK(LVEDrawSorter::quantizeDepth(0.f) == 0);
+		LVE_CHECK(LVEDrawSorter::quantizeDepth(-0.f) == 0);
+		LVE_CHECK(LVEDrawSorter::quantizeDepth(-1.f) == 0);
+		LVE_CHECK(LVEDrawSorter::quantizeDepth(-std::numeric_limits<float>::infinity()) == 0);
+		LVE_CHECK(LVEDrawSorter::quantizeDepth(std::numeric_limits<float>::quiet_NaN()) == 0);
+		LVE_CHECK(LVEDrawSorter::quantizeDepth(std::numeric_limits<float>::max()) < (1u << LVEDrawSorter::DEPTH_BITS));
+
+		//相邻深度相差 0.1%，24 位量化保留 16 位尾数，应当严格递增
+		uint32_t decreases = 0;
+		uint32_t ties = 0;
+		uint32_t previous = LVEDrawSorter::quantizeDepth(1e-4f);
+		for (float depth = 1e-4f * 1.001f; depth < 1e5f; depth *= 1.001f) {
+			uint32_t quantized = LVEDrawSorter::quantizeDepth(depth);
+			decreases += quantized < previous ? 1 : 0;
+			ties += quantized == previous ? 1 : 0;
+			previous = quantized;
+		}
+		LVE_CHECK(decreases == 0);
+		LVE_CHECK(ties == 0);
+
+		//键的高位是管线，同一网格内由近到远
+		LVE_CHECK(LVEDrawSorter::makeOpaqueKey(0, 5, 5, 1000.f) < LVEDrawSorter::makeOpaqueKey(1, 0, 0, 0.5f));
+		LVE_CHECK(LVEDrawSorter::makeOpaqueKey(1, 2, 3, 0.5f) < LVEDrawSorter::makeOpaqueKey(1, 2, 3, 2.f));
+		LVE_CHECK(LVEDrawSorter::makeOpaqueKey(1, 2, 3, -1.f) < LVEDrawSorter::makeOpaqueKey(1, 2, 3, 0.5f));
+	}
+
+}  // namespace lve
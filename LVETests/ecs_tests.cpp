@@ -0,0 +1,202 @@
+#include "lve_test.h"
+
+#include "lve_ecs.h"
+#include "lve_job_system.h"
+
+// std
+#include <array>
+#include <atomic>
+#include <memory>
+#include <random>
+#include <vector>
+
+namespace lve {
+
+	namespace {
+		struct Position {
+			float x, y, z;
+		};
+		struct Velocity {
+			float x, y, z;
+		};
+		struct Tag {
+			uint32_t value;
+		};
+		//非平凡的组件，use_count 能看出是否被多拷贝或少析构
+		struct SharedHandle {
+			std::shared_ptr<int> handle;
+		};
+		//每个约 1KB，一个 16KB 的块只放得下十几个，少量实体就会跨越多个块
+		struct Payload {
+			uint32_t id;
+			std::array<uint8_t, 1020> padding;
+		};
+		struct VisitCounter {
+			uint32_t visits;
+		};
+	}
+
+	LVE_TEST(EcsStaleHandleIsNotAlive) {
+		LVEWorld world{};
+		LVEEntity first = world.createEntity(Tag{ 1 });
+		LVE_CHECK(world.isAlive(first));
+		world.destroyEntity(first);
+		LVE_CHECK(!world.isAlive(first));
+		LVE_CHECK(world.tryGetComponent<Tag>(first) == nullptr);
+
+		//新实体复用同一个 index，旧句柄仍然无效，用旧句柄销毁不会影响新实体
+		LVEEntity second = world.createEntity(Tag{ 2 });
+		LVE_CHECK(second.index == first.index);
+		LVE_CHECK(second.generation != first.generation);
+		LVE_CHECK(!world.isAlive(first));
+		LVE_CHECK(world.isAlive(second));
+		world.destroyEntity(first);
+		LVE_CHECK(world.isAlive(second));
+		LVE_CHECK(world.getComponent<Tag>(second).value == 2);
+		LVE_CHECK(world.getEntityCount() == 1);
+
+		world.clear();
+		LVE_CHECK(!world.isAlive(second));
+		LVE_CHECK(world.getEntityCount() == 0);
+	}
+
+	LVE_TEST(EcsComponentsSurviveArchetypeMoves) {
+		LVEWorld world{};
+		//同一原型里放几个实体，搬走中间的那个时会用最后一行填洞
+		std::vector<LVEEntity> entities;
+		for (uint32_t i = 0; i < 4; i++) {
+			entities.push_back(world.createEntity(Position{ float(i), float(i) + 0.5f, -float(i) }, Velocity{ 1.f, 2.f, float(i) }));
+		}
+		LVEEntity moving = entities[1];
+
+		world.addComponent(moving, Tag{ 42 });
+		LVE_CHECK(world.hasComponent<Tag>(moving));
+		LVE_CHECK(world.getComponent<Position>(moving).y == 1.5f);
+		LVE_CHECK(world.getComponent<Velocity>(moving).z == 1.f);
+
+		world.removeComponent<Velocity>(moving);
+		LVE_CHECK(!world.hasComponent<Velocity>(moving));
+		LVE_CHECK(world.getComponent<Position>(moving).x == 1.f);
+		LVE_CHECK(world.getComponent<Tag>(moving).value == 42);
+
+		//已有的组件直接赋值，不换原型
+		uint32_t archetypeCount = world.getArchetypeCount();
+		world.addComponent(moving, Tag{ 7 });
+		LVE_CHECK(world.getComponent<Tag>(moving).value == 7);
+		LVE_CHECK(world.getArchetypeCount() == archetypeCount);
+
+		for (uint32_t i = 0; i < entities.size(); i++) {
+			if (entities[i] == moving) {
+				continue;
+			}
+			LVE_CHECK(world.getComponent<Position>(entities[i]).x == float(i));
+			LVE_CHECK(world.getComponent<Velocity>(entities[i]).z == float(i));
+		}
+	}
+
+	LVE_TEST(EcsNonTrivialComponentsAreDestroyedOnce) {
+		auto shared = std::make_shared<int>(5);
+		{
+			LVEWorld world{};
+			std::vector<LVEEntity> entities;
+			for (uint32_t i = 0; i < 8; i++) {
+				entities.push_back(world.createEntity(SharedHandle{ shared }, Tag{ i }));
+			}
+			LVE_CHECK(shared.use_count() == 9);
+
+			//换原型和填洞都是移动，不增加也不减少引用
+			world.addComponent(entities[0], Position{});
+			world.removeComponent<Tag>(entities[3]);
+			world.addComponent(entities[5], Velocity{});
+			LVE_CHECK(shared.use_count() == 9);
+			LVE_CHECK(world.getComponent<SharedHandle>(entities[0]).handle == shared);
+
+			world.destroyEntity(entities[2]);
+			LVE_CHECK(shared.use_count() == 8);
+			world.removeComponent<SharedHandle>(entities[5]);
+			LVE_CHECK(shared.use_count() == 7);
+			world.addComponent(entities[6], SharedHandle{ std::make_shared<int>(6) });
+			LVE_CHECK(shared.use_count() == 6);
+
+			for (LVEEntity entity : entities) {
+				if (world.hasComponent<SharedHandle>(entity)) {
+					LVE_CHECK(*world.getComponent<SharedHandle>(entity).handle == (entity == entities[6] ? 6 : 5));
+				}
+			}
+		}
+		LVE_CHECK(shared.use_count() == 1);
+	}
+
+	LVE_TEST(EcsSwapFillKeepsRecordsAcrossChunks) {
+		uint32_t capacity = LVEArchetype{ componentMask<Payload>() }.getChunkCapacity();
+		LVE_CHECK(capacity > 1);
+		uint32_t entityCount = capacity * 3 + 2;
+
+		LVEWorld world{};
+		std::vector<LVEEntity> entities;
+		for (uint32_t i = 0; i < entityCount; i++) {
+			Payload payload{};
+			payload.id = i;
+			payload.padding.fill(static_cast<uint8_t>(i));
+			entities.push_back(world.createEntity(payload));
+		}
+
+		//先删第一个块的第一行（最后一个块的实体搬过来），再随机删一半
+		std::vector<bool> alive(entityCount, true);
+		world.destroyEntity(entities[0]);
+		alive[0] = false;
+		std::mt19937 rng{ 3 };
+		for (uint32_t i = 0; i < entityCount / 2; i++) {
+			uint32_t victim = std::uniform_int_distribution<uint32_t>{ 0, entityCount - 1 }(rng);
+			world.destroyEntity(entities[victim]);
+			alive[victim] = false;
+		}
+
+		uint32_t aliveCount = 0;
+		for (uint32_t i = 0; i < entityCount; i++) {
+			LVE_CHECK(world.isAlive(entities[i]) == alive[i]);
+			if (!alive[i]) {
+				continue;
+			}
+			aliveCount++;
+			const Payload& payload = world.getComponent<Payload>(entities[i]);
+			LVE_CHECK(payload.id == i);
+			LVE_CHECK(payload.padding.back() == static_cast<uint8_t>(i));
+		}
+		LVE_CHECK(world.getEntityCount() == aliveCount);
+
+		//遍历看到的实体和组件也要对得上
+		uint32_t visited = 0;
+		world.each<Payload>([&](LVEEntity entity, Payload& payload) {
+			LVE_CHECK(entity == entities[payload.id]);
+			visited++;
+		});
+		LVE_CHECK(visited == aliveCount);
+	}
+
+	LVE_TEST(EcsParallelEachVisitsEveryEntityOnce) {
+		LVEWorld world{};
+		constexpr uint32_t ENTITY_COUNT = 20000;
+		std::vector<LVEEntity> entities;
+		for (uint32_t i = 0; i < ENTITY_COUNT; i++) {
+			//一半实体在另一个原型里，查询只要求 VisitCounter，两个原型都要遍历到
+			entities.push_back(i % 2 == 0 ? world.createEntity(VisitCounter{ 0 }) : world.createEntity(VisitCounter{ 0 }, Tag{ i }));
+		}
+
+		LVEJobSystem jobSystem{ 3 };
+		std::atomic<uint32_t> total{ 0 };
+		world.parallelEach<VisitCounter>(jobSystem, [&](LVEEntity, VisitCounter& counter) {
+			counter.visits++;
+			total.fetch_add(1, std::memory_order_relaxed);
+		});
+		LVE_CHECK(total.load() == ENTITY_COUNT);
+		uint32_t wrongCounts = 0;
+		for (LVEEntity entity : entities) {
+			if (world.getComponent<VisitCounter>(entity).visits != 1) {
+				wrongCounts++;
+			}
+		}
+		LVE_CHECK(wrongCounts == 0);
+	}
+
+}  // namespace lve
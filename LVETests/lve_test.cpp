@@ -0,0 +1,58 @@
+#include "lve_test.h"
+
+//std
+#include <exception>
+#include <iostream>
+#include <vector>
+
+namespace lve {
+	namespace {
+		struct RegisteredTest {
+			const char* name;
+			TestFunction function;
+		};
+
+		//函数内的静态变量，保证其他翻译单元的静态注册先于它使用时已经构造
+		std::vector<RegisteredTest>& registry() {
+			static std::vector<RegisteredTest> tests;
+			return tests;
+		}
+
+		int currentFailures = 0;
+	}
+
+	bool registerTest(const char* name, TestFunction function) {
+		registry().push_back({ name, std::move(function) });
+		return true;
+	}
+
+	void reportCheckFailure(const char* expression, const char* file, int line) {
+		std::cerr << file << "(" << line << "): check failed: " << expression << std::endl;
+		currentFailures++;
+	}
+
+	int runTests(const std::string& filter) {
+		int failedTests = 0;
+		int ranTests = 0;
+		for (const auto& test : registry()) {
+			if (!filter.empty() && std::string{ test.name }.find(filter) == std::string::npos) {
+				continue;
+			}
+			currentFailures = 0;
+			try {
+				test.function();
+			}
+			catch (const std::exception& e) {
+				std::cerr << test.name << ": unexpected exception: " << e.what() << std::endl;
+				currentFailures++;
+			}
+			ranTests++;
+			if (currentFailures > 0) {
+				failedTests++;
+			}
+			std::cout << (currentFailures > 0 ? "[  FAILED  ] " : "[       OK ] ") << test.name << std::endl;
+		}
+		std::cout << ranTests - failedTests << " of " << ranTests << " tests passed" << std::endl;
+		return failedTests;
+	}
+}  // namespace lve
@@ -0,0 +1,32 @@
+#pragma once
+
+//std
+#include <functional>
+#include <string>
+
+namespace lve {
+	//不需要 GPU 的单元测试用的最小框架：LVE_TEST 在命名空间作用域注册一个测试，
+	//LVE_CHECK 失败时打印表达式和行号并把当前测试记为失败，测试本身继续运行
+	using TestFunction = std::function<void()>;
+
+	bool registerTest(const char* name, TestFunction function);
+	void reportCheckFailure(const char* expression, const char* file, int line);
+
+	//运行名字里包含 filter 的测试（空表示全部），返回失败的测试数量
+	int runTests(const std::string& filter);
+}  // namespace lve
+
+#define LVE_TEST_CONCAT_INNER(a, b) a##b
+#define LVE_TEST_CONCAT(a, b) LVE_TEST_CONCAT_INNER(a, b)
+
+#define LVE_TEST(name) \
+	static void name(); \
+	static bool LVE_TEST_CONCAT(lveTest_, name) = ::lve::registerTest(#name, name); \
+	static void name()
+
+#define LVE_CHECK(expression) \
+	do { \
+		if (!(expression)) { \
+			::lve::reportCheckFailure(#expression, __FILE__, __LINE__); \
+		} \
+	} while (0)
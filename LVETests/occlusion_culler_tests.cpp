@@ -0,0 +1,125 @@
+#include "lve_test.h"
+
+#include "lve_ecs.h"
+#include "lve_job_system.h"
+#include "lve_occlusion_culler.h"
+#include "lve_scene_index.h"
+#include "lve_transform_system.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+// std
+#include <memory>
+#include <vector>
+
+namespace lve {
+
+	namespace {
+		//相机在原点朝 +z 看。z = 5 处有一堵 4 x 4 的墙，挡住屏幕中间 tan 值 [-0.4, 0.4] 的范围
+		glm::mat4 cameraProjectionView() {
+			glm::mat4 projection = glm::perspective(glm::radians(60.f), 1.5f, 0.1f, 100.f);
+			return projection * glm::lookAt(glm::vec3{ 0.f }, glm::vec3{ 0.f, 0.f, 1.f }, glm::vec3{ 0.f, 1.f, 0.f });
+		}
+
+		TransformComponent wallTransform() {
+			TransformComponent wall{};
+			wall.translation = { 0.f, 0.f, 5.f };
+			wall.scale = { 4.f, 4.f, 0.2f };
+			return wall;
+		}
+
+		LVEAabb unitBoxAt(const glm::vec3& center) {
+			return LVEAabb{ center - glm::vec3{ 0.5f }, center + glm::vec3{ 0.5f } };
+		}
+
+		//下标和测试场景里的槽位一一对应
+		enum SceneObject : uint32_t {
+			BehindWall,			//完全在墙后面
+			InFrontOfWall,		//在墙和相机之间
+			BesideWall,			//在墙后面，但在墙的侧面
+			PartlyBehindWall,	//只有一半被墙挡住
+			CrossingNearPlane,	//跨过近平面，总被当作可见
+			SceneObjectCount,
+		};
+
+		const glm::vec3 objectCenters[SceneObjectCount] = {
+			{ 0.f, 0.f, 15.f },
+			{ 0.f, 0.f, 3.f },
+			{ 9.f, 0.f, 15.f },
+			{ 6.f, 0.f, 15.f },
+			{ 0.f, 0.f, 0.2f },
+		};
+	}
+
+	//直接加入遮挡体，逐个测试世界包围盒
+	LVE_TEST(OcclusionCullerHidesOnlyFullyCoveredBounds) {
+		LVEOcclusionCuller culler{};
+		LVEOccluderMesh box = LVEOccluderMesh::createBox();
+
+		culler.beginFrame(cameraProjectionView());
+		//还没有遮挡体时什么都不剔除
+		culler.rasterize();
+		LVE_CHECK(!culler.isOccluded(unitBoxAt(objectCenters[BehindWall])));
+
+		culler.beginFrame(cameraProjectionView());
+		culler.addOccluder(box, wallTransform().mat4());
+		culler.rasterize();
+		LVE_CHECK(culler.getOccluderTriangleCount() > 0);
+
+		LVE_CHECK(culler.isOccluded(unitBoxAt(objectCenters[BehindWall])));
+		LVE_CHECK(!culler.isOccluded(unitBoxAt(objectCenters[InFrontOfWall])));
+		LVE_CHECK(!culler.isOccluded(unitBoxAt(objectCenters[BesideWall])));
+		LVE_CHECK(!culler.isOccluded(unitBoxAt(objectCenters[PartlyBehindWall])));
+		LVE_CHECK(!culler.isOccluded(unitBoxAt(objectCenters[CrossingNearPlane])));
+		//穿过墙的物体有一部分在墙前面
+		LVE_CHECK(!culler.isOccluded(LVEAabb{ glm::vec3{ -0.5f, -0.5f, 4.f }, glm::vec3{ 0.5f, 0.5f, 6.f } }));
+
+		//墙中心的像素是墙的深度，角上的像素没有遮挡体
+		const std::vector<float>& depth = culler.getDepthBuffer();
+		uint32_t width = culler.getWidth();
+		uint32_t height = culler.getHeight();
+		LVE_CHECK(depth[(height / 2) * width + width / 2] < 1.f);
+		LVE_CHECK(depth[0] == 1.f);
+	}
+
+	//和渲染循环相同的路径：遮挡体来自 world，候选物体的包围盒来自 LVESceneIndex，并行光栅化
+	LVE_TEST(OcclusionCullerCullsSceneVisibility) {
+		LVEJobSystem jobSystem{};
+		LVETransformSystem transformSystem{ &jobSystem };
+		LVESceneIndex sceneIndex{ &jobSystem };
+		LVEWorld world;
+
+		for (const glm::vec3& center : objectCenters) {
+			TransformComponent transform{};
+			transform.translation = center;
+			uint32_t slot = transformSystem.add(transform);
+			sceneIndex.add(slot, unitBoxAt(glm::vec3{ 0.f }));
+		}
+		uint32_t wallSlot = transformSystem.add(wallTransform());
+		world.createEntity(
+			TransformSlotComponent{ wallSlot }, OccluderComponent{ std::make_shared<const LVEOccluderMesh>(LVEOccluderMesh::createBox()) });
+		transformSystem.update();
+		sceneIndex.update(transformSystem);
+
+		LVEOcclusionCuller culler{ &jobSystem };
+		culler.beginFrame(cameraProjectionView());
+		culler.addOccluders(world, transformSystem);
+		culler.rasterize();
+
+		std::vector<uint8_t> visibility(transformSystem.size(), 1);
+		LVE_CHECK(culler.cullVisibility(sceneIndex, visibility) == 1);
+		LVE_CHECK(culler.getLastOccludedCount() == 1);
+		LVE_CHECK(visibility[BehindWall] == 0);
+		LVE_CHECK(visibility[InFrontOfWall] == 1);
+		LVE_CHECK(visibility[BesideWall] == 1);
+		LVE_CHECK(visibility[PartlyBehindWall] == 1);
+		LVE_CHECK(visibility[CrossingNearPlane] == 1);
+		//墙自己没有登记在 sceneIndex 里，保持可见
+		LVE_CHECK(visibility[wallSlot] == 1);
+	}
+
+}  // namespace lve
@@ -0,0 +1,72 @@
+#include "lve_test.h"
+
+#include "lve_render_graph.h"
+
+// std
+#include <vector>
+
+namespace lve {
+
+	namespace {
+		using CullAccess = LVERenderGraph::CullAccess;
+		using CullPass = LVERenderGraph::CullPass;
+		using AliasRequest = LVERenderGraph::AliasRequest;
+
+		CullAccess writeImage(uint32_t image, bool discard = true) { return CullAccess{ image, false, true, discard }; }
+		CullAccess readImage(uint32_t image) { return CullAccess{ image, true, false, false }; }
+
+		enum GraphImage : uint32_t { Backbuffer, Depth, Unused, GraphImageCount };
+	}
+
+	LVE_TEST(RenderGraphCullsPassesWithoutConsumers) {
+		std::vector<CullPass> passes(6);
+		passes[0].accesses = { writeImage(Backbuffer) };			//之后被 Scene 完整覆盖
+		passes[1].accesses = { writeImage(Unused) };				//结果没人读
+		passes[2].accesses = { writeImage(Depth) };
+		passes[3].accesses = { writeImage(Backbuffer), readImage(Depth) };
+		passes[4].accesses = { readImage(Backbuffer) };
+		passes[4].sideEffects = true;
+		passes[5].accesses = { writeImage(Backbuffer, false) };		//在 Scene 的结果上叠加
+
+		std::vector<bool> outputs(GraphImageCount, false);
+		outputs[Backbuffer] = true;
+		std::vector<bool> alive = LVERenderGraph::findLivePasses(passes, outputs);
+		LVE_CHECK(alive == std::vector<bool>({ false, false, true, true, true, true }));
+
+		//没有输出时只剩有副作用的通道和它读到的结果
+		std::vector<bool> noOutputs = LVERenderGraph::findLivePasses(passes, std::vector<bool>(GraphImageCount, false));
+		LVE_CHECK(noOutputs == std::vector<bool>({ false, false, true, true, true, false }));
+	}
+
+	LVE_TEST(RenderGraphLoadKeepsEarlierWriter) {
+		std::vector<CullPass> passes(2);
+		passes[0].accesses = { writeImage(Backbuffer) };
+		passes[1].accesses = { writeImage(Backbuffer, false) };
+		std::vector<bool> outputs(GraphImageCount, false);
+		outputs[Backbuffer] = true;
+		LVE_CHECK(LVERenderGraph::findLivePasses(passes, outputs) == std::vector<bool>({ true, true }));
+	}
+
+	LVE_TEST(RenderGraphAliasesOnlyDisjointCompatibleImages) {
+		std::vector<AliasRequest> requests = {
+			{ 0, 1, 100, 0b01 },
+			{ 2, 3, 80, 0b11 },
+			{ 1, 2, 60, 0b01 },		//和第 0 张重叠
+			{ 4, 4, 50, 0b10 },		//区间不重叠，但和第一块剩下的内存类型没有交集
+			{ 5, 5, 120, 0b11 },
+		};
+		std::vector<LVERenderGraph::AliasBlock> blocks = LVERenderGraph::planAliasing(requests);
+		LVE_CHECK(blocks.size() == 3);
+		if (blocks.size() != 3) {
+			return;
+		}
+		LVE_CHECK(blocks[0].requests == std::vector<uint32_t>({ 4, 0, 1 }));
+		LVE_CHECK(blocks[0].size == 120);
+		LVE_CHECK(blocks[0].memoryTypeBits == 0b01);
+		LVE_CHECK(blocks[1].requests == std::vector<uint32_t>({ 2 }));
+		LVE_CHECK(blocks[1].size == 60);
+		LVE_CHECK(blocks[2].requests == std::vector<uint32_t>({ 3 }));
+		LVE_CHECK(blocks[2].memoryTypeBits == 0b10);
+	}
+
+}  // namespace lve
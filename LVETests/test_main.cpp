@@ -0,0 +1,12 @@
+#include "lve_test.h"
+
+//std
+#include <cstdlib>
+#include <iostream>
+#include <string>
+
+// 用法: LVETests [filter]，只运行名字里包含 filter 的测试
+int main(int argc, char** argv) {
+    std::string filter = argc > 1 ? argv[1] : "";
+    return lve::runTests(filter) == 0 ? EXIT_SUCCESS : EXIT_FAILURE;
+}
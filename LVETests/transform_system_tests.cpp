@@ -0,0 +1,192 @@
+#include "lve_test.h"
+
+#include "lve_job_system.h"
+#include "lve_transform_system.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cmath>
+#include <random>
+#include <stdexcept>
+#include <vector>
+
+namespace lve {
+
+	namespace {
+		//旋转覆盖几圈，让 sinCos4 的范围约简走到所有象限；缩放不为 0
+		TransformComponent makeRandomTransform(std::mt19937& rng) {
+			std::uniform_real_distribution<float> position{ -100.f, 100.f };
+			std::uniform_real_distribution<float> angle{ -20.f, 20.f };
+			std::uniform_real_distribution<float> scale{ 0.25f, 4.f };
+			TransformComponent transform{};
+			transform.translation = { position(rng), position(rng), position(rng) };
+			transform.rotation = { angle(rng), angle(rng), angle(rng) };
+			transform.scale = { scale(rng), scale(rng), scale(rng) };
+			return transform;
+		}
+
+		//矩阵元素的量级不超过 100（平移）和 4（缩放的倒数），按元素大小放宽误差
+		bool nearlyEqual(const glm::mat4& a, const glm::mat4& b, float tolerance = 1e-5f) {
+			for (int column = 0; column < 4; column++) {
+				for (int row = 0; row < 4; row++) {
+					float expected = b[column][row];
+					if (std::abs(a[column][row] - expected) > tolerance * (1.f + std::abs(expected))) {
+						return false;
+					}
+				}
+			}
+			return true;
+		}
+
+		bool matchesComponent(const LVETransformSystem& transforms, uint32_t slot, TransformComponent transform) {
+			return nearlyEqual(transforms.getModelMatrix(slot), transform.mat4()) &&
+				nearlyEqual(transforms.getNormalMatrix(slot), glm::mat4{ transform.normalMatrix() });
+		}
+
+		void checkBatchedMatricesMatchComponent(LVEJobSystem* jobSystem) {
+			//301 个批次，最后一个只有 3 个槽位：超过并行阈值，也覆盖不满一个批次的尾部
+			constexpr uint32_t SLOT_COUNT = 300 * 4 + 3;
+			std::mt19937 rng{ 7 };
+			LVETransformSystem transforms{ jobSystem };
+			std::vector<TransformComponent> components(SLOT_COUNT);
+			for (auto& component : components) {
+				component = makeRandomTransform(rng);
+				transforms.add(component);
+			}
+			transforms.update();
+			LVE_CHECK(transforms.getLastUpdatedCount() == SLOT_COUNT);
+			uint32_t mismatches = 0;
+			for (uint32_t slot = 0; slot < SLOT_COUNT; slot++) {
+				if (!matchesComponent(transforms, slot, components[slot])) {
+					mismatches++;
+				}
+			}
+			LVE_CHECK(mismatches == 0);
+
+			transforms.update();
+			LVE_CHECK(transforms.getLastUpdatedCount() == 0);
+
+			//只改尾部批次里的一个槽位，同一批次里干净的槽位重算后结果不变
+			components[SLOT_COUNT - 1] = makeRandomTransform(rng);
+			transforms.set(SLOT_COUNT - 1, components[SLOT_COUNT - 1]);
+			transforms.update();
+			LVE_CHECK(transforms.getLastUpdatedCount() == 1);
+			for (uint32_t slot = SLOT_COUNT - 3; slot < SLOT_COUNT; slot++) {
+				LVE_CHECK(matchesComponent(transforms, slot, components[slot]));
+			}
+		}
+	}
+
+	LVE_TEST(TransformSystemMatchesComponentMatrices) {
+		checkBatchedMatricesMatchComponent(nullptr);
+	}
+
+	LVE_TEST(TransformSystemParallelUpdateMatchesComponentMatrices) {
+		LVEJobSystem jobSystem{ 3 };
+		checkBatchedMatricesMatchComponent(&jobSystem);
+	}
+
+	namespace {
+		//三层的链 Root <- Middle <- Leaf，外加一个不相关的根节点。
+		//父节点的槽位故意排在子节点后面，世界矩阵的顺序只能来自按深度排序
+		enum ChainSlot : uint32_t { Leaf, Unrelated, Middle, Root, ChainSlotCount };
+
+		struct Chain {
+			LVETransformSystem transforms;
+			std::vector<TransformComponent> components;
+
+			Chain() {
+				std::mt19937 rng{ 11 };
+				for (uint32_t slot = 0; slot < ChainSlotCount; slot++) {
+					components.push_back(makeRandomTransform(rng));
+					//链上的缩放取 1 附近，三层相乘后误差仍然可比
+					components.back().scale = glm::vec3{ 1.f + 0.1f * slot };
+					transforms.add(components.back());
+				}
+				transforms.setParent(Middle, Root);
+				transforms.setParent(Leaf, Middle);
+				transforms.update();
+			}
+
+			glm::mat4 localMatrix(uint32_t slot) { return components[slot].mat4(); }
+			glm::mat4 localNormalMatrix(uint32_t slot) { return glm::mat4{ components[slot].normalMatrix() }; }
+		};
+	}
+
+	LVE_TEST(TransformHierarchyComposesParentMatrices) {
+		Chain chain{};
+		LVETransformSystem& transforms = chain.transforms;
+		glm::mat4 rootToMiddle = chain.localMatrix(Root) * chain.localMatrix(Middle);
+		glm::mat4 rootToMiddleNormal = chain.localNormalMatrix(Root) * chain.localNormalMatrix(Middle);
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Root), chain.localMatrix(Root)));
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Middle), rootToMiddle));
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Leaf), rootToMiddle * chain.localMatrix(Leaf)));
+		LVE_CHECK(nearlyEqual(transforms.getNormalMatrix(Leaf), rootToMiddleNormal * chain.localNormalMatrix(Leaf)));
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Unrelated), chain.localMatrix(Unrelated)));
+		LVE_CHECK(nearlyEqual(transforms.getLocalMatrix(Leaf), chain.localMatrix(Leaf)));
+	}
+
+	LVE_TEST(TransformHierarchyUpdatesOnlyDirtySubtree) {
+		Chain chain{};
+		LVETransformSystem& transforms = chain.transforms;
+
+		chain.components[Root].translation += glm::vec3{ 1.f, 2.f, 3.f };
+		transforms.set(Root, chain.components[Root]);
+		transforms.update();
+		LVE_CHECK(transforms.getLastUpdatedCount() == 3);
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Leaf),
+			chain.localMatrix(Root) * chain.localMatrix(Middle) * chain.localMatrix(Leaf)));
+
+		chain.components[Leaf].rotation.y += 0.5f;
+		transforms.set(Leaf, chain.components[Leaf]);
+		transforms.update();
+		LVE_CHECK(transforms.getLastUpdatedCount() == 1);
+		LVE_CHECK(transforms.getUpdatedSlots() == std::vector<uint32_t>({ Leaf }));
+
+		transforms.update();
+		LVE_CHECK(transforms.getLastUpdatedCount() == 0);
+	}
+
+	LVE_TEST(TransformHierarchyReparentToRootRestoresLocalMatrix) {
+		Chain chain{};
+		LVETransformSystem& transforms = chain.transforms;
+		transforms.setParent(Leaf, LVETransformSystem::INVALID_SLOT);
+		transforms.update();
+		LVE_CHECK(transforms.getParent(Leaf) == LVETransformSystem::INVALID_SLOT);
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Leaf), chain.localMatrix(Leaf)));
+		LVE_CHECK(nearlyEqual(transforms.getNormalMatrix(Leaf), chain.localNormalMatrix(Leaf)));
+
+		//之后移动原来的父节点不再带动它
+		chain.components[Middle].translation.x += 5.f;
+		transforms.set(Middle, chain.components[Middle]);
+		transforms.update();
+		LVE_CHECK(transforms.getLastUpdatedCount() == 1);
+		LVE_CHECK(nearlyEqual(transforms.getModelMatrix(Leaf), chain.localMatrix(Leaf)));
+	}
+
+	LVE_TEST(TransformHierarchyRejectsCycles) {
+		Chain chain{};
+		LVETransformSystem& transforms = chain.transforms;
+		auto throwsOnSetParent = [&](uint32_t slot, uint32_t parentSlot) {
+			try {
+				transforms.setParent(slot, parentSlot);
+			}
+			catch (const std::runtime_error&) {
+				return true;
+			}
+			return false;
+		};
+		LVE_CHECK(throwsOnSetParent(Root, Leaf));
+		LVE_CHECK(throwsOnSetParent(Middle, Middle));
+		//失败的调用不改变层级
+		LVE_CHECK(transforms.getParent(Root) == LVETransformSystem::INVALID_SLOT);
+		LVE_CHECK(transforms.getParent(Middle) == Root);
+		transforms.update();
+		LVE_CHECK(transforms.getLastUpdatedCount() == 0);
+	}
+
+}  // namespace lve
@@ -1,8 +1,11 @@
 #include "first_app.h"
 
 #include "keyboard_movement_controller.h"
+#include "lve_camera_path.h"
+#include "lve_input_recorder.h"
 #include "lve_buffer.h"
 #include "lve_camera.h"
+#include "lve_profiler.h"
 #include "simple_render_system.h"
 
 #define GLM_FORCE_RADIANS
@@ -14,6 +17,8 @@
 #include <stdexcept>
 #include <array>
 #include <chrono>
+#include <cstdint>
+#include <iostream>
 #include <memory>
 
 namespace lve {
@@ -23,11 +28,15 @@ namespace lve {
 		glm::vec3 lightDirection = glm::normalize(glm::vec3{ 1.f, -3.f, -1.f });
 	};
 
-	FirstApp::FirstApp() {
+	//设备在 runOptions 之前构造，动态渲染的开关直接从参数读取
+	FirstApp::FirstApp(const AppRunOptions& options)
+		: lveDevice{ lveWindow, options.dynamicRendering }, runOptions{ options } {
+		LVE_PROFILE_THREAD("Main");
+		lveRenderer.getFrameStats().setExportFile(FRAME_STATS_FILE_PATH);
 		globalPool =
 			LVEDescriptorPool::Builder(lveDevice)
-			.setMaxSets(LVESwapChain::MAX_FRAMES_IN_FLIGHT)
-			.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, LVESwapChain::MAX_FRAMES_IN_FLIGHT)
+			.setMaxSets(lveRenderer.getFramesInFlight())
+			.addPoolSize(VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, lveRenderer.getFramesInFlight())
 			.build();
 		loadGameObjects();
 	}
@@ -39,14 +48,14 @@ namespace lve {
 		//LVEBuffer globalUboBuffer{
 		//	  lveDevice,
 		//	  sizeof(GlobalUbo),
-		//	  LVESwapChain::MAX_FRAMES_IN_FLIGHT,//MAX_FRAMES_IN_FLIGHT  !!!ȫʹãԼframeuboBufferrender commandBuffersimageAvailableSemaphoresrenderFinishedSemaphoresinFlightFences
+		//	  LVESwapChain::MAX_FRAMES_IN_FLIGHT,//MAX_FRAMES_IN_FLIGHT  !!!全局使用，约定数量：frame、uboBuffer、render commandBuffers、imageAvailableSemaphores、renderFinishedSemaphores、inFlightFences
 		//	  VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-		//	  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,//δѡһԣȾĻ
+		//	  VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT,//未选择一致性，避免干扰正在渲染的缓冲
 		//	  lveDevice.properties.limits.minUniformBufferOffsetAlignment,
 		//};
 		//globalUboBuffer.map();
 
-		std::vector<std::unique_ptr<LVEBuffer>> uboBuffers(LVESwapChain::MAX_FRAMES_IN_FLIGHT);
+		std::vector<std::unique_ptr<LVEBuffer>> uboBuffers(lveRenderer.getFramesInFlight());
 		for (int i = 0; i < uboBuffers.size(); ++i) {
 			uboBuffers[i] = std::make_unique<LVEBuffer>(
 				lveDevice,
@@ -63,22 +72,24 @@ namespace lve {
 			.addBinding(0, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
 			.build();
 
-		//ʾڶ֡ȾʱҪΪÿһ֡׼һ趨֧ͨ˫໺ȾԼ GPU  CPU ֮ĵȴʱ䡣
-		std::vector<VkDescriptorSet> globalDescriptorSets(LVESwapChain::MAX_FRAMES_IN_FLIGHT);
+		//表示在多帧渲染时，我们需要为每一帧准备一个描述集。这个设定通常用于支持双缓冲或多缓冲渲染，以减少 GPU 和 CPU 之间的等待时间。
+		std::vector<VkDescriptorSet> globalDescriptorSets(lveRenderer.getFramesInFlight());
 
-		//Ҫ֡ءָĶbufferimage...
+		//填充描述集：需要描述符集布局、描述符池、描述符具体指向的对象（buffer、image...）
 		for (int i = 0; i < globalDescriptorSets.size(); i++) {
 			auto bufferInfo = uboBuffers[i]->descriptorInfo();
-			LVEDescriptorWriter(*globalSetLayout, *globalPool)		//һд֮ǰֺء
-				.writeBuffer(0, &bufferInfo)						// 0 ŰλúͶӦĻϢдСϢὫݴݸɫ
-				.build(globalDescriptorSets[i]);					//洢Ӧ
+			LVEDescriptorWriter(*globalSetLayout, *globalPool)		//创建一个描述集写入器对象利用之前创建的描述集布局和描述池。
+				.writeBuffer(0, &bufferInfo)						//将第 0 号绑定位置和对应的缓冲区描述信息写入描述集中。这个缓冲区信息会将数据传递给着色器
+				.build(globalDescriptorSets[i]);					//构建描述集，并将其存储到对应的
 		}
 
 
+		//渲染系统在构造时只提交管线编译请求，所有管线在工作线程上并行编译
 		SimpleRenderSystem simpleRenderSystem{
 			lveDevice,
-			lveRenderer.getSwapChainRenderPass(),			//ȡȾͨͨлͼʱϸϢ
-			globalSetLayout->getDescriptorSetLayout() };	//ȡ֮ǰȫ֣ԱȾʹá
+			pipelineRegistry,
+			lveRenderer.getPipelineTarget(),				//交换链的渲染通道，动态渲染时是颜色和深度附件的格式。
+			globalSetLayout->getDescriptorSetLayout() };	//取之前创建的全局描述集布局，以便在渲染过程中使用。
 
 		LVECamera camera{};
 		////camera.setViewDirection(glm::vec3(0.f), glm::vec3(0.5f, 0.f, 1.f));
@@ -88,20 +99,262 @@ namespace lve {
 		KeyboardMovementController cameraController{};
 		auto currentTime = std::chrono::high_resolution_clock::now();
 
+		//录制、回放和脚本路径都基于每帧的模拟时间步长，配合 fixedTimestep 可以得到逐帧一致的画面
+		LVEInputRecorder inputRecorder{};
+		std::unique_ptr<LVEInputReplay> inputReplay;
+		if (!runOptions.replayInputPath.empty()) {
+			inputReplay = std::make_unique<LVEInputReplay>(runOptions.replayInputPath);
+		}
+		std::unique_ptr<LVECameraPath> cameraPath;
+		if (!runOptions.cameraPathFile.empty()) {
+			cameraPath = std::make_unique<LVECameraPath>(LVECameraPath::loadFromFile(runOptions.cameraPathFile));
+		}
+		else if (runOptions.orbitCamera) {
+			cameraPath = std::make_unique<LVECameraPath>(
+				LVECameraPath::createOrbit(glm::vec3{ 0.f, 0.5f, 2.5f }, 2.5f, -1.f, 20.f));
+			cameraPath->setLooping(false);
+		}
+		float cameraPathTime = 0.f;
+
+		//渲染图只接管单线程渲染的场景通道，和 GPU 剔除、静态命令缓存同时打开时以渲染图为准
+		const bool useRenderGraph = runOptions.useRenderGraph && !runOptions.threadedRendering;
+		if (runOptions.useRenderGraph && runOptions.threadedRendering) {
+			std::cerr << "render graph is not supported with threaded rendering, ignoring --render-graph" << std::endl;
+		}
+		if (useRenderGraph && runOptions.gpuOcclusionCulling) {
+			std::cerr << "render graph takes precedence, disabling gpu culling" << std::endl;
+		}
+		if (useRenderGraph && runOptions.cacheStaticCommands) {
+			std::cerr << "render graph takes precedence, disabling static command cache" << std::endl;
+		}
+
+		//GPU 剔除需要保留第一个渲染通道的深度，再在第二个渲染通道里补画
+		//创建失败（例如着色器编译不过）时退回 CPU 剔除，而不是让程序退出
+		std::unique_ptr<LVEHiZCuller> hizCuller;
+		if (!runOptions.threadedRendering && !useRenderGraph && !runOptions.cacheStaticCommands && runOptions.gpuOcclusionCulling) {
+			if (!LVEHiZCuller::isSupported(lveDevice)) {
+				std::cerr << "gpu culling unavailable (needs drawIndirectFirstInstance and compiled hiz_*.spv), using cpu culling" << std::endl;
+			}
+			else {
+				try {
+					hizCuller = std::make_unique<LVEHiZCuller>(
+						lveDevice,
+						pipelineRegistry,
+						lveRenderer.getPipelineTarget(),
+						globalSetLayout->getDescriptorSetLayout(),
+						lveRenderer.getFramesInFlight());
+				}
+				catch (const std::exception& e) {
+					std::cerr << "failed to create gpu culler, using cpu culling: " << e.what() << std::endl;
+				}
+			}
+		}
+		//缓存的命令包含所有实体，物体移动或实体增删时 sceneVersion 改变，缓存重新录制
+		std::unique_ptr<LVEStaticCommandCache> staticCommandCache;
+		uint64_t transformVersion = 0;
+		if (!runOptions.threadedRendering && !useRenderGraph && runOptions.cacheStaticCommands) {
+			staticCommandCache = std::make_unique<LVEStaticCommandCache>(lveDevice, lveRenderer);
+		}
+
+		//渲染图的结构固定，交换链重建（附件尺寸变化）后重新构建；通道回调通过 graphFrameInfo 拿到这一帧的信息
+		std::unique_ptr<LVERenderGraph> renderGraph;
+		LVERenderGraphImage graphColor{};
+		uint32_t renderGraphGeneration = 0;
+		FrameInfo* graphFrameInfo = nullptr;
+		auto buildRenderGraph = [&](const LVEColorTarget& colorTarget, VkFormat depthFormat) {
+			renderGraph = std::make_unique<LVERenderGraph>(lveDevice);
+			LVERenderGraph::ImportDesc colorDesc{};
+			colorDesc.format = colorTarget.format;
+			colorDesc.extent = colorTarget.extent;
+			colorDesc.initialStage = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+			colorDesc.finalLayout = colorTarget.finalLayout;
+			graphColor = renderGraph->importImage("SceneColor", colorDesc);
+			LVERenderGraphImage depth = renderGraph->createImage("SceneDepth", { depthFormat, colorTarget.extent });
+			//附件顺序与交换链的渲染通道一致（颜色、深度），SimpleRenderSystem 的管线可以直接使用
+			renderGraph->addPass("Scene", LVERenderGraph::PassType::Graphics)
+				.writeColor(graphColor, LVERenderGraph::LoadOp::Clear, { { 0.01f, 0.01f, 0.01f, 1.0f } })
+				.writeDepth(depth)
+				.execute([&](const LVERenderGraphContext&) { simpleRenderSystem.renderEntities(*graphFrameInfo, world); });
+			renderGraph->compile();
+			renderGraphGeneration = lveRenderer.getSwapChainGeneration();
+		};
+
+		//渲染线程只读游戏线程交来的数据包，LVERenderer、uniform 缓冲区和渲染系统之后只在渲染线程上使用。
+		//它在这些对象之后创建，析构时先把已提交的数据包渲染完再退出
+		std::unique_ptr<LVERenderThread> renderThread;
+		if (runOptions.threadedRendering) {
+			renderThread = std::make_unique<LVERenderThread>([&](const LVERenderPacket& packet) {
+				lveRenderer.getFramePacer().markInputSampled(packet.inputSampleTime);
+				if (auto commandBuffer = lveRenderer.beginFrame()) {
+					int frameIndex = lveRenderer.getFrameIndex();
+					LVECamera packetCamera = packet.camera;
+					FrameInfo frameInfo{
+						frameIndex,
+						packet.frameTime,
+						commandBuffer,
+						packetCamera,
+						globalDescriptorSets[frameIndex],
+						&lveRenderer.getGpuProfiler(),
+						&lveRenderer.getFrameStats() };
+
+					LVE_PROFILE_SCOPE("RecordCommands");
+					GlobalUbo ubo{};
+					ubo.projectionView = packetCamera.getProjection() * packetCamera.getView();
+					uboBuffers[frameIndex]->writeToBuffer(&ubo);
+					uboBuffers[frameIndex]->flush();
+
+					lveRenderer.getFrameStats().setCullingCounts(packet.visibleCount, packet.culledCount);
+					lveRenderer.beginSwapChainRenderPass(commandBuffer);
+					simpleRenderSystem.renderPacket(frameInfo, packet);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+					lveRenderer.endFrame();
+				}
+			});
+		}
+
+		//空闲模式：上一轮判断画面不需要更新时，不再 beginFrame/endFrame，而是阻塞等待下一个事件。
+		//可复现的运行每帧都要推进，不进入空闲
+		bool idleEnabled = runOptions.idleWhenStatic && runOptions.recordInputPath.empty() && !inputReplay && !cameraPath;
+		bool idle = false;
+		glm::vec3 lastCameraTranslation{ 0.f };
+		glm::vec3 lastCameraRotation{ 0.f };
+		uint64_t lastStructureVersion = UINT64_MAX;
+		bool lastPipelinesReady = false;
+
 		while (!lveWindow.shouldClose()) {
-			glfwPollEvents();
+			LVE_PROFILE_SCOPE("Frame");
+			//限帧等待放在采样输入之前，保证输入尽可能新
+			{
+				LVE_PROFILE_SCOPE("WaitForNextFrame");
+				lveRenderer.getFramePacer().waitForNextFrame();
+			}
+			{
+				LVE_PROFILE_SCOPE("PollInput");
+				if (idle) {
+					lveWindow.waitEvents(IDLE_WAIT_TIMEOUT);
+					//等待的时间不算进帧间隔，否则醒来后的第一帧相机会跳一大步
+					currentTime = std::chrono::high_resolution_clock::now();
+				}
+				else {
+					glfwPollEvents();
+				}
+				updateProfilerCapture();
+			}
 
 			auto newTime = std::chrono::high_resolution_clock::now();
 			float frameTime =
 				std::chrono::duration<float, std::chrono::seconds::period>(newTime - currentTime).count();
 			currentTime = newTime;
-			cameraController.moveInPlaneXZ(lveWindow.getGLFWwindow(), frameTime, viewerObject);
+			if (runOptions.fixedTimestep > 0.f) {
+				frameTime = runOptions.fixedTimestep;
+			}
+
+			bool inputActive = false;
+			if (cameraPath) {
+				cameraPathTime += frameTime;
+				CameraKeyframe keyframe = cameraPath->sample(cameraPathTime);
+				viewerObject.transform.translation = keyframe.position;
+				viewerObject.transform.rotation = keyframe.rotation;
+				if (cameraPath->isFinished(cameraPathTime)) {
+					glfwSetWindowShouldClose(lveWindow.getGLFWwindow(), GLFW_TRUE);
+				}
+			}
+			else if (inputReplay) {
+				RecordedInputFrame recorded{};
+				if (inputReplay->next(recorded)) {
+					if (runOptions.fixedTimestep <= 0.f) {
+						frameTime = recorded.dt;
+					}
+					cameraController.applyInput(recorded.input, frameTime, viewerObject);
+				}
+				else {
+					glfwSetWindowShouldClose(lveWindow.getGLFWwindow(), GLFW_TRUE);
+				}
+			}
+			else {
+				auto input = cameraController.sampleInput(lveWindow.getGLFWwindow());
+				inputActive = input.buttons != 0;
+				if (!runOptions.recordInputPath.empty()) {
+					inputRecorder.record(frameTime, input);
+				}
+				cameraController.applyInput(input, frameTime, viewerObject);
+			}
+			auto inputSampleTime = LVEFramePacer::Clock::now();
+			if (!renderThread) {
+				lveRenderer.getFramePacer().markInputSampled(inputSampleTime);
+			}
 			camera.setViewYXZ(viewerObject.transform.translation, viewerObject.transform.rotation);
 
-			float aspect = lveRenderer.getAspectRatio();
+			//渲染线程可能正在重建交换链，游戏线程从窗口尺寸计算宽高比
+			float aspect = 1.f;
+			if (renderThread) {
+				VkExtent2D extent = lveWindow.getExtent();
+				if (extent.height > 0) {
+					aspect = static_cast<float>(extent.width) / static_cast<float>(extent.height);
+				}
+			}
+			else {
+				aspect = lveRenderer.getAspectRatio();
+			}
 			//camera.setOrthographicProjection(-aspect, aspect, -1, 1, -1, 1);
 			camera.setPerspectiveProjection(glm::radians(50.f), aspect, 0.1f, 10.f);
 
+			//只有本帧被 markDirty 的物体会重算矩阵
+			transformSystem.update();
+			if (transformSystem.getLastUpdatedCount() > 0) {
+				transformVersion++;
+			}
+			sceneIndex.update(transformSystem);
+
+			if (idleEnabled) {
+				//按住按键时即使相机没动（醒来后的第一帧时间步长接近 0）也继续渲染，避免再次进入等待
+				bool cameraMoved = viewerObject.transform.translation != lastCameraTranslation ||
+					viewerObject.transform.rotation != lastCameraRotation;
+				bool pipelinesReady = simpleRenderSystem.isPipelineReady() && (!hizCuller || hizCuller->isPipelineReady());
+				bool needsRedraw = lveWindow.consumeRedrawRequest() || lveWindow.wasWindowResized() ||
+					inputActive || cameraMoved ||
+					transformSystem.getLastUpdatedCount() > 0 ||
+					world.getStructureVersion() != lastStructureVersion ||
+					pipelinesReady != lastPipelinesReady;
+				lastCameraTranslation = viewerObject.transform.translation;
+				lastCameraRotation = viewerObject.transform.rotation;
+				lastStructureVersion = world.getStructureVersion();
+				lastPipelinesReady = pipelinesReady;
+				idle = !needsRedraw;
+				if (idle) {
+					continue;
+				}
+			}
+			//绘制管线在工作线程上编译，失败时才知道。剔除器的资源都交给延迟销毁队列，可以直接销毁
+			if (hizCuller && hizCuller->isPipelineFailed()) {
+				std::cerr << "gpu culler pipeline failed to compile, using cpu culling" << std::endl;
+				hizCuller.reset();
+			}
+			glm::mat4 projectionView = camera.getProjection() * camera.getView();
+			uint32_t visibleCount = 0;
+			if (!hizCuller && !staticCommandCache) {
+				visibleCount = sceneIndex.cullFrustum(projectionView, transformSystem.size(), visibleSlots);
+				//场景里没有遮挡体时 cullVisibility 直接返回
+				occlusionCuller.beginFrame(projectionView);
+				occlusionCuller.addOccluders(world, transformSystem, &visibleSlots);
+				occlusionCuller.rasterize();
+				visibleCount -= occlusionCuller.cullVisibility(sceneIndex, visibleSlots);
+			}
+
+			if (renderThread) {
+				//数据包里保存矩阵的拷贝，渲染线程录制时游戏线程可以继续更新下一帧
+				LVERenderPacket& packet = renderThread->getWritePacket();
+				packet.reset();
+				packet.frameTime = frameTime;
+				packet.camera = camera;
+				packet.inputSampleTime = inputSampleTime;
+				packet.visibleCount = visibleCount;
+				packet.culledCount = transformSystem.size() - visibleCount;
+				packet.gatherEntities(world, transformSystem, &visibleSlots);
+				renderThread->submitPacket();
+				continue;
+			}
+
 			if (auto commandBuffer = lveRenderer.beginFrame()) {
 				int frameIndex = lveRenderer.getFrameIndex();
 				FrameInfo frameInfo{
@@ -109,38 +362,104 @@ namespace lve {
 					frameTime,
 					commandBuffer,
 					camera,
-					globalDescriptorSets[frameIndex] };
+					globalDescriptorSets[frameIndex],
+					&lveRenderer.getGpuProfiler(),
+					&lveRenderer.getFrameStats(),
+					&transformSystem,
+					&visibleSlots };
 
 				// update
+				LVE_PROFILE_SCOPE("RecordCommands");
 				GlobalUbo ubo{};
 				ubo.projectionView = camera.getProjection() * camera.getView();
 				uboBuffers[frameIndex]->writeToBuffer(&ubo);
-				uboBuffers[frameIndex]->flush();//!!! ע ǰȾ߶Ӧuboˢ£֪洢λü
+				uboBuffers[frameIndex]->flush();//!!! 注意 当前渲染管线对应的ubo在这里刷新，被告知存储位置及长度
 
 				// render
-				lveRenderer.beginSwapChainRenderPass(commandBuffer);
-				simpleRenderSystem.renderGameObjects(frameInfo, gameObjects);
-				lveRenderer.endSwapChainRenderPass(commandBuffer);
+				if (hizCuller) {
+					//第一阶段画上一帧可见的物体，用它们的深度剔除其余物体，第二阶段只补画新出现的
+					hizCuller->beginFrame(frameInfo, world, sceneIndex);
+					lveRenderer.beginSwapChainRenderPass(commandBuffer);
+					hizCuller->drawEarly(frameInfo);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+					hizCuller->cullLate(frameInfo, lveRenderer.getCurrentDepthTarget());
+					lveRenderer.beginSwapChainRenderPass(commandBuffer, RenderPassLoad::Load);
+					hizCuller->drawLate(frameInfo);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+				}
+				else if (staticCommandCache) {
+					//两个版本号都只增不减，和不会在场景变化后回到旧值
+					uint64_t sceneVersion = transformVersion + world.getStructureVersion();
+					lveRenderer.getFrameStats().setCullingCounts(transformSystem.size(), 0);
+					lveRenderer.beginSwapChainRenderPass(commandBuffer, RenderPassLoad::Clear, RenderPassContents::SecondaryCommandBuffers);
+					simpleRenderSystem.renderEntitiesCached(frameInfo, world, *staticCommandCache, sceneVersion);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+				}
+				else if (useRenderGraph) {
+					LVEColorTarget colorTarget = lveRenderer.getCurrentColorTarget();
+					if (!renderGraph || renderGraphGeneration != lveRenderer.getSwapChainGeneration()) {
+						buildRenderGraph(colorTarget, lveRenderer.getCurrentDepthTarget().format);
+					}
+					renderGraph->setImportedImage(graphColor, colorTarget.image, colorTarget.view);
+					lveRenderer.getFrameStats().setCullingCounts(visibleCount, transformSystem.size() - visibleCount);
+					graphFrameInfo = &frameInfo;
+					renderGraph->execute(commandBuffer);
+					graphFrameInfo = nullptr;
+				}
+				else {
+					lveRenderer.getFrameStats().setCullingCounts(visibleCount, transformSystem.size() - visibleCount);
+					lveRenderer.beginSwapChainRenderPass(commandBuffer);
+					simpleRenderSystem.renderEntities(frameInfo, world);
+					lveRenderer.endSwapChainRenderPass(commandBuffer);
+				}
 				lveRenderer.endFrame();
 			}
 		}
 
-		vkDeviceWaitIdle(lveDevice.device());
+		//渲染线程中的异常在这里抛出
+		if (renderThread) {
+			renderThread->waitIdle();
+		}
+
+		if (!runOptions.recordInputPath.empty()) {
+			inputRecorder.save(runOptions.recordInputPath);
+		}
+
+		//不需要 vkDeviceWaitIdle：uniform 缓冲区、描述符池和管线析构时都进入设备的延迟销毁队列，
+		//LVEDevice 析构时会等待设备空闲再统一释放
+	}
+
+	void FirstApp::updateProfilerCapture() {
+		bool keyDown = glfwGetKey(lveWindow.getGLFWwindow(), PROFILER_CAPTURE_KEY) == GLFW_PRESS;
+		if (keyDown && !profilerKeyWasDown) {
+			if (!LVEProfiler::isCapturing()) {
+				LVEProfiler::startCapture();
+				std::cout << "profiler capture started" << std::endl;
+			}
+			else {
+				LVEProfiler::stopCapture();
+				LVEProfiler::writeChromeTrace(TRACE_FILE_PATH);
+				std::cout << "profiler capture written to " << TRACE_FILE_PATH << std::endl;
+			}
+		}
+		profilerKeyWasDown = keyDown;
 	}
 
 	void FirstApp::loadGameObjects() {
+		LVE_PROFILE_FUNCTION();
 		std::shared_ptr<LVEModel> lveModel =
 			LVEModel::createModelFromFile(lveDevice, "C:/Users/tolcf/Desktop/models/flat_vase.obj");
-		auto flatVase = LVEGameObject::createGameObject();
-		flatVase.model = lveModel;
-		flatVase.transform.translation = { -.5f, .5f, 2.5f };
-		flatVase.transform.scale = { 3.f, 1.5f, 3.f };
-		gameObjects.push_back(std::move(flatVase));
+		TransformComponent flatVase{};
+		flatVase.translation = { -.5f, .5f, 2.5f };
+		flatVase.scale = { 3.f, 1.5f, 3.f };
+		world.createEntity(ModelComponent{ lveModel }, TransformSlotComponent{ transformSystem.add(flatVase) });
+
 		lveModel = LVEModel::createModelFromFile(lveDevice, "C:/Users/tolcf/Desktop/models/smooth_vase.obj");
-		auto smoothVase = LVEGameObject::createGameObject();
-		smoothVase.model = lveModel;
-		smoothVase.transform.translation = { .5f, .5f, 2.5f };
-		smoothVase.transform.scale = { 3.f, 1.5f, 3.f };
-		gameObjects.push_back(std::move(smoothVase));
+		TransformComponent smoothVase{};
+		smoothVase.translation = { .5f, .5f, 2.5f };
+		smoothVase.scale = { 3.f, 1.5f, 3.f };
+		world.createEntity(ModelComponent{ lveModel }, TransformSlotComponent{ transformSystem.add(smoothVase) });
+
+		sceneIndex.registerEntities(world);
 	}
 };
\ No newline at end of file
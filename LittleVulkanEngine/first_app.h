@@ -3,37 +3,80 @@
 #include "lve_window.h"
 #include "lve_model.h"
 #include "lve_descriptors.h"
+#include "lve_ecs.h"
 #include "lve_game_object.h"
 #include "lve_renderer.h"
+#include "lve_hiz_culler.h"
+#include "lve_job_system.h"
+#include "lve_occlusion_culler.h"
+#include "lve_pipeline_registry.h"
+#include "lve_render_graph.h"
+#include "lve_render_thread.h"
+#include "lve_scene_index.h"
+#include "lve_static_command_cache.h"
+#include "lve_transform_system.h"
 
 //std
 #include <memory>
+#include <string>
 #include <vector>
 
 namespace lve {
+	//可复现运行的选项，全部为空时与普通交互运行相同
+	struct AppRunOptions {
+		std::string recordInputPath;	//退出时把每帧输入写到这个文件
+		std::string replayInputPath;	//回放录制的输入，回放结束后退出
+		std::string cameraPathFile;		//按脚本路径移动相机（忽略键盘），路径结束后退出
+		bool orbitCamera = false;		//没有路径文件时使用默认的环绕路径
+		float fixedTimestep = 0.f;		//大于 0 时每帧使用固定的时间步长，而不是真实的帧间隔
+		bool gpuOcclusionCulling = false;	//设备支持且 hiz_*.spv 已编译时用 LVEHiZCuller 在 GPU 上剔除，否则退回 CPU 剔除
+		bool cacheStaticCommands = false;	//场景的绘制命令录制到次级命令缓冲区中重放，不做剔除，适合静态场景
+		bool idleWhenStatic = false;		//输入、相机和场景都没有变化时不渲染，阻塞等待事件（录制、回放和相机路径下不生效）
+		bool threadedRendering = false;		//游戏线程更新和剔除，渲染线程同时录制提交上一帧（不使用 GPU 剔除和命令缓存）
+		bool useRenderGraph = false;		//CPU 剔除的场景通道通过 LVERenderGraph 执行，深度附件由渲染图管理；优先于 GPU 剔除和静态命令缓存，多线程渲染时不生效
+		bool dynamicRendering = true;		//设备支持时用 VK_KHR_dynamic_rendering 代替渲染通道和帧缓冲，关闭时始终使用传统路径
+	};
+
 	class FirstApp {
 	public:
 		static constexpr int WIDTH = 800;
 		static constexpr int HEIGHT = 600;
+		//按一次开始 CPU 分析采集，再按一次停止并写出 TRACE_FILE_PATH
+		static constexpr int PROFILER_CAPTURE_KEY = GLFW_KEY_F9;
+		static constexpr const char* TRACE_FILE_PATH = "lve_trace.json";
+		//每 10 秒一个窗口追加到这个文件，供运维看板读取
+		static constexpr const char* FRAME_STATS_FILE_PATH = "lve_frame_stats.csv";
+		//空闲时等待事件的最长时间，超时后重新检查异步编译的管线这类不会产生窗口事件的变化
+		static constexpr double IDLE_WAIT_TIMEOUT = 0.5;
 
-		FirstApp();
+		explicit FirstApp(const AppRunOptions& options = AppRunOptions{});
 		~FirstApp();
 
 		FirstApp(const FirstApp&) = delete;
 		FirstApp& operator=(const FirstApp&) = delete;
 
 		void run();
+		//后台系统（例如流式加载）改变了画面内容时调用，可以在任意线程调用
+		void requestRedraw() { lveWindow.requestRedraw(); }
 
 	private:
 		void loadGameObjects();
-		std::unique_ptr<LVEModel> createCubeModel(LVEDevice& device, glm::vec3 offset);
+		void updateProfilerCapture();
 
 		lve::LVEWindow lveWindow{ WIDTH, HEIGHT, "HelloVulkan!" };
 		lve::LVEDevice lveDevice{ lveWindow };
 		LVERenderer lveRenderer{lveWindow, lveDevice};
+		LVEJobSystem jobSystem{};
+		LVEPipelineRegistry pipelineRegistry{ lveDevice, jobSystem };
+		LVETransformSystem transformSystem{ &jobSystem };
+		LVESceneIndex sceneIndex{ &jobSystem };
+		LVEOcclusionCuller occlusionCuller{ &jobSystem };
+		std::vector<uint8_t> visibleSlots;
 
-		// ע⣺˳Ҫ
+		// 注意：声明的顺序很重要
 		std::unique_ptr<LVEDescriptorPool> globalPool{};
-		std::vector<LVEGameObject> gameObjects;
+		LVEWorld world;
+		bool profilerKeyWasDown = false;
+		AppRunOptions runOptions;
 	};
 }
\ No newline at end of file
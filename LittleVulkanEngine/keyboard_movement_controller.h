@@ -3,6 +3,9 @@
 #include "lve_game_object.h"
 #include "lve_window.h"
 
+// std
+#include <cstdint>
+
 namespace lve {
 	class KeyboardMovementController {
 	public:
@@ -19,6 +22,27 @@ namespace lve {
 			int lookDown = GLFW_KEY_DOWN;
 		};
 
+		//一帧的输入状态，每个按键一位。与窗口无关，可以录制下来回放
+		enum Button : uint32_t {
+			MoveLeft = 1u << 0,
+			MoveRight = 1u << 1,
+			MoveForward = 1u << 2,
+			MoveBackward = 1u << 3,
+			MoveUp = 1u << 4,
+			MoveDown = 1u << 5,
+			LookLeft = 1u << 6,
+			LookRight = 1u << 7,
+			LookUp = 1u << 8,
+			LookDown = 1u << 9,
+		};
+		struct MovementInput {
+			uint32_t buttons = 0;
+			bool isDown(Button button) const { return (buttons & button) != 0; }
+		};
+
+		//采样和应用分开：录制时保存 sampleInput 的结果，回放时直接把保存的结果交给 applyInput
+		MovementInput sampleInput(GLFWwindow* window) const;
+		void applyInput(const MovementInput& input, float dt, LVEGameObject& gameObject) const;
 		void moveInPlaneXZ(GLFWwindow* window, float dt, LVEGameObject& gameObject);
 
 		KeyMappings keys{};
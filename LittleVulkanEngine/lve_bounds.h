@@ -0,0 +1,143 @@
+#pragma once
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <array>
+#include <cfloat>
+#include <cmath>
+
+namespace lve {
+
+	//轴对齐包围盒，默认构造是空盒（min > max），expand/merge 后才有效
+	struct LVEAabb {
+		glm::vec3 min{ FLT_MAX };
+		glm::vec3 max{ -FLT_MAX };
+
+		bool isValid() const { return min.x <= max.x && min.y <= max.y && min.z <= max.z; }
+		glm::vec3 center() const { return (min + max) * 0.5f; }
+		glm::vec3 extent() const { return (max - min) * 0.5f; }
+
+		void expand(const glm::vec3& point) {
+			min = glm::min(min, point);
+			max = glm::max(max, point);
+		}
+		void merge(const LVEAabb& other) {
+			min = glm::min(min, other.min);
+			max = glm::max(max, other.max);
+		}
+		static LVEAabb merged(const LVEAabb& a, const LVEAabb& b) {
+			LVEAabb result = a;
+			result.merge(b);
+			return result;
+		}
+
+		//向外扩 margin，用于动态 BVH 的“胖”包围盒
+		LVEAabb inflated(const glm::vec3& margin) const { return LVEAabb{ min - margin, max + margin }; }
+
+		float surfaceArea() const {
+			glm::vec3 size = max - min;
+			return 2.f * (size.x * size.y + size.y * size.z + size.z * size.x);
+		}
+		bool contains(const LVEAabb& other) const {
+			return glm::all(glm::lessThanEqual(min, other.min)) && glm::all(glm::greaterThanEqual(max, other.max));
+		}
+		bool overlaps(const LVEAabb& other) const {
+			return glm::all(glm::lessThanEqual(min, other.max)) && glm::all(glm::greaterThanEqual(max, other.min));
+		}
+
+		//变换后的包围盒（Arvo 的方法，只用中心和半边长，不需要变换 8 个角点）
+		LVEAabb transformed(const glm::mat4& matrix) const {
+			glm::vec3 c = glm::vec3{ matrix * glm::vec4{ center(), 1.f } };
+			glm::vec3 e = extent();
+			glm::vec3 newExtent{
+				glm::abs(matrix[0][0]) * e.x + glm::abs(matrix[1][0]) * e.y + glm::abs(matrix[2][0]) * e.z,
+				glm::abs(matrix[0][1]) * e.x + glm::abs(matrix[1][1]) * e.y + glm::abs(matrix[2][1]) * e.z,
+				glm::abs(matrix[0][2]) * e.x + glm::abs(matrix[1][2]) * e.y + glm::abs(matrix[2][2]) * e.z };
+			return LVEAabb{ c - newExtent, c + newExtent };
+		}
+	};
+
+	//射线与包围盒求交（slab 方法），invDirection 为方向的倒数。命中时 tHit 是进入点的距离（起点在盒内时为 0）。
+	//方向分量为 0 时倒数是 inf，起点正好在 slab 平面上会算出 0 * inf = NaN，所以这样的轴单独判断：
+	//射线平行于这一对平面，起点在两平面之间（含边界）才可能命中
+	inline bool intersectRayAabb(
+		const glm::vec3& origin, const glm::vec3& invDirection, const LVEAabb& box, float maxDistance, float& tHit)
+	{
+		float enter = 0.f;
+		float exit = maxDistance;
+		for (int axis = 0; axis < 3; axis++) {
+			if (std::isinf(invDirection[axis])) {
+				if (origin[axis] < box.min[axis] || origin[axis] > box.max[axis]) {
+					return false;
+				}
+				continue;
+			}
+			float t0 = (box.min[axis] - origin[axis]) * invDirection[axis];
+			float t1 = (box.max[axis] - origin[axis]) * invDirection[axis];
+			enter = glm::max(enter, glm::min(t0, t1));
+			exit = glm::min(exit, glm::max(t0, t1));
+		}
+		tHit = enter;
+		return enter <= exit;
+	}
+
+	inline bool intersectSphereAabb(const glm::vec3& center, float radius, const LVEAabb& box) {
+		glm::vec3 closest = glm::clamp(center, box.min, box.max);
+		glm::vec3 offset = closest - center;
+		return glm::dot(offset, offset) <= radius * radius;
+	}
+
+	//视锥体的 6 个平面，法线指向视锥内部。平面方程为 dot(n, p) + d >= 0 表示在内侧
+	struct LVEFrustum {
+		enum class Containment {
+			Outside,
+			Intersecting,
+			Inside,
+		};
+
+		std::array<glm::vec4, 6> planes{};
+
+		//从 projection * view 提取平面（Gribb-Hartmann），深度范围是 Vulkan 的 [0, 1]
+		static LVEFrustum fromMatrix(const glm::mat4& projectionView) {
+			auto row = [&](int i) {
+				return glm::vec4{ projectionView[0][i], projectionView[1][i], projectionView[2][i], projectionView[3][i] };
+			};
+			LVEFrustum frustum{};
+			frustum.planes[0] = row(3) + row(0);	// left
+			frustum.planes[1] = row(3) - row(0);	// right
+			frustum.planes[2] = row(3) + row(1);	// bottom
+			frustum.planes[3] = row(3) - row(1);	// top
+			frustum.planes[4] = row(2);				// near（z >= 0）
+			frustum.planes[5] = row(3) - row(2);	// far
+			for (auto& plane : frustum.planes) {
+				plane /= glm::length(glm::vec3{ plane });
+			}
+			return frustum;
+		}
+
+		//只用中心和半边长对每个平面测试，保守：少数实际在外面的盒子会被当成相交
+		Containment classify(const LVEAabb& box) const {
+			glm::vec3 c = box.center();
+			glm::vec3 e = box.extent();
+			Containment result = Containment::Inside;
+			for (const auto& plane : planes) {
+				glm::vec3 n{ plane };
+				float distance = glm::dot(n, c) + plane.w;
+				float radius = glm::dot(e, glm::abs(n));
+				if (distance < -radius) {
+					return Containment::Outside;
+				}
+				if (distance < radius) {
+					result = Containment::Intersecting;
+				}
+			}
+			return result;
+		}
+		bool intersects(const LVEAabb& box) const { return classify(box) != Containment::Outside; }
+	};
+
+}  // namespace lve
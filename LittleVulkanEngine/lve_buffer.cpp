@@ -14,13 +14,13 @@
 namespace lve {
 
 	/**
-	 * 豸СʵСminOffsetAlignment
+	 * 返回与设备兼容所需的最小实例大小minOffsetAlignment
 	 *
-	 * @param instanceSize ʵĴС
-	 * @param minOffsetAlignment ƫԱС뷽ʽֽΪλ
+	 * @param instanceSize 实例的大小
+	 * @param minOffsetAlignment 偏移量成员所需的最小对齐方式（以字节为单位）（例如
 	 * minUniformBufferOffsetAlignment)
 	 *
-	 * @return ӳõVkResult
+	 * @return 缓冲区映射调用的VkResult
 	 */
 	VkDeviceSize LVEBuffer::getAlignment(VkDeviceSize instanceSize, VkDeviceSize minOffsetAlignment) {
 		if (minOffsetAlignment > 0) {
@@ -47,13 +47,19 @@ namespace lve {
 		device.createBuffer(bufferSize, usageFlags, memoryPropertyFlags, buffer, memory);
 	}
 
+	//GPU 可能还在读这个缓冲区（顶点、索引、uniform），交给延迟销毁队列，等已提交的帧执行完再释放
 	LVEBuffer::~LVEBuffer() {
 		unmap();
-		vkDestroyBuffer(lveDevice.device(), buffer, nullptr);
-		vkFreeMemory(lveDevice.device(), memory, nullptr);
+		VkDevice device = lveDevice.device();
+		VkBuffer retiredBuffer = buffer;
+		VkDeviceMemory retiredMemory = memory;
+		lveDevice.retire([device, retiredBuffer, retiredMemory]() {
+			vkDestroyBuffer(device, retiredBuffer, nullptr);
+			vkFreeMemory(device, retiredMemory, nullptr);
+		});
 	}
 
-	//ڴӳ䵽 CPU ɷʵĵַ
+	//将缓冲区的内存映射到 CPU 可访问的地址。
 	VkResult LVEBuffer::map(VkDeviceSize size, VkDeviceSize offset) {
 		assert(buffer && memory && "Called map on buffer before create");
 		//if (size == VK_WHOLE_SIZE) {
@@ -62,7 +68,7 @@ namespace lve {
 		return vkMapMemory(lveDevice.device(), memory, offset, size, 0, &mapped);
 	}
 
-	// ӳ䡣
+	// 解除映射。
 	void LVEBuffer::unmap() {
 		if (mapped) {
 			vkUnmapMemory(lveDevice.device(), memory);
@@ -70,21 +76,23 @@ namespace lve {
 		}
 	}
 
-	// ݸƵӳĻڡ
+	// 将数据复制到已映射的缓冲区内。
 	void LVEBuffer::writeToBuffer(void* data, VkDeviceSize size, VkDeviceSize offset) {
 		assert(mapped && "Cannot copy to unmapped buffer");
 
 		if (size == VK_WHOLE_SIZE) {
 			memcpy(mapped, data, bufferSize);
+			lveDevice.recordUpload(bufferSize);
 		}
 		else {
 			char* memOffset = (char*)mapped;
 			memOffset += offset;
 			memcpy(memOffset, data, size);
+			lveDevice.recordUpload(size);
 		}
 	}
 
-	// ڽڴ淶Χͬ GPUڷһڴǱҪġ
+	// 方法用于将内存范围的内容同步到 GPU，这对于非一致性内存是必要的。
 	VkResult LVEBuffer::flush(VkDeviceSize size, VkDeviceSize offset) {
 		VkMappedMemoryRange mappedRange = {};
 		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
@@ -94,7 +102,7 @@ namespace lve {
 		return vkFlushMappedMemoryRanges(lveDevice.device(), 1, &mappedRange);
 	}
 
-	// ʹ CPU ܹ GPU ޸ĵݣҲڷһڴ档
+	// 方法使 CPU 能够看到 GPU 修改的内容，也是用于非一致性内存。
 	VkResult LVEBuffer::invalidate(VkDeviceSize size, VkDeviceSize offset) {
 		VkMappedMemoryRange mappedRange = {};
 		mappedRange.sType = VK_STRUCTURE_TYPE_MAPPED_MEMORY_RANGE;
@@ -104,7 +112,7 @@ namespace lve {
 		return vkInvalidateMappedMemoryRanges(lveDevice.device(), 1, &mappedRange);
 	}
 
-	// Ϣ
+	// 创建描述符缓冲区信息
 	VkDescriptorBufferInfo LVEBuffer::descriptorInfo(VkDeviceSize size, VkDeviceSize offset) {
 		return VkDescriptorBufferInfo{
 			buffer,
@@ -114,10 +122,10 @@ namespace lve {
 	}
 
 	/**
-	 * instanceSizeֽݸƵƫӳ仺 *alignmentSize
+	 * 将“instanceSize”字节数据复制到索引偏移量处的映射缓冲区 *alignmentSize
 	 *
-	 * @param data ָҪƵݵָ
-	 * @param index ƫ
+	 * @param data 指向要复制的数据的指针
+	 * @param index 用于偏移量计算
 	 *
 	 */
 	void LVEBuffer::writeToIndex(void* data, int index) {
@@ -125,32 +133,32 @@ namespace lve {
 	}
 
 	/**
-	 * ˢڴ淶Χ * alignmentSizeʹ豸ɼ
+	 * 刷新索引处的内存范围 * 缓冲区的alignmentSize，使其对设备可见
 	 *
-	 * @param index ƫ
+	 * @param index 用于偏移量计算
 	 *
 	 */
 	VkResult LVEBuffer::flushIndex(int index) { return flush(alignmentSize, index * alignmentSize); }
 
 	/**
-	 * Ϣ
+	 * 创建缓冲区信息描述符
 	 *
-	 * @param index ָ *alignmentSize
+	 * @param index 指定索引给定的区域 *alignmentSize
 	 *
-	 * @return VkDescriptorBufferInfo 
+	 * @return VkDescriptorBufferInfo 例如在索引处
 	 */
 	VkDescriptorBufferInfo LVEBuffer::descriptorInfoForIndex(int index) {
 		return descriptorInfo(alignmentSize, index * alignmentSize);
 	}
 
 	/**
-	 * ʹڴ淶ΧЧʹɼ
+	 * 使缓冲区的内存范围无效以使其对主机可见
 	 *
-	 * @note ڷһڴ
+	 * @note 仅适用于非一致性内存
 	 *
-	 * @paramindex ָҪʧЧindex *alignmentSize
+	 * @paramindex 指定要失效的区域：index *alignmentSize
 	 *
-	 * @return ЧõVkResult
+	 * @return 无效调用的VkResult
 	 */
 	VkResult LVEBuffer::invalidateIndex(int index) {
 		return invalidate(alignmentSize, index * alignmentSize);
@@ -3,7 +3,7 @@
 #include "lve_device.h"
 
 namespace lve {
-	//Ĵӳ䡢д롢ˢºЧȹ
+	//缓冲区的创建、映射、写入、刷新和无效化等功能
 	class LVEBuffer {
 	public:
 		LVEBuffer(
@@ -0,0 +1,597 @@
+#include "lve_bvh.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <limits>
+
+namespace lve {
+
+	LVEBvh::LVEBvh(LVEJobSystem* jobSystem) : jobSystem{ jobSystem } {}
+
+	LVEBvh::~LVEBvh() {
+		//后台任务引用的是快照，不访问这个对象，但仍要等它结束再析构 future
+		if (pendingRebuild.valid()) {
+			pendingRebuild.wait();
+		}
+	}
+
+	LVEAabb LVEBvh::fatten(const LVEAabb& bounds) {
+		glm::vec3 margin = (bounds.max - bounds.min) * FAT_MARGIN_SCALE + glm::vec3{ FAT_MARGIN_MIN };
+		return bounds.inflated(margin);
+	}
+
+	// ---------------------------------------------------------------------------
+	// 代理
+	// ---------------------------------------------------------------------------
+
+	uint32_t LVEBvh::insert(const LVEAabb& bounds, uint32_t userData) {
+		uint32_t proxy;
+		if (!freeProxies.empty()) {
+			proxy = freeProxies.back();
+			freeProxies.pop_back();
+		}
+		else {
+			proxy = static_cast<uint32_t>(proxies.size());
+			proxies.emplace_back();
+		}
+		Proxy& entry = proxies[proxy];
+		entry.bounds = bounds;
+		entry.userData = userData;
+		entry.alive = true;
+		proxyCount++;
+
+		uint32_t leaf = allocateNode();
+		nodes[leaf].bounds = fatten(bounds);
+		nodes[leaf].proxy = proxy;
+		entry.node = leaf;
+		insertLeaf(leaf);
+
+		modificationsSinceBuild++;
+		markChanged(proxy);
+		return proxy;
+	}
+
+	void LVEBvh::remove(uint32_t proxy) {
+		assert(proxy < proxies.size() && proxies[proxy].alive && "removing a dead bvh proxy");
+		Proxy& entry = proxies[proxy];
+		removeLeaf(entry.node);
+		freeNode(entry.node);
+		entry.node = INVALID_NODE;
+		entry.alive = false;
+		freeProxies.push_back(proxy);
+		proxyCount--;
+
+		modificationsSinceBuild++;
+		markChanged(proxy);
+	}
+
+	bool LVEBvh::update(uint32_t proxy, const LVEAabb& bounds) {
+		assert(proxy < proxies.size() && proxies[proxy].alive && "updating a dead bvh proxy");
+		Proxy& entry = proxies[proxy];
+		entry.bounds = bounds;
+		markChanged(proxy);
+
+		Node& leaf = nodes[entry.node];
+		if (leaf.bounds.contains(bounds)) {
+			return false;
+		}
+		leaf.bounds = fatten(bounds);
+		refit(leaf.parent);
+		modificationsSinceBuild++;
+		return true;
+	}
+
+	void LVEBvh::markChanged(uint32_t proxy) {
+		if (!pendingRebuild.valid()) {
+			return;
+		}
+		if (changedFlags.size() <= proxy) {
+			changedFlags.resize(proxies.size(), 0);
+		}
+		if (!changedFlags[proxy]) {
+			changedFlags[proxy] = 1;
+			changedProxies.push_back(proxy);
+		}
+	}
+
+	// ---------------------------------------------------------------------------
+	// 树结构
+	// ---------------------------------------------------------------------------
+
+	uint32_t LVEBvh::allocateNode() {
+		if (!freeNodes.empty()) {
+			uint32_t node = freeNodes.back();
+			freeNodes.pop_back();
+			nodes[node] = Node{};
+			return node;
+		}
+		nodes.emplace_back();
+		return static_cast<uint32_t>(nodes.size() - 1);
+	}
+
+	void LVEBvh::freeNode(uint32_t node) {
+		nodes[node].height = -1;
+		freeNodes.push_back(node);
+	}
+
+	//沿着代价最小的方向下降找兄弟节点（Box2D 的分支限界启发式），代价是新增父节点的表面积加上祖先因此增加的表面积
+	void LVEBvh::insertLeaf(uint32_t leaf) {
+		if (root == INVALID_NODE) {
+			root = leaf;
+			nodes[leaf].parent = INVALID_NODE;
+			return;
+		}
+
+		LVEAabb leafBounds = nodes[leaf].bounds;
+		uint32_t index = root;
+		while (!nodes[index].isLeaf()) {
+			const Node& node = nodes[index];
+			float area = node.bounds.surfaceArea();
+			float combinedArea = LVEAabb::merged(node.bounds, leafBounds).surfaceArea();
+			float cost = 2.f * combinedArea;
+			float inheritanceCost = 2.f * (combinedArea - area);
+
+			auto childCost = [&](uint32_t child) {
+				const Node& childNode = nodes[child];
+				float mergedArea = LVEAabb::merged(childNode.bounds, leafBounds).surfaceArea();
+				if (childNode.isLeaf()) {
+					return mergedArea + inheritanceCost;
+				}
+				return mergedArea - childNode.bounds.surfaceArea() + inheritanceCost;
+			};
+			float leftCost = childCost(node.left);
+			float rightCost = childCost(node.right);
+			if (cost < leftCost && cost < rightCost) {
+				break;
+			}
+			index = leftCost < rightCost ? node.left : node.right;
+		}
+
+		uint32_t sibling = index;
+		uint32_t oldParent = nodes[sibling].parent;
+		uint32_t newParent = allocateNode();
+		nodes[newParent].parent = oldParent;
+		nodes[newParent].left = sibling;
+		nodes[newParent].right = leaf;
+		nodes[newParent].bounds = LVEAabb::merged(nodes[sibling].bounds, leafBounds);
+		nodes[newParent].height = nodes[sibling].height + 1;
+		nodes[sibling].parent = newParent;
+		nodes[leaf].parent = newParent;
+
+		if (oldParent == INVALID_NODE) {
+			root = newParent;
+		}
+		else {
+			if (nodes[oldParent].left == sibling) {
+				nodes[oldParent].left = newParent;
+			}
+			else {
+				nodes[oldParent].right = newParent;
+			}
+			refit(oldParent);
+		}
+	}
+
+	void LVEBvh::removeLeaf(uint32_t leaf) {
+		if (leaf == root) {
+			root = INVALID_NODE;
+			return;
+		}
+
+		uint32_t parent = nodes[leaf].parent;
+		uint32_t grandParent = nodes[parent].parent;
+		uint32_t sibling = nodes[parent].left == leaf ? nodes[parent].right : nodes[parent].left;
+
+		if (grandParent == INVALID_NODE) {
+			root = sibling;
+			nodes[sibling].parent = INVALID_NODE;
+		}
+		else {
+			if (nodes[grandParent].left == parent) {
+				nodes[grandParent].left = sibling;
+			}
+			else {
+				nodes[grandParent].right = sibling;
+			}
+			nodes[sibling].parent = grandParent;
+			refit(grandParent);
+		}
+		freeNode(parent);
+	}
+
+	//从 node 向上重算包围盒和高度，某个祖先完全没有变化时提前结束
+	void LVEBvh::refit(uint32_t node) {
+		while (node != INVALID_NODE) {
+			Node& current = nodes[node];
+			LVEAabb bounds = LVEAabb::merged(nodes[current.left].bounds, nodes[current.right].bounds);
+			int32_t height = 1 + std::max(nodes[current.left].height, nodes[current.right].height);
+			if (bounds.min == current.bounds.min && bounds.max == current.bounds.max && height == current.height) {
+				break;
+			}
+			current.bounds = bounds;
+			current.height = height;
+			node = current.parent;
+		}
+	}
+
+	// ---------------------------------------------------------------------------
+	// SAH 重建
+	// ---------------------------------------------------------------------------
+
+	//改动超过上次重建时叶子数的四分之一，或者树高明显超过平衡树时重建
+	bool LVEBvh::needsRebuild() const {
+		if (proxyCount < 2) {
+			return false;
+		}
+		uint32_t modificationBudget = std::max(proxiesAtLastBuild / 4, 64u);
+		if (modificationsSinceBuild > modificationBudget) {
+			return true;
+		}
+		float balancedHeight = std::ceil(std::log2(static_cast<float>(proxyCount)));
+		return static_cast<float>(getHeight()) > 3.f * balancedHeight + 4.f;
+	}
+
+	std::vector<LVEBvh::BuildItem> LVEBvh::snapshot() {
+		std::vector<BuildItem> items;
+		items.reserve(proxyCount);
+		inSnapshot.assign(proxies.size(), 0);
+		for (uint32_t proxy = 0; proxy < proxies.size(); proxy++) {
+			if (!proxies[proxy].alive) {
+				continue;
+			}
+			const LVEAabb& fatBounds = nodes[proxies[proxy].node].bounds;
+			items.push_back({ fatBounds, fatBounds.center(), proxy });
+			inSnapshot[proxy] = 1;
+		}
+		changedFlags.assign(proxies.size(), 0);
+		changedProxies.clear();
+		proxiesAtLastBuild = proxyCount;
+		modificationsSinceBuild = 0;
+		return items;
+	}
+
+	void LVEBvh::maintain() {
+		LVE_PROFILE_FUNCTION();
+		if (pendingRebuild.valid()) {
+			if (pendingRebuild.wait_for(std::chrono::seconds{ 0 }) != std::future_status::ready) {
+				return;
+			}
+			applyRebuild(pendingRebuild.get());
+			return;
+		}
+		if (!needsRebuild()) {
+			return;
+		}
+		if (jobSystem == nullptr) {
+			rebuild();
+			return;
+		}
+		uint32_t proxySlots = static_cast<uint32_t>(proxies.size());
+		pendingRebuild = jobSystem->submit(
+			[items = snapshot(), proxySlots]() mutable { return build(std::move(items), proxySlots); });
+	}
+
+	void LVEBvh::rebuild() {
+		LVE_PROFILE_FUNCTION();
+		if (pendingRebuild.valid()) {
+			pendingRebuild.wait();
+			applyRebuild(pendingRebuild.get());
+		}
+		uint32_t proxySlots = static_cast<uint32_t>(proxies.size());
+		//同步重建没有并发修改，直接换入即可
+		BuildResult result = build(snapshot(), proxySlots);
+		inSnapshot.clear();
+		nodes = std::move(result.nodes);
+		freeNodes.clear();
+		root = result.root;
+		for (uint32_t proxy = 0; proxy < proxySlots; proxy++) {
+			proxies[proxy].node = result.proxyNodes[proxy];
+		}
+	}
+
+	//换入后台建好的树，再把快照之后的插入、删除和移动重新应用到新树上
+	void LVEBvh::applyRebuild(BuildResult result) {
+		LVE_PROFILE_FUNCTION();
+		nodes = std::move(result.nodes);
+		freeNodes.clear();
+		root = result.root;
+		for (uint32_t proxy = 0; proxy < proxies.size(); proxy++) {
+			proxies[proxy].node = proxy < result.proxyNodes.size() ? result.proxyNodes[proxy] : INVALID_NODE;
+		}
+
+		for (uint32_t proxy : changedProxies) {
+			Proxy& entry = proxies[proxy];
+			bool hasLeaf = proxy < inSnapshot.size() && inSnapshot[proxy];
+			if (entry.alive && hasLeaf) {
+				//同一个下标可能被删除后又重新分配，直接用当前的包围盒覆盖
+				Node& leaf = nodes[entry.node];
+				if (!leaf.bounds.contains(entry.bounds)) {
+					leaf.bounds = fatten(entry.bounds);
+					refit(leaf.parent);
+				}
+			}
+			else if (entry.alive) {
+				uint32_t leaf = allocateNode();
+				nodes[leaf].bounds = fatten(entry.bounds);
+				nodes[leaf].proxy = proxy;
+				entry.node = leaf;
+				insertLeaf(leaf);
+			}
+			else if (hasLeaf) {
+				removeLeaf(entry.node);
+				freeNode(entry.node);
+				entry.node = INVALID_NODE;
+			}
+		}
+		//这些改动发生在快照之后，算进下一次重建的预算
+		modificationsSinceBuild = static_cast<uint32_t>(changedProxies.size());
+		changedProxies.clear();
+		changedFlags.clear();
+		inSnapshot.clear();
+	}
+
+	LVEBvh::BuildResult LVEBvh::build(std::vector<BuildItem> items, uint32_t proxySlots) {
+		LVE_PROFILE_SCOPE("LVEBvh::build");
+		BuildResult result{};
+		result.proxyNodes.assign(proxySlots, INVALID_NODE);
+		if (items.empty()) {
+			return result;
+		}
+		result.nodes.reserve(items.size() * 2 - 1);
+		result.root = buildRecursive(result, items, 0, static_cast<uint32_t>(items.size()), INVALID_NODE);
+		return result;
+	}
+
+	//自顶向下按分桶 SAH 划分，每个叶子只有一个代理；所有质心都落在同一个桶里时退化为中位数划分
+	uint32_t LVEBvh::buildRecursive(
+		BuildResult& result, std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t parent)
+	{
+		uint32_t nodeIndex = static_cast<uint32_t>(result.nodes.size());
+		result.nodes.emplace_back();
+		result.nodes[nodeIndex].parent = parent;
+
+		if (end - begin == 1) {
+			Node& leaf = result.nodes[nodeIndex];
+			leaf.bounds = items[begin].bounds;
+			leaf.proxy = items[begin].proxy;
+			leaf.height = 0;
+			result.proxyNodes[items[begin].proxy] = nodeIndex;
+			return nodeIndex;
+		}
+
+		LVEAabb centroidBounds{};
+		for (uint32_t i = begin; i < end; i++) {
+			centroidBounds.expand(items[i].centroid);
+		}
+		glm::vec3 centroidSize = centroidBounds.max - centroidBounds.min;
+		int axis = 0;
+		if (centroidSize.y > centroidSize[axis]) axis = 1;
+		if (centroidSize.z > centroidSize[axis]) axis = 2;
+
+		uint32_t mid = begin + (end - begin) / 2;
+		float axisMin = centroidBounds.min[axis];
+		float axisSize = centroidSize[axis];
+		if (axisSize > 0.f) {
+			struct Bin {
+				LVEAabb bounds;
+				uint32_t count = 0;
+			};
+			std::array<Bin, SAH_BINS> bins{};
+			auto binOf = [&](const BuildItem& item) {
+				uint32_t bin = static_cast<uint32_t>((item.centroid[axis] - axisMin) / axisSize * SAH_BINS);
+				return std::min(bin, SAH_BINS - 1);
+			};
+			for (uint32_t i = begin; i < end; i++) {
+				Bin& bin = bins[binOf(items[i])];
+				bin.bounds.merge(items[i].bounds);
+				bin.count++;
+			}
+
+			//从右往左累计，得到每个划分位置右侧的面积和数量
+			std::array<float, SAH_BINS> rightArea{};
+			std::array<uint32_t, SAH_BINS> rightCount{};
+			LVEAabb accumulated{};
+			uint32_t accumulatedCount = 0;
+			for (uint32_t i = SAH_BINS - 1; i > 0; i--) {
+				accumulated.merge(bins[i].bounds);
+				accumulatedCount += bins[i].count;
+				rightArea[i] = accumulatedCount > 0 ? accumulated.surfaceArea() : 0.f;
+				rightCount[i] = accumulatedCount;
+			}
+
+			float bestCost = std::numeric_limits<float>::max();
+			uint32_t bestSplit = 0;
+			accumulated = LVEAabb{};
+			accumulatedCount = 0;
+			for (uint32_t split = 1; split < SAH_BINS; split++) {
+				accumulated.merge(bins[split - 1].bounds);
+				accumulatedCount += bins[split - 1].count;
+				if (accumulatedCount == 0 || rightCount[split] == 0) {
+					continue;
+				}
+				float cost = accumulated.surfaceArea() * accumulatedCount + rightArea[split] * rightCount[split];
+				if (cost < bestCost) {
+					bestCost = cost;
+					bestSplit = split;
+				}
+			}
+
+			if (bestSplit != 0) {
+				auto middle = std::partition(
+					items.begin() + begin, items.begin() + end,
+					[&](const BuildItem& item) { return binOf(item) < bestSplit; });
+				mid = static_cast<uint32_t>(middle - items.begin());
+			}
+			else {
+				std::nth_element(
+					items.begin() + begin, items.begin() + mid, items.begin() + end,
+					[axis](const BuildItem& a, const BuildItem& b) { return a.centroid[axis] < b.centroid[axis]; });
+			}
+		}
+
+		//递归过程中 nodes 会扩容，不能持有引用
+		uint32_t left = buildRecursive(result, items, begin, mid, nodeIndex);
+		uint32_t right = buildRecursive(result, items, mid, end, nodeIndex);
+		Node& node = result.nodes[nodeIndex];
+		node.left = left;
+		node.right = right;
+		node.bounds = LVEAabb::merged(result.nodes[left].bounds, result.nodes[right].bounds);
+		node.height = 1 + std::max(result.nodes[left].height, result.nodes[right].height);
+		return nodeIndex;
+	}
+
+	// ---------------------------------------------------------------------------
+	// 查询
+	// ---------------------------------------------------------------------------
+
+	void LVEBvh::collectLeaves(uint32_t node, std::vector<uint32_t>& out) const {
+		std::vector<uint32_t> stack{ node };
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& current = nodes[index];
+			if (current.isLeaf()) {
+				out.push_back(proxies[current.proxy].userData);
+			}
+			else {
+				stack.push_back(current.left);
+				stack.push_back(current.right);
+			}
+		}
+	}
+
+	//完全在视锥内的子树不再逐个测试，直接收集所有叶子
+	void LVEBvh::queryFrustum(const LVEFrustum& frustum, std::vector<uint32_t>& out) const {
+		LVE_PROFILE_FUNCTION();
+		if (root == INVALID_NODE) {
+			return;
+		}
+		std::vector<uint32_t> stack;
+		stack.reserve(64);
+		stack.push_back(root);
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = nodes[index];
+			if (node.isLeaf()) {
+				if (frustum.intersects(proxies[node.proxy].bounds)) {
+					out.push_back(proxies[node.proxy].userData);
+				}
+				continue;
+			}
+			LVEFrustum::Containment containment = frustum.classify(node.bounds);
+			if (containment == LVEFrustum::Containment::Outside) {
+				continue;
+			}
+			if (containment == LVEFrustum::Containment::Inside) {
+				collectLeaves(index, out);
+				continue;
+			}
+			stack.push_back(node.left);
+			stack.push_back(node.right);
+		}
+	}
+
+	void LVEBvh::queryAabb(const LVEAabb& bounds, std::vector<uint32_t>& out) const {
+		if (root == INVALID_NODE) {
+			return;
+		}
+		std::vector<uint32_t> stack{ root };
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = nodes[index];
+			if (node.isLeaf()) {
+				if (proxies[node.proxy].bounds.overlaps(bounds)) {
+					out.push_back(proxies[node.proxy].userData);
+				}
+			}
+			else if (node.bounds.overlaps(bounds)) {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	void LVEBvh::queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const {
+		if (root == INVALID_NODE) {
+			return;
+		}
+		std::vector<uint32_t> stack{ root };
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = nodes[index];
+			if (node.isLeaf()) {
+				if (intersectSphereAabb(center, radius, proxies[node.proxy].bounds)) {
+					out.push_back(proxies[node.proxy].userData);
+				}
+			}
+			else if (intersectSphereAabb(center, radius, node.bounds)) {
+				stack.push_back(node.left);
+				stack.push_back(node.right);
+			}
+		}
+	}
+
+	//先访问更近的子节点，已经找到的命中距离用来裁掉更远的子树
+	bool LVEBvh::raycast(
+		const glm::vec3& origin, const glm::vec3& direction, float maxDistance, LVEBvhRayHit& hit) const
+	{
+		if (root == INVALID_NODE) {
+			return false;
+		}
+		glm::vec3 invDirection = 1.f / direction;
+		float closest = maxDistance;
+		bool found = false;
+
+		float rootDistance;
+		if (!intersectRayAabb(origin, invDirection, nodes[root].bounds, closest, rootDistance)) {
+			return false;
+		}
+		std::vector<uint32_t> stack{ root };
+		while (!stack.empty()) {
+			uint32_t index = stack.back();
+			stack.pop_back();
+			const Node& node = nodes[index];
+			if (node.isLeaf()) {
+				float distance;
+				if (intersectRayAabb(origin, invDirection, proxies[node.proxy].bounds, closest, distance)) {
+					closest = distance;
+					hit.userData = proxies[node.proxy].userData;
+					hit.distance = distance;
+					found = true;
+				}
+				continue;
+			}
+			float leftDistance, rightDistance;
+			bool hitLeft = intersectRayAabb(origin, invDirection, nodes[node.left].bounds, closest, leftDistance);
+			bool hitRight = intersectRayAabb(origin, invDirection, nodes[node.right].bounds, closest, rightDistance);
+			if (hitLeft && hitRight) {
+				//栈是后进先出，近的后压入
+				if (leftDistance < rightDistance) {
+					stack.push_back(node.right);
+					stack.push_back(node.left);
+				}
+				else {
+					stack.push_back(node.left);
+					stack.push_back(node.right);
+				}
+			}
+			else if (hitLeft) {
+				stack.push_back(node.left);
+			}
+			else if (hitRight) {
+				stack.push_back(node.right);
+			}
+		}
+		return found;
+	}
+
+}  // namespace lve
@@ -0,0 +1,135 @@
+#pragma once
+
+#include "lve_bounds.h"
+#include "lve_job_system.h"
+
+// std
+#include <cstdint>
+#include <future>
+#include <vector>
+
+namespace lve {
+
+	struct LVEBvhRayHit {
+		uint32_t userData = ~0u;
+		float distance = 0.f;
+	};
+
+	//动态包围体层次结构（BVH），每个叶子对应一个代理（proxy），代理句柄在整棵树的生命周期内保持不变。
+	//叶子存放稍微放大的“胖”包围盒，物体小幅移动时 update() 不改动树；移出胖包围盒时只重算叶子到根路径上的包围盒（refit）。
+	//refit 和增量插入会让树的质量逐渐变差，maintain() 发现结构改动过多时在后台按 SAH 整体重建，完成后再替换回来。
+	//查询时内部节点用胖包围盒，叶子用物体精确的包围盒测试。
+	class LVEBvh {
+	public:
+		static constexpr uint32_t INVALID_PROXY = ~0u;
+
+		//jobSystem 为空时重建在调用 maintain() 的线程上同步完成
+		explicit LVEBvh(LVEJobSystem* jobSystem = nullptr);
+		~LVEBvh();
+
+		LVEBvh(const LVEBvh&) = delete;
+		LVEBvh& operator=(const LVEBvh&) = delete;
+
+		uint32_t insert(const LVEAabb& bounds, uint32_t userData);
+		void remove(uint32_t proxy);
+		//bounds 仍在叶子的胖包围盒内时什么都不做，返回是否改动了树
+		bool update(uint32_t proxy, const LVEAabb& bounds);
+
+		//每帧调用一次：换入已完成的后台重建，树的质量下降时开始新的重建
+		void maintain();
+		//立即同步重建（加载场景之后调用可以避免第一帧使用逐个插入得到的树）
+		void rebuild();
+
+		//结果按 userData 追加到 out 末尾
+		void queryFrustum(const LVEFrustum& frustum, std::vector<uint32_t>& out) const;
+		void queryAabb(const LVEAabb& bounds, std::vector<uint32_t>& out) const;
+		void queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& out) const;
+		//返回包围盒最近的命中，direction 不需要归一化，距离以 direction 的长度为单位
+		bool raycast(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, LVEBvhRayHit& hit) const;
+
+		const LVEAabb& getBounds(uint32_t proxy) const { return proxies[proxy].bounds; }
+		uint32_t getUserData(uint32_t proxy) const { return proxies[proxy].userData; }
+		uint32_t getProxyCount() const { return proxyCount; }
+		uint32_t getNodeCount() const { return static_cast<uint32_t>(nodes.size() - freeNodes.size()); }
+		//根节点的高度，叶子为 0
+		int32_t getHeight() const { return root == INVALID_NODE ? 0 : nodes[root].height; }
+		bool isRebuildPending() const { return pendingRebuild.valid(); }
+
+	private:
+		static constexpr uint32_t INVALID_NODE = ~0u;
+		//胖包围盒按包围盒尺寸的比例放大，再加一个固定值，避免扁平物体的包围盒没有余量
+		static constexpr float FAT_MARGIN_SCALE = 0.1f;
+		static constexpr float FAT_MARGIN_MIN = 0.05f;
+		//SAH 分桶数量
+		static constexpr uint32_t SAH_BINS = 12;
+
+		struct Node {
+			LVEAabb bounds;
+			uint32_t parent = INVALID_NODE;
+			uint32_t left = INVALID_NODE;
+			uint32_t right = INVALID_NODE;
+			uint32_t proxy = INVALID_PROXY;
+			int32_t height = 0;
+
+			bool isLeaf() const { return left == INVALID_NODE; }
+		};
+
+		struct Proxy {
+			LVEAabb bounds;
+			uint32_t node = INVALID_NODE;
+			uint32_t userData = 0;
+			bool alive = false;
+		};
+
+		struct BuildItem {
+			LVEAabb bounds;
+			glm::vec3 centroid;
+			uint32_t proxy;
+		};
+
+		struct BuildResult {
+			std::vector<Node> nodes;
+			uint32_t root = INVALID_NODE;
+			//按代理下标索引，快照里没有的代理为 INVALID_NODE
+			std::vector<uint32_t> proxyNodes;
+		};
+
+		static LVEAabb fatten(const LVEAabb& bounds);
+		static BuildResult build(std::vector<BuildItem> items, uint32_t proxySlots);
+		static uint32_t buildRecursive(
+			BuildResult& result, std::vector<BuildItem>& items, uint32_t begin, uint32_t end, uint32_t parent);
+
+		uint32_t allocateNode();
+		void freeNode(uint32_t node);
+		void insertLeaf(uint32_t leaf);
+		void removeLeaf(uint32_t leaf);
+		void refit(uint32_t node);
+		void collectLeaves(uint32_t node, std::vector<uint32_t>& out) const;
+
+		bool needsRebuild() const;
+		std::vector<BuildItem> snapshot();
+		void applyRebuild(BuildResult result);
+		void markChanged(uint32_t proxy);
+
+		LVEJobSystem* jobSystem;
+
+		std::vector<Node> nodes;
+		std::vector<uint32_t> freeNodes;
+		uint32_t root = INVALID_NODE;
+
+		std::vector<Proxy> proxies;
+		std::vector<uint32_t> freeProxies;
+		uint32_t proxyCount = 0;
+
+		//上次重建以来的结构改动（插入、删除、refit）次数，决定何时重建
+		uint32_t modificationsSinceBuild = 0;
+		uint32_t proxiesAtLastBuild = 0;
+
+		//后台重建期间，记录哪些代理在快照之后被改动，换入新树时重新应用
+		std::future<BuildResult> pendingRebuild;
+		std::vector<uint8_t> inSnapshot;
+		std::vector<uint8_t> changedFlags;
+		std::vector<uint32_t> changedProxies;
+	};
+
+}  // namespace lve
@@ -0,0 +1,125 @@
+#include "lve_camera_path.h"
+
+// libs
+#include <glm/gtc/constants.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+namespace lve {
+
+	static glm::vec3 catmullRom(const glm::vec3& p0, const glm::vec3& p1, const glm::vec3& p2, const glm::vec3& p3, float t) {
+		float t2 = t * t;
+		float t3 = t2 * t;
+		return 0.5f * ((2.f * p1)
+			+ (-p0 + p2) * t
+			+ (2.f * p0 - 5.f * p1 + 4.f * p2 - p3) * t2
+			+ (-p0 + 3.f * p1 - 3.f * p2 + p3) * t3);
+	}
+
+	//偏航角按最短方向插值，避免在 0 和 2π 之间绕一大圈
+	static float lerpAngle(float a, float b, float t) {
+		float delta = std::remainder(b - a, glm::two_pi<float>());
+		return a + delta * t;
+	}
+
+	LVECameraPath LVECameraPath::loadFromFile(const std::string& filePath) {
+		std::ifstream file{ filePath };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open camera path: " + filePath);
+		}
+
+		LVECameraPath path{};
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.empty() || line[0] == '#') {
+				continue;
+			}
+			std::istringstream stream{ line };
+			CameraKeyframe keyframe{};
+			stream >> keyframe.time
+				>> keyframe.position.x >> keyframe.position.y >> keyframe.position.z
+				>> keyframe.rotation.x >> keyframe.rotation.y >> keyframe.rotation.z;
+			if (stream.fail()) {
+				throw std::runtime_error("invalid camera path keyframe: " + line);
+			}
+			path.addKeyframe(keyframe);
+		}
+		if (path.keyframes.empty()) {
+			throw std::runtime_error("camera path has no keyframes: " + filePath);
+		}
+		return path;
+	}
+
+	LVECameraPath LVECameraPath::createOrbit(
+		glm::vec3 center, float radius, float height, float duration, uint32_t keyframeCount)
+	{
+		LVECameraPath path{};
+		keyframeCount = std::max(keyframeCount, 2u);
+		for (uint32_t i = 0; i <= keyframeCount; i++) {
+			float t = static_cast<float>(i) / static_cast<float>(keyframeCount);
+			float angle = t * glm::two_pi<float>();
+
+			CameraKeyframe keyframe{};
+			keyframe.time = t * duration;
+			keyframe.position = center + glm::vec3{ -std::sin(angle) * radius, height, -std::cos(angle) * radius };
+			//相机前方是 (sin(yaw), 0, cos(yaw))，朝向中心
+			glm::vec3 toCenter = center - keyframe.position;
+			keyframe.rotation.y = std::atan2(toCenter.x, toCenter.z);
+			keyframe.rotation.x = std::atan2(-toCenter.y, glm::length(glm::vec2{ toCenter.x, toCenter.z }));
+			path.addKeyframe(keyframe);
+		}
+		path.setLooping(true);
+		return path;
+	}
+
+	void LVECameraPath::addKeyframe(const CameraKeyframe& keyframe) {
+		if (!keyframes.empty() && keyframe.time <= keyframes.back().time) {
+			throw std::runtime_error("camera path keyframes must have increasing time!");
+		}
+		keyframes.push_back(keyframe);
+	}
+
+	CameraKeyframe LVECameraPath::sample(float time) const {
+		if (keyframes.empty()) {
+			return CameraKeyframe{};
+		}
+		if (keyframes.size() == 1) {
+			return keyframes.front();
+		}
+
+		float duration = getDuration();
+		if (looping && duration > 0.f) {
+			time = std::fmod(time, duration);
+			if (time < 0.f) {
+				time += duration;
+			}
+		}
+		time = std::clamp(time, keyframes.front().time, duration);
+
+		//找到 time 所在的区间 [i, i + 1]
+		auto upper = std::upper_bound(keyframes.begin(), keyframes.end(), time,
+			[](float t, const CameraKeyframe& keyframe) { return t < keyframe.time; });
+		size_t i1 = std::min(static_cast<size_t>(upper - keyframes.begin()), keyframes.size() - 1);
+		size_t i0 = i1 - 1;
+		size_t iPrev = i0 > 0 ? i0 - 1 : i0;
+		size_t iNext = i1 + 1 < keyframes.size() ? i1 + 1 : i1;
+
+		const CameraKeyframe& k0 = keyframes[i0];
+		const CameraKeyframe& k1 = keyframes[i1];
+		float t = (time - k0.time) / (k1.time - k0.time);
+
+		CameraKeyframe result{};
+		result.time = time;
+		result.position = catmullRom(keyframes[iPrev].position, k0.position, k1.position, keyframes[iNext].position, t);
+		result.rotation.x = glm::mix(k0.rotation.x, k1.rotation.x, t);
+		result.rotation.y = lerpAngle(k0.rotation.y, k1.rotation.y, t);
+		result.rotation.z = glm::mix(k0.rotation.z, k1.rotation.z, t);
+		return result;
+	}
+
+}  // namespace lve
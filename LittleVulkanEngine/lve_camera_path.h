@@ -0,0 +1,43 @@
+#pragma once
+
+// libs
+#include <glm/glm.hpp>
+
+// std
+#include <string>
+#include <vector>
+
+namespace lve {
+
+	//相机飞行路径的关键帧，rotation 与 TransformComponent::rotation 相同（弧度，Y-X-Z 顺序）
+	struct CameraKeyframe {
+		float time = 0.f;
+		glm::vec3 position{ 0.f };
+		glm::vec3 rotation{ 0.f };
+	};
+
+	//脚本化的相机路径：位置用 Catmull-Rom 样条插值，角度线性插值（偏航角走最短方向）
+	class LVECameraPath {
+	public:
+		LVECameraPath() = default;
+
+		//文本格式，每行一个关键帧：time px py pz rx ry rz，# 开头的行是注释，time 必须递增
+		static LVECameraPath loadFromFile(const std::string& filePath);
+		//绕 center 转一圈，相机始终看向中心，用于没有路径文件时的默认基准测试
+		static LVECameraPath createOrbit(glm::vec3 center, float radius, float height, float duration, uint32_t keyframeCount = 16);
+
+		void addKeyframe(const CameraKeyframe& keyframe);
+		void setLooping(bool looping) { this->looping = looping; }
+		bool isLooping() const { return looping; }
+
+		float getDuration() const { return keyframes.empty() ? 0.f : keyframes.back().time; }
+		bool isFinished(float time) const { return !looping && time >= getDuration(); }
+		//返回 time 时刻的位置和角度，超出范围时循环或停在最后一帧
+		CameraKeyframe sample(float time) const;
+
+	private:
+		std::vector<CameraKeyframe> keyframes;
+		bool looping = false;
+	};
+
+}  // namespace lve
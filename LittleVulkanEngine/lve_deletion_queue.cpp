@@ -0,0 +1,61 @@
+#include "lve_deletion_queue.h"
+
+// std
+#include <iterator>
+#include <vector>
+
+namespace lve {
+
+	LVEDeletionQueue::~LVEDeletionQueue() {
+		flush();
+	}
+
+	void LVEDeletionQueue::retire(uint64_t timelineValue, std::function<void()> deleter) {
+		std::lock_guard<std::mutex> lock{ queueMutex };
+		//时间线值几乎总是递增的，按值有序插入，collect 时只需要从头部弹出
+		auto it = retired.end();
+		while (it != retired.begin() && std::prev(it)->timelineValue > timelineValue) {
+			--it;
+		}
+		retired.insert(it, RetiredResource{ timelineValue, std::move(deleter) });
+	}
+
+	size_t LVEDeletionQueue::collect(uint64_t completedValue) {
+		//先在锁内取出到期的销毁函数，再在锁外执行，销毁函数里可以再次调用 retire
+		std::vector<std::function<void()>> ready;
+		{
+			std::lock_guard<std::mutex> lock{ queueMutex };
+			while (!retired.empty() && retired.front().timelineValue <= completedValue) {
+				ready.push_back(std::move(retired.front().deleter));
+				retired.pop_front();
+			}
+		}
+		for (auto& deleter : ready) {
+			deleter();
+		}
+		return ready.size();
+	}
+
+	void LVEDeletionQueue::flush() {
+		//销毁函数可能登记新的资源（比如交换链释放它持有的旧交换链），循环直到清空
+		while (true) {
+			std::deque<RetiredResource> pending;
+			{
+				std::lock_guard<std::mutex> lock{ queueMutex };
+				if (retired.empty()) {
+					return;
+				}
+				pending.swap(retired);
+			}
+			for (auto& resource : pending) {
+				resource.deleter();
+			}
+		}
+	}
+
+	size_t LVEDeletionQueue::size() {
+		std::lock_guard<std::mutex> lock{ queueMutex };
+		return retired.size();
+	}
+
+}  // namespace lve
@@ -0,0 +1,40 @@
+#pragma once
+
+// std
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+
+namespace lve {
+
+	//延迟销毁队列：资源在 GPU 仍可能使用时不能立即销毁，先连同一个时间线值登记到这里，
+	//等设备的时间线信号量到达该值（对应的帧已经执行完）后再真正调用销毁函数。
+	class LVEDeletionQueue {
+	public:
+		LVEDeletionQueue() = default;
+		~LVEDeletionQueue();
+
+		LVEDeletionQueue(const LVEDeletionQueue&) = delete;
+		LVEDeletionQueue& operator=(const LVEDeletionQueue&) = delete;
+
+		//登记一个销毁函数，时间线到达 timelineValue 后执行。线程安全。
+		void retire(uint64_t timelineValue, std::function<void()> deleter);
+		//执行所有 timelineValue <= completedValue 的销毁函数，返回执行的数量
+		size_t collect(uint64_t completedValue);
+		//不管时间线，执行全部销毁函数。只能在设备空闲后调用（例如销毁设备前）。
+		void flush();
+
+		size_t size();
+
+	private:
+		struct RetiredResource {
+			uint64_t timelineValue;
+			std::function<void()> deleter;
+		};
+
+		std::mutex queueMutex;
+		std::deque<RetiredResource> retired;
+	};
+
+}  // namespace lve
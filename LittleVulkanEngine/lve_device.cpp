@@ -1,6 +1,7 @@
 #include "lve_device.h"
 
 // std headers
+#include <cassert>
 #include <cstring>
 #include <iostream>
 #include <set>
@@ -8,23 +9,23 @@
 
 namespace lve {
 
-	// Իصڴ Vulkan ĵϢ
+	// 调试回调函数，用于处理 Vulkan 的调试信息
 	static VKAPI_ATTR VkBool32 VKAPI_CALL debugCallback(
-		VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,     // Ϣԣ羯桢󣩡
-		VkDebugUtilsMessageTypeFlagsEXT messageType,                // Ϣͣһ㡢֤ܵȣ
-		const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,  // ϢϸϢ
-		void* pUserData) {                                          // ûԶݣͨΪ nullptr
+		VkDebugUtilsMessageSeverityFlagBitsEXT messageSeverity,     // 消息的严重性（例如警告、错误）。
+		VkDebugUtilsMessageTypeFlagsEXT messageType,                // 消息的类型（一般、验证、性能等）。
+		const VkDebugUtilsMessengerCallbackDataEXT* pCallbackData,  // 包含调试消息的详细信息。
+		void* pUserData) {                                          // 用户自定义数据，通常为 nullptr。
 		std::cerr << "validation layer: " << pCallbackData->pMessage << std::endl;
 
 		return VK_FALSE;
 	}
 
-	//Ϣڲʹ Vulkan ĵϢ
+	//创建调试消息处理器，用于捕获和处理 Vulkan 的调试信息。
 	VkResult CreateDebugUtilsMessengerEXT(
-		VkInstance instance,                                    //Vulkan ʵ
-		const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,  //Ϣṹ壬Ϣá
-		const VkAllocationCallbacks* pAllocator,                //صͨΪ nullptr
-		VkDebugUtilsMessengerEXT* pDebugMessenger) {            //ĵϢ
+		VkInstance instance,                                    //Vulkan 实例。
+		const VkDebugUtilsMessengerCreateInfoEXT* pCreateInfo,  //创建信息结构体，包含调试消息的配置。
+		const VkAllocationCallbacks* pAllocator,                //分配回调（通常为 nullptr）。
+		VkDebugUtilsMessengerEXT* pDebugMessenger) {            //输出的调试消息处理器句柄。
 		auto func = (PFN_vkCreateDebugUtilsMessengerEXT)vkGetInstanceProcAddr(
 			instance,
 			"vkCreateDebugUtilsMessengerEXT");
@@ -36,7 +37,7 @@ namespace lve {
 		}
 	}
 
-	//ٵϢ
+	//销毁调试消息处理器。
 	void DestroyDebugUtilsMessengerEXT(
 		VkInstance instance,
 		VkDebugUtilsMessengerEXT debugMessenger,
@@ -50,16 +51,32 @@ namespace lve {
 	}
 
 	// class member functions
-	LVEDevice::LVEDevice(LVEWindow& window) : window{ window } {
+	LVEDevice::LVEDevice(LVEWindow& window, bool allowDynamicRendering)
+		: window{ &window }, dynamicRenderingAllowed{ allowDynamicRendering } {
 		createInstance();
 		setupDebugMessenger();
 		createSurface();
 		pickPhysicalDevice();
 		createLogicalDevice();
 		createCommandPool();
+		createTimelineSemaphore();
+	}
+
+	LVEDevice::LVEDevice(bool allowDynamicRendering) : dynamicRenderingAllowed{ allowDynamicRendering } {
+		createInstance();
+		setupDebugMessenger();
+		pickPhysicalDevice();
+		createLogicalDevice();
+		createCommandPool();
+		createTimelineSemaphore();
 	}
 
 	LVEDevice::~LVEDevice() {
+		//延迟销毁的资源都依赖 device，必须在销毁 device 之前全部释放
+		vkDeviceWaitIdle(device_);
+		deletionQueue_.flush();
+
+		vkDestroySemaphore(device_, timelineSemaphore_, nullptr);
 		vkDestroyCommandPool(device_, commandPool, nullptr);
 		vkDestroyDevice(device_, nullptr);
 
@@ -67,11 +84,59 @@ namespace lve {
 			DestroyDebugUtilsMessengerEXT(instance, debugMessenger, nullptr);
 		}
 
-		vkDestroySurfaceKHR(instance, surface_, nullptr);
+		if (surface_ != VK_NULL_HANDLE) {
+			vkDestroySurfaceKHR(instance, surface_, nullptr);
+		}
 		vkDestroyInstance(instance, nullptr);
 	}
 
-	// Vulkan ʵ
+	uint32_t LVEDevice::getTimestampValidBits() {
+		QueueFamilyIndices indices = findPhysicalQueueFamilies();
+		uint32_t queueFamilyCount = 0;
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+		vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+		return queueFamilies[indices.graphicsFamily].timestampValidBits;
+	}
+
+	void LVEDevice::retireImage(VkImage image, VkDeviceMemory memory, VkImageView view) {
+		VkDevice device = device_;
+		retire([device, image, memory, view]() {
+			if (view != VK_NULL_HANDLE) {
+				vkDestroyImageView(device, view, nullptr);
+			}
+			vkDestroyImage(device, image, nullptr);
+			vkFreeMemory(device, memory, nullptr);
+		});
+	}
+
+	uint32_t LVEDevice::addHandleDestroyedListener(std::function<void(uint64_t)> listener) {
+		std::lock_guard<std::mutex> lock{ listenerMutex };
+		uint32_t listenerId = nextListenerId++;
+		handleDestroyedListeners.emplace(listenerId, std::move(listener));
+		return listenerId;
+	}
+
+	void LVEDevice::removeHandleDestroyedListener(uint32_t listenerId) {
+		std::lock_guard<std::mutex> lock{ listenerMutex };
+		handleDestroyedListeners.erase(listenerId);
+	}
+
+	//拷贝一份再调用，监听者里可以再登记或注销
+	void LVEDevice::notifyHandleValueDestroyed(uint64_t handle) {
+		std::vector<std::function<void(uint64_t)>> listeners;
+		{
+			std::lock_guard<std::mutex> lock{ listenerMutex };
+			for (const auto& entry : handleDestroyedListeners) {
+				listeners.push_back(entry.second);
+			}
+		}
+		for (const auto& listener : listeners) {
+			listener(handle);
+		}
+	}
+
+	//创建 Vulkan 实例
 	void LVEDevice::createInstance() {
 		if (enableValidationLayers && !checkValidationLayerSupport()) {
 			throw std::runtime_error("validation layers requested, but not available!");
@@ -83,7 +148,7 @@ namespace lve {
 		appInfo.applicationVersion = VK_MAKE_VERSION(1, 0, 0);
 		appInfo.pEngineName = "No Engine";
 		appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
-		appInfo.apiVersion = VK_API_VERSION_1_0;
+		appInfo.apiVersion = VK_API_VERSION_1_2;//时间线信号量从 1.2 开始成为核心功能
 
 		VkInstanceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -113,9 +178,9 @@ namespace lve {
 		hasGflwRequiredInstanceExtensions();
 	}
 
-	//ѡ豸
+	//选择物理设备
 	void LVEDevice::pickPhysicalDevice() {
-		//ͨ vkEnumeratePhysicalDevices ȡõ豸б
+		//通过 vkEnumeratePhysicalDevices 获取可用的物理设备列表。
 		uint32_t deviceCount = 0;
 		vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
 		if (deviceCount == 0) {
@@ -125,7 +190,7 @@ namespace lve {
 		std::vector<VkPhysicalDevice> devices(deviceCount);
 		vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
 
-		//豸 isDeviceSuitable ÿ豸Ƿʺϡ
+		//遍历设备，调用 isDeviceSuitable 检查每个设备是否适合。
 		for (const auto& device : devices) {
 			if (isDeviceSuitable(device)) {
 				physicalDevice = device;
@@ -141,7 +206,7 @@ namespace lve {
 		std::cout << "physical device: " << properties.deviceName << std::endl;
 	}
 
-	//߼豸
+	//创建逻辑设备
 	void LVEDevice::createLogicalDevice() {
 		QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
 
@@ -161,15 +226,47 @@ namespace lve {
 		VkPhysicalDeviceFeatures deviceFeatures = {};
 		deviceFeatures.samplerAnisotropy = VK_TRUE;
 
+		//GPU 驱动的间接绘制用到的可选特性，不支持时对应的功能退回 CPU 路径
+		VkPhysicalDeviceFeatures supportedFeatures;
+		vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+		deviceFeatures.multiDrawIndirect = supportedFeatures.multiDrawIndirect;
+		deviceFeatures.drawIndirectFirstInstance = supportedFeatures.drawIndirectFirstInstance;
+		multiDrawIndirectEnabled = supportedFeatures.multiDrawIndirect == VK_TRUE;
+		drawIndirectFirstInstanceEnabled = supportedFeatures.drawIndirectFirstInstance == VK_TRUE;
+
+		VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+		timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+		timelineFeatures.timelineSemaphore = VK_TRUE;
+
+		auto requiredDeviceExtensions = getRequiredDeviceExtensions();
+
+		//动态渲染是可选的：扩展或特性不可用时 dynamicRenderingEnabled 为 false，渲染器退回传统渲染通道。
+		//它依赖的 VK_KHR_create_renderpass2 和 VK_KHR_depth_stencil_resolve 在 1.2 中已是核心功能
+		VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+		dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+		if (dynamicRenderingAllowed && isDeviceExtensionAvailable(physicalDevice, VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+			VkPhysicalDeviceFeatures2 features2{};
+			features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features2.pNext = &dynamicRenderingFeatures;
+			vkGetPhysicalDeviceFeatures2(physicalDevice, &features2);
+			dynamicRenderingEnabled = dynamicRenderingFeatures.dynamicRendering == VK_TRUE;
+		}
+		if (dynamicRenderingEnabled) {
+			requiredDeviceExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+			dynamicRenderingFeatures.pNext = nullptr;
+			timelineFeatures.pNext = &dynamicRenderingFeatures;
+		}
+
 		VkDeviceCreateInfo createInfo = {};
 		createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+		createInfo.pNext = &timelineFeatures;
 
 		createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
 		createInfo.pQueueCreateInfos = queueCreateInfos.data();
 
 		createInfo.pEnabledFeatures = &deviceFeatures;
-		createInfo.enabledExtensionCount = static_cast<uint32_t>(deviceExtensions.size());
-		createInfo.ppEnabledExtensionNames = deviceExtensions.data();
+		createInfo.enabledExtensionCount = static_cast<uint32_t>(requiredDeviceExtensions.size());
+		createInfo.ppEnabledExtensionNames = requiredDeviceExtensions.data();
 
 		// might not really be necessary anymore because device specific validation layers
 		// have been deprecated
@@ -187,9 +284,26 @@ namespace lve {
 
 		vkGetDeviceQueue(device_, indices.graphicsFamily, 0, &graphicsQueue_);
 		vkGetDeviceQueue(device_, indices.presentFamily, 0, &presentQueue_);
+
+		//扩展命令不在 1.2 的加载器导出表中，需要按设备获取
+		if (dynamicRenderingEnabled) {
+			vkCmdBeginRenderingKHR_ = (PFN_vkCmdBeginRenderingKHR)vkGetDeviceProcAddr(device_, "vkCmdBeginRenderingKHR");
+			vkCmdEndRenderingKHR_ = (PFN_vkCmdEndRenderingKHR)vkGetDeviceProcAddr(device_, "vkCmdEndRenderingKHR");
+			dynamicRenderingEnabled = vkCmdBeginRenderingKHR_ != nullptr && vkCmdEndRenderingKHR_ != nullptr;
+		}
+	}
+
+	void LVEDevice::cmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo) {
+		assert(dynamicRenderingEnabled && "dynamic rendering is not enabled");
+		vkCmdBeginRenderingKHR_(commandBuffer, &renderingInfo);
+	}
+
+	void LVEDevice::cmdEndRendering(VkCommandBuffer commandBuffer) {
+		assert(dynamicRenderingEnabled && "dynamic rendering is not enabled");
+		vkCmdEndRenderingKHR_(commandBuffer);
 	}
 
-	//أڹ
+	//创建命令池，用于管理命令缓冲区。
 	void LVEDevice::createCommandPool() {
 		QueueFamilyIndices queueFamilyIndices = findPhysicalQueueFamilies();
 
@@ -204,15 +318,51 @@ namespace lve {
 		}
 	}
 
-	void LVEDevice::createSurface() { window.createWindowSurface(instance, &surface_); }
+	//创建帧同步用的时间线信号量，初始值为 0，之后每次提交递增。
+	void LVEDevice::createTimelineSemaphore() {
+		VkSemaphoreTypeCreateInfo typeInfo{};
+		typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO;
+		typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE;
+		typeInfo.initialValue = 0;
+
+		VkSemaphoreCreateInfo semaphoreInfo{};
+		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+		semaphoreInfo.pNext = &typeInfo;
+
+		if (vkCreateSemaphore(device_, &semaphoreInfo, nullptr, &timelineSemaphore_) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create timeline semaphore!");
+		}
+	}
+
+	uint64_t LVEDevice::getCompletedTimelineValue() {
+		uint64_t value = 0;
+		vkGetSemaphoreCounterValue(device_, timelineSemaphore_, &value);
+		return value;
+	}
+
+	//阻塞等待时间线信号量到达 value，超时返回 VK_TIMEOUT。value 为 0 时立即返回。
+	VkResult LVEDevice::waitForTimelineValue(uint64_t value, uint64_t timeout) {
+		if (value == 0) {
+			return VK_SUCCESS;
+		}
+		VkSemaphoreWaitInfo waitInfo{};
+		waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO;
+		waitInfo.semaphoreCount = 1;
+		waitInfo.pSemaphores = &timelineSemaphore_;
+		waitInfo.pValues = &value;
+		return vkWaitSemaphores(device_, &waitInfo, timeout);
+	}
+
+	void LVEDevice::createSurface() { window->createWindowSurface(instance, &surface_); }
 
 	bool LVEDevice::isDeviceSuitable(VkPhysicalDevice device) {
 		QueueFamilyIndices indices = findQueueFamilies(device);
 
 		bool extensionsSupported = checkDeviceExtensionSupport(device);
 
-		bool swapChainAdequate = false;
-		if (extensionsSupported) {
+		//无窗口模式不需要交换链
+		bool swapChainAdequate = isHeadless();
+		if (extensionsSupported && !isHeadless()) {
 			SwapChainSupportDetails swapChainSupport = querySwapChainSupport(device);
 			swapChainAdequate = !swapChainSupport.formats.empty() && !swapChainSupport.presentModes.empty();
 		}
@@ -220,8 +370,22 @@ namespace lve {
 		VkPhysicalDeviceFeatures supportedFeatures;
 		vkGetPhysicalDeviceFeatures(device, &supportedFeatures);
 
+		//帧同步依赖时间线信号量，需要设备支持 Vulkan 1.2
+		VkPhysicalDeviceProperties deviceProperties;
+		vkGetPhysicalDeviceProperties(device, &deviceProperties);
+		bool timelineSupported = false;
+		if (deviceProperties.apiVersion >= VK_API_VERSION_1_2) {
+			VkPhysicalDeviceTimelineSemaphoreFeatures timelineFeatures{};
+			timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES;
+			VkPhysicalDeviceFeatures2 features2{};
+			features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2;
+			features2.pNext = &timelineFeatures;
+			vkGetPhysicalDeviceFeatures2(device, &features2);
+			timelineSupported = timelineFeatures.timelineSemaphore == VK_TRUE;
+		}
+
 		return indices.isComplete() && extensionsSupported && swapChainAdequate &&
-			supportedFeatures.samplerAnisotropy;
+			supportedFeatures.samplerAnisotropy && timelineSupported;
 	}
 
 	void LVEDevice::populateDebugMessengerCreateInfo(
@@ -246,16 +410,16 @@ namespace lve {
 		}
 	}
 
-	//֤֧
+	//检查验证层支持
 	bool LVEDevice::checkValidationLayerSupport() {
-		//1. ʹ vkEnumerateInstanceLayerProperties ȡòԡ
+		//1. 使用 vkEnumerateInstanceLayerProperties 获取可用层的数量和属性。
 		uint32_t layerCount;
 		vkEnumerateInstanceLayerProperties(&layerCount, nullptr);
 
 		std::vector<VkLayerProperties> availableLayers(layerCount);
 		vkEnumerateInstanceLayerProperties(&layerCount, availableLayers.data());
 
-		//2.  validationLayers еÿ㣬ǷڿòбСκĲ㲻ã false򷵻 true
+		//2. 遍历 validationLayers 中的每个层，检查它们是否在可用层列表中。如果有任何请求的层不可用，返回 false；否则返回 true。
 		for (const char* layerName : validationLayers) {
 			bool layerFound = false;
 
@@ -274,13 +438,17 @@ namespace lve {
 		return true;
 	}
 
-	//ȡչ
+	//获取所需的扩展
 	std::vector<const char*> LVEDevice::getRequiredExtensions() {
-		uint32_t glfwExtensionCount = 0;
-		const char** glfwExtensions;
-		glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+		std::vector<const char*> extensions;
 
-		std::vector<const char*> extensions(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		//无窗口模式不需要 surface 相关的实例扩展，也不要求初始化 GLFW
+		if (!isHeadless()) {
+			uint32_t glfwExtensionCount = 0;
+			const char** glfwExtensions;
+			glfwExtensions = glfwGetRequiredInstanceExtensions(&glfwExtensionCount);
+			extensions.assign(glfwExtensions, glfwExtensions + glfwExtensionCount);
+		}
 
 		if (enableValidationLayers) {
 			extensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
@@ -289,7 +457,15 @@ namespace lve {
 		return extensions;
 	}
 
-	// GLFW ʵչ
+	//获取所需的设备扩展，无窗口模式不需要交换链扩展
+	std::vector<const char*> LVEDevice::getRequiredDeviceExtensions() {
+		if (isHeadless()) {
+			return {};
+		}
+		return deviceExtensions;
+	}
+
+	//检查 GLFW 所需的实例扩展
 	void LVEDevice::hasGflwRequiredInstanceExtensions() {
 		uint32_t extensionCount = 0;
 		vkEnumerateInstanceExtensionProperties(nullptr, &extensionCount, nullptr);
@@ -313,9 +489,9 @@ namespace lve {
 		}
 	}
 
-	//豸չ֧
+	//检查设备扩展支持
 	bool LVEDevice::checkDeviceExtensionSupport(VkPhysicalDevice device) {
-		//1. ѯ豸ֵ֧չȡչԡ
+		//1. 查询该物理设备支持的扩展数量，并获取可用扩展属性。
 		uint32_t extensionCount;
 		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
 
@@ -326,28 +502,43 @@ namespace lve {
 			&extensionCount,
 			availableExtensions.data());
 
-		//2. չӵһ
-		std::set<std::string> requiredExtensions(deviceExtensions.begin(), deviceExtensions.end());
+		//2. 将所需扩展添加到一个集合中
+		auto requiredDeviceExtensions = getRequiredDeviceExtensions();
+		std::set<std::string> requiredExtensions(requiredDeviceExtensions.begin(), requiredDeviceExtensions.end());
 
-		//3. չչɾЩõչ
+		//3. 遍历可用扩展，并从所需扩展集合中删除那些可用的扩展
 		for (const auto& extension : availableExtensions) {
 			requiredExtensions.erase(extension.extensionName);
 		}
 
-		//4. չΪգʾչ֧֣ true֮ false
+		//4. 如果所需扩展集合为空，表示所有所需扩展均已支持，返回 true；反之返回 false。
 		return requiredExtensions.empty();
 	}
 
-	//Ҷ
+	//检查某个可选的设备扩展是否可用
+	bool LVEDevice::isDeviceExtensionAvailable(VkPhysicalDevice device, const char* extensionName) {
+		uint32_t extensionCount;
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+		std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+		vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+		for (const auto& extension : availableExtensions) {
+			if (std::strcmp(extension.extensionName, extensionName) == 0) {
+				return true;
+			}
+		}
+		return false;
+	}
+
+	//查找队列族
 	QueueFamilyIndices LVEDevice::findQueueFamilies(VkPhysicalDevice device) {
-		//1. ѯ豸Ķԡ
+		//1. 查询物理设备的队列族属性。
 		uint32_t queueFamilyCount = 0;
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
 
 		std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
 		vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
 
-		//2. ÿ壬Ƿ֧ͼVK_QUEUE_GRAPHICS_BITͱ֧֡
+		//2. 遍历每个队列族，检查是否支持图形命令（VK_QUEUE_GRAPHICS_BIT）和表面呈现支持。
 		QueueFamilyIndices indices;
 		int i = 0;
 		for (const auto& queueFamily : queueFamilies) {
@@ -355,10 +546,16 @@ namespace lve {
 				indices.graphicsFamily = i;
 				indices.graphicsFamilyHasValue = true;
 			}
+			//无窗口模式没有 surface，直接把图形队列当作呈现队列
 			VkBool32 presentSupport = false;
-			vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+			if (isHeadless()) {
+				presentSupport = queueFamily.queueFlags & VK_QUEUE_GRAPHICS_BIT ? VK_TRUE : VK_FALSE;
+			}
+			else {
+				vkGetPhysicalDeviceSurfaceSupportKHR(device, i, surface_, &presentSupport);
+			}
 			if (queueFamily.queueCount > 0 && presentSupport) {
-				//ҵĶ洢 QueueFamilyIndices ĽṹС
+				//将找到的队列族索引存储到 QueueFamilyIndices 的结构中。
 				indices.presentFamily = i;
 				indices.presentFamilyHasValue = true;
 			}
@@ -372,16 +569,16 @@ namespace lve {
 		return indices;
 	}
 
-	//ѯ֧
+	//查询交换链支持
 	SwapChainSupportDetails LVEDevice::querySwapChainSupport(VkPhysicalDevice device) {
-		//1. ȡ豸ضĽ
+		//1. 获取物理设备对特定表面的交换链能力。
 		SwapChainSupportDetails details;
 		vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface_, &details.capabilities);
 
 		uint32_t formatCount;
 		vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface_, &formatCount, nullptr);
 
-		//2. ѯñֵ֧ĸʽ洢 details.formats С
+		//2. 查询该表面支持的格式，并存储在 details.formats 中。
 		if (formatCount != 0) {
 			details.formats.resize(formatCount);
 			vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface_, &formatCount, details.formats.data());
@@ -390,7 +587,7 @@ namespace lve {
 		uint32_t presentModeCount;
 		vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface_, &presentModeCount, nullptr);
 
-		//3. ѯǰֵ֧ĳģʽ洢 details.presentModes С
+		//3. 查询当前表面支持的呈现模式，并存储在 details.presentModes 中。
 		if (presentModeCount != 0) {
 			details.presentModes.resize(presentModeCount);
 			vkGetPhysicalDeviceSurfacePresentModesKHR(
@@ -400,20 +597,20 @@ namespace lve {
 				details.presentModes.data());
 		}
 
-		//4. ذϢ SwapChainSupportDetails ṹ
+		//4. 返回包含相关信息的 SwapChainSupportDetails 结构。
 		return details;
 	}
 
-	//ֵ֧ĸʽ
+	//查找支持的格式
 	VkFormat LVEDevice::findSupportedFormat(
 		const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features) 
 	{
-		//1. ѡʽȡÿʽԡ
+		//1. 遍历候选格式，获取每个格式的属性。
 		for (VkFormat format : candidates) {
 			VkFormatProperties props;
 			vkGetPhysicalDeviceFormatProperties(physicalDevice, format, &props);
 
-			//2. УԻѣԼҪԣøʽǷ֧֡
+			//2. 根据所需的像素排列（线性或最佳）以及需要的特性，检查该格式是否支持。
 			if (tiling == VK_IMAGE_TILING_LINEAR && (props.linearTilingFeatures & features) == features) {
 				return format;
 			}
@@ -425,13 +622,13 @@ namespace lve {
 		throw std::runtime_error("failed to find supported format!");
 	}
 
-	//ڴ
+	//查找内存类型
 	uint32_t LVEDevice::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-		//1. ȡ豸ڴԡ
+		//1. 取物理设备的内存属性。
 		VkPhysicalDeviceMemoryProperties memProperties;
 		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
 
-		//2. ڴͣǷض͹ڴԡ
+		//2. 遍历所有内存类型，检查它们是否符合特定的类型过滤器和内存属性。
 		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
 			if ((typeFilter & (1 << i)) &&
 				(memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
@@ -442,7 +639,20 @@ namespace lve {
 		throw std::runtime_error("failed to find suitable memory type!");
 	}
 
-	// Vulkan ڴ
+	uint32_t LVEDevice::getMemoryTypeBits(VkMemoryPropertyFlags properties) {
+		VkPhysicalDeviceMemoryProperties memProperties;
+		vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
+
+		uint32_t typeBits = 0;
+		for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+			if ((memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+				typeBits |= 1u << i;
+			}
+		}
+		return typeBits;
+	}
+
+	//创建 Vulkan 缓冲区并分配内存
 	void LVEDevice::createBuffer(
 		VkDeviceSize size,
 		VkBufferUsageFlags usage,
@@ -450,7 +660,7 @@ namespace lve {
 		VkBuffer& buffer,
 		VkDeviceMemory& bufferMemory) 
 	{
-		//1. ûϢС÷͹ģʽ
+		//1. 设置缓冲区创建信息，包括大小、用法和共享模式。
 		VkBufferCreateInfo bufferInfo{};
 		bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
 		bufferInfo.size = size;
@@ -461,11 +671,11 @@ namespace lve {
 			throw std::runtime_error("failed to create vertex buffer!");
 		}
 
-		//2. ѯûڴ
+		//2. 查询该缓冲区的内存需求。
 		VkMemoryRequirements memRequirements;
 		vkGetBufferMemoryRequirements(device_, buffer, &memRequirements);
 
-		//3. ڴ沢󶨵
+		//3. 分配所需的内存并绑定到缓冲区。
 		VkMemoryAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
 		allocInfo.allocationSize = memRequirements.size;
@@ -478,20 +688,20 @@ namespace lve {
 		vkBindBufferMemory(device_, buffer, bufferMemory, 0);
 	}
 
-	//ʼ: 䲢ʼһڵύ
+	//开始单次命令: 分配并开始一个用于单次提交的命令缓冲区。
 	VkCommandBuffer LVEDevice::beginSingleTimeCommands() {
-		//Ϣָؼ
+		//设置命令缓冲区分配信息，指定命令池及缓冲区数量
 		VkCommandBufferAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
 		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
 		allocInfo.commandPool = commandPool;
 		allocInfo.commandBufferCount = 1;
 
-		//ʼ
+		//分配命令缓冲区并初始化
 		VkCommandBuffer commandBuffer;
 		vkAllocateCommandBuffers(device_, &allocInfo, &commandBuffer);
 
-		//ʼ¼
+		//开始命令缓冲区的录制
 		VkCommandBufferBeginInfo beginInfo{};
 		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
 		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
@@ -500,12 +710,12 @@ namespace lve {
 		return commandBuffer;
 	}
 
-	//: ¼ƣύִС
+	//结束单次命令: 结束命令缓冲区的录制，并提交命令以执行。
 	void LVEDevice::endSingleTimeCommands(VkCommandBuffer commandBuffer) {
-		//1. ֮ǰ¼Ƶ
+		//1. 结束之前录制的命令缓冲区。
 		vkEndCommandBuffer(commandBuffer);
 
-		//2. ύϢύͼζС
+		//2. 创建提交信息并提交到图形队列。
 		VkSubmitInfo submitInfo{};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 		submitInfo.commandBufferCount = 1;
@@ -513,34 +723,34 @@ namespace lve {
 
 		vkQueueSubmit(graphicsQueue_, 1, &submitInfo, VK_NULL_HANDLE);
 
-		//3. ȴпУȻͷ
+		//3. 等待队列空闲，然后释放命令缓冲区
 		vkQueueWaitIdle(graphicsQueue_);
 		vkFreeCommandBuffers(device_, commandPool, 1, &commandBuffer);
 	}
 
-	//ƻ: ݴԴĿ껺
+	//复制缓冲区: 复制数据从源缓冲区到目标缓冲区。
 	void LVEDevice::copyBuffer(VkBuffer srcBuffer, VkBuffer dstBuffer, VkDeviceSize size) {
-		//1. ʼһ
+		//1. 开始一个单次命令。
 		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
-		//2. ûϢ
+		//2. 设置缓冲区复制区域信息。
 		VkBufferCopy copyRegion{};
 		copyRegion.srcOffset = 0;  // Optional
 		copyRegion.dstOffset = 0;  // Optional
 		copyRegion.size = size;
-		//3. ʹ vkCmdCopyBuffer ִиƲ
+		//3. 使用 vkCmdCopyBuffer 执行复制操作。
 		vkCmdCopyBuffer(commandBuffer, srcBuffer, dstBuffer, 1, &copyRegion);
-		//4. ύ
+		//4. 结束命令并提交。
 		endSingleTimeCommands(commandBuffer);
 	}
 
-	//ݴӻƵͼ
+	//将数据从缓冲区复制到图像。
 	void LVEDevice::copyBufferToImage(
 		VkBuffer buffer, VkImage image, uint32_t width, uint32_t height, uint32_t layerCount) 
 	{
-		//1. ʼ
+		//1. 开始单次命令。
 		VkCommandBuffer commandBuffer = beginSingleTimeCommands();
 
-		//2.  VkBufferImageCopy 򣬶ͼԣ㡢ƫ
+		//2. 设置 VkBufferImageCopy 区域，定义图像的属性（如层、偏移量）
 		VkBufferImageCopy region{};
 		region.bufferOffset = 0;
 		region.bufferRowLength = 0;
@@ -554,7 +764,7 @@ namespace lve {
 		region.imageOffset = { 0, 0, 0 };
 		region.imageExtent = { width, height, 1 };
 
-		//3. ʹ vkCmdCopyBufferToImage иơ
+		//3. 使用 vkCmdCopyBufferToImage 进行复制。
 		vkCmdCopyBufferToImage(
 			commandBuffer,
 			buffer,
@@ -563,27 +773,27 @@ namespace lve {
 			1,
 			&region);
 
-		//4. ύ
+		//4. 结束并提交命令。
 		endSingleTimeCommands(commandBuffer);
 	}
 
-	// Vulkan ͼ񲢷ڴ档
+	//创建 Vulkan 图像并分配所需内存。
 	void LVEDevice::createImageWithInfo(
 		const VkImageCreateInfo& imageInfo,
 		VkMemoryPropertyFlags properties,
 		VkImage& image,
 		VkDeviceMemory& imageMemory) 
 	{
-		//1.  vkCreateImage ͼ񣬼ɹ
+		//1. 用 vkCreateImage 创建图像，检查成功与否。
 		if (vkCreateImage(device_, &imageInfo, nullptr, &image) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create image!");
 		}
 
-		//2. ѯͼڴ
+		//2. 查询图像的内存需求。
 		VkMemoryRequirements memRequirements;
 		vkGetImageMemoryRequirements(device_, image, &memRequirements);
 
-		//3. ڴڴ棬󶨵ͼ
+		//3. 根据内存需求分配内存，并绑定到图像。
 		VkMemoryAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
 		allocInfo.allocationSize = memRequirements.size;
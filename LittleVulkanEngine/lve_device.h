@@ -1,8 +1,14 @@
 #pragma once
 
+#include "lve_deletion_queue.h"
 #include "lve_window.h"
 
 // std lib headers
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -30,7 +36,11 @@ namespace lve {
 		const bool enableValidationLayers = true;
 #endif
 
-		LVEDevice(LVEWindow& window);
+		//allowDynamicRendering 为 false 时即使设备支持也不启用动态渲染，始终使用传统的渲染通道和帧缓冲
+		LVEDevice(LVEWindow& window, bool allowDynamicRendering = true);
+		//无窗口模式：不创建 surface，不启用交换链扩展，呈现队列与图形队列相同。
+		//用于离屏渲染（基准测试、CI 上用 lavapipe 等软件驱动做图像回归）。
+		explicit LVEDevice(bool allowDynamicRendering = true);
 		~LVEDevice();
 
 		// Not copyable or movable
@@ -44,10 +54,57 @@ namespace lve {
 		VkSurfaceKHR surface() { return surface_; }
 		VkQueue graphicsQueue() { return graphicsQueue_; }
 		VkQueue presentQueue() { return presentQueue_; }
+		bool isHeadless() const { return window == nullptr; }
+
+		//整个图形队列共用一个时间线信号量：每次提交 signal 一个递增的值，
+		//CPU 端通过等待某个具体的值来确认对应的 GPU 工作已经完成。
+		VkSemaphore timelineSemaphore() { return timelineSemaphore_; }
+		//为下一次提交分配一个新的时间线值
+		uint64_t nextTimelineValue() { return ++lastTimelineValue; }
+		uint64_t getLastSubmittedTimelineValue() const { return lastTimelineValue.load(); }
+		uint64_t getCompletedTimelineValue();
+		VkResult waitForTimelineValue(uint64_t value, uint64_t timeout = UINT64_MAX);
+
+		//延迟销毁：deleter 会在当前已提交的所有帧（包括正在录制、下一次提交的帧）执行完之后才被调用。
+		//LVEBuffer、LVEPipeline、LVEDescriptorPool、交换链和离屏目标的析构都走这里，释放它们之前不需要 vkDeviceWaitIdle。
+		void retire(std::function<void()> deleter) { retire(getLastSubmittedTimelineValue() + 1, std::move(deleter)); }
+		//已知资源最后被哪次提交使用时，可以直接指定时间线值，比上面的保守估计更早释放
+		void retire(uint64_t timelineValue, std::function<void()> deleter) { deletionQueue_.retire(timelineValue, std::move(deleter)); }
+		//图像、内存和（可选的）视图一起延迟销毁
+		void retireImage(VkImage image, VkDeviceMemory memory, VkImageView view = VK_NULL_HANDLE);
+		LVEDeletionQueue& deletionQueue() { return deletionQueue_; }
+
+		//管线布局、渲染通道销毁后句柄的值可能被新对象复用，缓存了这些句柄的对象（例如 LVEPipelineRegistry）
+		//在这里登记，销毁前由对象的所有者调用 notifyHandleDestroyed 通知它们。线程安全。
+		uint32_t addHandleDestroyedListener(std::function<void(uint64_t)> listener);
+		void removeHandleDestroyedListener(uint32_t listenerId);
+		template <typename T>
+		void notifyHandleDestroyed(T handle) { notifyHandleValueDestroyed(handleValue(handle)); }
+		//非分发句柄在 64 位下是指针、在 32 位下是 uint64_t，统一转换成整数比较
+		template <typename T>
+		static uint64_t handleValue(T handle) { return (uint64_t)handle; }
+		//执行已经到期的延迟销毁，渲染器每帧调用一次
+		void collectRetiredResources() { deletionQueue_.collect(getCompletedTimelineValue()); }
 
 		SwapChainSupportDetails getSwapChainSupport() { return querySwapChainSupport(physicalDevice); }
 		uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
+		//所有带有这些属性的内存类型组成的位掩码，和 VkMemoryRequirements::memoryTypeBits 的格式相同
+		uint32_t getMemoryTypeBits(VkMemoryPropertyFlags properties);
 		QueueFamilyIndices findPhysicalQueueFamilies() { return findQueueFamilies(physicalDevice); }
+		//CPU 写入可映射缓冲区的字节数统计，渲染器每帧取走一次
+		void recordUpload(VkDeviceSize bytes) { uploadedBytes.fetch_add(bytes, std::memory_order_relaxed); }
+		uint64_t takeUploadedBytes() { return uploadedBytes.exchange(0, std::memory_order_relaxed); }
+		//一次 vkCmdDrawIndexedIndirect 提交多条命令（drawCount > 1），不支持时只能逐条提交
+		bool supportsMultiDrawIndirect() const { return multiDrawIndirectEnabled; }
+		//间接绘制命令的 firstInstance 可以不为 0，GPU 剔除靠它把命令对应到物体数据
+		bool supportsDrawIndirectFirstInstance() const { return drawIndirectFirstInstanceEnabled; }
+		//启用了 VK_KHR_dynamic_rendering：渲染时不需要 VkRenderPass 和 VkFramebuffer，管线只依赖附件格式
+		bool supportsDynamicRendering() const { return dynamicRenderingEnabled; }
+		//vkCmdBeginRenderingKHR / vkCmdEndRenderingKHR，只能在 supportsDynamicRendering 时调用
+		void cmdBeginRendering(VkCommandBuffer commandBuffer, const VkRenderingInfoKHR& renderingInfo);
+		void cmdEndRendering(VkCommandBuffer commandBuffer);
+		//图形队列时间戳的有效位数，0 表示不支持 vkCmdWriteTimestamp
+		uint32_t getTimestampValidBits();
 		VkFormat findSupportedFormat(
 			const std::vector<VkFormat>& candidates, VkImageTiling tiling, VkFormatFeatureFlags features);
 
@@ -79,27 +136,44 @@ namespace lve {
 		void pickPhysicalDevice();
 		void createLogicalDevice();
 		void createCommandPool();
+		void createTimelineSemaphore();
 
 		// helper functions
 		bool isDeviceSuitable(VkPhysicalDevice device);
 		std::vector<const char*> getRequiredExtensions();
+		std::vector<const char*> getRequiredDeviceExtensions();
 		bool checkValidationLayerSupport();
 		QueueFamilyIndices findQueueFamilies(VkPhysicalDevice device);
 		void populateDebugMessengerCreateInfo(VkDebugUtilsMessengerCreateInfoEXT& createInfo);
 		void hasGflwRequiredInstanceExtensions();
 		bool checkDeviceExtensionSupport(VkPhysicalDevice device);
+		bool isDeviceExtensionAvailable(VkPhysicalDevice device, const char* extensionName);
 		SwapChainSupportDetails querySwapChainSupport(VkPhysicalDevice device);
+		void notifyHandleValueDestroyed(uint64_t handle);
 
 		VkInstance instance;
 		VkDebugUtilsMessengerEXT debugMessenger;
 		VkPhysicalDevice physicalDevice = VK_NULL_HANDLE;
-		LVEWindow& window;
+		LVEWindow* window = nullptr;
 		VkCommandPool commandPool;
 
 		VkDevice device_;
-		VkSurfaceKHR surface_;
+		VkSurfaceKHR surface_ = VK_NULL_HANDLE;
 		VkQueue graphicsQueue_;
 		VkQueue presentQueue_;
+		VkSemaphore timelineSemaphore_;
+		std::atomic<uint64_t> lastTimelineValue{ 0 };
+		std::atomic<uint64_t> uploadedBytes{ 0 };
+		bool multiDrawIndirectEnabled = false;
+		bool drawIndirectFirstInstanceEnabled = false;
+		bool dynamicRenderingAllowed = true;
+		bool dynamicRenderingEnabled = false;
+		PFN_vkCmdBeginRenderingKHR vkCmdBeginRenderingKHR_ = nullptr;
+		PFN_vkCmdEndRenderingKHR vkCmdEndRenderingKHR_ = nullptr;
+		LVEDeletionQueue deletionQueue_;
+		std::mutex listenerMutex;
+		std::map<uint32_t, std::function<void(uint64_t)>> handleDestroyedListeners;
+		uint32_t nextListenerId = 0;
 
 		const std::vector<const char*> validationLayers = { "VK_LAYER_KHRONOS_validation" };
 		const std::vector<const char*> deviceExtensions = { VK_KHR_SWAPCHAIN_EXTENSION_NAME };
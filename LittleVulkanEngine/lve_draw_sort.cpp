@@ -0,0 +1,80 @@
+#include "lve_draw_sort.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+#include <cstring>
+
+namespace lve {
+
+	static constexpr uint64_t fieldMask(uint32_t bits) {
+		return (uint64_t{ 1 } << bits) - 1;
+	}
+
+	uint32_t LVEDrawSorter::quantizeDepth(float viewDepth) {
+		//相机后面的物体和 NaN 都排在最前面
+		if (!(viewDepth > 0.f)) {
+			return 0;
+		}
+		uint32_t bits;
+		std::memcpy(&bits, &viewDepth, sizeof(bits));
+		//符号位为 0，剩下 31 位取高 24 位
+		return bits >> (31 - DEPTH_BITS);
+	}
+
+	uint64_t LVEDrawSorter::makeOpaqueKey(uint32_t pipelineId, uint32_t materialId, uint32_t meshId, float viewDepth) {
+		uint64_t key = pipelineId & fieldMask(PIPELINE_BITS);
+		key = (key << MATERIAL_BITS) | (materialId & fieldMask(MATERIAL_BITS));
+		key = (key << MESH_BITS) | (meshId & fieldMask(MESH_BITS));
+		key = (key << DEPTH_BITS) | quantizeDepth(viewDepth);
+		return key;
+	}
+
+	void LVEDrawSorter::sort(std::vector<LVEDrawKey>& keys) {
+		LVE_PROFILE_FUNCTION();
+		size_t count = keys.size();
+		if (count < RADIX_SORT_THRESHOLD) {
+			std::stable_sort(keys.begin(), keys.end(), [](const LVEDrawKey& a, const LVEDrawKey& b) { return a.key < b.key; });
+			return;
+		}
+
+		//一遍读完所有字节的直方图
+		for (auto& histogram : histograms) {
+			histogram.fill(0);
+		}
+		for (const LVEDrawKey& item : keys) {
+			uint64_t key = item.key;
+			for (uint32_t pass = 0; pass < 8; pass++) {
+				histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+			}
+		}
+
+		scratch.resize(count);
+		LVEDrawKey* src = keys.data();
+		LVEDrawKey* dst = scratch.data();
+		for (uint32_t pass = 0; pass < 8; pass++) {
+			auto& histogram = histograms[pass];
+			uint32_t shift = pass * 8;
+			//所有键在这个字节上相同，这一趟不改变顺序。键的高位通常只有少数几种管线和材质，这里能省掉好几趟
+			if (histogram[(src[0].key >> shift) & 0xFF] == count) {
+				continue;
+			}
+			uint32_t offset = 0;
+			for (uint32_t& bucket : histogram) {
+				uint32_t bucketCount = bucket;
+				bucket = offset;
+				offset += bucketCount;
+			}
+			for (size_t i = 0; i < count; i++) {
+				dst[histogram[(src[i].key >> shift) & 0xFF]++] = src[i];
+			}
+			std::swap(src, dst);
+		}
+		//结果最后落在 scratch 里时交换两个数组，不需要再拷贝一遍
+		if (src != keys.data()) {
+			keys.swap(scratch);
+		}
+	}
+
+}  // namespace lve
@@ -0,0 +1,47 @@
+#pragma once
+
+// std
+#include <array>
+#include <cstdint>
+#include <vector>
+
+namespace lve {
+
+	//一次绘制的排序键，index 是它在调用方绘制列表中的下标
+	struct LVEDrawKey {
+		uint64_t key;
+		uint32_t index;
+	};
+
+	//按状态排序绘制：键从高位到低位依次是管线（12 位）、材质（12 位）、网格（16 位）和量化深度（24 位），
+	//升序排序后切换代价最高的管线最少，同一网格的绘制连在一起，同一网格内由近到远，提高 early-Z 的剔除率。
+	//编号超出位宽时只取低位，排序结果仍然可用，只是不同的管线（网格）可能交错，调用方应按实际对象判断是否需要重新绑定。
+	//排序用按字节的 LSD 基数排序，所有键在某个字节上都相同时跳过这一趟。
+	class LVEDrawSorter {
+	public:
+		static constexpr uint32_t PIPELINE_BITS = 12;
+		static constexpr uint32_t MATERIAL_BITS = 12;
+		static constexpr uint32_t MESH_BITS = 16;
+		static constexpr uint32_t DEPTH_BITS = 24;
+		//少于这个数量时直接用 std::stable_sort，基数排序清零直方图的开销不划算
+		static constexpr uint32_t RADIX_SORT_THRESHOLD = 64;
+
+		LVEDrawSorter() = default;
+
+		LVEDrawSorter(const LVEDrawSorter&) = delete;
+		LVEDrawSorter& operator=(const LVEDrawSorter&) = delete;
+
+		//不透明物体的键，viewDepth 是视图空间中到相机的距离，由近到远排序
+		static uint64_t makeOpaqueKey(uint32_t pipelineId, uint32_t materialId, uint32_t meshId, float viewDepth);
+		//保持单调的深度量化：正浮点数的位模式和数值同序，去掉低位尾数就得到 24 位的深度，不需要知道远平面
+		static uint32_t quantizeDepth(float viewDepth);
+
+		//按 key 升序排序，key 相同时保持原来的顺序
+		void sort(std::vector<LVEDrawKey>& keys);
+
+	private:
+		std::vector<LVEDrawKey> scratch;
+		std::array<std::array<uint32_t, 256>, 8> histograms{};
+	};
+
+}  // namespace lve
@@ -0,0 +1,230 @@
+#include "lve_ecs.h"
+
+// std
+#include <algorithm>
+#include <mutex>
+#include <stdexcept>
+
+namespace lve {
+
+	namespace detail {
+		//固定大小的表，注册后条目地址不变，读取不需要加锁
+		static std::array<ComponentTypeInfo, MAX_COMPONENT_TYPES> componentTypes{};
+		static uint32_t componentTypeCount = 0;
+		static std::mutex componentTypesMutex;
+
+		ComponentTypeId registerComponentType(const ComponentTypeInfo& info) {
+			std::lock_guard<std::mutex> lock{ componentTypesMutex };
+			if (componentTypeCount >= MAX_COMPONENT_TYPES) {
+				throw std::runtime_error("failed to register component type: too many component types!");
+			}
+			componentTypes[componentTypeCount] = info;
+			return componentTypeCount++;
+		}
+
+		const ComponentTypeInfo& getComponentTypeInfo(ComponentTypeId id) {
+			assert(id < componentTypeCount && "component type was not registered");
+			return componentTypes[id];
+		}
+	}  // namespace detail
+
+	static size_t alignUp(size_t value, size_t alignment) {
+		return (value + alignment - 1) / alignment * alignment;
+	}
+
+	// ---------------------------------------------------------------------------
+	// LVEArchetype
+	// ---------------------------------------------------------------------------
+
+	LVEArchetype::LVEArchetype(ComponentMask mask) : mask{ mask } {
+		columnLookup.fill(-1);
+		size_t bytesPerEntity = sizeof(LVEEntity);
+		for (ComponentTypeId type = 0; type < MAX_COMPONENT_TYPES; type++) {
+			if (mask & (ComponentMask{ 1 } << type)) {
+				const ComponentTypeInfo& info = detail::getComponentTypeInfo(type);
+				if (info.alignment > CHUNK_ALIGNMENT) {
+					throw std::runtime_error("failed to create archetype: component alignment is too large!");
+				}
+				columnLookup[type] = static_cast<int8_t>(columns.size());
+				columns.push_back({ type, info.size, 0, info });
+				bytesPerEntity += info.size;
+			}
+		}
+
+		//块头是实体数组，后面依次是每种组件的数组，每段按组件的对齐要求对齐。
+		//先按平均大小估一个容量，放不下再逐个减小；单个实体就超过 CHUNK_BYTES 时块会相应变大
+		auto layout = [&](uint32_t capacity) {
+			size_t offset = sizeof(LVEEntity) * capacity;
+			for (auto& column : columns) {
+				offset = alignUp(offset, column.info.alignment);
+				column.offset = offset;
+				offset += column.size * capacity;
+			}
+			return offset;
+		};
+		chunkCapacity = static_cast<uint32_t>(std::max<size_t>(CHUNK_BYTES / bytesPerEntity, 1));
+		while (chunkCapacity > 1 && layout(chunkCapacity) > CHUNK_BYTES) {
+			chunkCapacity--;
+		}
+		chunkBytes = alignUp(std::max<size_t>(layout(chunkCapacity), 1), CHUNK_ALIGNMENT);
+	}
+
+	LVEArchetype::~LVEArchetype() {
+		clear();
+	}
+
+	std::pair<uint32_t, uint32_t> LVEArchetype::allocateRow(LVEEntity entity) {
+		if (chunks.empty() || chunks.back().count == chunkCapacity) {
+			Chunk chunk{};
+			chunk.memory = static_cast<std::byte*>(::operator new(chunkBytes, std::align_val_t{ CHUNK_ALIGNMENT }));
+			chunks.push_back(chunk);
+		}
+		uint32_t chunk = static_cast<uint32_t>(chunks.size() - 1);
+		uint32_t row = chunks[chunk].count++;
+		reinterpret_cast<LVEEntity*>(chunks[chunk].memory)[row] = entity;
+		entityCount++;
+		return { chunk, row };
+	}
+
+	LVEEntity LVEArchetype::removeRow(uint32_t chunk, uint32_t row) {
+		uint32_t lastChunk = static_cast<uint32_t>(chunks.size() - 1);
+		uint32_t lastRow = chunks[lastChunk].count - 1;
+		LVEEntity moved{};
+		if (chunk != lastChunk || row != lastRow) {
+			for (const auto& column : columns) {
+				column.info.moveAndDestroy(
+					chunks[chunk].memory + column.offset + row * column.size,
+					chunks[lastChunk].memory + column.offset + lastRow * column.size);
+			}
+			moved = reinterpret_cast<LVEEntity*>(chunks[lastChunk].memory)[lastRow];
+			reinterpret_cast<LVEEntity*>(chunks[chunk].memory)[row] = moved;
+		}
+		chunks[lastChunk].count--;
+		entityCount--;
+		//最后一块空了就释放，保证除最后一块外都是满的
+		if (chunks[lastChunk].count == 0) {
+			::operator delete(chunks[lastChunk].memory, std::align_val_t{ CHUNK_ALIGNMENT });
+			chunks.pop_back();
+		}
+		return moved;
+	}
+
+	void LVEArchetype::destroyRow(uint32_t chunk, uint32_t row) {
+		for (const auto& column : columns) {
+			column.info.destroy(chunks[chunk].memory + column.offset + row * column.size);
+		}
+	}
+
+	void LVEArchetype::clear() {
+		for (uint32_t chunk = 0; chunk < chunks.size(); chunk++) {
+			for (uint32_t row = 0; row < chunks[chunk].count; row++) {
+				destroyRow(chunk, row);
+			}
+			::operator delete(chunks[chunk].memory, std::align_val_t{ CHUNK_ALIGNMENT });
+		}
+		chunks.clear();
+		entityCount = 0;
+	}
+
+	// ---------------------------------------------------------------------------
+	// LVEWorld
+	// ---------------------------------------------------------------------------
+
+	LVEWorld::~LVEWorld() {
+		clear();
+	}
+
+	LVEEntity LVEWorld::allocateEntity() {
+		uint32_t index;
+		if (!freeIndices.empty()) {
+			index = freeIndices.back();
+			freeIndices.pop_back();
+		}
+		else {
+			index = static_cast<uint32_t>(records.size());
+			records.emplace_back();
+		}
+		return LVEEntity{ index, records[index].generation };
+	}
+
+	LVEArchetype& LVEWorld::getOrCreateArchetype(ComponentMask mask) {
+		auto found = archetypes.find(mask);
+		if (found != archetypes.end()) {
+			return *found->second;
+		}
+		auto archetype = std::make_unique<LVEArchetype>(mask);
+		LVEArchetype* pointer = archetype.get();
+		archetypes.emplace(mask, std::move(archetype));
+		archetypeList.push_back(pointer);
+		return *pointer;
+	}
+
+	void LVEWorld::placeEntity(LVEEntity entity, LVEArchetype& archetype) {
+		auto [chunk, row] = archetype.allocateRow(entity);
+		EntityRecord& record = records[entity.index];
+		record.archetype = &archetype;
+		record.chunk = chunk;
+		record.row = row;
+		structureVersion++;
+	}
+
+	void LVEWorld::releaseRow(LVEArchetype& archetype, uint32_t chunk, uint32_t row) {
+		structureVersion++;
+		LVEEntity moved = archetype.removeRow(chunk, row);
+		if (moved.isValid()) {
+			records[moved.index].chunk = chunk;
+			records[moved.index].row = row;
+		}
+	}
+
+	void LVEWorld::moveEntity(LVEEntity entity, LVEArchetype& target) {
+		EntityRecord source = records[entity.index];
+		placeEntity(entity, target);
+		const EntityRecord& destination = records[entity.index];
+		for (ComponentTypeId type = 0; type < MAX_COMPONENT_TYPES; type++) {
+			if (!source.archetype->hasComponent(type)) {
+				continue;
+			}
+			void* sourceComponent = source.archetype->getComponent(source.chunk, source.row, type);
+			const ComponentTypeInfo& info = detail::getComponentTypeInfo(type);
+			if (target.hasComponent(type)) {
+				info.moveAndDestroy(target.getComponent(destination.chunk, destination.row, type), sourceComponent);
+			}
+			else {
+				info.destroy(sourceComponent);
+			}
+		}
+		releaseRow(*source.archetype, source.chunk, source.row);
+	}
+
+	void LVEWorld::destroyEntity(LVEEntity entity) {
+		if (!isAlive(entity)) {
+			return;
+		}
+		EntityRecord& record = records[entity.index];
+		LVEArchetype& archetype = *record.archetype;
+		uint32_t chunk = record.chunk;
+		uint32_t row = record.row;
+		archetype.destroyRow(chunk, row);
+		record.archetype = nullptr;
+		record.generation++;
+		freeIndices.push_back(entity.index);
+		releaseRow(archetype, chunk, row);
+	}
+
+	void LVEWorld::clear() {
+		structureVersion++;
+		for (LVEArchetype* archetype : archetypeList) {
+			archetype->clear();
+		}
+		freeIndices.clear();
+		for (uint32_t index = 0; index < records.size(); index++) {
+			if (records[index].archetype != nullptr) {
+				records[index].archetype = nullptr;
+				records[index].generation++;
+			}
+			freeIndices.push_back(index);
+		}
+	}
+
+}  // namespace lve
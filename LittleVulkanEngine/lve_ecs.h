@@ -0,0 +1,320 @@
+#pragma once
+
+#include "lve_job_system.h"
+
+// std
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <tuple>
+#include <type_traits>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace lve {
+
+	//实体句柄：index 指向 LVEWorld 的记录表，generation 在实体销毁时加一，
+	//所以指向已销毁实体的旧句柄不会误访问复用了同一个 index 的新实体
+	struct LVEEntity {
+		static constexpr uint32_t INVALID_INDEX = ~0u;
+
+		uint32_t index = INVALID_INDEX;
+		uint32_t generation = 0;
+
+		bool isValid() const { return index != INVALID_INDEX; }
+		bool operator==(const LVEEntity& other) const { return index == other.index && generation == other.generation; }
+		bool operator!=(const LVEEntity& other) const { return !(*this == other); }
+	};
+
+	using ComponentTypeId = uint32_t;
+	//组件类型集合用一个 64 位掩码表示
+	static constexpr uint32_t MAX_COMPONENT_TYPES = 64;
+	using ComponentMask = uint64_t;
+
+	//类型擦除后搬移和析构组件需要的信息
+	struct ComponentTypeInfo {
+		size_t size;
+		size_t alignment;
+		void (*moveAndDestroy)(void* destination, void* source);	//移动构造到 destination 并析构 source
+		void (*destroy)(void* component);
+	};
+
+	namespace detail {
+		ComponentTypeId registerComponentType(const ComponentTypeInfo& info);
+		const ComponentTypeInfo& getComponentTypeInfo(ComponentTypeId id);
+	}  // namespace detail
+
+	//每个组件类型第一次使用时分配一个 id，线程安全
+	template <typename T>
+	ComponentTypeId componentTypeId() {
+		static_assert(std::is_move_constructible_v<T>, "components must be move constructible");
+		static const ComponentTypeId id = detail::registerComponentType(ComponentTypeInfo{
+			sizeof(T),
+			alignof(T),
+			[](void* destination, void* source) {
+				T* typedSource = static_cast<T*>(source);
+				new (destination) T(std::move(*typedSource));
+				typedSource->~T();
+			},
+			[](void* component) { static_cast<T*>(component)->~T(); } });
+		return id;
+	}
+
+	template <typename... Ts>
+	ComponentMask componentMask() {
+		return (ComponentMask{ 0 } | ... | (ComponentMask{ 1 } << componentTypeId<Ts>()));
+	}
+
+	//同一组组件类型的所有实体。数据按固定大小的块存放，每个块里每种组件是一段连续数组，
+	//系统只读取自己需要的那几段数组。删除时用最后一个块的最后一行填洞，除最后一块外所有块都是满的
+	class LVEArchetype {
+	public:
+		static constexpr size_t CHUNK_BYTES = 16 * 1024;
+		static constexpr size_t CHUNK_ALIGNMENT = 64;
+
+		explicit LVEArchetype(ComponentMask mask);
+		~LVEArchetype();
+
+		LVEArchetype(const LVEArchetype&) = delete;
+		LVEArchetype& operator=(const LVEArchetype&) = delete;
+
+		ComponentMask getMask() const { return mask; }
+		uint32_t getChunkCount() const { return static_cast<uint32_t>(chunks.size()); }
+		uint32_t getChunkCapacity() const { return chunkCapacity; }
+		uint32_t getChunkSize(uint32_t chunk) const { return chunks[chunk].count; }
+		uint32_t getEntityCount() const { return entityCount; }
+		bool hasComponent(ComponentTypeId type) const { return columnLookup[type] >= 0; }
+
+		const LVEEntity* getEntities(uint32_t chunk) const {
+			return reinterpret_cast<const LVEEntity*>(chunks[chunk].memory);
+		}
+		void* getColumn(uint32_t chunk, ComponentTypeId type) const {
+			assert(hasComponent(type) && "archetype does not contain this component");
+			return chunks[chunk].memory + columns[columnLookup[type]].offset;
+		}
+		template <typename T>
+		T* getColumn(uint32_t chunk) const {
+			return static_cast<T*>(getColumn(chunk, componentTypeId<T>()));
+		}
+		void* getComponent(uint32_t chunk, uint32_t row, ComponentTypeId type) const {
+			return static_cast<std::byte*>(getColumn(chunk, type)) + row * columns[columnLookup[type]].size;
+		}
+
+		//在最后一个块的末尾分配一行，组件内存未初始化，由调用者构造
+		std::pair<uint32_t, uint32_t> allocateRow(LVEEntity entity);
+		//释放一行，这一行的组件必须已经被析构或移走。
+		//如果用最后一行填了洞，返回被搬动的实体（调用者需要更新它的位置），否则返回无效实体
+		LVEEntity removeRow(uint32_t chunk, uint32_t row);
+		void destroyRow(uint32_t chunk, uint32_t row);
+		void clear();
+
+	private:
+		struct Column {
+			ComponentTypeId type;
+			size_t size;
+			size_t offset;
+			ComponentTypeInfo info;
+		};
+		struct Chunk {
+			std::byte* memory = nullptr;
+			uint32_t count = 0;
+		};
+
+		ComponentMask mask;
+		std::vector<Column> columns;
+		std::array<int8_t, MAX_COMPONENT_TYPES> columnLookup;
+		std::vector<Chunk> chunks;
+		uint32_t chunkCapacity = 0;
+		size_t chunkBytes = 0;
+		uint32_t entityCount = 0;
+	};
+
+	//实体和组件的容器。组合相同的实体放在同一个原型里，
+	//forEachChunk / each / parallelEach 只遍历包含所需组件的原型。
+	//遍历过程中不能增删实体或组件；addComponent / removeComponent 之后之前拿到的组件引用失效
+	class LVEWorld {
+	public:
+		LVEWorld() = default;
+		~LVEWorld();
+
+		LVEWorld(const LVEWorld&) = delete;
+		LVEWorld& operator=(const LVEWorld&) = delete;
+
+		//直接在最终的原型里创建实体并移动构造所有组件，不经过中间原型
+		template <typename... Ts>
+		LVEEntity createEntity(Ts&&... components);
+		void destroyEntity(LVEEntity entity);
+		bool isAlive(LVEEntity entity) const {
+			return entity.index < records.size() && records[entity.index].generation == entity.generation &&
+				records[entity.index].archetype != nullptr;
+		}
+
+		//已经有这个组件时直接赋值
+		template <typename T>
+		T& addComponent(LVEEntity entity, T component);
+		template <typename T>
+		void removeComponent(LVEEntity entity);
+		template <typename T>
+		bool hasComponent(LVEEntity entity) const {
+			return isAlive(entity) && records[entity.index].archetype->hasComponent(componentTypeId<T>());
+		}
+		template <typename T>
+		T& getComponent(LVEEntity entity) {
+			T* component = tryGetComponent<T>(entity);
+			assert(component != nullptr && "entity does not have this component");
+			return *component;
+		}
+		template <typename T>
+		T* tryGetComponent(LVEEntity entity);
+
+		//每个非空块调用一次 func(count, entities, Ts* ...)，组件以连续数组的形式传入
+		template <typename... Ts, typename F>
+		void forEachChunk(F&& func);
+		//每个实体调用一次 func(entity, Ts& ...)
+		template <typename... Ts, typename F>
+		void each(F&& func);
+		//与 each 相同，按块分给 jobSystem 的工作线程并行执行，func 需要是线程安全的
+		template <typename... Ts, typename F>
+		void parallelEach(LVEJobSystem& jobSystem, F&& func);
+
+		uint32_t getEntityCount() const { return static_cast<uint32_t>(records.size() - freeIndices.size()); }
+		uint32_t getArchetypeCount() const { return static_cast<uint32_t>(archetypeList.size()); }
+		//销毁所有实体，所有旧句柄都会失效
+		void clear();
+		//创建/销毁实体、增删组件或用 addComponent 替换组件时递增，缓存了场景内容的系统用它判断是否失效。
+		//通过 getComponent 等引用直接修改组件不会递增
+		uint64_t getStructureVersion() const { return structureVersion; }
+
+	private:
+		struct EntityRecord {
+			LVEArchetype* archetype = nullptr;
+			uint32_t chunk = 0;
+			uint32_t row = 0;
+			uint32_t generation = 0;
+		};
+
+		LVEEntity allocateEntity();
+		LVEArchetype& getOrCreateArchetype(ComponentMask mask);
+		void placeEntity(LVEEntity entity, LVEArchetype& archetype);
+		//把实体搬到 target，两边都有的组件移动过去，target 没有的组件析构，target 新增的组件内存未初始化
+		void moveEntity(LVEEntity entity, LVEArchetype& target);
+		void releaseRow(LVEArchetype& archetype, uint32_t chunk, uint32_t row);
+
+		template <typename... Ts>
+		void collectChunks(std::vector<std::pair<LVEArchetype*, uint32_t>>& result);
+
+		std::vector<EntityRecord> records;
+		std::vector<uint32_t> freeIndices;
+		std::unordered_map<ComponentMask, std::unique_ptr<LVEArchetype>> archetypes;
+		std::vector<LVEArchetype*> archetypeList;
+		uint64_t structureVersion = 0;
+	};
+
+	template <typename... Ts>
+	LVEEntity LVEWorld::createEntity(Ts&&... components) {
+		LVEEntity entity = allocateEntity();
+		LVEArchetype& archetype = getOrCreateArchetype(componentMask<std::decay_t<Ts>...>());
+		placeEntity(entity, archetype);
+		const EntityRecord& record = records[entity.index];
+		(new (archetype.getComponent(record.chunk, record.row, componentTypeId<std::decay_t<Ts>>()))
+			std::decay_t<Ts>(std::forward<Ts>(components)), ...);
+		return entity;
+	}
+
+	template <typename T>
+	T& LVEWorld::addComponent(LVEEntity entity, T component) {
+		assert(isAlive(entity) && "entity is not alive");
+		if (T* existing = tryGetComponent<T>(entity)) {
+			*existing = std::move(component);
+			structureVersion++;
+			return *existing;
+		}
+		ComponentTypeId type = componentTypeId<T>();
+		LVEArchetype& target = getOrCreateArchetype(records[entity.index].archetype->getMask() | (ComponentMask{ 1 } << type));
+		moveEntity(entity, target);
+		const EntityRecord& record = records[entity.index];
+		return *new (target.getComponent(record.chunk, record.row, type)) T(std::move(component));
+	}
+
+	template <typename T>
+	void LVEWorld::removeComponent(LVEEntity entity) {
+		if (!hasComponent<T>(entity)) {
+			return;
+		}
+		LVEArchetype& target = getOrCreateArchetype(records[entity.index].archetype->getMask() & ~(ComponentMask{ 1 } << componentTypeId<T>()));
+		moveEntity(entity, target);
+	}
+
+	template <typename T>
+	T* LVEWorld::tryGetComponent(LVEEntity entity) {
+		if (!hasComponent<T>(entity)) {
+			return nullptr;
+		}
+		const EntityRecord& record = records[entity.index];
+		return static_cast<T*>(record.archetype->getComponent(record.chunk, record.row, componentTypeId<T>()));
+	}
+
+	template <typename... Ts, typename F>
+	void LVEWorld::forEachChunk(F&& func) {
+		ComponentMask required = componentMask<Ts...>();
+		for (LVEArchetype* archetype : archetypeList) {
+			if ((archetype->getMask() & required) != required) {
+				continue;
+			}
+			for (uint32_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+				uint32_t count = archetype->getChunkSize(chunk);
+				if (count > 0) {
+					func(count, archetype->getEntities(chunk), archetype->template getColumn<Ts>(chunk)...);
+				}
+			}
+		}
+	}
+
+	template <typename... Ts, typename F>
+	void LVEWorld::each(F&& func) {
+		forEachChunk<Ts...>([&](uint32_t count, const LVEEntity* entities, Ts*... columns) {
+			for (uint32_t i = 0; i < count; i++) {
+				func(entities[i], columns[i]...);
+			}
+		});
+	}
+
+	template <typename... Ts>
+	void LVEWorld::collectChunks(std::vector<std::pair<LVEArchetype*, uint32_t>>& result) {
+		ComponentMask required = componentMask<Ts...>();
+		for (LVEArchetype* archetype : archetypeList) {
+			if ((archetype->getMask() & required) != required) {
+				continue;
+			}
+			for (uint32_t chunk = 0; chunk < archetype->getChunkCount(); chunk++) {
+				if (archetype->getChunkSize(chunk) > 0) {
+					result.emplace_back(archetype, chunk);
+				}
+			}
+		}
+	}
+
+	template <typename... Ts, typename F>
+	void LVEWorld::parallelEach(LVEJobSystem& jobSystem, F&& func) {
+		std::vector<std::pair<LVEArchetype*, uint32_t>> chunks;
+		collectChunks<Ts...>(chunks);
+		//一个块是 16KB 的数据，单独作为一个批次已经足够大
+		jobSystem.parallelFor(static_cast<uint32_t>(chunks.size()), 1, [&](uint32_t begin, uint32_t end) {
+			for (uint32_t i = begin; i < end; i++) {
+				LVEArchetype* archetype = chunks[i].first;
+				uint32_t chunk = chunks[i].second;
+				uint32_t count = archetype->getChunkSize(chunk);
+				const LVEEntity* entities = archetype->getEntities(chunk);
+				std::tuple<Ts*...> columns{ archetype->template getColumn<Ts>(chunk)... };
+				for (uint32_t row = 0; row < count; row++) {
+					func(entities[row], std::get<Ts*>(columns)[row]...);
+				}
+			}
+		});
+	}
+
+}  // namespace lve
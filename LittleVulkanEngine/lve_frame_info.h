@@ -1,16 +1,28 @@
 #pragma once
 
 #include "lve_camera.h"
+#include "lve_frame_stats.h"
+#include "lve_gpu_profiler.h"
 
 // lib
 #include <vulkan/vulkan.h>
 
+// std
+#include <cstdint>
+#include <vector>
+
 namespace lve {
+	class LVETransformSystem;
+
 	struct FrameInfo {
 		int frameIndex;
 		float frameTime;
 		VkCommandBuffer commandBuffer;
 		LVECamera& camera;
 		VkDescriptorSet globalDescriptorSet;
+		LVEGpuProfiler* gpuProfiler = nullptr;	//为空时不记录 GPU 时间，渲染系统用 LVEGpuScope 包住自己的绘制
+		LVEFrameStats* frameStats = nullptr;	//为空时不统计，渲染系统每次 draw 后调用 addDrawCall
+		const LVETransformSystem* transformSystem = nullptr;	//为空或物体没有注册时，渲染系统逐个计算矩阵
+		const std::vector<uint8_t>* visibleSlots = nullptr;	//按变换槽位下标的可见性（LVESceneIndex::cullFrustum），为空时全部绘制
 	};
 }  // namespace lve
@@ -0,0 +1,95 @@
+#include "lve_frame_pacer.h"
+
+// std
+#include <thread>
+
+namespace lve {
+
+	static double toMilliseconds(std::chrono::steady_clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	void LVEFramePacer::setFrameRateLimit(double fps) {
+		frameRateLimit = fps > 0.0 ? fps : 0.0;
+		nextFrameTime = Clock::now();
+	}
+
+	void LVEFramePacer::waitForNextFrame() {
+		if (frameRateLimit <= 0.0) {
+			return;
+		}
+
+		auto frameDuration = std::chrono::duration_cast<Clock::duration>(
+			std::chrono::duration<double>(1.0 / frameRateLimit));
+		auto now = Clock::now();
+
+		//落后超过一帧时不追赶，直接从现在重新计时，避免连续多帧不等待
+		if (now > nextFrameTime + frameDuration) {
+			nextFrameTime = now;
+		}
+
+		//系统睡眠精度一般在 1ms 左右，先粗睡到目标前 1ms，剩下的自旋
+		auto spinThreshold = std::chrono::milliseconds(1);
+		if (nextFrameTime - now > spinThreshold) {
+			std::this_thread::sleep_until(nextFrameTime - spinThreshold);
+		}
+		while (Clock::now() < nextFrameTime) {
+			std::this_thread::yield();
+		}
+
+		nextFrameTime += frameDuration;
+	}
+
+	void LVEFramePacer::markSubmitted(
+		uint64_t timelineValue, Clock::time_point submitTime, Clock::time_point presentTime)
+	{
+		FrameLatencySample sample{};
+		sample.timelineValue = timelineValue;
+		if (inputSampleTime != Clock::time_point{}) {
+			sample.inputToSubmitMs = toMilliseconds(submitTime - inputSampleTime);
+		}
+		sample.submitToPresentMs = toMilliseconds(presentTime - submitTime);
+
+		history.push_back(sample);
+		pendingFrames.push_back({ timelineValue, submitTime, historyBase + history.size() - 1 });
+		while (history.size() > historySize) {
+			history.pop_front();
+			historyBase++;
+		}
+	}
+
+	void LVEFramePacer::resolveCompletedFrames(uint64_t completedTimelineValue) {
+		auto now = Clock::now();
+		while (!pendingFrames.empty() && pendingFrames.front().timelineValue <= completedTimelineValue) {
+			const PendingFrame& frame = pendingFrames.front();
+			if (frame.sampleNumber >= historyBase) {
+				history[frame.sampleNumber - historyBase].submitToGpuCompleteMs = toMilliseconds(now - frame.submitTime);
+			}
+			pendingFrames.pop_front();
+		}
+	}
+
+	FrameLatencySample LVEFramePacer::getAverageLatency() const {
+		FrameLatencySample average{};
+		if (history.empty()) {
+			return average;
+		}
+
+		uint32_t gpuCount = 0;
+		double gpuTotal = 0.0;
+		for (const auto& sample : history) {
+			average.inputToSubmitMs += sample.inputToSubmitMs;
+			average.submitToPresentMs += sample.submitToPresentMs;
+			if (sample.submitToGpuCompleteMs >= 0.0) {
+				gpuTotal += sample.submitToGpuCompleteMs;
+				gpuCount++;
+			}
+		}
+		average.timelineValue = history.back().timelineValue;
+		average.inputToSubmitMs /= history.size();
+		average.submitToPresentMs /= history.size();
+		average.submitToGpuCompleteMs = gpuCount > 0 ? gpuTotal / gpuCount : -1.0;
+		return average;
+	}
+
+}  // namespace lve
@@ -0,0 +1,64 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <deque>
+
+namespace lve {
+
+	//单帧的延迟采样，单位毫秒
+	struct FrameLatencySample {
+		uint64_t timelineValue = 0;
+		double inputToSubmitMs = 0.0;			//采样输入 -> vkQueueSubmit
+		double submitToPresentMs = 0.0;			//vkQueueSubmit -> vkQueuePresentKHR 返回
+		double submitToGpuCompleteMs = -1.0;	//vkQueueSubmit -> 观察到时间线值完成，未完成时为负数
+	};
+
+	//帧节奏控制：可选的帧率上限，以及每帧输入到提交、提交到呈现的延迟统计。
+	//帧率上限在采样输入之前等待，这样等待的时间不会被算进输入延迟里。
+	class LVEFramePacer {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		LVEFramePacer() = default;
+
+		LVEFramePacer(const LVEFramePacer&) = delete;
+		LVEFramePacer& operator=(const LVEFramePacer&) = delete;
+
+		//fps <= 0 表示不限帧
+		void setFrameRateLimit(double fps);
+		double getFrameRateLimit() const { return frameRateLimit; }
+		//在每帧开头（采样输入之前）调用，限帧时会睡眠到下一帧的时间点
+		void waitForNextFrame();
+
+		void markInputSampled() { inputSampleTime = Clock::now(); }
+		//输入在另一个线程采样时（LVERenderThread），由渲染线程传入采样时刻
+		void markInputSampled(Clock::time_point sampleTime) { inputSampleTime = sampleTime; }
+		void markSubmitted(uint64_t timelineValue, Clock::time_point submitTime, Clock::time_point presentTime);
+		//用已完成的时间线值补全之前帧的 GPU 完成时间（精度取决于调用频率，每帧 beginFrame 调用一次）
+		void resolveCompletedFrames(uint64_t completedTimelineValue);
+
+		//最近 historySize 帧的采样，最新的在末尾
+		const std::deque<FrameLatencySample>& getHistory() const { return history; }
+		FrameLatencySample getAverageLatency() const;
+		void setHistorySize(size_t size) { historySize = size; }
+
+	private:
+		double frameRateLimit = 0.0;
+		Clock::time_point nextFrameTime{};
+
+		Clock::time_point inputSampleTime{};
+
+		struct PendingFrame {
+			uint64_t timelineValue;
+			Clock::time_point submitTime;
+			uint64_t sampleNumber;
+		};
+		std::deque<PendingFrame> pendingFrames;
+		std::deque<FrameLatencySample> history;
+		uint64_t historyBase = 0;	//history.front() 在所有采样中的序号，用于定位 pendingFrames
+		size_t historySize = 240;
+	};
+
+}  // namespace lve
@@ -0,0 +1,181 @@
+#include "lve_frame_stats.h"
+
+#include "lve_utils.hpp"
+
+// std
+#include <algorithm>
+#include <stdexcept>
+
+namespace lve {
+
+	static double toMilliseconds(LVEFrameStats::Clock::duration duration) {
+		return std::chrono::duration<double, std::milli>(duration).count();
+	}
+
+	template <typename Getter>
+	static MetricSummary summarize(const std::vector<FrameStatsSample>& samples, Getter getter) {
+		MetricSummary summary{};
+		if (samples.empty()) {
+			return summary;
+		}
+
+		std::vector<double> values;
+		values.reserve(samples.size());
+		double total = 0.0;
+		for (const auto& sample : samples) {
+			double value = static_cast<double>(getter(sample));
+			values.push_back(value);
+			total += value;
+		}
+		std::sort(values.begin(), values.end());
+
+		summary.average = total / static_cast<double>(values.size());
+		summary.p50 = percentileOfSorted(values, 0.50);
+		summary.p95 = percentileOfSorted(values, 0.95);
+		summary.p99 = percentileOfSorted(values, 0.99);
+		summary.max = values.back();
+		return summary;
+	}
+
+	LVEFrameStats::LVEFrameStats() : creationTime{ Clock::now() }, windowStart{ creationTime } {}
+
+	LVEFrameStats::~LVEFrameStats() {
+		//不足一个窗口的尾巴也写出去，避免短时间运行的进程什么都没有留下
+		if (!windowSamples.empty()) {
+			closeWindow(Clock::now());
+		}
+	}
+
+	void LVEFrameStats::setExportFile(const std::string& filePath, ExportFormat format) {
+		if (exportFile.is_open()) {
+			exportFile.close();
+		}
+
+		bool writeHeader = false;
+		if (format == ExportFormat::Csv) {
+			std::ifstream existing{ filePath };
+			writeHeader = !existing.good() || existing.peek() == std::ifstream::traits_type::eof();
+		}
+
+		exportFile.open(filePath, std::ios::app);
+		if (!exportFile.is_open()) {
+			throw std::runtime_error("failed to open frame stats file: " + filePath);
+		}
+		exportFormat = format;
+
+		if (writeHeader) {
+			exportFile << "window,start_s,duration_s,frames,hitches";
+			for (const char* metric : {
+				"frame_ms", "cpu_ms", "gpu_ms", "draw_calls", "triangles", "upload_bytes", "visible_objects", "culled_objects" }) {
+				for (const char* stat : { "avg", "p50", "p95", "p99", "max" }) {
+					exportFile << ',' << metric << '_' << stat;
+				}
+			}
+			exportFile << '\n';
+			exportFile.flush();
+		}
+	}
+
+	void LVEFrameStats::beginFrame() {
+		auto now = Clock::now();
+		current = FrameStatsSample{};
+		if (lastBeginTime != Clock::time_point{}) {
+			current.frameTimeMs = toMilliseconds(now - lastBeginTime);
+		}
+		lastBeginTime = now;
+		cpuStartTime = now;
+		waitTime = Clock::duration::zero();
+		frameInProgress = true;
+	}
+
+	void LVEFrameStats::endFrame(double gpuTimeMs, uint64_t uploadBytes) {
+		if (!frameInProgress) {
+			return;
+		}
+		frameInProgress = false;
+
+		auto now = Clock::now();
+		current.cpuTimeMs = toMilliseconds(now - cpuStartTime - waitTime);
+		current.gpuTimeMs = gpuTimeMs;
+		current.uploadBytes = uploadBytes;
+		lastFrame = current;
+
+		//第一帧没有帧间隔，不参与统计
+		if (current.frameTimeMs > 0.0) {
+			windowSamples.push_back(current);
+		}
+
+		if (std::chrono::duration<double>(now - windowStart).count() >= windowDuration) {
+			closeWindow(now);
+		}
+	}
+
+	void LVEFrameStats::closeWindow(Clock::time_point now) {
+		FrameStatsWindow window{};
+		window.windowIndex = windowIndex++;
+		window.startSeconds = std::chrono::duration<double>(windowStart - creationTime).count();
+		window.durationSeconds = std::chrono::duration<double>(now - windowStart).count();
+		window.frameCount = static_cast<uint32_t>(windowSamples.size());
+
+		window.frameTimeMs = summarize(windowSamples, [](const FrameStatsSample& s) { return s.frameTimeMs; });
+		window.cpuTimeMs = summarize(windowSamples, [](const FrameStatsSample& s) { return s.cpuTimeMs; });
+		window.gpuTimeMs = summarize(windowSamples, [](const FrameStatsSample& s) { return s.gpuTimeMs; });
+		window.drawCalls = summarize(windowSamples, [](const FrameStatsSample& s) { return s.drawCalls; });
+		window.triangles = summarize(windowSamples, [](const FrameStatsSample& s) { return s.triangles; });
+		window.uploadBytes = summarize(windowSamples, [](const FrameStatsSample& s) { return s.uploadBytes; });
+		window.visibleObjects = summarize(windowSamples, [](const FrameStatsSample& s) { return s.visibleObjects; });
+		window.culledObjects = summarize(windowSamples, [](const FrameStatsSample& s) { return s.culledObjects; });
+
+		double hitchLimit = std::min(window.frameTimeMs.p50 * hitchMultiplier, hitchThresholdMs);
+		for (const auto& sample : windowSamples) {
+			if (sample.frameTimeMs > hitchLimit) {
+				window.hitchCount++;
+			}
+		}
+
+		lastWindow = window;
+		exportWindow(window);
+
+		windowSamples.clear();
+		windowStart = now;
+	}
+
+	void LVEFrameStats::exportWindow(const FrameStatsWindow& window) {
+		if (!exportFile.is_open()) {
+			return;
+		}
+
+		const MetricSummary* metrics[] = {
+			&window.frameTimeMs, &window.cpuTimeMs, &window.gpuTimeMs,
+			&window.drawCalls, &window.triangles, &window.uploadBytes,
+			&window.visibleObjects, &window.culledObjects };
+		const char* metricNames[] = {
+			"frame_ms", "cpu_ms", "gpu_ms", "draw_calls", "triangles", "upload_bytes", "visible_objects", "culled_objects" };
+
+		if (exportFormat == ExportFormat::Csv) {
+			exportFile << window.windowIndex << ',' << window.startSeconds << ',' << window.durationSeconds
+				<< ',' << window.frameCount << ',' << window.hitchCount;
+			for (const MetricSummary* metric : metrics) {
+				exportFile << ',' << metric->average << ',' << metric->p50 << ',' << metric->p95
+					<< ',' << metric->p99 << ',' << metric->max;
+			}
+			exportFile << '\n';
+		}
+		else {
+			exportFile << "{\"window\":" << window.windowIndex
+				<< ",\"start_s\":" << window.startSeconds
+				<< ",\"duration_s\":" << window.durationSeconds
+				<< ",\"frames\":" << window.frameCount
+				<< ",\"hitches\":" << window.hitchCount;
+			for (size_t i = 0; i < std::size(metrics); i++) {
+				exportFile << ",\"" << metricNames[i] << "\":{\"avg\":" << metrics[i]->average
+					<< ",\"p50\":" << metrics[i]->p50 << ",\"p95\":" << metrics[i]->p95
+					<< ",\"p99\":" << metrics[i]->p99 << ",\"max\":" << metrics[i]->max << "}";
+			}
+			exportFile << "}\n";
+		}
+		//每个窗口都刷新，进程崩溃时也能保留之前的数据
+		exportFile.flush();
+	}
+
+}  // namespace lve
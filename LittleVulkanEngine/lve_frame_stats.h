@@ -0,0 +1,128 @@
+#pragma once
+
+// std
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+	//单帧的统计数据
+	struct FrameStatsSample {
+		double frameTimeMs = 0.0;	//两次 beginFrame 之间的间隔
+		double cpuTimeMs = 0.0;		//beginFrame 到 endFrame，不包括等待帧槽位的时间
+		double gpuTimeMs = 0.0;		//GPU 时间戳分析器最近读回的整帧耗时，比当前帧晚 framesInFlight 帧
+		uint32_t drawCalls = 0;
+		uint64_t triangles = 0;
+		uint64_t uploadBytes = 0;	//CPU 写入可映射缓冲区的字节数
+		uint32_t visibleObjects = 0;	//剔除后绘制的物体数，GPU 剔除的结果比当前帧晚 framesInFlight 帧
+		uint32_t culledObjects = 0;		//被视锥或遮挡剔除掉的物体数
+	};
+
+	struct MetricSummary {
+		double average = 0.0;
+		double p50 = 0.0;
+		double p95 = 0.0;
+		double p99 = 0.0;
+		double max = 0.0;
+	};
+
+	//一个固定时间窗口内的汇总
+	struct FrameStatsWindow {
+		uint64_t windowIndex = 0;
+		double startSeconds = 0.0;	//相对于 LVEFrameStats 创建的时间
+		double durationSeconds = 0.0;
+		uint32_t frameCount = 0;
+		uint32_t hitchCount = 0;
+		MetricSummary frameTimeMs;
+		MetricSummary cpuTimeMs;
+		MetricSummary gpuTimeMs;
+		MetricSummary drawCalls;
+		MetricSummary triangles;
+		MetricSummary uploadBytes;
+		MetricSummary visibleObjects;
+		MetricSummary culledObjects;
+	};
+
+	//帧统计服务：收集每帧的帧时间、CPU/GPU 时间、draw call、三角形和上传字节数，
+	//按固定时间窗口计算百分位和卡顿次数，并可以把每个窗口追加写到 CSV 或 JSON Lines 文件里。
+	class LVEFrameStats {
+	public:
+		using Clock = std::chrono::steady_clock;
+
+		enum class ExportFormat {
+			Csv,
+			JsonLines,	//每行一个 JSON 对象，方便日志采集直接按行读取
+		};
+
+		LVEFrameStats();
+		~LVEFrameStats();
+
+		LVEFrameStats(const LVEFrameStats&) = delete;
+		LVEFrameStats& operator=(const LVEFrameStats&) = delete;
+
+		void setWindowDuration(double seconds) { windowDuration = seconds; }
+		//帧时间超过窗口中位数的 hitchMultiplier 倍，或者超过 hitchThresholdMs，都算一次卡顿
+		void setHitchCriteria(double multiplier, double thresholdMs) {
+			hitchMultiplier = multiplier;
+			hitchThresholdMs = thresholdMs;
+		}
+		//每个窗口结束时追加一行，文件不存在时创建（CSV 会先写表头）
+		void setExportFile(const std::string& filePath, ExportFormat format = ExportFormat::Csv);
+
+		//渲染器在 beginFrame/endFrame 中调用
+		void beginFrame();
+		void endFrame(double gpuTimeMs, uint64_t uploadBytes);
+		//渲染系统每次 draw 调用后记录
+		void addDrawCall(uint64_t triangles) {
+			current.drawCalls++;
+			current.triangles += triangles;
+		}
+		//剔除系统每帧记录一次可见和被剔除的物体数量
+		//重放缓存的命令缓冲区时，一次加回录制时记下的计数
+		void addDrawCalls(uint32_t drawCalls, uint64_t triangles) {
+			current.drawCalls += drawCalls;
+			current.triangles += triangles;
+		}
+		//当前帧到目前为止的计数，录制缓存命令前后各取一次得到录制内容的计数
+		uint32_t getCurrentDrawCalls() const { return current.drawCalls; }
+		uint64_t getCurrentTriangles() const { return current.triangles; }
+		void setCullingCounts(uint32_t visible, uint32_t culled) {
+			current.visibleObjects = visible;
+			current.culledObjects = culled;
+		}
+		//beginFrame 之后、CPU 在等待 GPU 的时间，不计入 CPU 时间
+		void addWaitTime(Clock::duration duration) { waitTime += duration; }
+
+		const FrameStatsSample& getLastFrame() const { return lastFrame; }
+		//最近一个完整窗口的汇总，第一个窗口结束前 frameCount 为 0
+		const FrameStatsWindow& getLastWindow() const { return lastWindow; }
+
+	private:
+		void closeWindow(Clock::time_point now);
+		void exportWindow(const FrameStatsWindow& window);
+
+		Clock::time_point creationTime;
+		Clock::time_point windowStart;
+		Clock::time_point lastBeginTime{};
+		Clock::time_point cpuStartTime{};
+		Clock::duration waitTime{};
+		bool frameInProgress = false;
+
+		FrameStatsSample current{};
+		FrameStatsSample lastFrame{};
+		std::vector<FrameStatsSample> windowSamples;
+		FrameStatsWindow lastWindow{};
+		uint64_t windowIndex = 0;
+
+		double windowDuration = 10.0;
+		double hitchMultiplier = 2.0;
+		double hitchThresholdMs = 100.0;
+
+		std::ofstream exportFile;
+		ExportFormat exportFormat = ExportFormat::Csv;
+	};
+
+}  // namespace lve
@@ -5,6 +5,7 @@
 //#include <glm/gtc/matrix_transform.hpp>
 
 // std
+#include <cstdint>
 #include <memory>
 namespace lve {
     struct TransformComponent {
@@ -12,17 +13,29 @@ namespace lve {
         glm::vec3 scale{ 1.f, 1.f, 1.f };
         glm::vec3 rotation{};
 
-        // Ӧ Translate * Ry * Rx * Rz * Scale
-        // תӦ Y(1)X(2)Z(3)  Tait-bryan 
+        // 矩阵对应 Translate * Ry * Rx * Rz * Scale
+        // 旋转对应于 Y(1)、X(2)、Z(3) 的 Tait-bryan 角
         // https://en.wikipedia.org/wiki/Euler_angles#Rotation_matrix
         glm::mat4 mat4();
 
         glm::mat3 normalMatrix();
     };
 
+    // 下面几个是 LVEWorld 中实体使用的组件，渲染系统只读取后两个
+    struct ModelComponent {
+        std::shared_ptr<LVEModel> model{};
+    };
+
+    // 实体在 LVETransformSystem 中的槽位。实体不带 TransformComponent，
+    // 平移/旋转/缩放只存放在那个槽位里，修改时调用 LVETransformSystem::get/set
+    struct TransformSlotComponent {
+        uint32_t slot = ~0u;
+    };
+
     class LVEGameObject {
     public:
         using id_t = unsigned int;
+        static constexpr uint32_t INVALID_TRANSFORM_SLOT = ~0u;
         static LVEGameObject createGameObject() {
             static id_t currentId = 0;
             return LVEGameObject{ currentId++ };
@@ -37,6 +50,8 @@ namespace lve {
         std::shared_ptr<LVEModel> model{};
         glm::vec3 color{};
         TransformComponent transform{};
+        // 在 LVETransformSystem 中的槽位，注册后修改 transform 需要调用 markDirty
+        uint32_t transformSlot = INVALID_TRANSFORM_SLOT;
 
     private:
         LVEGameObject(id_t objId) : id{ objId } {}
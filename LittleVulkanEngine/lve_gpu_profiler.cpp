@@ -0,0 +1,211 @@
+#include "lve_gpu_profiler.h"
+
+#include "lve_utils.hpp"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace lve {
+
+	LVEGpuProfiler::LVEGpuProfiler(LVEDevice& device, uint32_t framesInFlight, uint32_t maxScopesPerFrame)
+		: lveDevice{ device },
+		maxScopesPerFrame{ maxScopesPerFrame },
+		queriesPerFrame{ maxScopesPerFrame * 2 },
+		timestampPeriodNs{ static_cast<double>(device.properties.limits.timestampPeriod) }
+	{
+		frames.resize(framesInFlight);
+
+		uint32_t validBits = lveDevice.getTimestampValidBits();
+		if (validBits == 0) {
+			//图形队列不支持时间戳，不创建查询池
+			timestampMask = 0;
+			return;
+		}
+		timestampMask = validBits >= 64 ? UINT64_MAX : ((uint64_t{ 1 } << validBits) - 1);
+
+		VkQueryPoolCreateInfo poolInfo{};
+		poolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+		poolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+		poolInfo.queryCount = queriesPerFrame * framesInFlight;
+
+		if (vkCreateQueryPool(lveDevice.device(), &poolInfo, nullptr, &queryPool) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create timestamp query pool!");
+		}
+	}
+
+	LVEGpuProfiler::~LVEGpuProfiler() {
+		if (queryPool != VK_NULL_HANDLE) {
+			VkDevice device = lveDevice.device();
+			VkQueryPool pool = queryPool;
+			lveDevice.retire([device, pool]() { vkDestroyQueryPool(device, pool, nullptr); });
+		}
+	}
+
+	void LVEGpuProfiler::beginFrame(VkCommandBuffer commandBuffer, int frameIndex) {
+		currentFrame = -1;
+		if (!isEnabled()) {
+			//关闭期间没有重置查询，重新打开时不能把旧结果再统计一次
+			frames[frameIndex].recorded = false;
+			return;
+		}
+
+		currentFrame = frameIndex;
+		FrameQueries& frame = frames[frameIndex];
+		uint32_t firstQuery = static_cast<uint32_t>(frameIndex) * queriesPerFrame;
+
+		//这个槽位上一轮的命令缓冲区已经执行完，结果一定可用
+		if (frame.recorded) {
+			collectResults(frame, firstQuery);
+		}
+
+		frame.scopes.clear();
+		frame.queryCount = 0;
+		frame.recorded = true;
+		openScopes.clear();
+
+		//查询在使用前必须重置，而且不能在渲染通道内重置
+		vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, queriesPerFrame);
+		frameScope = beginScope(commandBuffer, "Frame");
+	}
+
+	void LVEGpuProfiler::endFrame(VkCommandBuffer commandBuffer) {
+		if (currentFrame < 0) {
+			return;
+		}
+		//漏掉 endScope 的范围在这里统一结束，避免读取未写入的查询
+		while (!openScopes.empty()) {
+			endScope(commandBuffer, openScopes.back());
+		}
+		frameScope = INVALID_SCOPE;
+		currentFrame = -1;
+	}
+
+	uint32_t LVEGpuProfiler::beginScope(VkCommandBuffer commandBuffer, const char* name) {
+		if (currentFrame < 0) {
+			return INVALID_SCOPE;
+		}
+		FrameQueries& frame = frames[currentFrame];
+		if (frame.scopes.size() >= maxScopesPerFrame) {
+			return INVALID_SCOPE;
+		}
+
+		uint32_t firstQuery = static_cast<uint32_t>(currentFrame) * queriesPerFrame;
+		ScopeRecord record{};
+		record.name = name;
+		record.depth = static_cast<uint32_t>(openScopes.size());
+		record.beginQuery = firstQuery + frame.queryCount++;
+		record.endQuery = firstQuery + frame.queryCount++;
+		record.ended = false;
+
+		//TOP_OF_PIPE：前面的命令都已经开始执行时写入
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, record.beginQuery);
+
+		uint32_t scope = static_cast<uint32_t>(frame.scopes.size());
+		frame.scopes.push_back(std::move(record));
+		openScopes.push_back(scope);
+		return scope;
+	}
+
+	void LVEGpuProfiler::endScope(VkCommandBuffer commandBuffer, uint32_t scope) {
+		if (currentFrame < 0 || scope == INVALID_SCOPE) {
+			return;
+		}
+		FrameQueries& frame = frames[currentFrame];
+		assert(scope < frame.scopes.size() && "Invalid gpu profiler scope");
+		assert(!openScopes.empty() && openScopes.back() == scope && "Gpu profiler scopes must be properly nested");
+
+		ScopeRecord& record = frame.scopes[scope];
+		//BOTTOM_OF_PIPE：前面的命令全部执行完时写入
+		vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, record.endQuery);
+		record.ended = true;
+		openScopes.pop_back();
+	}
+
+	void LVEGpuProfiler::collectResults(FrameQueries& frame, uint32_t firstQuery) {
+		if (frame.queryCount == 0) {
+			return;
+		}
+
+		//每个查询两个 64 位值：时间戳和可用性，不带 WAIT 标志，没写入的查询直接跳过
+		std::vector<uint64_t> results(static_cast<size_t>(frame.queryCount) * 2);
+		VkResult result = vkGetQueryPoolResults(
+			lveDevice.device(),
+			queryPool,
+			firstQuery,
+			frame.queryCount,
+			results.size() * sizeof(uint64_t),
+			results.data(),
+			sizeof(uint64_t) * 2,
+			VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+		if (result != VK_SUCCESS && result != VK_NOT_READY) {
+			return;
+		}
+
+		for (const auto& record : frame.scopes) {
+			if (!record.ended) {
+				continue;
+			}
+			size_t beginIndex = static_cast<size_t>(record.beginQuery - firstQuery) * 2;
+			size_t endIndex = static_cast<size_t>(record.endQuery - firstQuery) * 2;
+			if (results[beginIndex + 1] == 0 || results[endIndex + 1] == 0) {
+				continue;
+			}
+
+			uint64_t begin = results[beginIndex] & timestampMask;
+			uint64_t end = results[endIndex] & timestampMask;
+			uint64_t ticks = end >= begin ? end - begin : 0;
+			double ms = static_cast<double>(ticks) * timestampPeriodNs / 1000000.0;
+
+			auto it = history.find(record.name);
+			if (it == history.end()) {
+				ScopeHistory scopeHistory{};
+				scopeHistory.order = history.size();
+				it = history.emplace(record.name, std::move(scopeHistory)).first;
+			}
+			if (record.depth == 0) {
+				lastFrameMs = ms;
+			}
+			it->second.depth = record.depth;
+			it->second.samples.push_back(ms);
+			while (it->second.samples.size() > historySize) {
+				it->second.samples.pop_front();
+			}
+		}
+	}
+
+	std::vector<GpuScopeStats> LVEGpuProfiler::getStats() const {
+		std::vector<GpuScopeStats> stats(history.size());
+		for (const auto& kv : history) {
+			const ScopeHistory& scopeHistory = kv.second;
+			GpuScopeStats& scopeStats = stats[scopeHistory.order];
+			scopeStats.name = kv.first;
+			scopeStats.depth = scopeHistory.depth;
+			scopeStats.sampleCount = static_cast<uint32_t>(scopeHistory.samples.size());
+			if (scopeHistory.samples.empty()) {
+				continue;
+			}
+
+			std::vector<double> sorted(scopeHistory.samples.begin(), scopeHistory.samples.end());
+			std::sort(sorted.begin(), sorted.end());
+			double total = 0.0;
+			for (double ms : sorted) {
+				total += ms;
+			}
+			scopeStats.lastMs = scopeHistory.samples.back();
+			scopeStats.averageMs = total / static_cast<double>(sorted.size());
+			scopeStats.p50Ms = percentileOfSorted(sorted, 0.50);
+			scopeStats.p95Ms = percentileOfSorted(sorted, 0.95);
+			scopeStats.p99Ms = percentileOfSorted(sorted, 0.99);
+			scopeStats.maxMs = sorted.back();
+		}
+		return stats;
+	}
+
+	void LVEGpuProfiler::reset() {
+		history.clear();
+		lastFrameMs = 0.0;
+	}
+
+}  // namespace lve
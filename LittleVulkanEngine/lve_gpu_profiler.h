@@ -0,0 +1,130 @@
+#pragma once
+
+#include "lve_device.h"
+
+// std
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+	//单个命名范围的 GPU 耗时统计，单位毫秒
+	struct GpuScopeStats {
+		std::string name;
+		uint32_t depth = 0;			//嵌套深度，0 为最外层（整帧）
+		uint32_t sampleCount = 0;
+		double lastMs = 0.0;
+		double averageMs = 0.0;
+		double p50Ms = 0.0;
+		double p95Ms = 0.0;
+		double p99Ms = 0.0;
+		double maxMs = 0.0;
+	};
+
+	//基于时间戳查询池的 GPU 分析器：每个帧槽位一段查询，范围开始/结束各写一个 vkCmdWriteTimestamp。
+	//结果在同一个帧槽位下一次被复用时读取（渲染器在 beginFrame 已经等过这个槽位的时间线值），
+	//所以读回晚 framesInFlight 帧，但永远不会阻塞。
+	class LVEGpuProfiler {
+	public:
+		static constexpr uint32_t DEFAULT_MAX_SCOPES_PER_FRAME = 64;
+		static constexpr uint32_t INVALID_SCOPE = UINT32_MAX;
+
+		LVEGpuProfiler(
+			LVEDevice& device,
+			uint32_t framesInFlight,
+			uint32_t maxScopesPerFrame = DEFAULT_MAX_SCOPES_PER_FRAME);
+		~LVEGpuProfiler();
+
+		LVEGpuProfiler(const LVEGpuProfiler&) = delete;
+		LVEGpuProfiler& operator=(const LVEGpuProfiler&) = delete;
+
+		//队列不支持时间戳时所有调用都是空操作
+		bool isSupported() const { return queryPool != VK_NULL_HANDLE; }
+		void setEnabled(bool enabled) { this->enabled = enabled; }
+		bool isEnabled() const { return enabled && isSupported(); }
+
+		//渲染器在 vkBeginCommandBuffer 之后调用：收集这个槽位上一轮的结果、重置查询并开始 "Frame" 范围
+		void beginFrame(VkCommandBuffer commandBuffer, int frameIndex);
+		//渲染器在 vkEndCommandBuffer 之前调用
+		void endFrame(VkCommandBuffer commandBuffer);
+
+		//返回范围编号，交给 endScope。超出每帧上限时返回 INVALID_SCOPE，endScope 会忽略它
+		uint32_t beginScope(VkCommandBuffer commandBuffer, const char* name);
+		void endScope(VkCommandBuffer commandBuffer, uint32_t scope);
+
+		//按第一次出现的顺序返回所有范围的滚动统计
+		std::vector<GpuScopeStats> getStats() const;
+		//最近一次读回的整帧 GPU 耗时，没有数据时为 0
+		double getLastFrameMs() const { return lastFrameMs; }
+		void setHistorySize(size_t size) { historySize = size; }
+		void reset();
+
+	private:
+		struct ScopeRecord {
+			std::string name;
+			uint32_t depth;
+			uint32_t beginQuery;
+			uint32_t endQuery;
+			bool ended;
+		};
+
+		struct FrameQueries {
+			std::vector<ScopeRecord> scopes;
+			uint32_t queryCount = 0;
+			bool recorded = false;
+		};
+
+		struct ScopeHistory {
+			uint32_t depth = 0;
+			size_t order = 0;
+			std::deque<double> samples;
+		};
+
+		void collectResults(FrameQueries& frame, uint32_t firstQuery);
+
+		LVEDevice& lveDevice;
+		VkQueryPool queryPool = VK_NULL_HANDLE;
+		uint32_t maxScopesPerFrame;
+		uint32_t queriesPerFrame;
+		double timestampPeriodNs;
+		uint64_t timestampMask;
+		bool enabled = true;
+
+		std::vector<FrameQueries> frames;
+		int currentFrame = -1;
+		std::vector<uint32_t> openScopes;
+		uint32_t frameScope = INVALID_SCOPE;
+
+		std::unordered_map<std::string, ScopeHistory> history;
+		size_t historySize = 240;
+		double lastFrameMs = 0.0;
+	};
+
+	//RAII 辅助：作用域结束时自动 endScope，profiler 为空指针时什么也不做
+	class LVEGpuScope {
+	public:
+		LVEGpuScope(LVEGpuProfiler* profiler, VkCommandBuffer commandBuffer, const char* name)
+			: profiler{ profiler }, commandBuffer{ commandBuffer } {
+			if (profiler != nullptr) {
+				scope = profiler->beginScope(commandBuffer, name);
+			}
+		}
+		~LVEGpuScope() {
+			if (profiler != nullptr) {
+				profiler->endScope(commandBuffer, scope);
+			}
+		}
+
+		LVEGpuScope(const LVEGpuScope&) = delete;
+		LVEGpuScope& operator=(const LVEGpuScope&) = delete;
+
+	private:
+		LVEGpuProfiler* profiler;
+		VkCommandBuffer commandBuffer;
+		uint32_t scope = LVEGpuProfiler::INVALID_SCOPE;
+	};
+
+}  // namespace lve
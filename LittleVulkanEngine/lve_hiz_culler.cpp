@@ -0,0 +1,709 @@
+#include "lve_hiz_culler.h"
+
+#include "lve_profiler.h"
+#include "lve_transform_system.h"
+
+// std
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstring>
+#include <filesystem>
+#include <stdexcept>
+
+namespace lve {
+
+	static const char* CULL_SHADER_PATH = "E:/opengl/HalCG/LittleVulkanEngine/LittleVulkanEngine/shaders/hiz_cull.comp.spv";
+	static const char* REDUCE_SHADER_PATH = "E:/opengl/HalCG/LittleVulkanEngine/LittleVulkanEngine/shaders/hiz_reduce.comp.spv";
+	static const char* DRAW_VERT_SHADER_PATH = "E:/opengl/HalCG/LittleVulkanEngine/LittleVulkanEngine/shaders/hiz_indirect.vert.spv";
+	static const char* DRAW_FRAG_SHADER_PATH = "E:/opengl/HalCG/LittleVulkanEngine/LittleVulkanEngine/shaders/hiz_indirect.frag.spv";
+
+	//与 hiz_cull.comp 的 push_constant 布局一致
+	struct HiZCullPushConstants {
+		glm::mat4 projectionView{ 1.f };
+		glm::vec2 depthSize{ 0.f };
+		uint32_t objectCount = 0;
+		uint32_t phase = 0;	//0 为第一阶段，1 为第二阶段
+		uint32_t pyramidLevels = 0;
+	};
+
+	//与 hiz_reduce.comp 的 push_constant 布局一致
+	struct HiZReducePushConstants {
+		glm::uvec2 srcSize{ 0 };
+		glm::uvec2 dstSize{ 0 };
+	};
+
+	//GPU 写回的计数，顺序与 hiz_cull.comp 中的 Stats 一致
+	struct HiZStatsData {
+		uint32_t earlyDrawn;
+		uint32_t lateDrawn;
+		uint32_t visible;
+		uint32_t frustumCulled;
+		uint32_t occluded;
+	};
+
+	static constexpr uint32_t MIN_OBJECT_CAPACITY = 256;
+
+	static bool hasStencilComponent(VkFormat format) {
+		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+	}
+
+	static void memoryBarrier(
+		VkCommandBuffer commandBuffer,
+		VkPipelineStageFlags srcStage, VkAccessFlags srcAccess,
+		VkPipelineStageFlags dstStage, VkAccessFlags dstAccess) {
+		VkMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+		barrier.srcAccessMask = srcAccess;
+		barrier.dstAccessMask = dstAccess;
+		vkCmdPipelineBarrier(commandBuffer, srcStage, dstStage, 0, 1, &barrier, 0, nullptr, 0, nullptr);
+	}
+
+	LVEHiZCuller::LVEHiZCuller(
+		LVEDevice& device,
+		LVEPipelineRegistry& pipelineRegistry,
+		const LVEPipelineTarget& target,
+		VkDescriptorSetLayout globalSetLayout,
+		uint32_t framesInFlight)
+		: lveDevice{ device }, lvePipelineRegistry{ pipelineRegistry }, frames(framesInFlight)
+	{
+		createDescriptorResources();
+		createPipelines(target, globalSetLayout);
+		createSampler();
+		ensureVisibilityCapacity(MIN_OBJECT_CAPACITY);
+		for (auto& frame : frames) {
+			frame.statsBuffer = std::make_unique<LVEBuffer>(
+				lveDevice,
+				sizeof(HiZStatsData),
+				1,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			frame.statsBuffer->map();
+			std::memset(frame.statsBuffer->getMappedMemory(), 0, sizeof(HiZStatsData));
+			ensureCapacity(frame, MIN_OBJECT_CAPACITY);
+		}
+	}
+
+	//缓冲区、描述符池和管线自己会进入延迟销毁队列，这里只需要处理裸的 Vulkan 对象
+	//着色器二进制不在时构造函数会在创建了一半资源之后抛出异常，所以提前检查
+	bool LVEHiZCuller::isSupported(LVEDevice& device) {
+		if (!device.supportsDrawIndirectFirstInstance()) {
+			return false;
+		}
+		for (const char* path : { CULL_SHADER_PATH, REDUCE_SHADER_PATH, DRAW_VERT_SHADER_PATH, DRAW_FRAG_SHADER_PATH }) {
+			std::error_code error;
+			if (!std::filesystem::is_regular_file(path, error)) {
+				return false;
+			}
+		}
+		return true;
+	}
+
+	LVEHiZCuller::~LVEHiZCuller() {
+		drawPipeline.wait();
+		for (auto& frame : frames) {
+			destroyPyramid(frame);
+		}
+		VkDevice device = lveDevice.device();
+		VkPipelineLayout layouts[] = { drawPipelineLayout, cullPipelineLayout, reducePipelineLayout };
+		for (VkPipelineLayout layout : layouts) {
+			lveDevice.notifyHandleDestroyed(layout);
+		}
+		VkSampler sampler = pyramidSampler;
+		lveDevice.retire([device, layouts, sampler]() {
+			for (VkPipelineLayout layout : layouts) {
+				vkDestroyPipelineLayout(device, layout, nullptr);
+			}
+			vkDestroySampler(device, sampler, nullptr);
+		});
+	}
+
+	void LVEHiZCuller::createDescriptorResources() {
+		uint32_t frameCount = static_cast<uint32_t>(frames.size());
+		descriptorPool =
+			LVEDescriptorPool::Builder(lveDevice)
+			.setMaxSets(frameCount * (2 + MAX_PYRAMID_LEVELS))
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, frameCount * 6)
+			.addPoolSize(VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, frameCount * (1 + MAX_PYRAMID_LEVELS))
+			.addPoolSize(VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, frameCount * MAX_PYRAMID_LEVELS)
+			.build();
+
+		objectSetLayout =
+			LVEDescriptorSetLayout::Builder(lveDevice)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_VERTEX_BIT)
+			.build();
+		cullSetLayout =
+			LVEDescriptorSetLayout::Builder(lveDevice)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)		//物体数据
+			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)		//第一阶段的绘制命令
+			.addBinding(2, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)		//第二阶段的绘制命令
+			.addBinding(3, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)		//按槽位的可见性
+			.addBinding(4, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, VK_SHADER_STAGE_COMPUTE_BIT)		//计数
+			.addBinding(5, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)	//深度金字塔
+			.build();
+		reduceSetLayout =
+			LVEDescriptorSetLayout::Builder(lveDevice)
+			.addBinding(0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, VK_SHADER_STAGE_COMPUTE_BIT)
+			.addBinding(1, VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, VK_SHADER_STAGE_COMPUTE_BIT)
+			.build();
+
+		for (auto& frame : frames) {
+			if (!descriptorPool->allocateDescriptor(objectSetLayout->getDescriptorSetLayout(), frame.objectSet) ||
+				!descriptorPool->allocateDescriptor(cullSetLayout->getDescriptorSetLayout(), frame.cullSet)) {
+				throw std::runtime_error("failed to allocate hi-z descriptor sets!");
+			}
+			frame.reduceSets.resize(MAX_PYRAMID_LEVELS);
+			for (auto& set : frame.reduceSets) {
+				if (!descriptorPool->allocateDescriptor(reduceSetLayout->getDescriptorSetLayout(), set)) {
+					throw std::runtime_error("failed to allocate hi-z descriptor sets!");
+				}
+			}
+		}
+	}
+
+	void LVEHiZCuller::createPipelines(const LVEPipelineTarget& target, VkDescriptorSetLayout globalSetLayout) {
+		std::array<VkDescriptorSetLayout, 2> drawSetLayouts{ globalSetLayout, objectSetLayout->getDescriptorSetLayout() };
+		VkPipelineLayoutCreateInfo layoutInfo{};
+		layoutInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO;
+		layoutInfo.setLayoutCount = static_cast<uint32_t>(drawSetLayouts.size());
+		layoutInfo.pSetLayouts = drawSetLayouts.data();
+		if (vkCreatePipelineLayout(lveDevice.device(), &layoutInfo, nullptr, &drawPipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+
+		VkPushConstantRange pushConstantRange{};
+		pushConstantRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+		pushConstantRange.offset = 0;
+
+		VkDescriptorSetLayout cullSetLayoutHandle = cullSetLayout->getDescriptorSetLayout();
+		pushConstantRange.size = sizeof(HiZCullPushConstants);
+		layoutInfo.setLayoutCount = 1;
+		layoutInfo.pSetLayouts = &cullSetLayoutHandle;
+		layoutInfo.pushConstantRangeCount = 1;
+		layoutInfo.pPushConstantRanges = &pushConstantRange;
+		if (vkCreatePipelineLayout(lveDevice.device(), &layoutInfo, nullptr, &cullPipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+
+		VkDescriptorSetLayout reduceSetLayoutHandle = reduceSetLayout->getDescriptorSetLayout();
+		pushConstantRange.size = sizeof(HiZReducePushConstants);
+		layoutInfo.pSetLayouts = &reduceSetLayoutHandle;
+		if (vkCreatePipelineLayout(lveDevice.device(), &layoutInfo, nullptr, &reducePipelineLayout) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline layout!");
+		}
+
+		cullPipeline = std::make_unique<LVEComputePipeline>(lveDevice, CULL_SHADER_PATH, cullPipelineLayout);
+		reducePipeline = std::make_unique<LVEComputePipeline>(lveDevice, REDUCE_SHADER_PATH, reducePipelineLayout);
+
+		//两个渲染通道相互兼容（动态渲染时附件格式相同），用第一个创建的管线也能在保留内容的渲染通道里使用
+		PipelineConfigInfo pipelineConfig{};
+		LVEPipeline::defaultPipelineConfigInfo(pipelineConfig);
+		target.applyTo(pipelineConfig);
+		pipelineConfig.pipelineLayout = drawPipelineLayout;
+		drawPipeline = lvePipelineRegistry.requestPipeline(DRAW_VERT_SHADER_PATH, DRAW_FRAG_SHADER_PATH, pipelineConfig);
+	}
+
+	//金字塔只用 texelFetch 读取，采样器的过滤方式不起作用，但组合图像采样器描述符必须有一个
+	void LVEHiZCuller::createSampler() {
+		VkSamplerCreateInfo samplerInfo{};
+		samplerInfo.sType = VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO;
+		samplerInfo.magFilter = VK_FILTER_NEAREST;
+		samplerInfo.minFilter = VK_FILTER_NEAREST;
+		samplerInfo.mipmapMode = VK_SAMPLER_MIPMAP_MODE_NEAREST;
+		samplerInfo.addressModeU = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeV = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.addressModeW = VK_SAMPLER_ADDRESS_MODE_CLAMP_TO_EDGE;
+		samplerInfo.minLod = 0.f;
+		samplerInfo.maxLod = VK_LOD_CLAMP_NONE;
+		if (vkCreateSampler(lveDevice.device(), &samplerInfo, nullptr, &pyramidSampler) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create hi-z sampler!");
+		}
+	}
+
+	//容量按 2 的幂增长。旧缓冲区可能还在已提交的帧里，LVEBuffer 析构时会延迟释放
+	void LVEHiZCuller::ensureCapacity(FrameResources& frame, uint32_t objectCount) {
+		if (objectCount <= frame.capacity) {
+			return;
+		}
+		uint32_t capacity = std::max(frame.capacity, MIN_OBJECT_CAPACITY);
+		while (capacity < objectCount) {
+			capacity *= 2;
+		}
+		frame.capacity = capacity;
+
+		frame.objectBuffer = std::make_unique<LVEBuffer>(
+			lveDevice,
+			sizeof(GpuObjectData),
+			capacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+			VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+		frame.objectBuffer->map();
+		for (auto* commands : { &frame.earlyCommandBuffer, &frame.lateCommandBuffer }) {
+			*commands = std::make_unique<LVEBuffer>(
+				lveDevice,
+				sizeof(IndirectCommand),
+				capacity,
+				VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT);
+			(*commands)->map();
+		}
+
+		auto objectInfo = frame.objectBuffer->descriptorInfo();
+		LVEDescriptorWriter(*objectSetLayout, *descriptorPool)
+			.writeBuffer(0, &objectInfo)
+			.overwrite(frame.objectSet);
+		writeCullSet(frame);
+	}
+
+	//可见性缓冲区换新之后内容全部清零：所有物体都交给第二阶段判断，相当于一次冷启动
+	void LVEHiZCuller::ensureVisibilityCapacity(uint32_t slotCount) {
+		if (slotCount <= visibilityCapacity) {
+			return;
+		}
+		uint32_t capacity = std::max(visibilityCapacity, MIN_OBJECT_CAPACITY);
+		while (capacity < slotCount) {
+			capacity *= 2;
+		}
+		visibilityCapacity = capacity;
+		visibilityBuffer = std::make_unique<LVEBuffer>(
+			lveDevice,
+			sizeof(uint32_t),
+			capacity,
+			VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+			VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		visibilityVersion++;
+		visibilityNeedsClear = true;
+	}
+
+	void LVEHiZCuller::writeCullSet(FrameResources& frame) {
+		auto objectInfo = frame.objectBuffer->descriptorInfo();
+		auto earlyInfo = frame.earlyCommandBuffer->descriptorInfo();
+		auto lateInfo = frame.lateCommandBuffer->descriptorInfo();
+		auto visibilityInfo = visibilityBuffer->descriptorInfo();
+		auto statsInfo = frame.statsBuffer->descriptorInfo();
+		LVEDescriptorWriter writer{ *cullSetLayout, *descriptorPool };
+		writer.writeBuffer(0, &objectInfo)
+			.writeBuffer(1, &earlyInfo)
+			.writeBuffer(2, &lateInfo)
+			.writeBuffer(3, &visibilityInfo)
+			.writeBuffer(4, &statsInfo);
+
+		//金字塔第一次使用前还不存在，cullLate 创建它之后会再写一次
+		VkDescriptorImageInfo pyramidInfo{};
+		if (frame.pyramidView != VK_NULL_HANDLE) {
+			pyramidInfo.sampler = pyramidSampler;
+			pyramidInfo.imageView = frame.pyramidView;
+			pyramidInfo.imageLayout = VK_IMAGE_LAYOUT_GENERAL;
+			writer.writeImage(5, &pyramidInfo);
+		}
+		writer.overwrite(frame.cullSet);
+		frame.visibilityVersion = visibilityVersion;
+	}
+
+	//金字塔第 0 级是深度附件尺寸的一半（向上取整），之后每级再减半，直到 1x1
+	void LVEHiZCuller::ensurePyramid(FrameResources& frame, VkExtent2D sourceExtent) {
+		if (frame.pyramidImage != VK_NULL_HANDLE &&
+			frame.pyramidSourceExtent.width == sourceExtent.width &&
+			frame.pyramidSourceExtent.height == sourceExtent.height) {
+			return;
+		}
+		destroyPyramid(frame);
+		frame.pyramidSourceExtent = sourceExtent;
+
+		uint32_t width = std::max(1u, (sourceExtent.width + 1) / 2);
+		uint32_t height = std::max(1u, (sourceExtent.height + 1) / 2);
+		uint32_t levels = 1;
+		for (uint32_t w = width, h = height; (w > 1 || h > 1) && levels < MAX_PYRAMID_LEVELS; levels++) {
+			w = std::max(1u, (w + 1) / 2);
+			h = std::max(1u, (h + 1) / 2);
+		}
+		frame.pyramidLevels = levels;
+
+		VkImageCreateInfo imageInfo{};
+		imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+		imageInfo.imageType = VK_IMAGE_TYPE_2D;
+		imageInfo.extent = { width, height, 1 };
+		imageInfo.mipLevels = levels;
+		imageInfo.arrayLayers = 1;
+		imageInfo.format = VK_FORMAT_R32_SFLOAT;
+		imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+		imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		imageInfo.usage = VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+		imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+		imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+		lveDevice.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, frame.pyramidImage, frame.pyramidMemory);
+
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = frame.pyramidImage;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = VK_FORMAT_R32_SFLOAT;
+		viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = levels;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &frame.pyramidView) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create hi-z image view!");
+		}
+
+		frame.pyramidLevelViews.resize(levels);
+		viewInfo.subresourceRange.levelCount = 1;
+		for (uint32_t level = 0; level < levels; level++) {
+			viewInfo.subresourceRange.baseMipLevel = level;
+			if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &frame.pyramidLevelViews[level]) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create hi-z image view!");
+			}
+		}
+
+		//第 n 级从第 n - 1 级读取；第 0 级的来源是每帧不同的深度附件，在 buildPyramid 中写
+		for (uint32_t level = 1; level < levels; level++) {
+			VkDescriptorImageInfo srcInfo{ pyramidSampler, frame.pyramidLevelViews[level - 1], VK_IMAGE_LAYOUT_GENERAL };
+			VkDescriptorImageInfo dstInfo{ VK_NULL_HANDLE, frame.pyramidLevelViews[level], VK_IMAGE_LAYOUT_GENERAL };
+			LVEDescriptorWriter(*reduceSetLayout, *descriptorPool)
+				.writeImage(0, &srcInfo)
+				.writeImage(1, &dstInfo)
+				.overwrite(frame.reduceSets[level]);
+		}
+		writeCullSet(frame);
+	}
+
+	void LVEHiZCuller::destroyPyramid(FrameResources& frame) {
+		if (frame.pyramidImage == VK_NULL_HANDLE) {
+			return;
+		}
+		VkDevice device = lveDevice.device();
+		std::vector<VkImageView> levelViews = std::move(frame.pyramidLevelViews);
+		lveDevice.retire([device, levelViews]() {
+			for (VkImageView view : levelViews) {
+				vkDestroyImageView(device, view, nullptr);
+			}
+		});
+		lveDevice.retireImage(frame.pyramidImage, frame.pyramidMemory, frame.pyramidView);
+		frame.pyramidImage = VK_NULL_HANDLE;
+		frame.pyramidMemory = VK_NULL_HANDLE;
+		frame.pyramidView = VK_NULL_HANDLE;
+		frame.pyramidLevelViews.clear();
+		frame.pyramidLevels = 0;
+	}
+
+	//渲染器在 beginFrame 中已经等这个帧槽位上一轮的提交完成，计数可以直接读取
+	void LVEHiZCuller::readStats(FrameResources& frame, FrameInfo& frameInfo) {
+		auto* data = static_cast<HiZStatsData*>(frame.statsBuffer->getMappedMemory());
+		if (frame.statsPending) {
+			lastStats.earlyDrawn = data->earlyDrawn;
+			lastStats.lateDrawn = data->lateDrawn;
+			lastStats.visible = data->visible;
+			lastStats.frustumCulled = data->frustumCulled;
+			lastStats.occluded = data->occluded;
+			frame.statsPending = false;
+		}
+		std::memset(data, 0, sizeof(HiZStatsData));
+		if (frameInfo.frameStats != nullptr) {
+			frameInfo.frameStats->setCullingCounts(lastStats.visible, lastStats.frustumCulled + lastStats.occluded);
+		}
+	}
+
+	//按模型分组：第一遍统计每个模型的物体数量，第二遍把物体放到所属批次的连续区间里
+	void LVEHiZCuller::uploadObjects(
+		FrameResources& frame, FrameInfo& frameInfo, LVEWorld& world, const LVESceneIndex& sceneIndex) {
+		LVE_PROFILE_FUNCTION();
+		const LVETransformSystem& transformSystem = *frameInfo.transformSystem;
+
+		batches.clear();
+		batchLookup.clear();
+		entityBatches.clear();
+		LVEModel* lastModel = nullptr;
+		uint32_t lastBatch = 0;
+		world.forEachChunk<ModelComponent, TransformSlotComponent>(
+			[&](uint32_t count, const LVEEntity*, ModelComponent* models, TransformSlotComponent*) {
+				for (uint32_t i = 0; i < count; i++) {
+					LVEModel* model = models[i].model.get();
+					//同一个块里相邻实体经常共用模型，先和上一个比较，省掉哈希查找
+					if (model != lastModel) {
+						auto [it, inserted] = batchLookup.try_emplace(model, static_cast<uint32_t>(batches.size()));
+						if (inserted) {
+							batches.push_back({ model, 0, 0 });
+						}
+						lastModel = model;
+						lastBatch = it->second;
+					}
+					batches[lastBatch].commandCount++;
+					entityBatches.push_back(lastBatch);
+				}
+			});
+
+		uint32_t objectCount = static_cast<uint32_t>(entityBatches.size());
+		uint32_t firstCommand = 0;
+		for (auto& batch : batches) {
+			batch.firstCommand = firstCommand;
+			firstCommand += batch.commandCount;
+		}
+
+		ensureCapacity(frame, objectCount);
+		objectScratch.resize(objectCount);
+		commandScratch.resize(objectCount);
+
+		//cursor 借用 commandCount：先清零，边放边加回来
+		for (auto& batch : batches) {
+			batch.commandCount = 0;
+		}
+		uint32_t entityIndex = 0;
+		world.forEachChunk<ModelComponent, TransformSlotComponent>(
+			[&](uint32_t count, const LVEEntity*, ModelComponent* models, TransformSlotComponent* slots) {
+				for (uint32_t i = 0; i < count; i++, entityIndex++) {
+					DrawBatch& batch = batches[entityBatches[entityIndex]];
+					uint32_t index = batch.firstCommand + batch.commandCount++;
+					uint32_t slot = slots[i].slot;
+
+					GpuObjectData& object = objectScratch[index];
+					object.modelMatrix = transformSystem.getModelMatrix(slot);
+					object.normalMatrix = transformSystem.getNormalMatrix(slot);
+					const LVEAabb* bounds = sceneIndex.tryGetWorldBounds(slot);
+					LVEAabb worldBounds = bounds != nullptr
+						? *bounds
+						: models[i].model->getBoundingBox().transformed(object.modelMatrix);
+					object.boundsMin = glm::vec4{ worldBounds.min, 1.f };
+					object.boundsMax = glm::vec4{ worldBounds.max, 1.f };
+					object.info = glm::uvec4{ slot, 0, 0, 0 };
+
+					const LVEModel& model = *models[i].model;
+					IndirectCommand& command = commandScratch[index];
+					command.instanceCount = 0;
+					command.first = 0;
+					command.firstInstance = index;
+					if (model.hasIndices()) {
+						command.count = model.getIndexCount();
+						command.vertexOffset = 0;
+					}
+					else {
+						command.count = model.getVertexCount();
+						command.vertexOffset = static_cast<int32_t>(index);
+					}
+				}
+			});
+		frame.objectCount = objectCount;
+		if (objectCount == 0) {
+			return;
+		}
+
+		VkDeviceSize objectBytes = sizeof(GpuObjectData) * objectCount;
+		VkDeviceSize commandBytes = sizeof(IndirectCommand) * objectCount;
+		frame.objectBuffer->writeToBuffer(objectScratch.data(), objectBytes);
+		frame.objectBuffer->flush();
+		frame.earlyCommandBuffer->writeToBuffer(commandScratch.data(), commandBytes);
+		frame.earlyCommandBuffer->flush();
+		frame.lateCommandBuffer->writeToBuffer(commandScratch.data(), commandBytes);
+		frame.lateCommandBuffer->flush();
+	}
+
+	void LVEHiZCuller::beginFrame(FrameInfo& frameInfo, LVEWorld& world, const LVESceneIndex& sceneIndex) {
+		LVE_PROFILE_FUNCTION();
+		assert(frameInfo.transformSystem != nullptr && "LVEHiZCuller requires frameInfo.transformSystem");
+		FrameResources& frame = frames[frameInfo.frameIndex];
+		readStats(frame, frameInfo);
+		ensureVisibilityCapacity(frameInfo.transformSystem->size());
+		uploadObjects(frame, frameInfo, world, sceneIndex);
+		if (frame.visibilityVersion != visibilityVersion) {
+			writeCullSet(frame);
+		}
+
+		VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+		LVEGpuScope gpuScope{ frameInfo.gpuProfiler, commandBuffer, "HiZEarlyCull" };
+		if (visibilityNeedsClear) {
+			visibilityNeedsClear = false;
+			//之前的帧可能还在读写旧的内容
+			memoryBarrier(
+				commandBuffer,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT);
+			vkCmdFillBuffer(commandBuffer, visibilityBuffer->getBuffer(), 0, VK_WHOLE_SIZE, 0);
+			memoryBarrier(
+				commandBuffer,
+				VK_PIPELINE_STAGE_TRANSFER_BIT, VK_ACCESS_TRANSFER_WRITE_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		}
+		else {
+			//上一帧第二阶段写入的可见性（同一个队列上更早的提交）
+			memoryBarrier(
+				commandBuffer,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT);
+		}
+		if (frame.objectCount == 0) {
+			return;
+		}
+
+		dispatchCull(frameInfo, frame, 0, VkExtent2D{ 0, 0 });
+		frame.statsPending = true;
+		memoryBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+	}
+
+	void LVEHiZCuller::dispatchCull(FrameInfo& frameInfo, FrameResources& frame, uint32_t phase, VkExtent2D depthExtent) {
+		VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+		cullPipeline->bind(commandBuffer);
+		vkCmdBindDescriptorSets(
+			commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cullPipelineLayout, 0, 1, &frame.cullSet, 0, nullptr);
+
+		HiZCullPushConstants push{};
+		push.projectionView = frameInfo.camera.getProjection() * frameInfo.camera.getView();
+		push.depthSize = glm::vec2{ static_cast<float>(depthExtent.width), static_cast<float>(depthExtent.height) };
+		push.objectCount = frame.objectCount;
+		push.phase = phase;
+		push.pyramidLevels = phase == 0 ? 0 : frame.pyramidLevels;
+		vkCmdPushConstants(
+			commandBuffer, cullPipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZCullPushConstants), &push);
+		vkCmdDispatch(commandBuffer, (frame.objectCount + CULL_WORKGROUP_SIZE - 1) / CULL_WORKGROUP_SIZE, 1, 1);
+	}
+
+	void LVEHiZCuller::drawEarly(FrameInfo& frameInfo) {
+		FrameResources& frame = frames[frameInfo.frameIndex];
+		drawPhase(frameInfo, *frame.earlyCommandBuffer, "HiZEarlyDraw");
+	}
+
+	void LVEHiZCuller::drawLate(FrameInfo& frameInfo) {
+		FrameResources& frame = frames[frameInfo.frameIndex];
+		drawPhase(frameInfo, *frame.lateCommandBuffer, "HiZLateDraw");
+	}
+
+	//被剔除的命令 instanceCount 为 0，GPU 直接跳过。不支持 multiDrawIndirect 时逐条提交
+	void LVEHiZCuller::drawPhase(FrameInfo& frameInfo, LVEBuffer& commands, const char* scopeName) {
+		LVE_PROFILE_FUNCTION();
+		LVEPipeline* pipeline = drawPipeline.tryGet();
+		if (pipeline == nullptr || frames[frameInfo.frameIndex].objectCount == 0) {
+			return;
+		}
+		VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+		LVEGpuScope gpuScope{ frameInfo.gpuProfiler, commandBuffer, scopeName };
+		pipeline->bind(commandBuffer);
+		std::array<VkDescriptorSet, 2> sets{ frameInfo.globalDescriptorSet, frames[frameInfo.frameIndex].objectSet };
+		vkCmdBindDescriptorSets(
+			commandBuffer,
+			VK_PIPELINE_BIND_POINT_GRAPHICS,
+			drawPipelineLayout,
+			0,
+			static_cast<uint32_t>(sets.size()),
+			sets.data(),
+			0,
+			nullptr);
+
+		constexpr uint32_t stride = sizeof(IndirectCommand);
+		bool multiDraw = lveDevice.supportsMultiDrawIndirect();
+		for (const DrawBatch& batch : batches) {
+			batch.model->bind(commandBuffer);
+			VkDeviceSize offset = static_cast<VkDeviceSize>(batch.firstCommand) * stride;
+			if (multiDraw) {
+				batch.model->drawIndirect(commandBuffer, commands.getBuffer(), offset, batch.commandCount, stride);
+			}
+			else {
+				for (uint32_t i = 0; i < batch.commandCount; i++) {
+					batch.model->drawIndirect(commandBuffer, commands.getBuffer(), offset + i * stride, 1, stride);
+				}
+			}
+			//三角形数量取决于 GPU 的剔除结果，CPU 这里不知道
+			if (frameInfo.frameStats != nullptr) {
+				frameInfo.frameStats->addDrawCall(0);
+			}
+		}
+	}
+
+	void LVEHiZCuller::buildPyramid(FrameInfo& frameInfo, FrameResources& frame, const LVEDepthTarget& depthTarget) {
+		VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+		ensurePyramid(frame, depthTarget.extent);
+
+		VkImageAspectFlags depthAspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (hasStencilComponent(depthTarget.format)) {
+			depthAspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+
+		//深度附件转为可采样；金字塔的旧内容不需要保留
+		std::array<VkImageMemoryBarrier, 2> barriers{};
+		barriers[0].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barriers[0].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		barriers[0].dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		barriers[0].oldLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		barriers[0].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[0].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[0].image = depthTarget.image;
+		barriers[0].subresourceRange = { depthAspect, 0, 1, 0, 1 };
+
+		barriers[1].sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barriers[1].srcAccessMask = 0;
+		barriers[1].dstAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+		barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[1].newLayout = VK_IMAGE_LAYOUT_GENERAL;
+		barriers[1].srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[1].dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barriers[1].image = frame.pyramidImage;
+		barriers[1].subresourceRange = { VK_IMAGE_ASPECT_COLOR_BIT, 0, frame.pyramidLevels, 0, 1 };
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			0, 0, nullptr, 0, nullptr,
+			static_cast<uint32_t>(barriers.size()), barriers.data());
+
+		VkDescriptorImageInfo depthInfo{ pyramidSampler, depthTarget.view, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+		VkDescriptorImageInfo level0Info{ VK_NULL_HANDLE, frame.pyramidLevelViews[0], VK_IMAGE_LAYOUT_GENERAL };
+		LVEDescriptorWriter(*reduceSetLayout, *descriptorPool)
+			.writeImage(0, &depthInfo)
+			.writeImage(1, &level0Info)
+			.overwrite(frame.reduceSets[0]);
+
+		reducePipeline->bind(commandBuffer);
+		HiZReducePushConstants push{};
+		push.srcSize = glm::uvec2{ depthTarget.extent.width, depthTarget.extent.height };
+		for (uint32_t level = 0; level < frame.pyramidLevels; level++) {
+			push.dstSize = glm::uvec2{ std::max(1u, (push.srcSize.x + 1) / 2), std::max(1u, (push.srcSize.y + 1) / 2) };
+			vkCmdBindDescriptorSets(
+				commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, reducePipelineLayout, 0, 1, &frame.reduceSets[level], 0, nullptr);
+			vkCmdPushConstants(
+				commandBuffer, reducePipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(HiZReducePushConstants), &push);
+			vkCmdDispatch(
+				commandBuffer,
+				(push.dstSize.x + REDUCE_WORKGROUP_SIZE - 1) / REDUCE_WORKGROUP_SIZE,
+				(push.dstSize.y + REDUCE_WORKGROUP_SIZE - 1) / REDUCE_WORKGROUP_SIZE,
+				1);
+			//下一级（以及最后的剔除）要读这一级的结果
+			memoryBarrier(
+				commandBuffer,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+				VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_READ_BIT);
+			push.srcSize = push.dstSize;
+		}
+
+		//第二个渲染通道继续使用深度附件
+		VkImageMemoryBarrier depthBarrier = barriers[0];
+		depthBarrier.srcAccessMask = VK_ACCESS_SHADER_READ_BIT;
+		depthBarrier.dstAccessMask =
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		depthBarrier.oldLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		depthBarrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+			0, 0, nullptr, 0, nullptr, 1, &depthBarrier);
+	}
+
+	void LVEHiZCuller::cullLate(FrameInfo& frameInfo, const LVEDepthTarget& depthTarget) {
+		LVE_PROFILE_FUNCTION();
+		FrameResources& frame = frames[frameInfo.frameIndex];
+		if (frame.objectCount == 0) {
+			return;
+		}
+		VkCommandBuffer commandBuffer = frameInfo.commandBuffer;
+		LVEGpuScope gpuScope{ frameInfo.gpuProfiler, commandBuffer, "HiZLateCull" };
+		buildPyramid(frameInfo, frame, depthTarget);
+		dispatchCull(frameInfo, frame, 1, depthTarget.extent);
+		memoryBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_ACCESS_SHADER_WRITE_BIT,
+			VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT, VK_ACCESS_INDIRECT_COMMAND_READ_BIT);
+	}
+
+}  // namespace lve
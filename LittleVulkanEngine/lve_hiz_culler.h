@@ -0,0 +1,179 @@
+#pragma once
+
+#include "lve_buffer.h"
+#include "lve_descriptors.h"
+#include "lve_device.h"
+#include "lve_ecs.h"
+#include "lve_frame_info.h"
+#include "lve_model.h"
+#include "lve_pipeline.h"
+#include "lve_pipeline_registry.h"
+#include "lve_renderer.h"
+#include "lve_scene_index.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+	//GPU 剔除的计数，由计算着色器用原子操作累加，回读比当前帧晚 framesInFlight 帧
+	struct LVEGpuCullingStats {
+		uint32_t earlyDrawn = 0;	//第一阶段绘制的物体：上一帧可见并且仍在视锥内
+		uint32_t lateDrawn = 0;		//第二阶段绘制的物体：这一帧新出现的
+		uint32_t visible = 0;		//第二阶段判定可见的物体，也就是下一帧第一阶段的候选
+		uint32_t frustumCulled = 0;
+		uint32_t occluded = 0;
+	};
+
+	//GPU 上的 Hi-Z 两阶段遮挡剔除，不需要把可见性回读到 CPU：
+	//1. 第一阶段：计算着色器挑出上一帧可见、这一帧仍在视锥内的物体，写入间接绘制命令并画出来；
+	//2. 从这一阶段的深度附件用计算着色器逐级取最大值，生成深度金字塔；
+	//3. 第二阶段：所有物体的世界包围盒投影到屏幕，在覆盖不超过 2x2 个像素的那一级金字塔上比较深度，
+	//   被挡住的物体不画，新出现的物体写入第二组间接绘制命令，在保留内容的渲染通道里补画。
+	//每个物体的可见性按变换槽位保存在 GPU 缓冲区里，作为下一帧第一阶段的输入。
+	//物体按模型分组，每个模型一次 vkCmdDrawIndexedIndirect，物体数据通过 firstInstance 在顶点着色器里索引。
+	class LVEHiZCuller {
+	public:
+		static constexpr uint32_t CULL_WORKGROUP_SIZE = 64;
+		static constexpr uint32_t REDUCE_WORKGROUP_SIZE = 8;
+		//深度金字塔的最大级数，足够 65536 像素宽的深度附件
+		static constexpr uint32_t MAX_PYRAMID_LEVELS = 16;
+
+		LVEHiZCuller(
+			LVEDevice& device,
+			LVEPipelineRegistry& pipelineRegistry,
+			const LVEPipelineTarget& target,
+			VkDescriptorSetLayout globalSetLayout,
+			uint32_t framesInFlight);
+		~LVEHiZCuller();
+
+		LVEHiZCuller(const LVEHiZCuller&) = delete;
+		LVEHiZCuller& operator=(const LVEHiZCuller&) = delete;
+
+		//间接绘制命令需要 firstInstance 不为 0，而且 hiz_*.spv 必须已经用 shaders/compile.sh 编译好，
+		//不满足时请退回 CPU 剔除
+		static bool isSupported(LVEDevice& device);
+
+		//在第一个渲染通道之前调用：读回这个帧槽位上一轮的计数，上传 world 中可渲染实体
+		//（ModelComponent + TransformSlotComponent）的矩阵和世界包围盒，并录制第一阶段的剔除。
+		//需要 frameInfo.transformSystem；包围盒优先从 sceneIndex 读取
+		void beginFrame(FrameInfo& frameInfo, LVEWorld& world, const LVESceneIndex& sceneIndex);
+		//第一个渲染通道中调用
+		void drawEarly(FrameInfo& frameInfo);
+		//两个渲染通道之间调用：生成深度金字塔并录制第二阶段的剔除
+		void cullLate(FrameInfo& frameInfo, const LVEDepthTarget& depthTarget);
+		//第二个渲染通道（RenderPassLoad::Load）中调用
+		void drawLate(FrameInfo& frameInfo);
+
+		//清空可见性历史，下一帧所有物体都交给第二阶段判断（例如相机瞬移之后）
+		void resetVisibility() { visibilityNeedsClear = true; }
+		const LVEGpuCullingStats& getLastStats() const { return lastStats; }
+		bool isPipelineReady() const { return drawPipeline.isReady(); }
+		//绘制管线编译失败时返回 true，这时应当销毁剔除器并退回 CPU 剔除
+		bool isPipelineFailed() const { return drawPipeline.isReady() && drawPipeline.tryGet() == nullptr; }
+
+	private:
+		//与 hiz_cull.comp / hiz_indirect.vert 中的 ObjectData 布局一致（std430）
+		struct GpuObjectData {
+			glm::mat4 modelMatrix{ 1.f };
+			glm::mat4 normalMatrix{ 1.f };
+			glm::vec4 boundsMin{ 0.f };
+			glm::vec4 boundsMax{ 0.f };
+			glm::uvec4 info{ 0 };	//x = 变换槽位
+		};
+
+		//同时兼容 VkDrawIndexedIndirectCommand 和 VkDrawIndirectCommand：没有索引的模型把 firstInstance 写在第 4 个字段
+		struct IndirectCommand {
+			uint32_t count;
+			uint32_t instanceCount;
+			uint32_t first;
+			int32_t vertexOffset;
+			uint32_t firstInstance;
+		};
+
+		//每个模型的物体在命令数组里连续存放
+		struct DrawBatch {
+			LVEModel* model;
+			uint32_t firstCommand;
+			uint32_t commandCount;
+		};
+
+		struct FrameResources {
+			std::unique_ptr<LVEBuffer> objectBuffer;
+			std::unique_ptr<LVEBuffer> earlyCommandBuffer;
+			std::unique_ptr<LVEBuffer> lateCommandBuffer;
+			std::unique_ptr<LVEBuffer> statsBuffer;
+			uint32_t capacity = 0;
+			uint32_t objectCount = 0;
+			bool statsPending = false;
+			//这个槽位的描述符集引用的可见性缓冲区版本，不一致时重写
+			uint32_t visibilityVersion = 0;
+
+			VkImage pyramidImage = VK_NULL_HANDLE;
+			VkDeviceMemory pyramidMemory = VK_NULL_HANDLE;
+			VkImageView pyramidView = VK_NULL_HANDLE;
+			std::vector<VkImageView> pyramidLevelViews;
+			VkExtent2D pyramidSourceExtent{ 0, 0 };
+			uint32_t pyramidLevels = 0;
+
+			VkDescriptorSet objectSet = VK_NULL_HANDLE;
+			VkDescriptorSet cullSet = VK_NULL_HANDLE;
+			std::vector<VkDescriptorSet> reduceSets;
+		};
+
+		void createDescriptorResources();
+		void createPipelines(const LVEPipelineTarget& target, VkDescriptorSetLayout globalSetLayout);
+		void createSampler();
+		void ensureCapacity(FrameResources& frame, uint32_t objectCount);
+		void ensureVisibilityCapacity(uint32_t slotCount);
+		void ensurePyramid(FrameResources& frame, VkExtent2D sourceExtent);
+		void destroyPyramid(FrameResources& frame);
+		void writeCullSet(FrameResources& frame);
+		void readStats(FrameResources& frame, FrameInfo& frameInfo);
+		void uploadObjects(FrameResources& frame, FrameInfo& frameInfo, LVEWorld& world, const LVESceneIndex& sceneIndex);
+		void dispatchCull(FrameInfo& frameInfo, FrameResources& frame, uint32_t phase, VkExtent2D depthExtent);
+		void buildPyramid(FrameInfo& frameInfo, FrameResources& frame, const LVEDepthTarget& depthTarget);
+		void drawPhase(FrameInfo& frameInfo, LVEBuffer& commands, const char* scopeName);
+
+		LVEDevice& lveDevice;
+		LVEPipelineRegistry& lvePipelineRegistry;
+
+		std::unique_ptr<LVEDescriptorPool> descriptorPool;
+		std::unique_ptr<LVEDescriptorSetLayout> objectSetLayout;
+		std::unique_ptr<LVEDescriptorSetLayout> cullSetLayout;
+		std::unique_ptr<LVEDescriptorSetLayout> reduceSetLayout;
+
+		VkPipelineLayout drawPipelineLayout = VK_NULL_HANDLE;
+		VkPipelineLayout cullPipelineLayout = VK_NULL_HANDLE;
+		VkPipelineLayout reducePipelineLayout = VK_NULL_HANDLE;
+		LVEPipelineHandle drawPipeline;
+		std::unique_ptr<LVEComputePipeline> cullPipeline;
+		std::unique_ptr<LVEComputePipeline> reducePipeline;
+		VkSampler pyramidSampler = VK_NULL_HANDLE;
+
+		std::vector<FrameResources> frames;
+		//按变换槽位保存的可见性（0/1），所有帧槽位共用，由第二阶段写入、下一帧第一阶段读取
+		std::unique_ptr<LVEBuffer> visibilityBuffer;
+		uint32_t visibilityCapacity = 0;
+		uint32_t visibilityVersion = 0;
+		bool visibilityNeedsClear = true;
+
+		//当前帧的绘制批次，beginFrame 中重建
+		std::vector<DrawBatch> batches;
+		std::unordered_map<LVEModel*, uint32_t> batchLookup;
+		//遍历顺序中每个实体所属的批次，第二遍遍历时按它放到批次内的位置
+		std::vector<uint32_t> entityBatches;
+		std::vector<GpuObjectData> objectScratch;
+		std::vector<IndirectCommand> commandScratch;
+		LVEGpuCullingStats lastStats{};
+	};
+
+}  // namespace lve
@@ -0,0 +1,73 @@
+#include "lve_input_recorder.h"
+
+// std
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+
+namespace lve {
+
+	//文件格式：文件头 + frameCount 条 { float dt; uint32_t buttons; }，小端
+	struct InputFileHeader {
+		char magic[4];
+		uint32_t version;
+		uint32_t frameCount;
+	};
+
+	static constexpr char INPUT_FILE_MAGIC[4] = { 'L', 'V', 'E', 'I' };
+	static constexpr uint32_t INPUT_FILE_VERSION = 1;
+
+	void LVEInputRecorder::save(const std::string& filePath) const {
+		std::ofstream file{ filePath, std::ios::binary | std::ios::trunc };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open input recording: " + filePath);
+		}
+
+		InputFileHeader header{};
+		std::memcpy(header.magic, INPUT_FILE_MAGIC, sizeof(header.magic));
+		header.version = INPUT_FILE_VERSION;
+		header.frameCount = static_cast<uint32_t>(frames.size());
+		file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+		for (const auto& frame : frames) {
+			file.write(reinterpret_cast<const char*>(&frame.dt), sizeof(frame.dt));
+			file.write(reinterpret_cast<const char*>(&frame.input.buttons), sizeof(frame.input.buttons));
+		}
+		if (!file.good()) {
+			throw std::runtime_error("failed to write input recording: " + filePath);
+		}
+	}
+
+	LVEInputReplay::LVEInputReplay(const std::string& filePath) {
+		std::ifstream file{ filePath, std::ios::binary };
+		if (!file.is_open()) {
+			throw std::runtime_error("failed to open input recording: " + filePath);
+		}
+
+		InputFileHeader header{};
+		file.read(reinterpret_cast<char*>(&header), sizeof(header));
+		if (!file.good()
+			|| std::memcmp(header.magic, INPUT_FILE_MAGIC, sizeof(header.magic)) != 0
+			|| header.version != INPUT_FILE_VERSION) {
+			throw std::runtime_error("invalid input recording: " + filePath);
+		}
+
+		frames.resize(header.frameCount);
+		for (auto& frame : frames) {
+			file.read(reinterpret_cast<char*>(&frame.dt), sizeof(frame.dt));
+			file.read(reinterpret_cast<char*>(&frame.input.buttons), sizeof(frame.input.buttons));
+		}
+		if (!file.good()) {
+			throw std::runtime_error("truncated input recording: " + filePath);
+		}
+	}
+
+	bool LVEInputReplay::next(RecordedInputFrame& frame) {
+		if (finished()) {
+			return false;
+		}
+		frame = frames[cursor++];
+		return true;
+	}
+
+}  // namespace lve
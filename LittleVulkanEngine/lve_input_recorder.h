@@ -0,0 +1,53 @@
+#pragma once
+
+#include "keyboard_movement_controller.h"
+
+// std
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+	//一帧的录制数据：这一帧使用的时间步长和输入状态
+	struct RecordedInputFrame {
+		float dt = 0.f;
+		KeyboardMovementController::MovementInput input{};
+	};
+
+	//输入录制：每帧 record 一次，结束时 save 写成二进制文件
+	class LVEInputRecorder {
+	public:
+		LVEInputRecorder() = default;
+
+		LVEInputRecorder(const LVEInputRecorder&) = delete;
+		LVEInputRecorder& operator=(const LVEInputRecorder&) = delete;
+
+		void record(float dt, const KeyboardMovementController::MovementInput& input) {
+			frames.push_back({ dt, input });
+		}
+		void save(const std::string& filePath) const;
+		size_t frameCount() const { return frames.size(); }
+
+	private:
+		std::vector<RecordedInputFrame> frames;
+	};
+
+	//输入回放：按录制顺序逐帧返回，回放完之后 next 返回 false
+	class LVEInputReplay {
+	public:
+		explicit LVEInputReplay(const std::string& filePath);
+
+		LVEInputReplay(const LVEInputReplay&) = delete;
+		LVEInputReplay& operator=(const LVEInputReplay&) = delete;
+
+		bool next(RecordedInputFrame& frame);
+		bool finished() const { return cursor >= frames.size(); }
+		size_t frameCount() const { return frames.size(); }
+
+	private:
+		std::vector<RecordedInputFrame> frames;
+		size_t cursor = 0;
+	};
+
+}  // namespace lve
@@ -0,0 +1,113 @@
+#include "lve_job_system.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+#include <atomic>
+#include <string>
+
+namespace lve {
+
+	LVEJobSystem::LVEJobSystem(uint32_t threadCount) {
+		if (threadCount == 0) {
+			uint32_t hardwareThreads = std::thread::hardware_concurrency();
+			threadCount = hardwareThreads > 1 ? hardwareThreads - 1 : 1;
+		}
+
+		workers.reserve(threadCount);
+		for (uint32_t i = 0; i < threadCount; i++) {
+			workers.emplace_back([this, i]() {
+				LVE_PROFILE_THREAD(("Worker " + std::to_string(i)).c_str());
+				workerLoop();
+			});
+		}
+	}
+
+	LVEJobSystem::~LVEJobSystem() {
+		{
+			std::lock_guard<std::mutex> lock{ jobsMutex };
+			stopping = true;
+		}
+		jobsCondition.notify_all();
+
+		//队列里剩余的任务会在线程退出前执行完，保证 submit 返回的 future 都能拿到结果
+		for (auto& worker : workers) {
+			worker.join();
+		}
+	}
+
+	void LVEJobSystem::enqueue(std::function<void()> job) {
+		{
+			std::lock_guard<std::mutex> lock{ jobsMutex };
+			jobs.push_back(std::move(job));
+		}
+		jobsCondition.notify_one();
+	}
+
+	void LVEJobSystem::workerLoop() {
+		while (true) {
+			std::function<void()> job;
+			{
+				std::unique_lock<std::mutex> lock{ jobsMutex };
+				jobsCondition.wait(lock, [this]() { return stopping || !jobs.empty(); });
+				if (jobs.empty()) {
+					return;
+				}
+				job = std::move(jobs.front());
+				jobs.pop_front();
+			}
+			LVE_PROFILE_SCOPE("Job");
+			job();
+		}
+	}
+
+	void LVEJobSystem::parallelFor(
+		uint32_t count,
+		uint32_t batchSize,
+		const std::function<void(uint32_t begin, uint32_t end)>& func)
+	{
+		if (count == 0) {
+			return;
+		}
+		batchSize = std::max(batchSize, 1u);
+		const uint32_t batchCount = (count + batchSize - 1) / batchSize;
+		if (batchCount == 1) {
+			func(0, count);
+			return;
+		}
+
+		//共享状态放在堆上：辅助任务可能在 parallelFor 返回之后才被线程取到，此时只会发现没有剩余批次。
+		struct ForState {
+			std::atomic<uint32_t> nextBatch{ 0 };
+			std::atomic<uint32_t> finishedBatches{ 0 };
+			std::mutex doneMutex;
+			std::condition_variable doneCondition;
+		};
+		auto state = std::make_shared<ForState>();
+
+		auto drain = [state, count, batchSize, batchCount, &func]() {
+			uint32_t batch;
+			while ((batch = state->nextBatch.fetch_add(1)) < batchCount) {
+				uint32_t begin = batch * batchSize;
+				uint32_t end = std::min(begin + batchSize, count);
+				func(begin, end);
+				if (state->finishedBatches.fetch_add(1) + 1 == batchCount) {
+					std::lock_guard<std::mutex> lock{ state->doneMutex };
+					state->doneCondition.notify_all();
+				}
+			}
+		};
+
+		//辅助任务只持有 state 的引用计数；func 的引用只会在还有批次可领时被使用，而此时调用者一定还在等待。
+		uint32_t helperCount = std::min(getThreadCount(), batchCount - 1);
+		for (uint32_t i = 0; i < helperCount; i++) {
+			enqueue(drain);
+		}
+		drain();
+
+		std::unique_lock<std::mutex> lock{ state->doneMutex };
+		state->doneCondition.wait(lock, [&]() { return state->finishedBatches.load() == batchCount; });
+	}
+
+}  // namespace lve
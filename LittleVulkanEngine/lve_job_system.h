@@ -0,0 +1,57 @@
+#pragma once
+
+// std
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+namespace lve {
+
+	//简单的工作线程池：submit 提交单个任务并返回 std::future，parallelFor 把一个区间拆成批次分给所有线程执行。
+	class LVEJobSystem {
+	public:
+		//threadCount 为 0 时使用 hardware_concurrency - 1 个工作线程（至少 1 个），调用线程本身也会参与 parallelFor。
+		explicit LVEJobSystem(uint32_t threadCount = 0);
+		~LVEJobSystem();
+
+		LVEJobSystem(const LVEJobSystem&) = delete;
+		LVEJobSystem& operator=(const LVEJobSystem&) = delete;
+
+		template <typename F>
+		auto submit(F&& func) -> std::future<std::invoke_result_t<std::decay_t<F>>> {
+			using R = std::invoke_result_t<std::decay_t<F>>;
+			//std::function 需要可拷贝，所以把 packaged_task 放进 shared_ptr
+			auto task = std::make_shared<std::packaged_task<R()>>(std::forward<F>(func));
+			std::future<R> result = task->get_future();
+			enqueue([task]() { (*task)(); });
+			return result;
+		}
+
+		//把 [0, count) 按 batchSize 切分，每批调用一次 func(begin, end)，返回前保证所有批次执行完毕。
+		//调用线程会一起消化批次，因此在工作线程内部调用也不会死锁。
+		void parallelFor(
+			uint32_t count,
+			uint32_t batchSize,
+			const std::function<void(uint32_t begin, uint32_t end)>& func);
+
+		uint32_t getThreadCount() const { return static_cast<uint32_t>(workers.size()); }
+
+	private:
+		void enqueue(std::function<void()> job);
+		void workerLoop();
+
+		std::vector<std::thread> workers;
+		std::deque<std::function<void()>> jobs;
+		std::mutex jobsMutex;
+		std::condition_variable jobsCondition;
+		bool stopping = false;
+	};
+
+}  // namespace lve
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "lve_bounds.h"
 #include "lve_buffer.h"
 #include "lve_device.h"
 
@@ -27,6 +28,9 @@ namespace lve{
 				return position == other.position && color == other.color && normal == other.normal &&
 					uv == other.uv;
 			}
+
+			//定义在 lve_model.cpp 里，glm 的实验性哈希扩展不会泄漏给包含这个头文件的代码
+			static size_t hash(const Vertex& vertex);
 		};
 
 		struct Builder {
@@ -49,10 +53,23 @@ namespace lve{
 
 		void bind(VkCommandBuffer commandBuffer);
 		void draw(VkCommandBuffer commandBuffer);
+		//从 buffer 的 offset 处读取 drawCount 条间接绘制命令。有索引时命令是 VkDrawIndexedIndirectCommand，
+		//否则是 VkDrawIndirectCommand；stride 是相邻两条命令的间隔，可以比命令本身大
+		void drawIndirect(VkCommandBuffer commandBuffer, VkBuffer buffer, VkDeviceSize offset, uint32_t drawCount, uint32_t stride);
+		bool hasIndices() const { return hasIndexBuffer; }
+		uint32_t getIndexCount() const { return hasIndexBuffer ? indexCount : 0; }
+		uint32_t getVertexCount() const { return vertexCount; }
+		//draw 一次提交的三角形数量，用于帧统计
+		uint32_t getTriangleCount() const { return (hasIndexBuffer ? indexCount : vertexCount) / 3; }
+		//模型空间的包围盒，剔除和拾取用
+		const LVEAabb& getBoundingBox() const { return boundingBox; }
+		//进程内唯一的编号，绘制排序键用它把同一个网格的绘制排在一起
+		uint32_t getSortId() const { return sortId; }
 
 	private:
 		void createVertexBuffers(const std::vector<Vertex> &vertices);
 		void createIndexBuffers(const std::vector<uint32_t>& indices);
+		static uint32_t allocateSortId();
 
 		LVEDevice& lveDevice;
 
@@ -62,14 +79,27 @@ namespace lve{
 		bool hasIndexBuffer = false;
 		std::unique_ptr<LVEBuffer> indexBuffer;
 		uint32_t indexCount;
+
+		LVEAabb boundingBox{};
+		uint32_t sortId = allocateSortId();
 	};
 }
 
+//loadModel 去重和微基准测试用的是同一个哈希
+namespace std {
+	template <>
+	struct hash<lve::LVEModel::Vertex> {
+		size_t operator()(lve::LVEModel::Vertex const& vertex) const {
+			return lve::LVEModel::Vertex::hash(vertex);
+		}
+	};
+}  // namespace std
+
 
 /*
 1. **`#define GLM_FORCE_RADIANS`**
-   дǿ GLM Ǻ `sin``cos` ȣͽǶصĲʹûƣĬϵĽǶơΪͼαУܶ漰ǶȵļʹûȸΪ OpenGL ѧ׼Ǻϡ
+   这行代码强制 GLM 在三角函数（例如 `sin`、`cos` 等）和角度相关的操作中使用弧度制，而不是默认的角度制。这是因为在图形编程中，很多情况下涉及到角度的计算使用弧度更为常见，与 OpenGL 的数学计算标准相吻合。
 
 2. **`#define GLM_FORCE_DEPTH_ZERO_TO_ONE`**
-   дָ GLM ʹȷΧ㵽һı׼ĬϵĴӸֵֵȷΧͨĳЩִͼ API УֵĻȻĴ淽ʽݡ
+   该行代码指定 GLM 使用深度范围从零到一的标准，而不是默认的从负值到正值的深度范围。这通常用于某些现代的图形 API 中，这样深度值更易于与屏幕坐标和深度缓冲区的储存方式相兼容。
 */
\ No newline at end of file
@@ -0,0 +1,533 @@
+#include "lve_occlusion_culler.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LVE_OCCLUSION_SIMD 1
+#include <emmintrin.h>
+#else
+#define LVE_OCCLUSION_SIMD 0
+#endif
+
+namespace lve {
+
+	//裁剪空间里的保护带：超出屏幕 GUARD_BAND 倍的三角形先裁掉，避免屏幕坐标过大时边函数失去精度
+	static constexpr float GUARD_BAND = 4.f;
+	static constexpr uint32_t MAX_CLIPPED_VERTICES = 16;
+
+	static uint32_t roundUpToTile(uint32_t value) {
+		uint32_t tile = LVEOcclusionCuller::TILE_SIZE;
+		return std::max((value + tile - 1) / tile * tile, tile);
+	}
+
+	// ---------------------------------------------------------------------------
+	// LVEOccluderMesh
+	// ---------------------------------------------------------------------------
+
+	LVEOccluderMesh LVEOccluderMesh::fromBuilder(const LVEModel::Builder& builder) {
+		LVEOccluderMesh mesh{};
+		mesh.positions.reserve(builder.vertices.size());
+		for (const auto& vertex : builder.vertices) {
+			mesh.positions.push_back(vertex.position);
+		}
+		if (builder.indices.empty()) {
+			mesh.indices.resize(builder.vertices.size());
+			for (uint32_t i = 0; i < mesh.indices.size(); i++) {
+				mesh.indices[i] = i;
+			}
+		}
+		else {
+			mesh.indices = builder.indices;
+		}
+		return mesh;
+	}
+
+	LVEOccluderMesh LVEOccluderMesh::createBox() {
+		LVEOccluderMesh mesh{};
+		for (uint32_t i = 0; i < 8; i++) {
+			mesh.positions.push_back({ i & 1 ? .5f : -.5f, i & 2 ? .5f : -.5f, i & 4 ? .5f : -.5f });
+		}
+		//光栅化不区分正反面，只要每个面被两个三角形覆盖即可
+		mesh.indices = {
+			0, 2, 3, 0, 3, 1,	// -z
+			4, 5, 7, 4, 7, 6,	// +z
+			0, 4, 6, 0, 6, 2,	// -x
+			1, 3, 7, 1, 7, 5,	// +x
+			0, 1, 5, 0, 5, 4,	// -y
+			2, 6, 7, 2, 7, 3 };	// +y
+		return mesh;
+	}
+
+	// ---------------------------------------------------------------------------
+	// 遮挡体的变换、裁剪和三角形设置
+	// ---------------------------------------------------------------------------
+
+	LVEOcclusionCuller::LVEOcclusionCuller(LVEJobSystem* jobSystem, uint32_t width, uint32_t height)
+		: jobSystem{ jobSystem }, width{ roundUpToTile(width) }, height{ roundUpToTile(height) }
+	{
+		tilesX = this->width / TILE_SIZE;
+		tilesY = this->height / TILE_SIZE;
+		bandHeight = TILE_SIZE * 2;
+		bandCount = (this->height + bandHeight - 1) / bandHeight;
+		depthBuffer.assign(static_cast<size_t>(this->width) * this->height, 1.f);
+		tileMaxDepth.assign(static_cast<size_t>(tilesX) * tilesY, 1.f);
+	}
+
+	void LVEOcclusionCuller::beginFrame(const glm::mat4& projectionView) {
+		this->projectionView = projectionView;
+		triangles.clear();
+	}
+
+	//对 dot(plane, v) >= 0 的半空间做 Sutherland-Hodgman 裁剪
+	static uint32_t clipPolygon(
+		const glm::vec4* input, uint32_t count, const glm::vec4& plane, glm::vec4* output)
+	{
+		uint32_t outCount = 0;
+		for (uint32_t i = 0; i < count; i++) {
+			const glm::vec4& current = input[i];
+			const glm::vec4& next = input[(i + 1) % count];
+			float currentDistance = glm::dot(plane, current);
+			float nextDistance = glm::dot(plane, next);
+			if (currentDistance >= 0.f) {
+				output[outCount++] = current;
+			}
+			if ((currentDistance >= 0.f) != (nextDistance >= 0.f)) {
+				float t = currentDistance / (currentDistance - nextDistance);
+				output[outCount++] = current + (next - current) * t;
+			}
+		}
+		return outCount;
+	}
+
+	void LVEOcclusionCuller::addOccluder(const LVEOccluderMesh& mesh, const glm::mat4& modelMatrix) {
+		glm::mat4 transform = projectionView * modelMatrix;
+		clipScratch.resize(mesh.positions.size());
+		for (size_t i = 0; i < mesh.positions.size(); i++) {
+			clipScratch[i] = transform * glm::vec4{ mesh.positions[i], 1.f };
+		}
+
+		//近平面 z >= 0，再加上四个保护带平面
+		static const glm::vec4 clipPlanes[5] = {
+			{ 0.f, 0.f, 1.f, 0.f },
+			{ 1.f, 0.f, 0.f, GUARD_BAND },
+			{ -1.f, 0.f, 0.f, GUARD_BAND },
+			{ 0.f, 1.f, 0.f, GUARD_BAND },
+			{ 0.f, -1.f, 0.f, GUARD_BAND } };
+
+		auto outcode = [](const glm::vec4& v) {
+			uint32_t code = 0;
+			if (v.x < -v.w) code |= 1;
+			if (v.x > v.w) code |= 2;
+			if (v.y < -v.w) code |= 4;
+			if (v.y > v.w) code |= 8;
+			if (v.z < 0.f) code |= 16;
+			if (v.z > v.w) code |= 32;
+			return code;
+		};
+
+		for (size_t i = 0; i + 2 < mesh.indices.size(); i += 3) {
+			const glm::vec4& a = clipScratch[mesh.indices[i]];
+			const glm::vec4& b = clipScratch[mesh.indices[i + 1]];
+			const glm::vec4& c = clipScratch[mesh.indices[i + 2]];
+			//三个顶点都在同一个平面外侧时整个三角形不可见
+			if (outcode(a) & outcode(b) & outcode(c)) {
+				continue;
+			}
+
+			glm::vec4 polygon[MAX_CLIPPED_VERTICES] = { a, b, c };
+			glm::vec4 clipped[MAX_CLIPPED_VERTICES];
+			uint32_t count = 3;
+			for (const auto& plane : clipPlanes) {
+				bool inside = glm::dot(plane, polygon[0]) >= 0.f;
+				bool allInside = inside;
+				for (uint32_t v = 1; v < count; v++) {
+					allInside = allInside && glm::dot(plane, polygon[v]) >= 0.f;
+				}
+				if (allInside) {
+					continue;
+				}
+				count = clipPolygon(polygon, count, plane, clipped);
+				std::copy(clipped, clipped + count, polygon);
+				if (count < 3) {
+					break;
+				}
+			}
+			for (uint32_t v = 1; v + 1 < count; v++) {
+				setupTriangle(polygon[0], polygon[v], polygon[v + 1]);
+			}
+		}
+	}
+
+	void LVEOcclusionCuller::addOccluders(
+		LVEWorld& world, const LVETransformSystem& transformSystem, const std::vector<uint8_t>* visibleSlots)
+	{
+		LVE_PROFILE_FUNCTION();
+		world.forEachChunk<OccluderComponent, TransformSlotComponent>(
+			[&](uint32_t count, const LVEEntity*, OccluderComponent* occluders, TransformSlotComponent* slots) {
+				for (uint32_t i = 0; i < count; i++) {
+					uint32_t slot = slots[i].slot;
+					if (!occluders[i].mesh || slot >= transformSystem.size()) {
+						continue;
+					}
+					if (visibleSlots != nullptr && slot < visibleSlots->size() && !(*visibleSlots)[slot]) {
+						continue;
+					}
+					addOccluder(*occluders[i].mesh, transformSystem.getModelMatrix(slot));
+				}
+			});
+	}
+
+	void LVEOcclusionCuller::setupTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2) {
+		//透视除法后映射到像素坐标，像素中心在 +0.5
+		auto toScreen = [&](const glm::vec4& v) {
+			float invW = 1.f / v.w;
+			return glm::vec3{
+				(v.x * invW * 0.5f + 0.5f) * static_cast<float>(width),
+				(v.y * invW * 0.5f + 0.5f) * static_cast<float>(height),
+				v.z * invW };
+		};
+		glm::vec3 p[3] = { toScreen(v0), toScreen(v1), toScreen(v2) };
+
+		float area = (p[1].x - p[0].x) * (p[2].y - p[0].y) - (p[2].x - p[0].x) * (p[1].y - p[0].y);
+		if (std::abs(area) < 1e-6f) {
+			return;
+		}
+		//不区分正反面，统一成面积为正的顺序
+		if (area < 0.f) {
+			std::swap(p[1], p[2]);
+			area = -area;
+		}
+
+		ScreenTriangle triangle{};
+		float minX = std::min({ p[0].x, p[1].x, p[2].x });
+		float maxX = std::max({ p[0].x, p[1].x, p[2].x });
+		float minY = std::min({ p[0].y, p[1].y, p[2].y });
+		float maxY = std::max({ p[0].y, p[1].y, p[2].y });
+		//只有中心落在三角形包围盒内的像素才可能被覆盖
+		triangle.minX = std::max(static_cast<int32_t>(std::ceil(minX - 0.5f)), 0);
+		triangle.maxX = std::min(static_cast<int32_t>(std::floor(maxX - 0.5f)), static_cast<int32_t>(width) - 1);
+		triangle.minY = std::max(static_cast<int32_t>(std::ceil(minY - 0.5f)), 0);
+		triangle.maxY = std::min(static_cast<int32_t>(std::floor(maxY - 0.5f)), static_cast<int32_t>(height) - 1);
+		if (triangle.minX > triangle.maxX || triangle.minY > triangle.maxY) {
+			return;
+		}
+
+		//边 i 是顶点 i 对面的边，在顶点 i 处的值等于 area
+		float invArea = 1.f / area;
+		triangle.depthDx = 0.f;
+		triangle.depthDy = 0.f;
+		triangle.depthC = 0.f;
+		for (int i = 0; i < 3; i++) {
+			const glm::vec3& from = p[(i + 1) % 3];
+			const glm::vec3& to = p[(i + 2) % 3];
+			triangle.edgeA[i] = from.y - to.y;
+			triangle.edgeB[i] = to.x - from.x;
+			triangle.edgeC[i] = from.x * to.y - to.x * from.y;
+			triangle.depthDx += triangle.edgeA[i] * p[i].z * invArea;
+			triangle.depthDy += triangle.edgeB[i] * p[i].z * invArea;
+			triangle.depthC += triangle.edgeC[i] * p[i].z * invArea;
+		}
+		triangles.push_back(triangle);
+	}
+
+	// ---------------------------------------------------------------------------
+	// 光栅化
+	// ---------------------------------------------------------------------------
+
+	void LVEOcclusionCuller::rasterize() {
+		LVE_PROFILE_FUNCTION();
+		//没有遮挡体时 isOccluded 总是返回 false，不需要清空深度缓冲区
+		if (triangles.empty()) {
+			return;
+		}
+		if (jobSystem != nullptr && bandCount > 1) {
+			jobSystem->parallelFor(bandCount, 1, [this](uint32_t begin, uint32_t end) {
+				for (uint32_t band = begin; band < end; band++) {
+					rasterizeBand(band);
+				}
+			});
+		}
+		else {
+			for (uint32_t band = 0; band < bandCount; band++) {
+				rasterizeBand(band);
+			}
+		}
+	}
+
+	//每条带只写自己的行和块，不同条带之间不需要同步
+	void LVEOcclusionCuller::rasterizeBand(uint32_t band) {
+		int32_t bandMinY = static_cast<int32_t>(band * bandHeight);
+		int32_t bandMaxY = std::min(bandMinY + static_cast<int32_t>(bandHeight), static_cast<int32_t>(height)) - 1;
+		std::fill(
+			depthBuffer.begin() + static_cast<size_t>(bandMinY) * width,
+			depthBuffer.begin() + static_cast<size_t>(bandMaxY + 1) * width,
+			1.f);
+
+		for (const auto& triangle : triangles) {
+			if (triangle.maxY < bandMinY || triangle.minY > bandMaxY) {
+				continue;
+			}
+			rasterizeTriangle(triangle, bandMinY, bandMaxY);
+		}
+
+		for (uint32_t tileY = bandMinY / TILE_SIZE; tileY <= static_cast<uint32_t>(bandMaxY) / TILE_SIZE; tileY++) {
+			for (uint32_t tileX = 0; tileX < tilesX; tileX++) {
+				float maxDepth = 0.f;
+				for (uint32_t y = tileY * TILE_SIZE; y < (tileY + 1) * TILE_SIZE; y++) {
+					const float* row = depthBuffer.data() + static_cast<size_t>(y) * width + tileX * TILE_SIZE;
+					for (uint32_t x = 0; x < TILE_SIZE; x++) {
+						maxDepth = std::max(maxDepth, row[x]);
+					}
+				}
+				tileMaxDepth[tileY * tilesX + tileX] = maxDepth;
+			}
+		}
+	}
+
+	//一行中可能被三角形覆盖的列范围：每条边把这一行切成两半，取三个半区的交集，再向外放宽一个像素吸收浮点误差。
+	//起点向下对齐到 4，深度缓冲区的宽度是 4 的倍数，按 4 个像素一组前进不会越过行尾
+	bool LVEOcclusionCuller::rowSpan(const ScreenTriangle& triangle, float py, int32_t& spanStart, int32_t& spanEnd) {
+		float low = static_cast<float>(triangle.minX) + 0.5f;
+		float high = static_cast<float>(triangle.maxX) + 0.5f;
+		for (int i = 0; i < 3; i++) {
+			float rowValue = triangle.edgeB[i] * py + triangle.edgeC[i];
+			float a = triangle.edgeA[i];
+			if (a > 0.f) {
+				low = std::max(low, -rowValue / a);
+			}
+			else if (a < 0.f) {
+				high = std::min(high, -rowValue / a);
+			}
+			else if (rowValue < 0.f) {
+				return false;
+			}
+		}
+		if (low > high) {
+			return false;
+		}
+		spanStart = std::max(static_cast<int32_t>(std::ceil(low - 0.5f)) - 1, triangle.minX) & ~3;
+		spanEnd = std::min(static_cast<int32_t>(std::floor(high - 0.5f)) + 1, triangle.maxX);
+		return spanStart <= spanEnd;
+	}
+
+	//边函数和深度都是屏幕坐标的线性函数，沿一行每次前进 4 个像素只需要加上常数
+	void LVEOcclusionCuller::rasterizeTriangle(const ScreenTriangle& triangle, int32_t bandMinY, int32_t bandMaxY) {
+		int32_t startY = std::max(triangle.minY, bandMinY);
+		int32_t endY = std::min(triangle.maxY, bandMaxY);
+
+#if LVE_OCCLUSION_SIMD
+		const __m128 pixelOffsets = _mm_setr_ps(0.5f, 1.5f, 2.5f, 3.5f);
+		const __m128 zero = _mm_setzero_ps();
+		__m128 edgeA[3], edgeStep[3];
+		for (int i = 0; i < 3; i++) {
+			edgeA[i] = _mm_set1_ps(triangle.edgeA[i]);
+			edgeStep[i] = _mm_set1_ps(triangle.edgeA[i] * 4.f);
+		}
+		__m128 depthDx = _mm_set1_ps(triangle.depthDx);
+		__m128 depthStep = _mm_set1_ps(triangle.depthDx * 4.f);
+
+		for (int32_t y = startY; y <= endY; y++) {
+			float py = static_cast<float>(y) + 0.5f;
+			int32_t spanStart, spanEnd;
+			if (!rowSpan(triangle, py, spanStart, spanEnd)) {
+				continue;
+			}
+			__m128 spanPx = _mm_add_ps(_mm_set1_ps(static_cast<float>(spanStart)), pixelOffsets);
+			__m128 edge[3];
+			for (int i = 0; i < 3; i++) {
+				__m128 rowValue = _mm_set1_ps(triangle.edgeB[i] * py + triangle.edgeC[i]);
+				edge[i] = _mm_add_ps(_mm_mul_ps(edgeA[i], spanPx), rowValue);
+			}
+			__m128 depth = _mm_add_ps(
+				_mm_mul_ps(depthDx, spanPx), _mm_set1_ps(triangle.depthDy * py + triangle.depthC));
+
+			float* row = depthBuffer.data() + static_cast<size_t>(y) * width;
+			for (int32_t x = spanStart; x <= spanEnd; x += 4) {
+				__m128 inside = _mm_and_ps(
+					_mm_and_ps(_mm_cmpge_ps(edge[0], zero), _mm_cmpge_ps(edge[1], zero)),
+					_mm_cmpge_ps(edge[2], zero));
+				if (_mm_movemask_ps(inside) != 0) {
+					__m128 old = _mm_loadu_ps(row + x);
+					__m128 nearer = _mm_min_ps(old, depth);
+					_mm_storeu_ps(row + x, _mm_or_ps(_mm_and_ps(inside, nearer), _mm_andnot_ps(inside, old)));
+				}
+				for (int i = 0; i < 3; i++) {
+					edge[i] = _mm_add_ps(edge[i], edgeStep[i]);
+				}
+				depth = _mm_add_ps(depth, depthStep);
+			}
+		}
+#else
+		for (int32_t y = startY; y <= endY; y++) {
+			float py = static_cast<float>(y) + 0.5f;
+			int32_t spanStart, spanEnd;
+			if (!rowSpan(triangle, py, spanStart, spanEnd)) {
+				continue;
+			}
+			float* row = depthBuffer.data() + static_cast<size_t>(y) * width;
+			for (int32_t x = spanStart; x <= spanEnd; x++) {
+				float px = static_cast<float>(x) + 0.5f;
+				bool inside = true;
+				for (int i = 0; i < 3; i++) {
+					inside = inside && triangle.edgeA[i] * px + triangle.edgeB[i] * py + triangle.edgeC[i] >= 0.f;
+				}
+				if (inside) {
+					float depth = triangle.depthDx * px + triangle.depthDy * py + triangle.depthC;
+					row[x] = std::min(row[x], depth);
+				}
+			}
+		}
+#endif
+	}
+
+	// ---------------------------------------------------------------------------
+	// 遮挡测试
+	// ---------------------------------------------------------------------------
+
+#if LVE_OCCLUSION_SIMD
+	static float horizontalMin(__m128 value) {
+		value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+		value = _mm_min_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(value);
+	}
+
+	static float horizontalMax(__m128 value) {
+		value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(2, 3, 0, 1)));
+		value = _mm_max_ps(value, _mm_shuffle_ps(value, value, _MM_SHUFFLE(1, 0, 3, 2)));
+		return _mm_cvtss_f32(value);
+	}
+#endif
+
+	bool LVEOcclusionCuller::isOccluded(const LVEAabb& worldBounds) const {
+		if (triangles.empty() || !worldBounds.isValid()) {
+			return false;
+		}
+		//只做一次矩阵乘法，其余 7 个角点由最小角点加上各轴方向的增量得到
+		glm::vec4 minCorner = projectionView * glm::vec4{ worldBounds.min, 1.f };
+		glm::vec3 size = worldBounds.max - worldBounds.min;
+		glm::vec4 deltaX = projectionView[0] * size.x;
+		glm::vec4 deltaY = projectionView[1] * size.y;
+		glm::vec4 deltaZ = projectionView[2] * size.z;
+
+		//NDC 下的矩形和最近深度
+		float ndcMinX, ndcMinY, ndcMaxX, ndcMaxY, nearestDepth;
+#if LVE_OCCLUSION_SIMD
+		//4 个通道是 x/y 方向的 4 种组合，minZFace 和 maxZFace 分别是包围盒 z 最小和最大的两个面，8 个角点只需要两次除法
+		const __m128 laneX = _mm_setr_ps(0.f, 1.f, 0.f, 1.f);
+		const __m128 laneY = _mm_setr_ps(0.f, 0.f, 1.f, 1.f);
+		__m128 minZFace[4], maxZFace[4];
+		for (int c = 0; c < 4; c++) {
+			minZFace[c] = _mm_add_ps(
+				_mm_set1_ps(minCorner[c]),
+				_mm_add_ps(_mm_mul_ps(laneX, _mm_set1_ps(deltaX[c])), _mm_mul_ps(laneY, _mm_set1_ps(deltaY[c]))));
+			maxZFace[c] = _mm_add_ps(minZFace[c], _mm_set1_ps(deltaZ[c]));
+		}
+		//有角点在近平面前面时屏幕矩形不可靠，当作可见
+		const __m128 zero = _mm_setzero_ps();
+		__m128 behind = _mm_or_ps(
+			_mm_or_ps(_mm_cmplt_ps(minZFace[2], zero), _mm_cmplt_ps(maxZFace[2], zero)),
+			_mm_or_ps(_mm_cmple_ps(minZFace[3], zero), _mm_cmple_ps(maxZFace[3], zero)));
+		if (_mm_movemask_ps(behind) != 0) {
+			return false;
+		}
+		const __m128 one = _mm_set1_ps(1.f);
+		__m128 minZInvW = _mm_div_ps(one, minZFace[3]);
+		__m128 maxZInvW = _mm_div_ps(one, maxZFace[3]);
+		__m128 minZX = _mm_mul_ps(minZFace[0], minZInvW), maxZX = _mm_mul_ps(maxZFace[0], maxZInvW);
+		__m128 minZY = _mm_mul_ps(minZFace[1], minZInvW), maxZY = _mm_mul_ps(maxZFace[1], maxZInvW);
+		__m128 minZDepth = _mm_mul_ps(minZFace[2], minZInvW), maxZDepth = _mm_mul_ps(maxZFace[2], maxZInvW);
+		ndcMinX = horizontalMin(_mm_min_ps(minZX, maxZX));
+		ndcMaxX = horizontalMax(_mm_max_ps(minZX, maxZX));
+		ndcMinY = horizontalMin(_mm_min_ps(minZY, maxZY));
+		ndcMaxY = horizontalMax(_mm_max_ps(minZY, maxZY));
+		nearestDepth = horizontalMin(_mm_min_ps(minZDepth, maxZDepth));
+#else
+		ndcMinX = ndcMinY = nearestDepth = std::numeric_limits<float>::max();
+		ndcMaxX = ndcMaxY = -std::numeric_limits<float>::max();
+		for (uint32_t i = 0; i < 8; i++) {
+			glm::vec4 clip = minCorner;
+			if (i & 1) clip += deltaX;
+			if (i & 2) clip += deltaY;
+			if (i & 4) clip += deltaZ;
+			//有角点在近平面前面时屏幕矩形不可靠，当作可见
+			if (clip.z < 0.f || clip.w <= 0.f) {
+				return false;
+			}
+			float invW = 1.f / clip.w;
+			ndcMinX = std::min(ndcMinX, clip.x * invW);
+			ndcMaxX = std::max(ndcMaxX, clip.x * invW);
+			ndcMinY = std::min(ndcMinY, clip.y * invW);
+			ndcMaxY = std::max(ndcMaxY, clip.y * invW);
+			nearestDepth = std::min(nearestDepth, clip.z * invW);
+		}
+#endif
+
+		//和矩形有任何重叠的像素都要检查。先限制在屏幕附近，避免很大的坐标转换成整数时溢出
+		auto toPixelX = [&](float ndc) {
+			return static_cast<int32_t>(std::floor((std::clamp(ndc, -2.f, 2.f) * 0.5f + 0.5f) * static_cast<float>(width)));
+		};
+		auto toPixelY = [&](float ndc) {
+			return static_cast<int32_t>(std::floor((std::clamp(ndc, -2.f, 2.f) * 0.5f + 0.5f) * static_cast<float>(height)));
+		};
+		int32_t pixelMinX = std::max(toPixelX(ndcMinX), 0);
+		int32_t pixelMinY = std::max(toPixelY(ndcMinY), 0);
+		int32_t pixelMaxX = std::min(toPixelX(ndcMaxX), static_cast<int32_t>(width) - 1);
+		int32_t pixelMaxY = std::min(toPixelY(ndcMaxY), static_cast<int32_t>(height) - 1);
+		//完全在屏幕外的物体交给视锥剔除
+		if (pixelMinX > pixelMaxX || pixelMinY > pixelMaxY) {
+			return false;
+		}
+		return isRectOccluded(pixelMinX, pixelMinY, pixelMaxX, pixelMaxY, nearestDepth);
+	}
+
+	//先用块的最远深度整块判断，只有判断不了的块才逐个像素比较
+	bool LVEOcclusionCuller::isRectOccluded(
+		int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, float nearestDepth) const
+	{
+		for (int32_t tileY = minY / TILE_SIZE; tileY <= maxY / static_cast<int32_t>(TILE_SIZE); tileY++) {
+			for (int32_t tileX = minX / TILE_SIZE; tileX <= maxX / static_cast<int32_t>(TILE_SIZE); tileX++) {
+				if (tileMaxDepth[tileY * tilesX + tileX] < nearestDepth) {
+					continue;
+				}
+				int32_t x0 = std::max(minX, tileX * static_cast<int32_t>(TILE_SIZE));
+				int32_t x1 = std::min(maxX, (tileX + 1) * static_cast<int32_t>(TILE_SIZE) - 1);
+				int32_t y0 = std::max(minY, tileY * static_cast<int32_t>(TILE_SIZE));
+				int32_t y1 = std::min(maxY, (tileY + 1) * static_cast<int32_t>(TILE_SIZE) - 1);
+				for (int32_t y = y0; y <= y1; y++) {
+					const float* row = depthBuffer.data() + static_cast<size_t>(y) * width;
+					for (int32_t x = x0; x <= x1; x++) {
+						if (row[x] >= nearestDepth) {
+							return false;
+						}
+					}
+				}
+			}
+		}
+		return true;
+	}
+
+	uint32_t LVEOcclusionCuller::cullVisibility(const LVESceneIndex& sceneIndex, std::vector<uint8_t>& visibility) {
+		LVE_PROFILE_FUNCTION();
+		lastOccludedCount = 0;
+		if (triangles.empty()) {
+			return 0;
+		}
+		for (uint32_t slot = 0; slot < visibility.size(); slot++) {
+			if (!visibility[slot]) {
+				continue;
+			}
+			const LVEAabb* bounds = sceneIndex.tryGetWorldBounds(slot);
+			if (bounds != nullptr && isOccluded(*bounds)) {
+				visibility[slot] = 0;
+				lastOccludedCount++;
+			}
+		}
+		return lastOccludedCount;
+	}
+
+}  // namespace lve
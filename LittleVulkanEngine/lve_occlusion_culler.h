@@ -0,0 +1,110 @@
+#pragma once
+
+#include "lve_bounds.h"
+#include "lve_ecs.h"
+#include "lve_job_system.h"
+#include "lve_model.h"
+#include "lve_scene_index.h"
+#include "lve_transform_system.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lve {
+
+	//遮挡体只需要位置和索引，通常用比渲染网格简单得多的包围网格
+	struct LVEOccluderMesh {
+		std::vector<glm::vec3> positions;
+		std::vector<uint32_t> indices;
+
+		static LVEOccluderMesh fromBuilder(const LVEModel::Builder& builder);
+		//中心在原点、边长为 1 的立方体，和 LVESceneGenerator::createCubeModel 的形状相同
+		static LVEOccluderMesh createBox();
+	};
+
+	//带这个组件（以及 TransformSlotComponent）的实体会被画进软件深度缓冲区，挡住后面的物体
+	struct OccluderComponent {
+		std::shared_ptr<const LVEOccluderMesh> mesh;
+	};
+
+	//CPU 软件光栅化的遮挡剔除（思路来自 masked software occlusion culling）。
+	//每帧把指定的遮挡体从相机视角画进一张低分辨率的深度缓冲区：屏幕按行分成若干条带，由工作线程各自光栅化，
+	//每次用 SSE 处理 4 个像素；画完后为每个 8x8 的块记录最远的深度。
+	//候选物体用世界包围盒在屏幕上的矩形和最近深度测试：覆盖到的块里遮挡体都更近时，物体就被完全挡住了。
+	//测试是保守的：跨过近平面或无法判断的物体总被当作可见。
+	class LVEOcclusionCuller {
+	public:
+		static constexpr uint32_t DEFAULT_WIDTH = 320;
+		static constexpr uint32_t DEFAULT_HEIGHT = 192;
+		static constexpr uint32_t TILE_SIZE = 8;
+
+		//width 和 height 会向上取整到 TILE_SIZE 的倍数。jobSystem 为空时在调用线程上光栅化
+		explicit LVEOcclusionCuller(
+			LVEJobSystem* jobSystem = nullptr, uint32_t width = DEFAULT_WIDTH, uint32_t height = DEFAULT_HEIGHT);
+
+		LVEOcclusionCuller(const LVEOcclusionCuller&) = delete;
+		LVEOcclusionCuller& operator=(const LVEOcclusionCuller&) = delete;
+
+		//开始新的一帧：清空遮挡体
+		void beginFrame(const glm::mat4& projectionView);
+		//变换并裁剪遮挡体的三角形，真正的光栅化在 rasterize() 中进行
+		void addOccluder(const LVEOccluderMesh& mesh, const glm::mat4& modelMatrix);
+		//加入 world 中所有带 OccluderComponent 的实体。visibleSlots 不为空时跳过视锥外的遮挡体
+		void addOccluders(
+			LVEWorld& world, const LVETransformSystem& transformSystem, const std::vector<uint8_t>* visibleSlots = nullptr);
+		//清空深度缓冲区并画入所有遮挡体，之后才能调用 isOccluded
+		void rasterize();
+
+		bool isOccluded(const LVEAabb& worldBounds) const;
+		//把 visibility 中被遮挡的槽位清零，返回清掉的数量
+		uint32_t cullVisibility(const LVESceneIndex& sceneIndex, std::vector<uint8_t>& visibility);
+
+		uint32_t getWidth() const { return width; }
+		uint32_t getHeight() const { return height; }
+		//每个像素离相机最近的遮挡体深度（Vulkan 的 [0, 1]，1 为远平面），调试和测试用
+		const std::vector<float>& getDepthBuffer() const { return depthBuffer; }
+		uint32_t getOccluderTriangleCount() const { return static_cast<uint32_t>(triangles.size()); }
+		uint32_t getLastOccludedCount() const { return lastOccludedCount; }
+
+	private:
+		//屏幕空间三角形：三条边函数 a * x + b * y + c >= 0 表示在内部，深度是屏幕坐标的线性函数
+		struct ScreenTriangle {
+			float edgeA[3];
+			float edgeB[3];
+			float edgeC[3];
+			float depthDx, depthDy, depthC;
+			int32_t minX, maxX, minY, maxY;
+		};
+
+		void setupTriangle(const glm::vec4& v0, const glm::vec4& v1, const glm::vec4& v2);
+		void rasterizeBand(uint32_t band);
+		void rasterizeTriangle(const ScreenTriangle& triangle, int32_t bandMinY, int32_t bandMaxY);
+		static bool rowSpan(const ScreenTriangle& triangle, float py, int32_t& spanStart, int32_t& spanEnd);
+		bool isRectOccluded(int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, float nearestDepth) const;
+
+		LVEJobSystem* jobSystem;
+		uint32_t width;
+		uint32_t height;
+		uint32_t tilesX;
+		uint32_t tilesY;
+		//每条带的行数，是 TILE_SIZE 的整数倍
+		uint32_t bandHeight;
+		uint32_t bandCount;
+
+		glm::mat4 projectionView{ 1.f };
+		std::vector<ScreenTriangle> triangles;
+		std::vector<float> depthBuffer;
+		//每个块中最远的遮挡体深度
+		std::vector<float> tileMaxDepth;
+		std::vector<glm::vec4> clipScratch;
+		uint32_t lastOccludedCount = 0;
+	};
+
+}  // namespace lve
@@ -0,0 +1,285 @@
+#include "lve_offscreen_target.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <array>
+#include <stdexcept>
+
+namespace lve {
+
+	LVEOffscreenTarget::LVEOffscreenTarget(
+		LVEDevice& deviceRef,
+		VkExtent2D extent,
+		uint32_t imageCount,
+		VkFormat colorFormat)
+		: device{ deviceRef }, extent{ extent }, colorFormat{ colorFormat }
+	{
+		depthFormat = device.findSupportedFormat(
+			{ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
+			VK_IMAGE_TILING_OPTIMAL,
+			VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
+
+		colorImages.resize(imageCount);
+		createImages();
+		//动态渲染时直接使用图像视图，不需要渲染通道和帧缓冲
+		if (!device.supportsDynamicRendering()) {
+			createRenderPass();
+			createFramebuffers();
+		}
+	}
+
+	//最近几帧可能还在渲染到这些图像上，全部交给延迟销毁队列
+	LVEOffscreenTarget::~LVEOffscreenTarget() {
+		VkDevice vkDevice = device.device();
+		std::vector<VkFramebuffer> retiredFramebuffers = std::move(framebuffers);
+		VkRenderPass retiredRenderPass = renderPass;
+		VkRenderPass retiredLoadRenderPass = loadRenderPass;
+		if (renderPass != VK_NULL_HANDLE) {
+			device.notifyHandleDestroyed(renderPass);
+			device.notifyHandleDestroyed(loadRenderPass);
+		}
+		device.retire([vkDevice, retiredFramebuffers, retiredRenderPass, retiredLoadRenderPass]() {
+			for (auto framebuffer : retiredFramebuffers) {
+				vkDestroyFramebuffer(vkDevice, framebuffer, nullptr);
+			}
+			vkDestroyRenderPass(vkDevice, retiredRenderPass, nullptr);
+			vkDestroyRenderPass(vkDevice, retiredLoadRenderPass, nullptr);
+		});
+		for (size_t i = 0; i < colorImages.size(); i++) {
+			device.retireImage(colorImages[i], colorImageMemorys[i], colorImageViews[i]);
+			device.retireImage(depthImages[i], depthImageMemorys[i], depthImageViews[i]);
+		}
+	}
+
+	void LVEOffscreenTarget::createRenderPass() {
+		renderPass = createRenderPass(false);
+		loadRenderPass = createRenderPass(true);
+	}
+
+	//与交换链的渲染通道相同的附件布局，区别是颜色附件最终转换到 TRANSFER_SRC_OPTIMAL 以便回读。
+	//loadContents 为 true 时保留已有内容，用于同一帧里的第二个渲染通道
+	VkRenderPass LVEOffscreenTarget::createRenderPass(bool loadContents) {
+		VkAttachmentDescription colorAttachment{};
+		colorAttachment.format = colorFormat;
+		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		colorAttachment.loadOp = loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		colorAttachment.initialLayout = loadContents ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+
+		VkAttachmentDescription depthAttachment{};
+		depthAttachment.format = depthFormat;
+		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
+		depthAttachment.loadOp = loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.initialLayout =
+			loadContents ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		VkAttachmentReference colorAttachmentRef{};
+		colorAttachmentRef.attachment = 0;
+		colorAttachmentRef.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+
+		VkAttachmentReference depthAttachmentRef{};
+		depthAttachmentRef.attachment = 1;
+		depthAttachmentRef.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = 1;
+		subpass.pColorAttachments = &colorAttachmentRef;
+		subpass.pDepthStencilAttachment = &depthAttachmentRef;
+
+		std::array<VkSubpassDependency, 2> dependencies{};
+		dependencies[0].srcSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[0].dstSubpass = 0;
+		dependencies[0].srcStageMask =
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[0].srcAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+		dependencies[0].dstStageMask =
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
+		dependencies[0].dstAccessMask =
+			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		if (loadContents) {
+			dependencies[0].srcAccessMask |= VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			dependencies[0].dstAccessMask |=
+				VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		}
+
+		//渲染结束后的复制要等颜色写入完成
+		dependencies[1].srcSubpass = 0;
+		dependencies[1].dstSubpass = VK_SUBPASS_EXTERNAL;
+		dependencies[1].srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		dependencies[1].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		dependencies[1].dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+		dependencies[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+
+		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		renderPassInfo.dependencyCount = static_cast<uint32_t>(dependencies.size());
+		renderPassInfo.pDependencies = dependencies.data();
+
+		VkRenderPass result = VK_NULL_HANDLE;
+		if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &result) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create offscreen render pass!");
+		}
+		return result;
+	}
+
+	//为每个帧槽位创建颜色图像、深度图像、它们的视图以及回读缓冲区
+	void LVEOffscreenTarget::createImages() {
+		size_t count = colorImages.size();
+		colorImageMemorys.resize(count);
+		colorImageViews.resize(count);
+		depthImages.resize(count);
+		depthImageMemorys.resize(count);
+		depthImageViews.resize(count);
+		readbackBuffers.resize(count);
+
+		for (size_t i = 0; i < count; i++) {
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.extent.width = extent.width;
+			imageInfo.extent.height = extent.height;
+			imageInfo.extent.depth = 1;
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+			imageInfo.format = colorFormat;
+			imageInfo.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT;
+			device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, colorImages[i], colorImageMemorys[i]);
+
+			imageInfo.format = depthFormat;
+			imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
+			device.createImageWithInfo(imageInfo, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, depthImages[i], depthImageMemorys[i]);
+
+			VkImageViewCreateInfo viewInfo{};
+			viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+			viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+			viewInfo.subresourceRange.baseMipLevel = 0;
+			viewInfo.subresourceRange.levelCount = 1;
+			viewInfo.subresourceRange.baseArrayLayer = 0;
+			viewInfo.subresourceRange.layerCount = 1;
+
+			viewInfo.image = colorImages[i];
+			viewInfo.format = colorFormat;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+			if (vkCreateImageView(device.device(), &viewInfo, nullptr, &colorImageViews[i]) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create offscreen color image view!");
+			}
+
+			viewInfo.image = depthImages[i];
+			viewInfo.format = depthFormat;
+			viewInfo.subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+			if (vkCreateImageView(device.device(), &viewInfo, nullptr, &depthImageViews[i]) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create offscreen depth image view!");
+			}
+
+			readbackBuffers[i] = std::make_unique<LVEBuffer>(
+				device,
+				4,
+				extent.width * extent.height,
+				VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+				VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+			readbackBuffers[i]->map();
+		}
+	}
+
+	void LVEOffscreenTarget::createFramebuffers() {
+		framebuffers.resize(colorImages.size());
+		for (size_t i = 0; i < colorImages.size(); i++) {
+			std::array<VkImageView, 2> attachments = { colorImageViews[i], depthImageViews[i] };
+
+			VkFramebufferCreateInfo framebufferInfo{};
+			framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+			framebufferInfo.renderPass = renderPass;
+			framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+			framebufferInfo.pAttachments = attachments.data();
+			framebufferInfo.width = extent.width;
+			framebufferInfo.height = extent.height;
+			framebufferInfo.layers = 1;
+
+			if (vkCreateFramebuffer(device.device(), &framebufferInfo, nullptr, &framebuffers[i]) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create offscreen framebuffer!");
+			}
+		}
+	}
+
+	void LVEOffscreenTarget::submitCommandBuffers(const VkCommandBuffer* buffers, uint64_t timelineValue) {
+		VkSemaphore timelineSemaphore = device.timelineSemaphore();
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.signalSemaphoreValueCount = 1;
+		timelineInfo.pSignalSemaphoreValues = &timelineValue;
+
+		VkSubmitInfo submitInfo{};
+		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+		submitInfo.pNext = &timelineInfo;
+		submitInfo.commandBufferCount = 1;
+		submitInfo.pCommandBuffers = buffers;
+		submitInfo.signalSemaphoreCount = 1;
+		submitInfo.pSignalSemaphores = &timelineSemaphore;
+
+		LVE_PROFILE_SCOPE("vkQueueSubmit");
+		if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+			throw std::runtime_error("failed to submit offscreen command buffer!");
+		}
+	}
+
+	void LVEOffscreenTarget::recordReadback(VkCommandBuffer commandBuffer, int index) {
+		VkBufferImageCopy region{};
+		region.bufferOffset = 0;
+		region.bufferRowLength = 0;
+		region.bufferImageHeight = 0;
+		region.imageSubresource.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		region.imageSubresource.mipLevel = 0;
+		region.imageSubresource.baseArrayLayer = 0;
+		region.imageSubresource.layerCount = 1;
+		region.imageOffset = { 0, 0, 0 };
+		region.imageExtent = { extent.width, extent.height, 1 };
+
+		vkCmdCopyImageToBuffer(
+			commandBuffer,
+			colorImages[index],
+			VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+			readbackBuffers[index]->getBuffer(),
+			1,
+			&region);
+
+		//让复制结果对 CPU 读取可见
+		VkBufferMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+		barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+		barrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.buffer = readbackBuffers[index]->getBuffer();
+		barrier.offset = 0;
+		barrier.size = VK_WHOLE_SIZE;
+
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_TRANSFER_BIT,
+			VK_PIPELINE_STAGE_HOST_BIT,
+			0,
+			0, nullptr,
+			1, &barrier,
+			0, nullptr);
+	}
+
+}  // namespace lve
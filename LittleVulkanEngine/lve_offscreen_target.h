@@ -0,0 +1,77 @@
+#pragma once
+
+#include "lve_buffer.h"
+#include "lve_device.h"
+
+// std
+#include <memory>
+#include <vector>
+
+namespace lve {
+
+	//离屏渲染目标：代替无窗口模式下的交换链，每个帧槽位一套颜色 + 深度图像和帧缓冲。
+	//渲染通道结束后颜色图像处于 TRANSFER_SRC_OPTIMAL，可以直接复制到回读缓冲区。
+	class LVEOffscreenTarget {
+	public:
+		static constexpr VkFormat DEFAULT_COLOR_FORMAT = VK_FORMAT_R8G8B8A8_UNORM;
+
+		LVEOffscreenTarget(
+			LVEDevice& deviceRef,
+			VkExtent2D extent,
+			uint32_t imageCount,
+			VkFormat colorFormat = DEFAULT_COLOR_FORMAT);
+		~LVEOffscreenTarget();
+
+		LVEOffscreenTarget(const LVEOffscreenTarget&) = delete;
+		LVEOffscreenTarget& operator=(const LVEOffscreenTarget&) = delete;
+
+		//设备启用动态渲染时不创建渲染通道和帧缓冲，下面三个函数不可用
+		VkFramebuffer getFrameBuffer(int index) { return framebuffers[index]; }
+		VkRenderPass getRenderPass() { return renderPass; }
+		//保留已有内容的兼容渲染通道
+		VkRenderPass getLoadRenderPass() { return loadRenderPass; }
+		VkImage getColorImage(int index) { return colorImages[index]; }
+		VkImageView getImageView(int index) { return colorImageViews[index]; }
+		size_t imageCount() { return colorImages.size(); }
+		VkFormat getColorFormat() { return colorFormat; }
+		VkFormat getDepthFormat() { return depthFormat; }
+		VkImage getDepthImage(int index) { return depthImages[index]; }
+		VkImageView getDepthImageView(int index) { return depthImageViews[index]; }
+		VkExtent2D getExtent() { return extent; }
+
+		float extentAspectRatio() {
+			return static_cast<float>(extent.width) / static_cast<float>(extent.height);
+		}
+
+		//只会 signal 设备的时间线信号量，没有 acquire/present
+		void submitCommandBuffers(const VkCommandBuffer* buffers, uint64_t timelineValue);
+
+		//在渲染通道结束之后录制：把 index 对应的颜色图像复制到它的回读缓冲区
+		void recordReadback(VkCommandBuffer commandBuffer, int index);
+		//回读缓冲区（HOST_VISIBLE | HOST_COHERENT，已映射），数据按行紧密排列，每像素 4 字节
+		LVEBuffer& getReadbackBuffer(int index) { return *readbackBuffers[index]; }
+
+	private:
+		void createRenderPass();
+		VkRenderPass createRenderPass(bool loadContents);
+		void createImages();
+		void createFramebuffers();
+
+		LVEDevice& device;
+		VkExtent2D extent;
+		VkFormat colorFormat;
+		VkFormat depthFormat;
+
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		VkRenderPass loadRenderPass = VK_NULL_HANDLE;
+		std::vector<VkImage> colorImages;
+		std::vector<VkDeviceMemory> colorImageMemorys;
+		std::vector<VkImageView> colorImageViews;
+		std::vector<VkImage> depthImages;
+		std::vector<VkDeviceMemory> depthImageMemorys;
+		std::vector<VkImageView> depthImageViews;
+		std::vector<VkFramebuffer> framebuffers;
+		std::vector<std::unique_ptr<LVEBuffer>> readbackBuffers;
+	};
+
+}  // namespace lve
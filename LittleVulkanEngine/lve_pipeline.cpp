@@ -1,6 +1,8 @@
 #include "lve_pipeline.h"
 #include "lve_model.h"
+#include "lve_profiler.h"
 
+#include <atomic>
 #include <fstream>
 #include <stdexcept>
 #include <iostream>
@@ -8,27 +10,37 @@
 
 namespace lve {
 	/*
-		LVEPipeline ฺ Vulkan ͼιߵĴ͹
-		ǴӶȡɫ뵽ͼιߵҪ裬
-		ͬʱṩ˿úĬϵĹá
+		LVEPipeline 类负责 Vulkan 图形管线的创建和管理，
+		涵盖从读取着色器代码到创建图形管线的主要步骤，
+		同时提供了可配置和默认的管线设置。
 	*/
+	//管线在工作线程上创建，编号要用原子计数
+	uint32_t LVEPipeline::allocateSortId() {
+		static std::atomic<uint32_t> nextSortId{ 0 };
+		return nextSortId.fetch_add(1, std::memory_order_relaxed);
+	}
+
 	LVEPipeline::LVEPipeline(
 		LVEDevice& device,
 		const std::string& vertFilePath,
 		const std::string& fragFilePath,
-		const PipelineConfigInfo& configInfo) :lveDevice(device) {
-		createGraphicsPipeline(vertFilePath, fragFilePath, configInfo);
+		const PipelineConfigInfo& configInfo,
+		VkPipelineCache pipelineCache) :lveDevice(device) {
+		createGraphicsPipeline(vertFilePath, fragFilePath, configInfo, pipelineCache);
 	}
 
 	LVEPipeline::~LVEPipeline() {
-		//ɫģͼιߣȷûڴй©
+		//销毁着色器模块和图形管线，确保没有内存泄漏。
+		//着色器模块在管线创建后就不再被引用，可以立即销毁；管线可能还在已提交的命令缓冲区里，延迟销毁。
 		vkDestroyShaderModule(lveDevice.device(), vertShaderModule, nullptr);
 		vkDestroyShaderModule(lveDevice.device(), fragShaderModule, nullptr);
-		vkDestroyPipeline(lveDevice.device(), graphicsPipeline, nullptr);
+		VkDevice device = lveDevice.device();
+		VkPipeline pipeline = graphicsPipeline;
+		lveDevice.retire([device, pipeline]() { vkDestroyPipeline(device, pipeline, nullptr); });
 	}
 
 	std::vector<char> LVEPipeline::readFile(const std::string& filePath) {
-		std::ifstream file(filePath, std::ios::ate | std::ios::binary);//ate ļʱλĩβԱ㶨λļС
+		std::ifstream file(filePath, std::ios::ate | std::ios::binary);//ate 文件打开时立即定位到末尾，以便定位到文件大小
 
 		if (!file.is_open()) {
 			throw std::runtime_error("failed to open file: " + filePath);
@@ -45,17 +57,32 @@ namespace lve {
 		return buffer;
 	}
 
-	void LVEPipeline::createGraphicsPipeline(const std::string& vertFilePath, const std::string& fragFilePath, const PipelineConfigInfo& configInfo) {
+	void LVEPipeline::createGraphicsPipeline(
+		const std::string& vertFilePath,
+		const std::string& fragFilePath,
+		const PipelineConfigInfo& configInfo,
+		VkPipelineCache pipelineCache) {
+		LVE_PROFILE_FUNCTION();
 		assert(configInfo.pipelineLayout != VK_NULL_HANDLE &&
 			"Cannot create graphics pipeline:: no pipelineLayout provided in configInfo");
-		assert(configInfo.renderPass != VK_NULL_HANDLE &&
-			"Cannot create graphics pipeline:: no renderPass provided in configInfo");
+		assert((configInfo.renderPass != VK_NULL_HANDLE ||
+			!configInfo.colorAttachmentFormats.empty() || configInfo.depthAttachmentFormat != VK_FORMAT_UNDEFINED) &&
+			"Cannot create graphics pipeline:: no renderPass or attachment formats provided in configInfo");
 		auto vectCode = readFile(vertFilePath);
 		auto fragCode = readFile(fragFilePath);
 
 		createShaderModule(vectCode, &vertShaderModule);
 		createShaderModule(fragCode, &fragShaderModule);
 
+		//没有特化常量时保持 nullptr，使用着色器里的默认值
+		VkSpecializationInfo specializationInfo{};
+		specializationInfo.mapEntryCount = static_cast<uint32_t>(configInfo.specializationEntries.size());
+		specializationInfo.pMapEntries = configInfo.specializationEntries.data();
+		specializationInfo.dataSize = configInfo.specializationData.size();
+		specializationInfo.pData = configInfo.specializationData.data();
+		const VkSpecializationInfo* pSpecializationInfo =
+			configInfo.specializationEntries.empty() ? nullptr : &specializationInfo;
+
 		VkPipelineShaderStageCreateInfo shaderStages[2];
 
 		shaderStages[0].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
@@ -64,7 +91,7 @@ namespace lve {
 		shaderStages[0].pName = "main";
 		shaderStages[0].flags = 0;
 		shaderStages[0].pNext = nullptr;
-		shaderStages[0].pSpecializationInfo = nullptr;
+		shaderStages[0].pSpecializationInfo = pSpecializationInfo;
 
 		shaderStages[1].sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
 		shaderStages[1].stage = VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -72,12 +99,12 @@ namespace lve {
 		shaderStages[1].pName = "main";
 		shaderStages[1].flags = 0;
 		shaderStages[1].pNext = nullptr;
-		shaderStages[1].pSpecializationInfo = nullptr;
+		shaderStages[1].pSpecializationInfo = pSpecializationInfo;
 
 		auto bindingDescriptions = LVEModel::Vertex::getBindingDescriptions();
 		auto attributeDescriptions = LVEModel::Vertex::gettAttributeDescriptions();
 
-		//ö״̬,涥ԺͰ
+		//配置顶点输入状态,保存顶点属性和绑定描述的数量。
 		VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
 		vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
 		vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(attributeDescriptions.size());
@@ -85,7 +112,7 @@ namespace lve {
 		vertexInputInfo.pVertexAttributeDescriptions = attributeDescriptions.data();
 		vertexInputInfo.pVertexBindingDescriptions = bindingDescriptions.data();
 
-		////configInfo Ƴ
+		////从configInfo 里面移出来
 		//VkPipelineViewportStateCreateInfo viewportInfo{};
 		//viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 		//viewportInfo.viewportCount = 1;
@@ -93,9 +120,9 @@ namespace lve {
 		//viewportInfo.scissorCount = 1;
 		//viewportInfo.pScissors = &configInfo.scissor;
 
-		//ͼιߵĸ״̬
-		//pipelineInfo ͼιߵдϢɫ׶Ρ״̬Ʒʽװ䣩ӿ״̬դ״̬ز״̬ɫ״̬ģ״̬Ͷ̬״̬ȡ
-		//ʹ configInfo дĸϢͼιߵϢṹ
+		//配置图形管线的各种状态。
+		//pipelineInfo 包含图形管线的所有创建信息，例如着色器阶段、顶点输入状态、绘制方式（输入装配）、视口状态、光栅化状态、多重采样状态、颜色混合状态、深度模板状态和动态状态等。
+		//使用 configInfo 中传入的各种信息来填充图形管线的信息结构。
 		VkGraphicsPipelineCreateInfo pipelineInfo{};
 		pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
 		pipelineInfo.stageCount = 2;
@@ -118,9 +145,20 @@ namespace lve {
 		pipelineInfo.basePipelineIndex = -1;
 		pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
 
+		//动态渲染：没有渲染通道，附件格式通过 pNext 给出。只绑定深度，不绑定模板
+		VkPipelineRenderingCreateInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+		renderingInfo.colorAttachmentCount = static_cast<uint32_t>(configInfo.colorAttachmentFormats.size());
+		renderingInfo.pColorAttachmentFormats = configInfo.colorAttachmentFormats.data();
+		renderingInfo.depthAttachmentFormat = configInfo.depthAttachmentFormat;
+		renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+		if (configInfo.renderPass == VK_NULL_HANDLE) {
+			pipelineInfo.pNext = &renderingInfo;
+		}
+
 		if (vkCreateGraphicsPipelines(
 			lveDevice.device(),
-			VK_NULL_HANDLE,
+			pipelineCache,		//VkPipelineCache 本身是线程安全的，多个工作线程可以共用同一个缓存
 			1,
 			&pipelineInfo,
 			nullptr,
@@ -140,28 +178,73 @@ namespace lve {
 		}
 	}
 
-	//ڸаͼιߡ
+	LVEComputePipeline::LVEComputePipeline(
+		LVEDevice& device,
+		const std::string& compFilePath,
+		VkPipelineLayout pipelineLayout,
+		VkPipelineCache pipelineCache) : lveDevice(device) {
+		LVE_PROFILE_FUNCTION();
+		assert(pipelineLayout != VK_NULL_HANDLE && "Cannot create compute pipeline:: no pipelineLayout provided");
+		auto compCode = LVEPipeline::readFile(compFilePath);
+
+		VkShaderModuleCreateInfo moduleInfo{};
+		moduleInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
+		moduleInfo.codeSize = compCode.size();
+		moduleInfo.pCode = reinterpret_cast<const uint32_t*>(compCode.data());
+		VkShaderModule compShaderModule;
+		if (vkCreateShaderModule(lveDevice.device(), &moduleInfo, nullptr, &compShaderModule) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create shader module");
+		}
+
+		VkComputePipelineCreateInfo pipelineInfo{};
+		pipelineInfo.sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO;
+		pipelineInfo.stage.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
+		pipelineInfo.stage.stage = VK_SHADER_STAGE_COMPUTE_BIT;
+		pipelineInfo.stage.module = compShaderModule;
+		pipelineInfo.stage.pName = "main";
+		pipelineInfo.layout = pipelineLayout;
+
+		VkResult result = vkCreateComputePipelines(
+			lveDevice.device(), pipelineCache, 1, &pipelineInfo, nullptr, &computePipeline);
+		//着色器模块在管线创建后就不再需要
+		vkDestroyShaderModule(lveDevice.device(), compShaderModule, nullptr);
+		if (result != VK_SUCCESS) {
+			throw std::runtime_error("failed to create compute pipeline!");
+		}
+	}
+
+	LVEComputePipeline::~LVEComputePipeline() {
+		VkDevice device = lveDevice.device();
+		VkPipeline pipeline = computePipeline;
+		lveDevice.retire([device, pipeline]() { vkDestroyPipeline(device, pipeline, nullptr); });
+	}
+
+	void LVEComputePipeline::bind(VkCommandBuffer commandBuffer) {
+		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, computePipeline);
+	}
+
+	//在给定的命令缓冲区中绑定图形管线。
 	void LVEPipeline::bind(VkCommandBuffer commandBuffer) {
 		vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, graphicsPipeline);
 	}
 
-	//ĬϹ
-	//װ䡢ӿڡդزɫϡģͶ̬״̬á
-	//Щ Vulkan ߵĻɲ֣ṩĬֵԼ򻯹ߴĹ̡
+	//默认管线配置
+	//定义输入装配、视口、光栅化、多重采样、颜色混合、深度模板和动态状态的配置。
+	//由于这些配置是 Vulkan 管线的基本组成部分，因此提供默认值可以简化管线创建的过程。
 	void LVEPipeline::defaultPipelineConfigInfo(PipelineConfigInfo& configInfo) {
-		// װ״̬
+		// 输入装配状态
 		configInfo.inputAssemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
 		configInfo.inputAssemblyInfo.topology = VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST;
 		configInfo.inputAssemblyInfo.primitiveRestartEnable = VK_FALSE;
 
-		// ӿ״̬
+		// 视口状态
 		configInfo.viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
 		configInfo.viewportInfo.viewportCount = 1;
 		configInfo.viewportInfo.pViewports = nullptr;
 		configInfo.viewportInfo.scissorCount = 1;
 		configInfo.viewportInfo.pScissors = nullptr;
 
-		// դ״̬ 
+		// 光栅化状态 
 		configInfo.rasterizationInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
 		configInfo.rasterizationInfo.depthClampEnable = VK_FALSE;
 		configInfo.rasterizationInfo.rasterizerDiscardEnable = VK_FALSE;
@@ -174,7 +257,7 @@ namespace lve {
 		configInfo.rasterizationInfo.depthBiasClamp = 0.0f;           // Optional
 		configInfo.rasterizationInfo.depthBiasSlopeFactor = 0.0f;     // Optional
 
-		// ز״̬ 
+		// 多重采样状态 
 		configInfo.multisampleInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
 		configInfo.multisampleInfo.sampleShadingEnable = VK_FALSE;
 		configInfo.multisampleInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
@@ -183,7 +266,7 @@ namespace lve {
 		configInfo.multisampleInfo.alphaToCoverageEnable = VK_FALSE;  // Optional
 		configInfo.multisampleInfo.alphaToOneEnable = VK_FALSE;       // Optional
 
-		// ɫ״̬
+		// 颜色混合状态
 		configInfo.colorBlendAttachment.colorWriteMask =
 			VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
 			VK_COLOR_COMPONENT_A_BIT;
@@ -204,7 +287,7 @@ namespace lve {
 		configInfo.colorBlendInfo.blendConstants[2] = 0.0f;  // Optional
 		configInfo.colorBlendInfo.blendConstants[3] = 0.0f;  // Optional
 
-		// ģ״̬ 
+		// 深度模板状态 
 		configInfo.depthStencilInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
 		configInfo.depthStencilInfo.depthTestEnable = VK_TRUE;
 		configInfo.depthStencilInfo.depthWriteEnable = VK_TRUE;
@@ -216,16 +299,43 @@ namespace lve {
 		configInfo.depthStencilInfo.front = {};  // Optional
 		configInfo.depthStencilInfo.back = {};   // Optional
 
-		// ̬״̬
+		// 动态状态
 		configInfo.dynamicStateEnables = { VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR };
 		configInfo.dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
 		configInfo.dynamicStateInfo.pDynamicStates = configInfo.dynamicStateEnables.data();
 		configInfo.dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(configInfo.dynamicStateEnables.size());
 		configInfo.dynamicStateInfo.flags = 0;
 	}
+
+	void LVEPipeline::copyPipelineConfigInfo(const PipelineConfigInfo& src, PipelineConfigInfo& dst) {
+		dst.viewportInfo = src.viewportInfo;
+		dst.inputAssemblyInfo = src.inputAssemblyInfo;
+		dst.rasterizationInfo = src.rasterizationInfo;
+		dst.multisampleInfo = src.multisampleInfo;
+		dst.colorBlendAttachment = src.colorBlendAttachment;
+		dst.colorBlendInfo = src.colorBlendInfo;
+		dst.depthStencilInfo = src.depthStencilInfo;
+		dst.dynamicStateEnables = src.dynamicStateEnables;
+		dst.dynamicStateInfo = src.dynamicStateInfo;
+		dst.pipelineLayout = src.pipelineLayout;
+		dst.renderPass = src.renderPass;
+		dst.subpass = src.subpass;
+		dst.colorAttachmentFormats = src.colorAttachmentFormats;
+		dst.depthAttachmentFormat = src.depthAttachmentFormat;
+		dst.specializationEntries = src.specializationEntries;
+		dst.specializationData = src.specializationData;
+
+		//重新指向 dst 自己的颜色混合附件和动态状态数组
+		if (src.colorBlendInfo.pAttachments == &src.colorBlendAttachment) {
+			dst.colorBlendInfo.pAttachments = &dst.colorBlendAttachment;
+		}
+		if (src.dynamicStateInfo.pDynamicStates == src.dynamicStateEnables.data()) {
+			dst.dynamicStateInfo.pDynamicStates = dst.dynamicStateEnables.data();
+		}
+	}
 }
 
-//ʱĴϢ
+//绘制三角形时的错误信息：
 /*
 validation layer: Validation Error: [ UNASSIGNED-GeneralParameterError-UnrecognizedBool32 ] | MessageID = 0xa320b052 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].blendEnable (3435973836) is neither VK_TRUE nor VK_FALSE. Applications MUST not pass any other values than VK_TRUE or VK_FALSE into a Vulkan implementation where a VkBool32 is expected.
 validation layer: Validation Error: [ VUID-VkPipelineColorBlendAttachmentState-srcColorBlendFactor-parameter ] | MessageID = 0xeb9e690 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].srcColorBlendFactor (3435973836) does not fall within the begin..end range of the VkBlendFactor enumeration tokens and is not an extension added token. The Vulkan spec states: srcColorBlendFactor must be a valid VkBlendFactor value (https://vulkan.lunarg.com/doc/view/1.3.290.0/windows/1.3-extensions/vkspec.html#VUID-VkPipelineColorBlendAttachmentState-srcColorBlendFactor-parameter)
@@ -238,65 +348,65 @@ validation layer: Validation Error: [ VUID-VkPipelineColorBlendAttachmentState-c
 failed to submit draw command buffer!
 */
 /*
-õģṩ Vulkan ־־˶֤Ҫڵ `vkCreateGraphicsPipelines()` ʱɫ״̬Ĳйءÿϸ
+好的，我们来分析你提供的 Vulkan 错误日志。这个日志包含了多个验证错误，主要是在调用 `vkCreateGraphicsPipelines()` 时，与颜色混合状态的参数设置有关。下面是每个错误的详细分析：
 
-### 1. Ч_bool32_ֵ
+### 1. 无效的_bool32_值
 ```
-֤: [ UNASSIGNED-GeneralParameterError-UnrecognizedBool32 ] | MessageID = 0xa320b052 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].blendEnable (3435973836)  VK_TRUE  VK_FALSE
+验证错误: [ UNASSIGNED-GeneralParameterError-UnrecognizedBool32 ] | MessageID = 0xa320b052 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].blendEnable (3435973836) 不是 VK_TRUE 或 VK_FALSE。
 ```
-- ****: `blendEnable` ֶӦǲֵ`VK_TRUE`  `VK_FALSE`յһЧֵ3435973836
-- ****: ȷ `blendEnable` Ϊ `VK_TRUE`  `VK_FALSE`
+- **问题**: `blendEnable` 字段应该是布尔值（`VK_TRUE` 或 `VK_FALSE`），但接收到一个无效的值（3435973836）。
+- **解决方案**: 确保将 `blendEnable` 设置为 `VK_TRUE` 或 `VK_FALSE`。
 
-### 2. ЧԴɫ
+### 2. 无效的源颜色混合因子
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-srcColorBlendFactor-parameter ] | MessageID = 0xeb9e690 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].srcColorBlendFactor (3435973836)  VkBlendFactor öٵЧΧڣҲչӵıǡ
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-srcColorBlendFactor-parameter ] | MessageID = 0xeb9e690 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].srcColorBlendFactor (3435973836) 不在 VkBlendFactor 枚举的有效范围内，且不是扩展添加的标记。
 ```
-- ****: `srcColorBlendFactor` ӦЧ `VkBlendFactor` öֵһЧ֣3435973836
-- ****: 鸳 `srcColorBlendFactor` ֵȷ϶ `VkBlendFactor` ֵ磬`VK_BLEND_FACTOR_ZERO``VK_BLEND_FACTOR_ONE` ȣ
+- **问题**: `srcColorBlendFactor` 应该是有效的 `VkBlendFactor` 枚举值，但设置了一个无效的数字（3435973836）。
+- **解决方案**: 检查赋给 `srcColorBlendFactor` 的值，确保它符合定义的 `VkBlendFactor` 值（例如，`VK_BLEND_FACTOR_ZERO`、`VK_BLEND_FACTOR_ONE` 等）。
 
-### 3. ЧĿɫ
+### 3. 无效的目标颜色混合因子
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-dstColorBlendFactor-parameter ] | MessageID = 0x8db942fe | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].dstColorBlendFactor (3435973836)  VkBlendFactor öٵЧΧڣҲչӵıǡ
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-dstColorBlendFactor-parameter ] | MessageID = 0x8db942fe | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].dstColorBlendFactor (3435973836) 不在 VkBlendFactor 枚举的有效范围内，且不是扩展添加的标记。
 ```
-- ****: `dstColorBlendFactor` ͬΪЧֵ
-- ****: ȷ `dstColorBlendFactor` һЧ `VkBlendFactor` ֵ
+- **问题**: `dstColorBlendFactor` 同样是设置为无效值。
+- **解决方案**: 确保 `dstColorBlendFactor` 被赋予一个有效的 `VkBlendFactor` 值。
 
-### 4. Чɫϲ
+### 4. 无效的颜色混合操作
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-colorBlendOp-parameter ] | MessageID = 0x7978ef4f | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].colorBlendOp (3435973836)  VkBlendOp öٵЧΧڣҲչӵıǡ
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-colorBlendOp-parameter ] | MessageID = 0x7978ef4f | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].colorBlendOp (3435973836) 不在 VkBlendOp 枚举的有效范围内，且不是扩展添加的标记。
 ```
-- ****: `colorBlendOp` ΪЧֵ
-- ****: Ϊ `colorBlendOp` Ч `VkBlendOp` ֵ
+- **问题**: `colorBlendOp` 参数设置为无效值。
+- **解决方案**: 为 `colorBlendOp` 赋予有效的 `VkBlendOp` 值。
 
-### 5. ЧԴ alpha 
+### 5. 无效的源 alpha 混合因子
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-srcAlphaBlendFactor-parameter ] | MessageID = 0x4a7f8ed8 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].srcAlphaBlendFactor (3358545944)  VkBlendFactor öٵЧΧڣҲչӵıǡ
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-srcAlphaBlendFactor-parameter ] | MessageID = 0x4a7f8ed8 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].srcAlphaBlendFactor (3358545944) 不在 VkBlendFactor 枚举的有效范围内，且不是扩展添加的标记。
 ```
-- ****: `srcAlphaBlendFactor` ΪЧֵ
-- ****: ȷ `srcAlphaBlendFactor` һЧ `VkBlendFactor` ֵ
+- **问题**: `srcAlphaBlendFactor` 设置为无效值。
+- **解决方案**: 确保 `srcAlphaBlendFactor` 被赋予一个有效的 `VkBlendFactor` 值。
 
-### 6. ЧĿ alpha 
+### 6. 无效的目标 alpha 混合因子
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-dstAlphaBlendFactor-parameter ] | MessageID = 0x53ab1c8f | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].dstAlphaBlendFactor (496)  VkBlendFactor öٵЧΧڣҲչӵıǡ
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-dstAlphaBlendFactor-parameter ] | MessageID = 0x53ab1c8f | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].dstAlphaBlendFactor (496) 不在 VkBlendFactor 枚举的有效范围内，且不是扩展添加的标记。
 ```
-- ****: `dstAlphaBlendFactor` ΪЧֵ
-- ****:  `dstAlphaBlendFactor` ΪЧ `VkBlendFactor` ֵ
+- **问题**: `dstAlphaBlendFactor` 设置为无效值。
+- **解决方案**: 将 `dstAlphaBlendFactor` 设置为有效的 `VkBlendFactor` 值。
 
-### 7. Ч alpha ϲ
+### 7. 无效的 alpha 混合操作
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-alphaBlendOp-parameter ] | MessageID = 0x48f9f9b | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].alphaBlendOp (4127412873)  VkBlendOp öٵЧΧڣҲչӵıǡ
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-alphaBlendOp-parameter ] | MessageID = 0x48f9f9b | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].alphaBlendOp (4127412873) 不在 VkBlendOp 枚举的有效范围内，且不是扩展添加的标记。
 ```
-- ****: `alphaBlendOp` ΪЧֵ
-- ****: Ϊ `alphaBlendOp` Ч `VkBlendOp` ֵ
+- **问题**: `alphaBlendOp` 为无效值。
+- **解决方案**: 为 `alphaBlendOp` 设置有效的 `VkBlendOp` 值。
 
-### 8. Чɫд
+### 8. 无效的颜色写掩码
 ```
-֤: [ VUID-VkPipelineColorBlendAttachmentState-colorWriteMask-parameter ] | MessageID = 0xb8f9c032 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].colorWriteMask  (0x36b2) ޷ʶ VkColorComponentFlagBits Ա
+验证错误: [ VUID-VkPipelineColorBlendAttachmentState-colorWriteMask-parameter ] | MessageID = 0xb8f9c032 | vkCreateGraphicsPipelines(): pCreateInfos[0].pColorBlendState->pAttachments[0].colorWriteMask 包含 (0x36b2) 无法识别的 VkColorComponentFlagBits 成员。
 ```
-- ****: `colorWriteMask` аЧı־λ
-- ****:  `colorWriteMask` ΪЧ `VkColorComponentFlagBits` ϣ磬`VK_COLOR_COMPONENT_R_BIT``VK_COLOR_COMPONENT_G_BIT` ȣ
+- **问题**: `colorWriteMask` 中包含了无效的标志位。
+- **解决方案**: 将 `colorWriteMask` 设置为有效的 `VkColorComponentFlagBits` 组合（例如，`VK_COLOR_COMPONENT_R_BIT`、`VK_COLOR_COMPONENT_G_BIT` 等）。
 
-### ܽ
-ҪЩϸ鸳ֵɫ״ֵ̬ȷǷ Vulkan 淶ҪЧֵȷȷֵԲʹõ Vulkan 汾ĵ⽫벢֤⣬ʱң
+### 总结
+要解决这些错误，请仔细检查赋值给颜色混合状态各个参数的值，确保它们符合 Vulkan 规范中所要求的有效值。如果不确定正确的值，可以查阅你所使用的 Vulkan 版本的文档。这将有助于你纠正代码并消除验证错误。如果还有其他问题，随时问我！
 
 */
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <cstring>
 #include <string>
+#include <type_traits>
 #include <vector>
 #include "lve_device.h"
 
@@ -28,6 +30,48 @@ namespace lve{
 		VkPipelineLayout pipelineLayout = nullptr;
 		VkRenderPass renderPass = nullptr;
 		uint32_t subpass = 0;
+		//renderPass 为空时使用动态渲染，管线只依赖附件格式，可以用于格式相同的任何渲染目标
+		std::vector<VkFormat> colorAttachmentFormats{};
+		VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+
+		//特化常量：对应着色器里的 layout(constant_id = N) const ...，在创建管线时写死数值，
+		//驱动可以把相关分支直接编译掉。同一份 SPIR-V 配不同的值就是不同的管线变体。
+		//顶点和片段阶段共用同一组常量，着色器里没有声明的 constant_id 会被忽略。
+		std::vector<VkSpecializationMapEntry> specializationEntries{};
+		std::vector<uint8_t> specializationData{};
+
+		//只支持 4 字节的标量（int32/uint32/float），bool 请传 VkBool32
+		template <typename T>
+		void setSpecializationConstant(uint32_t constantID, T value) {
+			static_assert(std::is_arithmetic_v<T> && sizeof(T) == 4, "specialization constant must be a 32-bit scalar");
+			for (auto& entry : specializationEntries) {
+				if (entry.constantID == constantID) {
+					std::memcpy(specializationData.data() + entry.offset, &value, sizeof(T));
+					return;
+				}
+			}
+			VkSpecializationMapEntry entry{};
+			entry.constantID = constantID;
+			entry.offset = static_cast<uint32_t>(specializationData.size());
+			entry.size = sizeof(T);
+			specializationEntries.push_back(entry);
+			specializationData.resize(specializationData.size() + sizeof(T));
+			std::memcpy(specializationData.data() + entry.offset, &value, sizeof(T));
+		}
+	};
+
+	//管线要渲染到的目标：传统路径是渲染通道，动态渲染时是附件格式（renderPass 为空）
+	struct LVEPipelineTarget {
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		std::vector<VkFormat> colorFormats{};
+		VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+
+		void applyTo(PipelineConfigInfo& configInfo) const {
+			configInfo.renderPass = renderPass;
+			configInfo.subpass = 0;
+			configInfo.colorAttachmentFormats = colorFormats;
+			configInfo.depthAttachmentFormat = depthFormat;
+		}
 	};
 
 	class LVEPipeline {
@@ -37,7 +81,8 @@ namespace lve{
 			LVEDevice& device,
 			const std::string& vertFilePath,
 			const std::string& fragFilePath,
-			const PipelineConfigInfo& configInfo);
+			const PipelineConfigInfo& configInfo,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE);
 
 		~LVEPipeline();
 
@@ -45,21 +90,53 @@ namespace lve{
 		void operator=(const LVEPipeline&) = delete;
 
 		void bind(VkCommandBuffer commandBuffer);
+		//进程内唯一的编号，绘制排序键用它区分管线
+		uint32_t getSortId() const { return sortId; }
 
 
 		static void defaultPipelineConfigInfo(PipelineConfigInfo& configInfo);
+		//PipelineConfigInfo 内部有指向自身成员的指针，不能直接拷贝，这里拷贝后把这些指针重新指向 dst 自己的成员。
+		static void copyPipelineConfigInfo(const PipelineConfigInfo& src, PipelineConfigInfo& dst);
 
 
-	private:
+		//读取 SPIR-V 文件，计算管线也用它
 		static std::vector<char> readFile(const std::string& filePath);
 
-		void createGraphicsPipeline(const std::string& vertFilePath, const std::string& fragFilePath, const PipelineConfigInfo& configInfo);
+	private:
+		void createGraphicsPipeline(
+			const std::string& vertFilePath,
+			const std::string& fragFilePath,
+			const PipelineConfigInfo& configInfo,
+			VkPipelineCache pipelineCache);
 
 		void createShaderModule(const std::vector<char>& code, VkShaderModule* shaderModule);
+		static uint32_t allocateSortId();
 
 		LVEDevice& lveDevice;
 		VkPipeline graphicsPipeline;
 		VkShaderModule vertShaderModule;
 		VkShaderModule fragShaderModule;
+		uint32_t sortId = allocateSortId();
+	};
+
+	//计算管线：只有一个计算着色器，管线布局由调用者创建和管理。
+	//数量少、创建快，直接同步创建，不经过 LVEPipelineRegistry。
+	class LVEComputePipeline {
+	public:
+		LVEComputePipeline(
+			LVEDevice& device,
+			const std::string& compFilePath,
+			VkPipelineLayout pipelineLayout,
+			VkPipelineCache pipelineCache = VK_NULL_HANDLE);
+		~LVEComputePipeline();
+
+		LVEComputePipeline(const LVEComputePipeline&) = delete;
+		LVEComputePipeline& operator=(const LVEComputePipeline&) = delete;
+
+		void bind(VkCommandBuffer commandBuffer);
+
+	private:
+		LVEDevice& lveDevice;
+		VkPipeline computePipeline = VK_NULL_HANDLE;
 	};
 }
\ No newline at end of file
@@ -0,0 +1,214 @@
+#include "lve_pipeline_registry.h"
+
+#include "lve_utils.hpp"
+
+// std
+#include <bit>
+#include <chrono>
+#include <cstring>
+#include <stdexcept>
+
+namespace lve {
+
+	bool LVEPipelineHandle::isReady() const {
+		return future.valid() && future.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+	}
+
+	LVEPipeline* LVEPipelineHandle::tryGet() const {
+		if (!isReady()) {
+			return nullptr;
+		}
+		//编译失败的管线当作一直没有准备好，调用 get() 才会看到异常
+		return future.get().pipeline.get();
+	}
+
+	LVEPipeline& LVEPipelineHandle::get() const {
+		const Result& result = future.get();
+		if (result.error) {
+			std::rethrow_exception(result.error);
+		}
+		return *result.pipeline;
+	}
+
+	void LVEPipelineHandle::wait() const {
+		if (future.valid()) {
+			future.wait();
+		}
+	}
+
+	size_t LVEPipelineKeyHash::operator()(const LVEPipelineKey& key) const {
+		size_t seed = 0;
+		hashCombine(seed, key.vertFilePath, key.fragFilePath, key.pipelineLayout, key.renderPass);
+		for (uint64_t value : key.state) {
+			hashCombine(seed, value);
+		}
+		return seed;
+	}
+
+	LVEPipelineRegistry::LVEPipelineRegistry(LVEDevice& device, LVEJobSystem& jobSystem)
+		: lveDevice{ device }, jobSystem{ jobSystem } {
+		createPipelineCache();
+		handleListenerId = lveDevice.addHandleDestroyedListener([this](uint64_t handle) { evictPipelinesUsing(handle); });
+	}
+
+	LVEPipelineRegistry::~LVEPipelineRegistry() {
+		lveDevice.removeHandleDestroyedListener(handleListenerId);
+		//工作线程还在使用 pipelineCache 和 device，必须等它们结束
+		waitIdle();
+		pipelines.clear();
+		vkDestroyPipelineCache(lveDevice.device(), pipelineCache, nullptr);
+	}
+
+	void LVEPipelineRegistry::createPipelineCache() {
+		VkPipelineCacheCreateInfo cacheInfo{};
+		cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+		cacheInfo.initialDataSize = 0;
+		cacheInfo.pInitialData = nullptr;
+
+		if (vkCreatePipelineCache(lveDevice.device(), &cacheInfo, nullptr, &pipelineCache) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create pipeline cache!");
+		}
+	}
+
+	LVEPipelineHandle LVEPipelineRegistry::requestPipeline(
+		const std::string& vertFilePath,
+		const std::string& fragFilePath,
+		const PipelineConfigInfo& configInfo)
+	{
+		LVEPipelineKey key = makeKey(vertFilePath, fragFilePath, configInfo);
+
+		std::lock_guard<std::mutex> lock{ registryMutex };
+		auto it = pipelines.find(key);
+		if (it != pipelines.end()) {
+			return it->second;
+		}
+
+		//拷贝一份配置给工作线程，调用者栈上的 configInfo 可能在编译完成前就被销毁
+		auto config = std::make_shared<PipelineConfigInfo>();
+		LVEPipeline::copyPipelineConfigInfo(configInfo, *config);
+
+		LVEDevice& device = lveDevice;
+		VkPipelineCache cache = pipelineCache;
+		std::shared_future<LVEPipelineHandle::Result> future = jobSystem.submit(
+			[&device, cache, vertFilePath, fragFilePath, config]() {
+				LVEPipelineHandle::Result result{};
+				try {
+					result.pipeline = std::make_shared<LVEPipeline>(device, vertFilePath, fragFilePath, *config, cache);
+				}
+				catch (...) {
+					result.error = std::current_exception();
+				}
+				return result;
+			}).share();
+
+		LVEPipelineHandle handle{ std::move(future) };
+		pipelines.emplace(std::move(key), handle);
+		return handle;
+	}
+
+	void LVEPipelineRegistry::evictPipelinesUsing(uint64_t handle) {
+		std::lock_guard<std::mutex> lock{ registryMutex };
+		for (auto it = pipelines.begin(); it != pipelines.end();) {
+			if (it->first.pipelineLayout == handle || it->first.renderPass == handle) {
+				it->second.wait();
+				it = pipelines.erase(it);
+			}
+			else {
+				++it;
+			}
+		}
+	}
+
+	void LVEPipelineRegistry::waitIdle() {
+		std::lock_guard<std::mutex> lock{ registryMutex };
+		for (auto& kv : pipelines) {
+			kv.second.wait();
+		}
+	}
+
+	uint32_t LVEPipelineRegistry::getPendingCount() {
+		std::lock_guard<std::mutex> lock{ registryMutex };
+		uint32_t pending = 0;
+		for (auto& kv : pipelines) {
+			if (!kv.second.isReady()) {
+				pending++;
+			}
+		}
+		return pending;
+	}
+
+	//key 覆盖所有会影响最终 VkPipeline 的状态，视口/裁剪是动态状态所以不参与
+	LVEPipelineKey LVEPipelineRegistry::makeKey(
+		const std::string& vertFilePath,
+		const std::string& fragFilePath,
+		const PipelineConfigInfo& configInfo)
+	{
+		LVEPipelineKey key{};
+		key.vertFilePath = vertFilePath;
+		key.fragFilePath = fragFilePath;
+		key.pipelineLayout = LVEDevice::handleValue(configInfo.pipelineLayout);
+		key.renderPass = LVEDevice::handleValue(configInfo.renderPass);
+
+		auto& state = key.state;
+		auto push = [&state](uint64_t value) { state.push_back(value); };
+
+		push(configInfo.inputAssemblyInfo.topology);
+		push(configInfo.inputAssemblyInfo.primitiveRestartEnable);
+
+		const auto& raster = configInfo.rasterizationInfo;
+		push(raster.depthClampEnable);
+		push(raster.rasterizerDiscardEnable);
+		push(raster.polygonMode);
+		push(raster.cullMode);
+		push(raster.frontFace);
+		push(raster.depthBiasEnable);
+		push(std::bit_cast<uint32_t>(raster.lineWidth));
+
+		push(configInfo.multisampleInfo.rasterizationSamples);
+		push(configInfo.multisampleInfo.sampleShadingEnable);
+		push(configInfo.multisampleInfo.alphaToCoverageEnable);
+
+		const auto& blend = configInfo.colorBlendAttachment;
+		push(blend.blendEnable);
+		push(blend.srcColorBlendFactor);
+		push(blend.dstColorBlendFactor);
+		push(blend.colorBlendOp);
+		push(blend.srcAlphaBlendFactor);
+		push(blend.dstAlphaBlendFactor);
+		push(blend.alphaBlendOp);
+		push(blend.colorWriteMask);
+		push(configInfo.colorBlendInfo.logicOpEnable);
+		push(configInfo.colorBlendInfo.logicOp);
+		push(configInfo.colorBlendInfo.attachmentCount);
+
+		const auto& depth = configInfo.depthStencilInfo;
+		push(depth.depthTestEnable);
+		push(depth.depthWriteEnable);
+		push(depth.depthCompareOp);
+		push(depth.stencilTestEnable);
+
+		//变长的部分前面带上数量，不同长度的组合不会展开成同一个序列
+		push(configInfo.dynamicStateEnables.size());
+		for (auto dynamicState : configInfo.dynamicStateEnables) {
+			push(dynamicState);
+		}
+
+		//特化常量不同就是不同的管线变体
+		push(configInfo.specializationEntries.size());
+		for (const auto& entry : configInfo.specializationEntries) {
+			uint32_t value = 0;
+			std::memcpy(&value, configInfo.specializationData.data() + entry.offset, sizeof(value));
+			push(entry.constantID);
+			push(value);
+		}
+
+		push(configInfo.subpass);
+		push(configInfo.colorAttachmentFormats.size());
+		for (auto format : configInfo.colorAttachmentFormats) {
+			push(format);
+		}
+		push(configInfo.depthAttachmentFormat);
+		return key;
+	}
+
+}  // namespace lve
@@ -0,0 +1,103 @@
+#pragma once
+
+#include "lve_device.h"
+#include "lve_job_system.h"
+#include "lve_pipeline.h"
+
+// std
+#include <cstdint>
+#include <exception>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace lve {
+
+	//注册表去重用的完整 key：哈希只用来分桶，命中后还要逐项比较，避免哈希碰撞返回别的配置的管线
+	struct LVEPipelineKey {
+		std::string vertFilePath;
+		std::string fragFilePath;
+		//句柄按整数保存，对象销毁时注册表据此清掉引用它的条目
+		uint64_t pipelineLayout = 0;
+		uint64_t renderPass = 0;
+		//其余影响 VkPipeline 的状态按固定顺序展开
+		std::vector<uint64_t> state;
+
+		bool operator==(const LVEPipelineKey& other) const = default;
+	};
+
+	struct LVEPipelineKeyHash {
+		size_t operator()(const LVEPipelineKey& key) const;
+	};
+
+	//异步编译管线的句柄，类似 std::shared_future：可以随意拷贝，编译完成前 tryGet 返回 nullptr。
+	class LVEPipelineHandle {
+	public:
+		LVEPipelineHandle() = default;
+
+		bool valid() const { return future.valid(); }
+		//编译已经结束（成功或失败）时返回 true，不会阻塞
+		bool isReady() const;
+		//编译成功则返回管线，否则返回 nullptr（未完成或编译失败），不会阻塞
+		LVEPipeline* tryGet() const;
+		//阻塞直到编译完成，编译失败时重新抛出工作线程里的异常
+		LVEPipeline& get() const;
+		void wait() const;
+
+	private:
+		friend class LVEPipelineRegistry;
+		//编译失败时 pipeline 为空、error 保存异常，tryGet 只检查结果，不需要每帧重新抛出再捕获
+		struct Result {
+			std::shared_ptr<LVEPipeline> pipeline;
+			std::exception_ptr error;
+		};
+
+		explicit LVEPipelineHandle(std::shared_future<Result> future) : future{ std::move(future) } {}
+
+		std::shared_future<Result> future;
+	};
+
+	//管线注册表：按 (着色器路径 + 管线配置 + 特化常量) 计算 key 去重，在工作线程上调用 vkCreateGraphicsPipelines，
+	//所有编译共用一个 VkPipelineCache。同一个 key 重复请求直接返回已有句柄。
+	//管线布局或渲染通道通过 LVEDevice::notifyHandleDestroyed 通知销毁后，引用它的条目被移除，复用同一个句柄值的新对象不会命中旧管线。
+	class LVEPipelineRegistry {
+	public:
+		LVEPipelineRegistry(LVEDevice& device, LVEJobSystem& jobSystem);
+		~LVEPipelineRegistry();
+
+		LVEPipelineRegistry(const LVEPipelineRegistry&) = delete;
+		LVEPipelineRegistry& operator=(const LVEPipelineRegistry&) = delete;
+
+		//立即返回，configInfo 会被拷贝一份交给工作线程，调用者可以马上释放它
+		LVEPipelineHandle requestPipeline(
+			const std::string& vertFilePath,
+			const std::string& fragFilePath,
+			const PipelineConfigInfo& configInfo);
+
+		//阻塞直到目前所有请求都编译完成，启动时可以用来等待整套管线
+		void waitIdle();
+		uint32_t getPendingCount();
+
+		static LVEPipelineKey makeKey(
+			const std::string& vertFilePath,
+			const std::string& fragFilePath,
+			const PipelineConfigInfo& configInfo);
+
+	private:
+		void createPipelineCache();
+		//移除引用 handle（管线布局或渲染通道）的条目，还在编译的先等它结束
+		void evictPipelinesUsing(uint64_t handle);
+
+		LVEDevice& lveDevice;
+		LVEJobSystem& jobSystem;
+		VkPipelineCache pipelineCache = VK_NULL_HANDLE;
+		uint32_t handleListenerId = 0;
+
+		std::mutex registryMutex;
+		std::unordered_map<LVEPipelineKey, LVEPipelineHandle, LVEPipelineKeyHash> pipelines;
+	};
+
+}  // namespace lve
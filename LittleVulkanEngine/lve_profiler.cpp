@@ -0,0 +1,170 @@
+#include "lve_profiler.h"
+
+// std
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <vector>
+
+namespace lve {
+
+	namespace {
+
+		struct ZoneEvent {
+			const char* name;
+			uint64_t startNs;
+			uint64_t endNs;
+		};
+
+		//每个线程一个固定容量的缓冲区，只有所属线程写入。
+		//count 用 release 发布，导出线程用 acquire 读取，读到的 count 之前的事件都是完整的。
+		struct ThreadBuffer {
+			static constexpr uint32_t CAPACITY = 1 << 16;
+
+			std::vector<ZoneEvent> events;
+			std::atomic<uint32_t> count{ 0 };
+			std::atomic<uint32_t> epoch{ 0 };
+			std::atomic<uint32_t> dropped{ 0 };
+			uint32_t threadId = 0;
+			std::string threadName;
+		};
+
+		struct ProfilerState {
+			std::mutex buffersMutex;	//只在注册线程、命名线程和导出时使用
+			std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+			std::atomic<uint32_t> captureEpoch{ 0 };
+			std::chrono::steady_clock::time_point baseTime = std::chrono::steady_clock::now();
+		};
+
+		ProfilerState& state() {
+			static ProfilerState profilerState;
+			return profilerState;
+		}
+
+		//缓冲区归全局状态所有，线程退出后事件仍然可以导出
+		ThreadBuffer& threadBuffer() {
+			thread_local ThreadBuffer* buffer = nullptr;
+			if (buffer == nullptr) {
+				auto& profilerState = state();
+				std::lock_guard<std::mutex> lock{ profilerState.buffersMutex };
+				auto newBuffer = std::make_unique<ThreadBuffer>();
+				newBuffer->events.resize(ThreadBuffer::CAPACITY);
+				newBuffer->threadId = static_cast<uint32_t>(profilerState.buffers.size()) + 1;
+				buffer = newBuffer.get();
+				profilerState.buffers.push_back(std::move(newBuffer));
+			}
+			return *buffer;
+		}
+
+		void writeJsonString(std::ofstream& out, const std::string& value) {
+			out << '"';
+			for (char c : value) {
+				if (c == '"' || c == '\\') {
+					out << '\\' << c;
+				}
+				else if (static_cast<unsigned char>(c) < 0x20) {
+					out << ' ';
+				}
+				else {
+					out << c;
+				}
+			}
+			out << '"';
+		}
+
+	}  // namespace
+
+	std::atomic<bool> LVEProfiler::capturing{ false };
+
+	void LVEProfiler::startCapture() {
+		//新的纪元让每个线程在下一次写入时自己清空缓冲区，不需要跨线程重置
+		state().captureEpoch.fetch_add(1, std::memory_order_acq_rel);
+		capturing.store(true, std::memory_order_release);
+	}
+
+	void LVEProfiler::stopCapture() {
+		capturing.store(false, std::memory_order_release);
+	}
+
+	void LVEProfiler::setThreadName(const char* name) {
+		ThreadBuffer& buffer = threadBuffer();
+		std::lock_guard<std::mutex> lock{ state().buffersMutex };
+		buffer.threadName = name;
+	}
+
+	uint64_t LVEProfiler::nowNs() {
+		auto elapsed = std::chrono::steady_clock::now() - state().baseTime;
+		//加 1 保证有效时间戳不为 0，LVEProfileZone 用 0 表示没有在采集
+		return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(elapsed).count()) + 1;
+	}
+
+	void LVEProfiler::recordZone(const char* name, uint64_t startNs, uint64_t endNs) {
+		ThreadBuffer& buffer = threadBuffer();
+		uint32_t epoch = state().captureEpoch.load(std::memory_order_acquire);
+		if (buffer.epoch.load(std::memory_order_relaxed) != epoch) {
+			buffer.count.store(0, std::memory_order_relaxed);
+			buffer.dropped.store(0, std::memory_order_relaxed);
+			buffer.epoch.store(epoch, std::memory_order_release);
+		}
+
+		uint32_t index = buffer.count.load(std::memory_order_relaxed);
+		if (index >= ThreadBuffer::CAPACITY) {
+			buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+			return;
+		}
+		buffer.events[index] = ZoneEvent{ name, startNs, endNs };
+		buffer.count.store(index + 1, std::memory_order_release);
+	}
+
+	void LVEProfiler::writeChromeTrace(const std::string& filePath) {
+		std::ofstream out{ filePath, std::ios::trunc };
+		if (!out.is_open()) {
+			throw std::runtime_error("failed to open trace file: " + filePath);
+		}
+
+		auto& profilerState = state();
+		uint32_t epoch = profilerState.captureEpoch.load(std::memory_order_acquire);
+
+		std::lock_guard<std::mutex> lock{ profilerState.buffersMutex };
+		out << std::fixed << std::setprecision(3);
+		out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+		bool first = true;
+		for (const auto& buffer : profilerState.buffers) {
+			if (buffer->epoch.load(std::memory_order_acquire) != epoch) {
+				continue;
+			}
+
+			if (!buffer->threadName.empty()) {
+				out << (first ? "" : ",") << "\n{\"ph\":\"M\",\"name\":\"thread_name\",\"pid\":1,\"tid\":" << buffer->threadId
+					<< ",\"args\":{\"name\":";
+				writeJsonString(out, buffer->threadName);
+				out << "}}";
+				first = false;
+			}
+
+			//Chrome trace 的时间单位是微秒
+			uint32_t count = buffer->count.load(std::memory_order_acquire);
+			for (uint32_t i = 0; i < count; i++) {
+				const ZoneEvent& event = buffer->events[i];
+				out << (first ? "" : ",") << "\n{\"ph\":\"X\",\"cat\":\"lve\",\"name\":";
+				writeJsonString(out, event.name);
+				out << ",\"pid\":1,\"tid\":" << buffer->threadId
+					<< ",\"ts\":" << static_cast<double>(event.startNs) / 1000.0
+					<< ",\"dur\":" << static_cast<double>(event.endNs - event.startNs) / 1000.0 << "}";
+				first = false;
+			}
+
+			uint32_t dropped = buffer->dropped.load(std::memory_order_relaxed);
+			if (dropped > 0) {
+				out << (first ? "" : ",") << "\n{\"ph\":\"i\",\"s\":\"t\",\"name\":\"dropped " << dropped
+					<< " zones\",\"pid\":1,\"tid\":" << buffer->threadId << ",\"ts\":0}";
+				first = false;
+			}
+		}
+		out << "\n]}\n";
+	}
+
+}  // namespace lve
@@ -0,0 +1,71 @@
+#pragma once
+
+// std
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+//编译期开关：定义 LVE_PROFILER_ENABLED=0 时所有宏展开为空，完全没有开销。
+//打开时未在采集的区间只有一次 relaxed 原子读。
+#ifndef LVE_PROFILER_ENABLED
+#define LVE_PROFILER_ENABLED 1
+#endif
+
+namespace lve {
+
+	//CPU 帧分析器：每个线程把区间写进自己的缓冲区（写入不加锁），采集结束后导出为 Chrome trace JSON，
+	//用 chrome://tracing 或 Perfetto 打开。区间名必须是静态存储期的字符串（字符串字面量、__func__），只保存指针。
+	class LVEProfiler {
+	public:
+		static void startCapture();
+		static void stopCapture();
+		static bool isCapturing() { return capturing.load(std::memory_order_relaxed); }
+		//导出最近一次采集的所有区间，可以在 stopCapture 之后任意时刻调用
+		static void writeChromeTrace(const std::string& filePath);
+
+		//给当前线程命名，显示在 trace 的线程轨道上
+		static void setThreadName(const char* name);
+
+		static uint64_t nowNs();
+		static void recordZone(const char* name, uint64_t startNs, uint64_t endNs);
+
+	private:
+		static std::atomic<bool> capturing;
+	};
+
+	//RAII 区间：构造时记录开始时间，析构时写入一条完整事件
+	class LVEProfileZone {
+	public:
+		explicit LVEProfileZone(const char* name) : name{ name } {
+			if (LVEProfiler::isCapturing()) {
+				startNs = LVEProfiler::nowNs();
+			}
+		}
+		~LVEProfileZone() {
+			if (startNs != 0) {
+				LVEProfiler::recordZone(name, startNs, LVEProfiler::nowNs());
+			}
+		}
+
+		LVEProfileZone(const LVEProfileZone&) = delete;
+		LVEProfileZone& operator=(const LVEProfileZone&) = delete;
+
+	private:
+		const char* name;
+		uint64_t startNs = 0;
+	};
+
+}  // namespace lve
+
+#define LVE_PROFILE_CONCAT_INNER(a, b) a##b
+#define LVE_PROFILE_CONCAT(a, b) LVE_PROFILE_CONCAT_INNER(a, b)
+
+#if LVE_PROFILER_ENABLED
+#define LVE_PROFILE_SCOPE(name) ::lve::LVEProfileZone LVE_PROFILE_CONCAT(lveProfileZone, __LINE__){ name }
+#define LVE_PROFILE_FUNCTION() LVE_PROFILE_SCOPE(__func__)
+#define LVE_PROFILE_THREAD(name) ::lve::LVEProfiler::setThreadName(name)
+#else
+#define LVE_PROFILE_SCOPE(name)
+#define LVE_PROFILE_FUNCTION()
+#define LVE_PROFILE_THREAD(name)
+#endif
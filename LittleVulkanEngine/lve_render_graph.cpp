@@ -0,0 +1,863 @@
+#include "lve_render_graph.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+namespace lve {
+
+	static constexpr VkAccessFlags WRITE_ACCESS_MASK =
+		VK_ACCESS_SHADER_WRITE_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT |
+		VK_ACCESS_TRANSFER_WRITE_BIT | VK_ACCESS_HOST_WRITE_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+
+	static bool isDepthFormat(VkFormat format) {
+		return format == VK_FORMAT_D16_UNORM || format == VK_FORMAT_X8_D24_UNORM_PACK32 || format == VK_FORMAT_D32_SFLOAT ||
+			format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+	}
+
+	static bool hasStencilComponent(VkFormat format) {
+		return format == VK_FORMAT_D16_UNORM_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT || format == VK_FORMAT_D32_SFLOAT_S8_UINT;
+	}
+
+	static VkAttachmentLoadOp toVkLoadOp(LVERenderGraph::LoadOp load) {
+		switch (load) {
+		case LVERenderGraph::LoadOp::Clear:
+			return VK_ATTACHMENT_LOAD_OP_CLEAR;
+		case LVERenderGraph::LoadOp::Load:
+			return VK_ATTACHMENT_LOAD_OP_LOAD;
+		default:
+			return VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+		}
+	}
+
+	// ----------------------------- PassBuilder -----------------------------
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::writeColor(
+		LVERenderGraphImage image, LoadOp load, VkClearColorValue clearValue)
+	{
+		Access& access = graph.addAccess(passIndex, image);
+		access.layout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		access.stages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+		access.access = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (load == LoadOp::Load ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT : 0);
+		access.usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+		access.read = load == LoadOp::Load;
+		access.write = true;
+		access.discard = load != LoadOp::Load;
+		access.attachment = Access::Attachment::Color;
+		access.load = load;
+		access.clearValue.color = clearValue;
+		return *this;
+	}
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::writeDepth(LVERenderGraphImage image, LoadOp load, float clearDepth) {
+		Access& access = graph.addAccess(passIndex, image);
+		access.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		access.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		access.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		access.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		access.read = load == LoadOp::Load;
+		access.write = true;
+		access.discard = load != LoadOp::Load;
+		access.attachment = Access::Attachment::Depth;
+		access.load = load;
+		access.clearValue.depthStencil = { clearDepth, 0 };
+		return *this;
+	}
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::readDepth(LVERenderGraphImage image) {
+		Access& access = graph.addAccess(passIndex, image);
+		access.layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_READ_ONLY_OPTIMAL;
+		access.stages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		access.access = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		access.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+		access.read = true;
+		access.write = false;
+		access.discard = false;
+		access.attachment = Access::Attachment::Depth;
+		access.load = LoadOp::Load;
+		return *this;
+	}
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::sample(LVERenderGraphImage image, VkPipelineStageFlags stages) {
+		Access& access = graph.addAccess(passIndex, image);
+		access.layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+		access.stages = stages;
+		access.access = VK_ACCESS_SHADER_READ_BIT;
+		access.usage = VK_IMAGE_USAGE_SAMPLED_BIT;
+		access.read = true;
+		access.write = false;
+		access.discard = false;
+		return *this;
+	}
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::readStorage(LVERenderGraphImage image) {
+		Access& access = graph.addAccess(passIndex, image);
+		access.layout = VK_IMAGE_LAYOUT_GENERAL;
+		access.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		access.access = VK_ACCESS_SHADER_READ_BIT;
+		access.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+		access.read = true;
+		access.write = false;
+		access.discard = false;
+		return *this;
+	}
+
+	//存储图像可能只写一部分像素，之前的内容仍然需要保留
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::writeStorage(LVERenderGraphImage image) {
+		Access& access = graph.addAccess(passIndex, image);
+		access.layout = VK_IMAGE_LAYOUT_GENERAL;
+		access.stages = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+		access.access = VK_ACCESS_SHADER_WRITE_BIT;
+		access.usage = VK_IMAGE_USAGE_STORAGE_BIT;
+		access.read = false;
+		access.write = true;
+		access.discard = false;
+		return *this;
+	}
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::setSideEffects() {
+		graph.passes[passIndex].sideEffects = true;
+		return *this;
+	}
+
+	LVERenderGraph::PassBuilder& LVERenderGraph::PassBuilder::execute(ExecuteFunction function) {
+		graph.passes[passIndex].function = std::move(function);
+		return *this;
+	}
+
+	// ----------------------------- LVERenderGraph -----------------------------
+
+	LVERenderGraph::LVERenderGraph(LVEDevice& device) : lveDevice{ device } {}
+
+	//已提交的帧可能还在使用这些对象，全部交给延迟销毁队列
+	LVERenderGraph::~LVERenderGraph() {
+		VkDevice device = lveDevice.device();
+		std::vector<VkFramebuffer> framebuffers;
+		std::vector<VkRenderPass> renderPasses;
+		for (const Pass& pass : passes) {
+			for (const auto& entry : pass.framebuffers) {
+				framebuffers.push_back(entry.second);
+			}
+			if (pass.renderPass != VK_NULL_HANDLE) {
+				lveDevice.notifyHandleDestroyed(pass.renderPass);
+				renderPasses.push_back(pass.renderPass);
+			}
+		}
+		std::vector<VkImageView> views;
+		std::vector<VkImage> transientImages;
+		for (const Image& image : images) {
+			if (image.imported) {
+				continue;
+			}
+			if (image.view != VK_NULL_HANDLE) {
+				views.push_back(image.view);
+			}
+			if (image.image != VK_NULL_HANDLE) {
+				transientImages.push_back(image.image);
+			}
+		}
+		std::vector<VkDeviceMemory> memories;
+		for (const MemoryBlock& block : memoryBlocks) {
+			if (block.memory != VK_NULL_HANDLE) {
+				memories.push_back(block.memory);
+			}
+		}
+		lveDevice.retire([device, framebuffers, renderPasses, views, transientImages, memories]() {
+			for (VkFramebuffer framebuffer : framebuffers) {
+				vkDestroyFramebuffer(device, framebuffer, nullptr);
+			}
+			for (VkRenderPass renderPass : renderPasses) {
+				vkDestroyRenderPass(device, renderPass, nullptr);
+			}
+			for (VkImageView view : views) {
+				vkDestroyImageView(device, view, nullptr);
+			}
+			for (VkImage image : transientImages) {
+				vkDestroyImage(device, image, nullptr);
+			}
+			for (VkDeviceMemory memory : memories) {
+				vkFreeMemory(device, memory, nullptr);
+			}
+		});
+	}
+
+	LVERenderGraphImage LVERenderGraph::createImage(const std::string& name, const ImageDesc& desc) {
+		assert(!compiled && "Cannot add images after compile");
+		Image image{};
+		image.name = name;
+		image.desc = desc;
+		images.push_back(image);
+		return LVERenderGraphImage{ static_cast<uint32_t>(images.size() - 1) };
+	}
+
+	LVERenderGraphImage LVERenderGraph::importImage(const std::string& name, const ImportDesc& desc) {
+		assert(!compiled && "Cannot add images after compile");
+		Image image{};
+		image.name = name;
+		image.desc = ImageDesc{ desc.format, desc.extent };
+		image.imported = true;
+		image.import = desc;
+		images.push_back(image);
+		return LVERenderGraphImage{ static_cast<uint32_t>(images.size() - 1) };
+	}
+
+	void LVERenderGraph::setImportedImage(LVERenderGraphImage image, VkImage vkImage, VkImageView view) {
+		assert(image.isValid() && image.index < images.size() && images[image.index].imported && "Image is not imported");
+		images[image.index].image = vkImage;
+		images[image.index].view = view;
+	}
+
+	LVERenderGraph::PassBuilder LVERenderGraph::addPass(const std::string& name, PassType type) {
+		assert(!compiled && "Cannot add passes after compile");
+		Pass pass{};
+		pass.name = name;
+		pass.type = type;
+		passes.push_back(std::move(pass));
+		return PassBuilder{ *this, static_cast<uint32_t>(passes.size() - 1) };
+	}
+
+	LVERenderGraph::Access& LVERenderGraph::addAccess(uint32_t passIndex, LVERenderGraphImage image) {
+		assert(!compiled && "Cannot declare accesses after compile");
+		assert(image.isValid() && image.index < images.size() && "Invalid render graph image");
+		Pass& pass = passes[passIndex];
+		for (const Access& access : pass.accesses) {
+			assert(access.image != image.index && "Image declared twice in the same pass");
+		}
+		pass.accesses.push_back(Access{});
+		pass.accesses.back().image = image.index;
+		return pass.accesses.back();
+	}
+
+	VkRenderPass LVERenderGraph::getRenderPass(const std::string& passName) const {
+		for (const Pass& pass : passes) {
+			if (pass.name == passName) {
+				return pass.renderPass;
+			}
+		}
+		return VK_NULL_HANDLE;
+	}
+
+	LVEPipelineTarget LVERenderGraph::getPipelineTarget(const std::string& passName) const {
+		LVEPipelineTarget target{};
+		for (const Pass& pass : passes) {
+			if (pass.name != passName || pass.type != PassType::Graphics) {
+				continue;
+			}
+			target.renderPass = pass.renderPass;
+			if (target.renderPass == VK_NULL_HANDLE) {
+				for (const Access& access : pass.accesses) {
+					if (access.attachment == Access::Attachment::Color) {
+						target.colorFormats.push_back(images[access.image].desc.format);
+					}
+					else if (access.attachment == Access::Attachment::Depth) {
+						target.depthFormat = images[access.image].desc.format;
+					}
+				}
+			}
+			break;
+		}
+		return target;
+	}
+
+	void LVERenderGraph::compile() {
+		LVE_PROFILE_FUNCTION();
+		assert(!compiled && "Render graph already compiled");
+		for (Image& image : images) {
+			if (isDepthFormat(image.desc.format)) {
+				image.aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
+				if (hasStencilComponent(image.desc.format)) {
+					image.aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
+				}
+			}
+			else {
+				image.aspect = VK_IMAGE_ASPECT_COLOR_BIT;
+			}
+		}
+
+		cullPasses();
+		computeLifetimes();
+		createTransientImages();
+
+		//先模拟一遍得到每块内存在帧末的状态，下一帧第一次使用时要等上一帧（或复用同一块内存的前一张图像）的访问结束
+		std::vector<ImageState> blockStates(memoryBlocks.size());
+		simulate(blockStates, false);
+		simulate(blockStates, true);
+
+		for (uint32_t i = 0; i < passes.size(); i++) {
+			Pass& pass = passes[i];
+			if (!pass.alive) {
+				continue;
+			}
+			if (!pass.accesses.empty()) {
+				pass.extent = images[pass.accesses.front().image].desc.extent;
+			}
+			if (pass.type == PassType::Graphics) {
+				collectAttachments(i);
+				if (!lveDevice.supportsDynamicRendering()) {
+					createRenderPass(i);
+				}
+			}
+		}
+		compiled = true;
+	}
+
+	void LVERenderGraph::cullPasses() {
+		std::vector<bool> outputs(images.size(), false);
+		for (size_t i = 0; i < images.size(); i++) {
+			outputs[i] = images[i].imported && images[i].import.finalLayout != VK_IMAGE_LAYOUT_UNDEFINED;
+		}
+		std::vector<CullPass> cullInput(passes.size());
+		for (size_t p = 0; p < passes.size(); p++) {
+			cullInput[p].sideEffects = passes[p].sideEffects;
+			for (const Access& access : passes[p].accesses) {
+				cullInput[p].accesses.push_back(CullAccess{ access.image, access.read, access.write, access.discard });
+			}
+		}
+
+		std::vector<bool> alive = findLivePasses(cullInput, std::move(outputs));
+		culledPassCount = 0;
+		for (size_t p = 0; p < passes.size(); p++) {
+			passes[p].alive = alive[p];
+			if (!alive[p]) {
+				culledPassCount++;
+			}
+		}
+	}
+
+	//从后往前：通道写了后面需要的图像（或有副作用）才保留；
+	//保留的通道完整覆盖的图像在它之前不再需要，读到的图像在它之前需要
+	std::vector<bool> LVERenderGraph::findLivePasses(const std::vector<CullPass>& passes, std::vector<bool> needed) {
+		std::vector<bool> alive(passes.size(), false);
+		for (size_t p = passes.size(); p-- > 0;) {
+			const CullPass& pass = passes[p];
+			alive[p] = pass.sideEffects;
+			for (const CullAccess& access : pass.accesses) {
+				if (access.write && needed[access.image]) {
+					alive[p] = true;
+				}
+			}
+			if (!alive[p]) {
+				continue;
+			}
+			for (const CullAccess& access : pass.accesses) {
+				if (access.write && access.discard) {
+					needed[access.image] = false;
+				}
+			}
+			for (const CullAccess& access : pass.accesses) {
+				if (access.read || (access.write && !access.discard)) {
+					needed[access.image] = true;
+				}
+			}
+		}
+		return alive;
+	}
+
+	void LVERenderGraph::computeLifetimes() {
+		for (uint32_t p = 0; p < passes.size(); p++) {
+			if (!passes[p].alive) {
+				continue;
+			}
+			for (const Access& access : passes[p].accesses) {
+				Image& image = images[access.image];
+				if (image.firstPass == ~0u) {
+					image.firstPass = p;
+				}
+				image.lastPass = p;
+				image.usage |= access.usage;
+			}
+		}
+	}
+
+	//每张临时图像先不带内存创建出来查询内存需求，再用 planAliasing 分组，同一组的图像都从偏移 0 开始绑定到同一块内存
+	void LVERenderGraph::createTransientImages() {
+		VkDevice device = lveDevice.device();
+		const uint32_t deviceLocalTypeBits = lveDevice.getMemoryTypeBits(VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+		std::vector<uint32_t> transientImages;
+		std::vector<AliasRequest> requests;
+		transientMemoryRequested = 0;
+		for (uint32_t i = 0; i < images.size(); i++) {
+			Image& image = images[i];
+			if (image.imported || image.firstPass == ~0u) {
+				continue;
+			}
+
+			VkImageCreateInfo imageInfo{};
+			imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+			imageInfo.imageType = VK_IMAGE_TYPE_2D;
+			imageInfo.extent = { image.desc.extent.width, image.desc.extent.height, 1 };
+			imageInfo.mipLevels = 1;
+			imageInfo.arrayLayers = 1;
+			imageInfo.format = image.desc.format;
+			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			imageInfo.usage = image.usage;
+			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+			if (vkCreateImage(device, &imageInfo, nullptr, &image.image) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create render graph image!");
+			}
+			vkGetImageMemoryRequirements(device, image.image, &image.requirements);
+			uint32_t memoryTypeBits = image.requirements.memoryTypeBits & deviceLocalTypeBits;
+			if (memoryTypeBits == 0) {
+				throw std::runtime_error("failed to find suitable memory type for render graph image!");
+			}
+			transientMemoryRequested += image.requirements.size;
+			transientImages.push_back(i);
+			requests.push_back(AliasRequest{ image.firstPass, image.lastPass, image.requirements.size, memoryTypeBits });
+		}
+
+		std::vector<AliasBlock> plan = planAliasing(requests);
+		transientMemoryAllocated = 0;
+		memoryBlocks.resize(plan.size());
+		for (uint32_t b = 0; b < plan.size(); b++) {
+			MemoryBlock& block = memoryBlocks[b];
+			block.size = plan[b].size;
+			VkMemoryAllocateInfo allocInfo{};
+			allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+			allocInfo.allocationSize = block.size;
+			allocInfo.memoryTypeIndex = lveDevice.findMemoryType(plan[b].memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+			if (vkAllocateMemory(device, &allocInfo, nullptr, &block.memory) != VK_SUCCESS) {
+				throw std::runtime_error("failed to allocate render graph memory!");
+			}
+			transientMemoryAllocated += block.size;
+
+			for (uint32_t request : plan[b].requests) {
+				uint32_t index = transientImages[request];
+				block.images.push_back(index);
+				images[index].memoryBlock = b;
+				if (vkBindImageMemory(device, images[index].image, block.memory, 0) != VK_SUCCESS) {
+					throw std::runtime_error("failed to bind render graph image memory!");
+				}
+				createImageView(images[index]);
+			}
+		}
+	}
+
+	std::vector<LVERenderGraph::AliasBlock> LVERenderGraph::planAliasing(const std::vector<AliasRequest>& requests) {
+		std::vector<uint32_t> order(requests.size());
+		for (uint32_t i = 0; i < order.size(); i++) {
+			order[i] = i;
+		}
+		std::stable_sort(order.begin(), order.end(), [&requests](uint32_t a, uint32_t b) {
+			return requests[a].size > requests[b].size;
+		});
+
+		std::vector<AliasBlock> blocks;
+		for (uint32_t index : order) {
+			const AliasRequest& request = requests[index];
+			AliasBlock* target = nullptr;
+			for (AliasBlock& block : blocks) {
+				if ((block.memoryTypeBits & request.memoryTypeBits) == 0) {
+					continue;
+				}
+				bool overlaps = false;
+				for (uint32_t other : block.requests) {
+					if (request.firstPass <= requests[other].lastPass && requests[other].firstPass <= request.lastPass) {
+						overlaps = true;
+						break;
+					}
+				}
+				if (!overlaps) {
+					target = &block;
+					break;
+				}
+			}
+			if (target == nullptr) {
+				blocks.push_back(AliasBlock{});
+				target = &blocks.back();
+			}
+			target->size = std::max(target->size, request.size);
+			target->memoryTypeBits &= request.memoryTypeBits;
+			target->requests.push_back(index);
+		}
+		return blocks;
+	}
+
+	void LVERenderGraph::createImageView(Image& image) {
+		VkImageViewCreateInfo viewInfo{};
+		viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+		viewInfo.image = image.image;
+		viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+		viewInfo.format = image.desc.format;
+		//采样深度模板图像时视图只能包含深度
+		viewInfo.subresourceRange.aspectMask =
+			(image.aspect & VK_IMAGE_ASPECT_DEPTH_BIT) != 0 ? VK_IMAGE_ASPECT_DEPTH_BIT : image.aspect;
+		viewInfo.subresourceRange.baseMipLevel = 0;
+		viewInfo.subresourceRange.levelCount = 1;
+		viewInfo.subresourceRange.baseArrayLayer = 0;
+		viewInfo.subresourceRange.layerCount = 1;
+		if (vkCreateImageView(lveDevice.device(), &viewInfo, nullptr, &image.view) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create render graph image view!");
+		}
+	}
+
+	//按执行顺序模拟每张图像的布局和访问，决定每个通道之前需要哪些屏障：
+	//布局变化、写之前（写后写、读后写）一定要屏障；只读时，只有最后一次写还没对这个阶段可见才需要
+	void LVERenderGraph::simulate(std::vector<ImageState>& blockStates, bool emitBarriers) {
+		std::vector<ImageState> states(images.size());
+		std::vector<bool> used(images.size(), false);
+		for (size_t i = 0; i < images.size(); i++) {
+			if (images[i].imported) {
+				states[i].layout = images[i].import.initialLayout;
+				states[i].writeStages = images[i].import.initialStage;
+				states[i].writeAccess = images[i].import.initialAccess;
+			}
+		}
+		if (emitBarriers) {
+			barrierCount = 0;
+		}
+
+		for (Pass& pass : passes) {
+			if (!pass.alive) {
+				continue;
+			}
+			for (const Access& access : pass.accesses) {
+				const Image& image = images[access.image];
+				ImageState& state = states[access.image];
+				bool firstUse = !used[access.image];
+				used[access.image] = true;
+				if (!image.imported && firstUse) {
+					//内存里之前是上一帧或同一块内存上另一张图像的内容
+					const ImageState& previous = blockStates[image.memoryBlock];
+					state = ImageState{};
+					state.writeStages = previous.writeStages | previous.readStages;
+					state.writeAccess = previous.writeAccess;
+				}
+				bool discard = access.discard || (!image.imported && firstUse);
+
+				bool layoutChanged = state.layout != access.layout;
+				bool needBarrier = false;
+				VkPipelineStageFlags srcStages = 0;
+				VkAccessFlags srcAccess = 0;
+				if (layoutChanged || access.write) {
+					srcStages = state.writeStages | state.readStages;
+					srcAccess = state.writeAccess;
+					needBarrier = layoutChanged || srcStages != 0;
+				}
+				else if (state.writeStages != 0 && (access.stages & ~state.visibleStages) != 0) {
+					srcStages = state.writeStages;
+					srcAccess = state.writeAccess;
+					needBarrier = true;
+				}
+
+				if (needBarrier && emitBarriers) {
+					VkImageMemoryBarrier barrier{};
+					barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+					barrier.srcAccessMask = srcAccess;
+					barrier.dstAccessMask = access.access;
+					barrier.oldLayout = discard ? VK_IMAGE_LAYOUT_UNDEFINED : state.layout;
+					barrier.newLayout = access.layout;
+					barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+					barrier.subresourceRange = { image.aspect, 0, 1, 0, 1 };
+					pass.barriers.push_back(barrier);
+					pass.barrierImages.push_back(access.image);
+					pass.srcStages |= srcStages != 0 ? srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+					pass.dstStages |= access.stages;
+					barrierCount++;
+				}
+
+				state.layout = access.layout;
+				if (access.write) {
+					state.writeStages = access.stages;
+					state.writeAccess = access.access & WRITE_ACCESS_MASK;
+					state.readStages = access.read ? access.stages : 0;
+					state.visibleStages = 0;
+				}
+				else {
+					if (layoutChanged) {
+						//布局转换也是一次写，之后其他阶段读之前要和这个屏障串起来
+						state.writeStages = access.stages;
+						state.writeAccess = 0;
+						state.readStages = 0;
+						state.visibleStages = access.stages;
+					}
+					else if (needBarrier) {
+						state.visibleStages |= access.stages;
+					}
+					state.readStages |= access.stages;
+				}
+				if (!image.imported) {
+					blockStates[image.memoryBlock] = state;
+				}
+			}
+		}
+
+		if (!emitBarriers) {
+			return;
+		}
+		finalBarriers.clear();
+		finalBarrierImages.clear();
+		finalSrcStages = 0;
+		for (uint32_t i = 0; i < images.size(); i++) {
+			const Image& image = images[i];
+			if (!image.imported || image.import.finalLayout == VK_IMAGE_LAYOUT_UNDEFINED ||
+				states[i].layout == image.import.finalLayout) {
+				continue;
+			}
+			const ImageState& state = states[i];
+			VkImageMemoryBarrier barrier{};
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcAccessMask = state.writeAccess;
+			barrier.dstAccessMask = 0;
+			barrier.oldLayout = state.layout;
+			barrier.newLayout = image.import.finalLayout;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange = { image.aspect, 0, 1, 0, 1 };
+			finalBarriers.push_back(barrier);
+			finalBarrierImages.push_back(i);
+			VkPipelineStageFlags srcStages = state.writeStages | state.readStages;
+			finalSrcStages |= srcStages != 0 ? srcStages : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			barrierCount++;
+		}
+	}
+
+	//附件的内容只有后面还有通道读它（或者它是导入的图像）时才需要写回
+	void LVERenderGraph::chooseStoreOps(uint32_t passIndex, std::vector<VkAttachmentStoreOp>& storeOps) const {
+		storeOps.clear();
+		for (const Access& access : passes[passIndex].accesses) {
+			if (access.attachment == Access::Attachment::None) {
+				continue;
+			}
+			bool store = images[access.image].imported;
+			for (uint32_t p = passIndex + 1; p < passes.size() && !store; p++) {
+				if (!passes[p].alive) {
+					continue;
+				}
+				bool found = false;
+				for (const Access& later : passes[p].accesses) {
+					if (later.image == access.image) {
+						store = later.read || !later.discard;
+						found = true;
+						break;
+					}
+				}
+				if (found) {
+					break;
+				}
+			}
+			storeOps.push_back(store ? VK_ATTACHMENT_STORE_OP_STORE : VK_ATTACHMENT_STORE_OP_DONT_CARE);
+		}
+	}
+
+	//附件按声明的顺序排列，两种渲染路径共用
+	void LVERenderGraph::collectAttachments(uint32_t passIndex) {
+		Pass& pass = passes[passIndex];
+		chooseStoreOps(passIndex, pass.storeOps);
+		bool hasDepth = false;
+		for (const Access& access : pass.accesses) {
+			if (access.attachment == Access::Attachment::None) {
+				continue;
+			}
+			const Image& image = images[access.image];
+			assert(image.desc.extent.width == pass.extent.width && image.desc.extent.height == pass.extent.height &&
+				"All attachments of a pass must have the same extent");
+			if (access.attachment == Access::Attachment::Depth) {
+				assert(!hasDepth && "A pass can only have one depth attachment");
+				hasDepth = true;
+			}
+			pass.attachmentImages.push_back(access.image);
+			pass.clearValues.push_back(access.clearValue);
+		}
+	}
+
+	//初始和最终布局都等于通道内的布局，不需要子通道依赖
+	void LVERenderGraph::createRenderPass(uint32_t passIndex) {
+		Pass& pass = passes[passIndex];
+		std::vector<VkAttachmentDescription> attachments;
+		std::vector<VkAttachmentReference> colorRefs;
+		VkAttachmentReference depthRef{};
+		bool hasDepth = false;
+		for (const Access& access : pass.accesses) {
+			if (access.attachment == Access::Attachment::None) {
+				continue;
+			}
+			uint32_t attachmentIndex = static_cast<uint32_t>(attachments.size());
+			VkAttachmentDescription attachment{};
+			attachment.format = images[access.image].desc.format;
+			attachment.samples = VK_SAMPLE_COUNT_1_BIT;
+			attachment.loadOp = toVkLoadOp(access.load);
+			attachment.storeOp = pass.storeOps[attachmentIndex];
+			attachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
+			attachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+			attachment.initialLayout = access.layout;
+			attachment.finalLayout = access.layout;
+			attachments.push_back(attachment);
+
+			VkAttachmentReference reference{ attachmentIndex, access.layout };
+			if (access.attachment == Access::Attachment::Color) {
+				colorRefs.push_back(reference);
+			}
+			else {
+				depthRef = reference;
+				hasDepth = true;
+			}
+		}
+
+		VkSubpassDescription subpass{};
+		subpass.pipelineBindPoint = VK_PIPELINE_BIND_POINT_GRAPHICS;
+		subpass.colorAttachmentCount = static_cast<uint32_t>(colorRefs.size());
+		subpass.pColorAttachments = colorRefs.data();
+		subpass.pDepthStencilAttachment = hasDepth ? &depthRef : nullptr;
+
+		VkRenderPassCreateInfo renderPassInfo{};
+		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO;
+		renderPassInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+		renderPassInfo.pAttachments = attachments.data();
+		renderPassInfo.subpassCount = 1;
+		renderPassInfo.pSubpasses = &subpass;
+		if (vkCreateRenderPass(lveDevice.device(), &renderPassInfo, nullptr, &pass.renderPass) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create render graph render pass!");
+		}
+	}
+
+	//导入的图像每帧不同（交换链图像），帧缓冲按视图组合缓存
+	VkFramebuffer LVERenderGraph::getFramebuffer(Pass& pass) {
+		std::vector<VkImageView> views;
+		views.reserve(pass.attachmentImages.size());
+		for (uint32_t index : pass.attachmentImages) {
+			assert(images[index].view != VK_NULL_HANDLE && "Imported image view not set");
+			views.push_back(images[index].view);
+		}
+		auto it = pass.framebuffers.find(views);
+		if (it != pass.framebuffers.end()) {
+			return it->second;
+		}
+
+		VkFramebufferCreateInfo framebufferInfo{};
+		framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
+		framebufferInfo.renderPass = pass.renderPass;
+		framebufferInfo.attachmentCount = static_cast<uint32_t>(views.size());
+		framebufferInfo.pAttachments = views.data();
+		framebufferInfo.width = pass.extent.width;
+		framebufferInfo.height = pass.extent.height;
+		framebufferInfo.layers = 1;
+		VkFramebuffer framebuffer;
+		if (vkCreateFramebuffer(lveDevice.device(), &framebufferInfo, nullptr, &framebuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to create render graph framebuffer!");
+		}
+		pass.framebuffers.emplace(std::move(views), framebuffer);
+		return framebuffer;
+	}
+
+	//动态渲染：附件信息与 createRenderPass 中的附件描述一一对应，布局转换已经由通道前的屏障完成
+	void LVERenderGraph::beginRendering(VkCommandBuffer commandBuffer, const Pass& pass) const {
+		std::vector<VkRenderingAttachmentInfoKHR> colorAttachments;
+		VkRenderingAttachmentInfoKHR depthAttachment{};
+		bool hasDepth = false;
+		uint32_t attachmentIndex = 0;
+		for (const Access& access : pass.accesses) {
+			if (access.attachment == Access::Attachment::None) {
+				continue;
+			}
+			assert(images[access.image].view != VK_NULL_HANDLE && "Imported image view not set");
+			VkRenderingAttachmentInfoKHR attachment{};
+			attachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+			attachment.imageView = images[access.image].view;
+			attachment.imageLayout = access.layout;
+			attachment.loadOp = toVkLoadOp(access.load);
+			attachment.storeOp = pass.storeOps[attachmentIndex];
+			attachment.clearValue = pass.clearValues[attachmentIndex];
+			attachmentIndex++;
+			if (access.attachment == Access::Attachment::Color) {
+				colorAttachments.push_back(attachment);
+			}
+			else {
+				depthAttachment = attachment;
+				hasDepth = true;
+			}
+		}
+
+		VkRenderingInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea.offset = { 0, 0 };
+		renderingInfo.renderArea.extent = pass.extent;
+		renderingInfo.layerCount = 1;
+		renderingInfo.colorAttachmentCount = static_cast<uint32_t>(colorAttachments.size());
+		renderingInfo.pColorAttachments = colorAttachments.data();
+		renderingInfo.pDepthAttachment = hasDepth ? &depthAttachment : nullptr;
+		lveDevice.cmdBeginRendering(commandBuffer, renderingInfo);
+	}
+
+	void LVERenderGraph::execute(VkCommandBuffer commandBuffer) {
+		LVE_PROFILE_FUNCTION();
+		assert(compiled && "Render graph must be compiled before execute");
+		for (Pass& pass : passes) {
+			if (!pass.alive) {
+				continue;
+			}
+			if (!pass.barriers.empty()) {
+				for (size_t i = 0; i < pass.barriers.size(); i++) {
+					pass.barriers[i].image = images[pass.barrierImages[i]].image;
+				}
+				vkCmdPipelineBarrier(
+					commandBuffer,
+					pass.srcStages,
+					pass.dstStages,
+					0, 0, nullptr, 0, nullptr,
+					static_cast<uint32_t>(pass.barriers.size()), pass.barriers.data());
+			}
+
+			LVERenderGraphContext context{ commandBuffer, pass.renderPass, pass.extent };
+			if (pass.type == PassType::Graphics) {
+				bool dynamicRendering = pass.renderPass == VK_NULL_HANDLE;
+				if (dynamicRendering) {
+					beginRendering(commandBuffer, pass);
+				}
+				else {
+					VkRenderPassBeginInfo renderPassInfo{};
+					renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+					renderPassInfo.renderPass = pass.renderPass;
+					renderPassInfo.framebuffer = getFramebuffer(pass);
+					renderPassInfo.renderArea.offset = { 0, 0 };
+					renderPassInfo.renderArea.extent = pass.extent;
+					renderPassInfo.clearValueCount = static_cast<uint32_t>(pass.clearValues.size());
+					renderPassInfo.pClearValues = pass.clearValues.data();
+					vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+				}
+
+				VkViewport viewport{};
+				viewport.x = 0.0f;
+				viewport.y = 0.0f;
+				viewport.width = static_cast<float>(pass.extent.width);
+				viewport.height = static_cast<float>(pass.extent.height);
+				viewport.minDepth = 0.0f;
+				viewport.maxDepth = 1.0f;
+				VkRect2D scissor{ { 0, 0 }, pass.extent };
+				vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+				vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+
+				if (pass.function) {
+					pass.function(context);
+				}
+				if (dynamicRendering) {
+					lveDevice.cmdEndRendering(commandBuffer);
+				}
+				else {
+					vkCmdEndRenderPass(commandBuffer);
+				}
+			}
+			else if (pass.function) {
+				pass.function(context);
+			}
+		}
+
+		if (!finalBarriers.empty()) {
+			for (size_t i = 0; i < finalBarriers.size(); i++) {
+				finalBarriers[i].image = images[finalBarrierImages[i]].image;
+			}
+			vkCmdPipelineBarrier(
+				commandBuffer,
+				finalSrcStages,
+				VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+				0, 0, nullptr, 0, nullptr,
+				static_cast<uint32_t>(finalBarriers.size()), finalBarriers.data());
+		}
+	}
+
+}  // namespace lve
@@ -0,0 +1,246 @@
+#pragma once
+
+#include "lve_device.h"
+#include "lve_pipeline.h"
+
+// std
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace lve {
+
+	//渲染图中图像的句柄，由 LVERenderGraph::createImage / importImage 返回
+	struct LVERenderGraphImage {
+		uint32_t index = ~0u;
+		bool isValid() const { return index != ~0u; }
+	};
+
+	//执行一个通道时传给回调的信息，图形通道的渲染通道已经开始，视口和裁剪已经设置为附件的尺寸
+	struct LVERenderGraphContext {
+		VkCommandBuffer commandBuffer;
+		VkRenderPass renderPass;	//计算通道和动态渲染时为空
+		VkExtent2D extent;
+	};
+
+	//帧图：每个通道声明自己读写哪些图像，compile 时按声明顺序推导出
+	//1. 剔除：从输出（带 finalLayout 的导入图像）和有副作用的通道往回找，结果没人用的通道不执行，它独占的临时图像也不创建；
+	//2. 屏障：模拟每张图像的布局和最后一次读写，只在布局变化、写后读、写后写和读后写时插入屏障，
+	//   每个通道执行前的所有屏障合并成一次 vkCmdPipelineBarrier，没人再读的附件 storeOp 为 DONT_CARE；
+	//3. 内存复用：临时图像按存活区间（第一次到最后一次使用它的通道）分组，区间不重叠、内存类型兼容的图像绑定到同一块内存。
+	//图形通道的渲染通道由图创建，附件的初始和最终布局都等于通道内的布局，布局转换全部由图的屏障完成；
+	//附件的格式和顺序相同时与 LVESwapChain 的渲染通道兼容，可以直接使用为它创建的管线。
+	//设备支持动态渲染时不创建渲染通道和帧缓冲，图形通道用 vkCmdBeginRenderingKHR 开始，管线只需要附件格式相同。
+	//图的结构在 compile 之后固定，导入的图像（交换链图像）每帧用 setImportedImage 更新；交换链重建后重新构建整个图。
+	class LVERenderGraph {
+	public:
+		enum class PassType { Graphics, Compute };
+		enum class LoadOp { Clear, Load, DontCare };
+
+		struct ImageDesc {
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			VkExtent2D extent{ 0, 0 };
+		};
+
+		//外部图像每帧进入渲染图时的状态，以及执行完之后要转换到的布局
+		struct ImportDesc {
+			VkFormat format = VK_FORMAT_UNDEFINED;
+			VkExtent2D extent{ 0, 0 };
+			VkImageLayout initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+			//之前最后使用它的阶段，交换链图像为获取信号量等待的 COLOR_ATTACHMENT_OUTPUT
+			VkPipelineStageFlags initialStage = VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+			VkAccessFlags initialAccess = 0;
+			//不为 UNDEFINED 时这张图像是渲染图的输出，写它的通道不会被剔除
+			VkImageLayout finalLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		};
+
+		using ExecuteFunction = std::function<void(const LVERenderGraphContext&)>;
+
+		//声明一个通道的读写，同一个通道里每张图像只能声明一次
+		class PassBuilder {
+		public:
+			//颜色附件，按声明顺序对应片段着色器的输出位置
+			PassBuilder& writeColor(LVERenderGraphImage image, LoadOp load = LoadOp::Clear, VkClearColorValue clearValue = { { 0.f, 0.f, 0.f, 1.f } });
+			//深度测试并写入深度
+			PassBuilder& writeDepth(LVERenderGraphImage image, LoadOp load = LoadOp::Clear, float clearDepth = 1.f);
+			//只做深度测试，不写入（例如深度预渲染之后的主通道）
+			PassBuilder& readDepth(LVERenderGraphImage image);
+			//在着色器中采样
+			PassBuilder& sample(LVERenderGraphImage image, VkPipelineStageFlags stages = VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT);
+			//计算着色器中的存储图像，布局为 GENERAL
+			PassBuilder& readStorage(LVERenderGraphImage image);
+			PassBuilder& writeStorage(LVERenderGraphImage image);
+			//即使没有通道使用它的结果也执行，例如回读或写缓冲区
+			PassBuilder& setSideEffects();
+			PassBuilder& execute(ExecuteFunction function);
+
+		private:
+			friend class LVERenderGraph;
+			PassBuilder(LVERenderGraph& graph, uint32_t passIndex) : graph{ graph }, passIndex{ passIndex } {}
+
+			LVERenderGraph& graph;
+			uint32_t passIndex;
+		};
+
+		explicit LVERenderGraph(LVEDevice& device);
+		~LVERenderGraph();
+
+		LVERenderGraph(const LVERenderGraph&) = delete;
+		LVERenderGraph& operator=(const LVERenderGraph&) = delete;
+
+		//由渲染图创建和管理的临时图像，每帧开始时内容未定义
+		LVERenderGraphImage createImage(const std::string& name, const ImageDesc& desc);
+		//外部图像，执行前用 setImportedImage 设置这一帧实际的图像
+		LVERenderGraphImage importImage(const std::string& name, const ImportDesc& desc);
+		void setImportedImage(LVERenderGraphImage image, VkImage vkImage, VkImageView view);
+		//通道按添加的顺序执行
+		PassBuilder addPass(const std::string& name, PassType type);
+
+		//剔除通道、计算屏障、分配临时图像的内存并创建渲染通道，之后不能再添加图像和通道
+		void compile();
+		void execute(VkCommandBuffer commandBuffer);
+
+		VkImage getImage(LVERenderGraphImage image) const { return images[image.index].image; }
+		VkImageView getImageView(LVERenderGraphImage image) const { return images[image.index].view; }
+		//图形通道的渲染通道（被剔除、计算通道或动态渲染时返回空）
+		VkRenderPass getRenderPass(const std::string& passName) const;
+		//创建只在这个通道里使用的管线时的目标：渲染通道，或动态渲染时附件的格式
+		LVEPipelineTarget getPipelineTarget(const std::string& passName) const;
+
+		//编译结果，用于确认剔除和内存复用的效果
+		uint32_t getCulledPassCount() const { return culledPassCount; }
+		uint32_t getBarrierCount() const { return barrierCount; }
+		VkDeviceSize getTransientMemoryRequested() const { return transientMemoryRequested; }
+		VkDeviceSize getTransientMemoryAllocated() const { return transientMemoryAllocated; }
+
+		//compile 中不访问设备的两步：剔除和内存复用的分组。只依赖下面这些描述，可以脱离设备单独测试
+		struct CullAccess {
+			uint32_t image;
+			bool read;
+			bool write;
+			bool discard;			//完整覆盖之前的内容
+		};
+		struct CullPass {
+			std::vector<CullAccess> accesses;
+			bool sideEffects = false;
+		};
+		//needed 标记渲染图的输出图像，返回每个通道是否需要执行
+		static std::vector<bool> findLivePasses(const std::vector<CullPass>& passes, std::vector<bool> needed);
+
+		//一张临时图像的存活区间（通道下标）和内存需求，memoryTypeBits 只保留可以使用的内存类型
+		struct AliasRequest {
+			uint32_t firstPass;
+			uint32_t lastPass;
+			VkDeviceSize size;
+			uint32_t memoryTypeBits;
+		};
+		struct AliasBlock {
+			VkDeviceSize size = 0;
+			uint32_t memoryTypeBits = ~0u;	//绑定在上面的所有图像都能使用的内存类型
+			std::vector<uint32_t> requests;
+		};
+		//按大小从大到小，把每张图像放进第一块区间不重叠、内存类型有交集的内存块，块的大小取其中最大的图像
+		static std::vector<AliasBlock> planAliasing(const std::vector<AliasRequest>& requests);
+
+	private:
+		struct Access {
+			uint32_t image;
+			VkImageLayout layout;
+			VkPipelineStageFlags stages;
+			VkAccessFlags access;
+			VkImageUsageFlags usage;
+			bool read;
+			bool write;
+			bool discard;			//不需要之前的内容（Clear / DontCare 的附件）
+			enum class Attachment { None, Color, Depth } attachment = Attachment::None;
+			LoadOp load = LoadOp::DontCare;
+			VkClearValue clearValue{};
+		};
+
+		struct Pass {
+			std::string name;
+			PassType type;
+			std::vector<Access> accesses;
+			bool sideEffects = false;
+			ExecuteFunction function;
+			bool alive = false;
+
+			//compile 的结果，barrierImages 与 barriers 一一对应，执行时填入这一帧的图像
+			std::vector<VkImageMemoryBarrier> barriers;
+			std::vector<uint32_t> barrierImages;
+			VkPipelineStageFlags srcStages = 0;
+			VkPipelineStageFlags dstStages = 0;
+			VkRenderPass renderPass = VK_NULL_HANDLE;
+			//附件按声明顺序排列，三个数组一一对应
+			std::vector<uint32_t> attachmentImages;
+			std::vector<VkClearValue> clearValues;
+			std::vector<VkAttachmentStoreOp> storeOps;
+			VkExtent2D extent{ 0, 0 };
+			std::map<std::vector<VkImageView>, VkFramebuffer> framebuffers;
+		};
+
+		struct Image {
+			std::string name;
+			ImageDesc desc;
+			bool imported = false;
+			ImportDesc import{};
+			VkImageUsageFlags usage = 0;
+			VkImageAspectFlags aspect = 0;
+			VkImage image = VK_NULL_HANDLE;
+			VkImageView view = VK_NULL_HANDLE;
+			//存活区间，按通道下标；没有存活的通道使用时为 ~0u
+			uint32_t firstPass = ~0u;
+			uint32_t lastPass = 0;
+			uint32_t memoryBlock = ~0u;
+			VkMemoryRequirements requirements{};
+		};
+
+		//多张临时图像共用的一块内存，images 是绑定在上面的图像
+		struct MemoryBlock {
+			VkDeviceMemory memory = VK_NULL_HANDLE;
+			VkDeviceSize size = 0;
+			std::vector<uint32_t> images;
+		};
+
+		//模拟执行时每张图像的同步状态
+		struct ImageState {
+			VkImageLayout layout = VK_IMAGE_LAYOUT_UNDEFINED;
+			VkPipelineStageFlags writeStages = 0;		//最后一次写（或布局转换）所在的阶段
+			VkAccessFlags writeAccess = 0;
+			VkPipelineStageFlags readStages = 0;		//最后一次写之后读过它的阶段
+			VkPipelineStageFlags visibleStages = 0;		//最后一次写已经对这些阶段可见
+		};
+
+		Access& addAccess(uint32_t passIndex, LVERenderGraphImage image);
+		void cullPasses();
+		void computeLifetimes();
+		void createTransientImages();
+		void createImageView(Image& image);
+		//emitBarriers 为 false 时只模拟一帧，得到临时图像内存块在帧末的状态
+		void simulate(std::vector<ImageState>& blockStates, bool emitBarriers);
+		void chooseStoreOps(uint32_t passIndex, std::vector<VkAttachmentStoreOp>& storeOps) const;
+		void collectAttachments(uint32_t passIndex);
+		void createRenderPass(uint32_t passIndex);
+		VkFramebuffer getFramebuffer(Pass& pass);
+		void beginRendering(VkCommandBuffer commandBuffer, const Pass& pass) const;
+
+		LVEDevice& lveDevice;
+		std::vector<Image> images;
+		std::vector<Pass> passes;
+		std::vector<MemoryBlock> memoryBlocks;
+		bool compiled = false;
+
+		//所有通道之后把输出图像转换到 finalLayout
+		std::vector<VkImageMemoryBarrier> finalBarriers;
+		std::vector<uint32_t> finalBarrierImages;
+		VkPipelineStageFlags finalSrcStages = 0;
+
+		uint32_t culledPassCount = 0;
+		uint32_t barrierCount = 0;
+		VkDeviceSize transientMemoryRequested = 0;
+		VkDeviceSize transientMemoryAllocated = 0;
+	};
+
+}  // namespace lve
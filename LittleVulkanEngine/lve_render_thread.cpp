@@ -0,0 +1,117 @@
+#include "lve_render_thread.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <utility>
+
+namespace lve {
+
+	void LVERenderPacket::reset() {
+		frameTime = 0.f;
+		camera = LVECamera{};
+		inputSampleTime = {};
+		visibleCount = 0;
+		culledCount = 0;
+		draws.clear();
+	}
+
+	void LVERenderPacket::gatherEntities(
+		LVEWorld& world, const LVETransformSystem& transformSystem, const std::vector<uint8_t>* visibleSlots)
+	{
+		LVE_PROFILE_FUNCTION();
+		world.forEachChunk<ModelComponent, TransformSlotComponent>(
+			[&](uint32_t count, const LVEEntity*, ModelComponent* models, TransformSlotComponent* slots) {
+				for (uint32_t i = 0; i < count; i++) {
+					uint32_t slot = slots[i].slot;
+					if (visibleSlots != nullptr && slot < visibleSlots->size() && !(*visibleSlots)[slot]) {
+						continue;
+					}
+					draws.push_back(Draw{
+						models[i].model.get(),
+						transformSystem.getModelMatrix(slot),
+						transformSystem.getNormalMatrix(slot) });
+				}
+			});
+	}
+
+	LVERenderThread::LVERenderThread(RenderFunction render) : renderFunction{ std::move(render) } {
+		thread = std::thread([this]() {
+			LVE_PROFILE_THREAD("Render");
+			renderLoop();
+		});
+	}
+
+	LVERenderThread::~LVERenderThread() {
+		{
+			std::lock_guard<std::mutex> lock{ packetMutex };
+			stopping = true;
+		}
+		packetCondition.notify_all();
+		thread.join();
+	}
+
+	void LVERenderThread::submitPacket() {
+		LVE_PROFILE_FUNCTION();
+		{
+			std::unique_lock<std::mutex> lock{ packetMutex };
+			//渲染线程还在用另一个数据包时等待，等完之后游戏线程才能接着写它
+			packetCondition.wait(lock, [this]() { return !packetPending && !rendering; });
+			rethrowRenderError();
+			pendingIndex = writeIndex;
+			packetPending = true;
+			writeIndex = 1 - writeIndex;
+		}
+		packetCondition.notify_all();
+	}
+
+	void LVERenderThread::waitIdle() {
+		LVE_PROFILE_FUNCTION();
+		std::unique_lock<std::mutex> lock{ packetMutex };
+		packetCondition.wait(lock, [this]() { return !packetPending && !rendering; });
+		rethrowRenderError();
+	}
+
+	void LVERenderThread::rethrowRenderError() {
+		if (renderError) {
+			std::exception_ptr error = renderError;
+			renderError = nullptr;
+			std::rethrow_exception(error);
+		}
+	}
+
+	void LVERenderThread::renderLoop() {
+		while (true) {
+			uint32_t index = 0;
+			{
+				std::unique_lock<std::mutex> lock{ packetMutex };
+				packetCondition.wait(lock, [this]() { return stopping || packetPending; });
+				//退出前先把已经提交的数据包渲染完
+				if (!packetPending) {
+					return;
+				}
+				index = pendingIndex;
+				packetPending = false;
+				rendering = true;
+			}
+
+			std::exception_ptr error;
+			try {
+				renderFunction(packets[index]);
+			}
+			catch (...) {
+				error = std::current_exception();
+			}
+
+			{
+				std::lock_guard<std::mutex> lock{ packetMutex };
+				rendering = false;
+				if (error && !renderError) {
+					renderError = error;
+				}
+			}
+			packetCondition.notify_all();
+		}
+	}
+
+}  // namespace lve
@@ -0,0 +1,90 @@
+#pragma once
+
+#include "lve_camera.h"
+#include "lve_ecs.h"
+#include "lve_frame_pacer.h"
+#include "lve_model.h"
+#include "lve_transform_system.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace lve {
+
+	//游戏线程交给渲染线程的一帧：渲染线程只读它，不再访问 LVEWorld 和 LVETransformSystem。
+	//模型只保存裸指针，删除模型之前先调用 LVERenderThread::waitIdle
+	struct LVERenderPacket {
+		struct Draw {
+			LVEModel* model;
+			glm::mat4 modelMatrix;
+			glm::mat4 normalMatrix;
+		};
+
+		float frameTime = 0.f;
+		LVECamera camera{};
+		LVEFramePacer::Clock::time_point inputSampleTime{};
+		uint32_t visibleCount = 0;
+		uint32_t culledCount = 0;
+		std::vector<Draw> draws;
+
+		//清空上一次的内容，保留 draws 的容量
+		void reset();
+		//收集 world 中可见的（visibleSlots 为空时全部）带 ModelComponent 和 TransformSlotComponent 的实体，矩阵从 transformSystem 拷贝
+		void gatherEntities(LVEWorld& world, const LVETransformSystem& transformSystem, const std::vector<uint8_t>* visibleSlots);
+	};
+
+	//游戏线程和渲染线程的流水线：游戏线程填写第 N+1 帧的数据包时，渲染线程录制并提交第 N 帧。
+	//两个数据包轮流使用，submitPacket 等渲染线程处理完上一个数据包后才交出当前的，因此游戏线程最多领先一帧，
+	//每帧的耗时接近 max(更新, 渲染) 而不是两者之和。
+	//渲染函数中抛出的异常在游戏线程下一次调用 submitPacket 或 waitIdle 时重新抛出
+	class LVERenderThread {
+	public:
+		using RenderFunction = std::function<void(const LVERenderPacket&)>;
+
+		explicit LVERenderThread(RenderFunction render);
+		//先渲染完已经提交的数据包再退出
+		~LVERenderThread();
+
+		LVERenderThread(const LVERenderThread&) = delete;
+		LVERenderThread& operator=(const LVERenderThread&) = delete;
+
+		//游戏线程当前可以写入的数据包，提交之前渲染线程不会读它
+		LVERenderPacket& getWritePacket() { return packets[writeIndex]; }
+		//把写好的数据包交给渲染线程，之后 getWritePacket 返回另一个数据包
+		void submitPacket();
+		//等到所有已提交的数据包都渲染完
+		void waitIdle();
+
+	private:
+		void renderLoop();
+		//调用时持有 packetMutex
+		void rethrowRenderError();
+
+		RenderFunction renderFunction;
+		std::array<LVERenderPacket, 2> packets;
+		uint32_t writeIndex = 0;
+
+		std::mutex packetMutex;
+		std::condition_variable packetCondition;
+		bool packetPending = false;		//有数据包等待渲染线程取走
+		bool rendering = false;			//渲染线程正在使用数据包
+		uint32_t pendingIndex = 0;
+		bool stopping = false;
+		std::exception_ptr renderError;
+
+		std::thread thread;
+	};
+
+}  // namespace lve
@@ -1,5 +1,7 @@
 #include "lve_renderer.h"
 
+#include "lve_profiler.h"
+
 // std
 #include <array>
 #include <cassert>
@@ -7,41 +9,91 @@
 
 namespace lve {
 
-	LVERenderer::LVERenderer(LVEWindow& window, LVEDevice& device)
-		: lveWindow{ window }, lveDevice{ device } {
+	static constexpr VkClearColorValue CLEAR_COLOR = { { 0.01f, 0.01f, 0.01f, 1.0f } };
+
+	static bool hasStencilComponent(VkFormat format) {
+		return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
+	}
+
+	LVERenderer::LVERenderer(LVEWindow& window, LVEDevice& device, uint32_t framesInFlight)
+		: lveWindow{ &window }, lveDevice{ device }, framesInFlight{ framesInFlight } {
+		if (framesInFlight < 1 || framesInFlight > LVESwapChain::MAX_FRAMES_IN_FLIGHT) {
+			throw std::runtime_error("frames in flight must be between 1 and MAX_FRAMES_IN_FLIGHT!");
+		}
+		frameTimelineValues.resize(framesInFlight, 0);
 		recreateSwapChain();
 		createCommandBuffers();
+		gpuProfiler = std::make_unique<LVEGpuProfiler>(lveDevice, framesInFlight);
 	}
 
-	LVERenderer::~LVERenderer() { freeCommandBuffers(); }
+	LVERenderer::LVERenderer(LVEDevice& device, VkExtent2D extent, uint32_t framesInFlight)
+		: lveDevice{ device }, framesInFlight{ framesInFlight } {
+		if (framesInFlight < 1 || framesInFlight > LVESwapChain::MAX_FRAMES_IN_FLIGHT) {
+			throw std::runtime_error("frames in flight must be between 1 and MAX_FRAMES_IN_FLIGHT!");
+		}
+		frameTimelineValues.resize(framesInFlight, 0);
+		//每个帧槽位一套离屏图像，避免相邻帧写同一张图
+		offscreenTarget = std::make_unique<LVEOffscreenTarget>(lveDevice, extent, framesInFlight);
+		createCommandBuffers();
+		gpuProfiler = std::make_unique<LVEGpuProfiler>(lveDevice, framesInFlight);
+	}
+
+	//命令缓冲区和交换链可能还被已提交的帧使用，交给延迟销毁队列，析构渲染器前不需要等待设备空闲
+	LVERenderer::~LVERenderer() {
+		VkDevice device = lveDevice.device();
+		VkCommandPool commandPool = lveDevice.getCommandPool();
+		std::vector<VkCommandBuffer> retiredCommandBuffers = std::move(commandBuffers);
+		lveDevice.retire([device, commandPool, retiredCommandBuffers]() {
+			vkFreeCommandBuffers(
+				device,
+				commandPool,
+				static_cast<uint32_t>(retiredCommandBuffers.size()),
+				retiredCommandBuffers.data());
+		});
+		if (lveSwapChain != nullptr) {
+			std::shared_ptr<LVESwapChain> retiredSwapChain = std::move(lveSwapChain);
+			lveDevice.retire([retiredSwapChain]() mutable { retiredSwapChain.reset(); });
+		}
+	}
 
-	//ؽķ
-	//ؽʱҪ鴰ڳߴ磬豸кȷκԴȷ
+	//重建交换链的方法
+	//不再调用 vkDeviceWaitIdle：旧交换链交给设备的延迟销毁队列，等已提交的帧都执行完再释放它的图像视图、深度图和帧缓冲，
+	//渲染通道在格式不变时由新交换链直接接管。窗口调整大小时不会再整段停顿。
 	void LVERenderer::recreateSwapChain() {
-		auto extent = lveWindow.getExtent();
+		if (isHeadless()) {
+			return;
+		}
+
+		auto extent = lveWindow->getExtent();
 		while (extent.width == 0 || extent.height == 0) {
-			extent = lveWindow.getExtent();
+			//在渲染线程上不能处理窗口事件，窗口最小化时放弃这次重建，之后的帧 acquire 失败会再次尝试
+			if (!lveWindow->isEventThread()) {
+				return;
+			}
+			extent = lveWindow->getExtent();
 			glfwWaitEvents();
 		}
-		vkDeviceWaitIdle(lveDevice.device());
 
 		if (lveSwapChain == nullptr) {
-			lveSwapChain = std::make_unique<LVESwapChain>(lveDevice, extent);
+			lveSwapChain = std::make_unique<LVESwapChain>(lveDevice, extent, framesInFlight, presentPolicy);
 		}
 		else {
-			///!!! ĳЩϵͳУͬһϹ棬ȷ˾ɵĽȱٻƶ
+			///!!! 在某些系统中，两个交换链不能在同一窗口上共存，因此这确保了旧的交换链首先被销毁或者移动。
 			std::shared_ptr<LVESwapChain> oldSwapChain = std::move(lveSwapChain);
-			lveSwapChain = std::make_unique<LVESwapChain>(lveDevice, extent, oldSwapChain);
+			lveSwapChain = std::make_unique<LVESwapChain>(lveDevice, extent, oldSwapChain, framesInFlight, presentPolicy);
 
 			if (!oldSwapChain->compareSwapFormats(*lveSwapChain.get())) {
 				throw std::runtime_error("Swap chain image(or depth) format has changed!");
 			}
+
+			lveDevice.retire([oldSwapChain]() mutable { oldSwapChain.reset(); });
 		}
+		swapChainGeneration++;
 	}
 
-	//䡢ͷԼ¼ ִʱһϵָӿڡüԼָȡ
+	//分配、释放以及记录 执行时所需的一系列指令，包括设置视口、裁剪区域，以及绘制指令等。
 	void LVERenderer::createCommandBuffers() {
-		commandBuffers.resize(LVESwapChain::MAX_FRAMES_IN_FLIGHT);
+		commandBuffers.resize(framesInFlight);
 
 		VkCommandBufferAllocateInfo allocInfo{};
 		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
@@ -55,26 +107,52 @@ namespace lve {
 		}
 	}
 
-	void LVERenderer::freeCommandBuffers() {
-		vkFreeCommandBuffers(
-			lveDevice.device(),
-			lveDevice.getCommandPool(),
-			static_cast<uint32_t>(commandBuffers.size()),
-			commandBuffers.data());
-		commandBuffers.clear();
+	void LVERenderer::setPresentPolicy(PresentPolicy policy) {
+		if (policy != presentPolicy) {
+			presentPolicy = policy;
+			presentPolicyChanged = true;
+		}
 	}
 
 	VkCommandBuffer LVERenderer::beginFrame() {
 		assert(!isFrameStarted && "Can't call beginFrame while already in progress");
+		LVE_PROFILE_FUNCTION();
+		frameStats.beginFrame();
 
-		auto result = lveSwapChain->acquireNextImage(&currentImageIndex);
-		if (result == VK_ERROR_OUT_OF_DATE_KHR) {
-			recreateSwapChain();
-			return nullptr;
+		//等待这个帧槽位上一轮的提交完成，之后它的命令缓冲区和每帧资源才能复用
+		{
+			LVE_PROFILE_SCOPE("WaitForFrameSlot");
+			auto waitStart = LVEFrameStats::Clock::now();
+			lveDevice.waitForTimelineValue(frameTimelineValues[currentFrameIndex]);
+			frameStats.addWaitTime(LVEFrameStats::Clock::now() - waitStart);
 		}
+		framePacer.resolveCompletedFrames(lveDevice.getCompletedTimelineValue());
+		lveDevice.collectRetiredResources();
+
+		deliverReadbacks(lveDevice.getCompletedTimelineValue());
 
-		if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
-			throw std::runtime_error("failed to acquire swap chain image!");
+		if (isHeadless()) {
+			//离屏图像按帧槽位分配，槽位的上一轮提交已经完成，可以直接使用
+			currentImageIndex = static_cast<uint32_t>(currentFrameIndex);
+		}
+		else {
+			if (presentPolicyChanged) {
+				presentPolicyChanged = false;
+				recreateSwapChain();
+			}
+
+			auto result = lveSwapChain->acquireNextImage(&currentImageIndex, acquireTimeout);
+			if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+				recreateSwapChain();
+				return nullptr;
+			}
+			if (result == VK_TIMEOUT || result == VK_NOT_READY) {
+				return nullptr;
+			}
+
+			if (result != VK_SUCCESS && result != VK_SUBOPTIMAL_KHR) {
+				throw std::runtime_error("failed to acquire swap chain image!");
+			}
 		}
 
 		isFrameStarted = true;
@@ -86,82 +164,342 @@ namespace lve {
 		if (vkBeginCommandBuffer(commandBuffer, &beginInfo) != VK_SUCCESS) {
 			throw std::runtime_error("failed to begin recording command buffer!");
 		}
+		gpuProfiler->beginFrame(commandBuffer, currentFrameIndex);
 		return commandBuffer;
 	}
 
-	//Ҫǽǰ֡Ⱦ̡
+	//主要功能是结束当前帧的渲染过程。
 	void LVERenderer::endFrame() {
 		assert(isFrameStarted && "Can't call endFrame while frame is not in progress");
+		LVE_PROFILE_FUNCTION();
 
-		//1. ȡǰcommand bufferڴ洢ǰ֡Ⱦ
+		//1. 获取当前的命令缓冲区（command buffer），这个缓冲区用于存储当前帧的渲染命令。
 		auto commandBuffer = getCurrentCommandBuffer();
-		//2.  vkEndCommandBuffer ǰ¼
+
+		//无窗口模式下如果请求了回读，在渲染通道之后追加复制命令
+		bool readbackThisFrame = isHeadless() && requestedReadback != nullptr;
+		if (readbackThisFrame) {
+			LVEGpuScope scope{ gpuProfiler.get(), commandBuffer, "Readback" };
+			offscreenTarget->recordReadback(commandBuffer, static_cast<int>(currentImageIndex));
+		}
+		gpuProfiler->endFrame(commandBuffer);
+
+		//2. 调用 vkEndCommandBuffer 函数来结束当前的命令缓冲区记录
 		if (vkEndCommandBuffer(commandBuffer) != VK_SUCCESS) {
 			throw std::runtime_error("failed to record command buffer!");
 		}
 
-		//3. ύswap chainȾȡύ
-		auto result = lveSwapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex);
+		uint64_t timelineValue = lveDevice.nextTimelineValue();
+		frameTimelineValues[currentFrameIndex] = timelineValue;
+
+		if (isHeadless()) {
+			auto submitTime = LVEFramePacer::Clock::now();
+			offscreenTarget->submitCommandBuffers(&commandBuffer, timelineValue);
+			framePacer.markSubmitted(timelineValue, submitTime, submitTime);
+			if (readbackThisFrame) {
+				pendingReadbacks.push_back({ timelineValue, static_cast<int>(currentImageIndex), std::move(requestedReadback) });
+				requestedReadback = nullptr;
+			}
+
+			frameStats.endFrame(gpuProfiler->getLastFrameMs(), lveDevice.takeUploadedBytes());
+			isFrameStarted = false;
+			currentFrameIndex = (currentFrameIndex + 1) % framesInFlight;
+			return;
+		}
+
+		//3. 提交命令缓冲区到交换链（swap chain）进行渲染，并获取提交结果。
+		auto result = lveSwapChain->submitCommandBuffers(&commandBuffer, &currentImageIndex, timelineValue);
+		framePacer.markSubmitted(timelineValue, lveSwapChain->getLastSubmitTime(), lveSwapChain->getLastPresentTime());
 		
-		//ύǷΪڣVK_ERROR_OUT_OF_DATE_KHRţVK_SUBOPTIMAL_KHR򴰿Ƿ񱻵С֮һҪؽ
+		//检查提交结果是否为交换链过期（VK_ERROR_OUT_OF_DATE_KHR）、次优（VK_SUBOPTIMAL_KHR）或窗口是否被调整大小。如果是其中之一，则需要重建交换链。
 		if (result == VK_ERROR_OUT_OF_DATE_KHR 
 			|| result == VK_SUBOPTIMAL_KHR 
-			|| lveWindow.wasWindowResized()) 
+			|| lveWindow->wasWindowResized()) 
 		{
-			lveWindow.resetWindowResizedFlag();
+			lveWindow->resetWindowResizedFlag();
 			recreateSwapChain();
 		}
 		else if (result != VK_SUCCESS) {
 			throw std::runtime_error("failed to present swap chain image!");
 		}
 
+		frameStats.endFrame(gpuProfiler->getLastFrameMs(), lveDevice.takeUploadedBytes());
 		isFrameStarted = false;
-		currentFrameIndex = (currentFrameIndex + 1) % LVESwapChain::MAX_FRAMES_IN_FLIGHT;
+		currentFrameIndex = (currentFrameIndex + 1) % framesInFlight;
+	}
+
+	LVEDepthTarget LVERenderer::getCurrentDepthTarget() const {
+		assert(isFrameStarted && "Cannot get depth target when frame not in progress");
+		LVEDepthTarget target{};
+		target.extent = getExtent();
+		if (isHeadless()) {
+			target.image = offscreenTarget->getDepthImage(static_cast<int>(currentImageIndex));
+			target.view = offscreenTarget->getDepthImageView(static_cast<int>(currentImageIndex));
+			target.format = offscreenTarget->getDepthFormat();
+		}
+		else {
+			target.image = lveSwapChain->getDepthImage(static_cast<int>(currentImageIndex));
+			target.view = lveSwapChain->getDepthImageView(static_cast<int>(currentImageIndex));
+			target.format = lveSwapChain->getDepthFormat();
+		}
+		return target;
 	}
 
-	void LVERenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer) {
+	LVEColorTarget LVERenderer::getCurrentColorTarget() const {
+		assert(isFrameStarted && "Cannot get color target when frame not in progress");
+		LVEColorTarget target{};
+		target.extent = getExtent();
+		if (isHeadless()) {
+			target.image = offscreenTarget->getColorImage(static_cast<int>(currentImageIndex));
+			target.view = offscreenTarget->getImageView(static_cast<int>(currentImageIndex));
+			target.format = offscreenTarget->getColorFormat();
+			target.finalLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+		}
+		else {
+			target.image = lveSwapChain->getImage(static_cast<int>(currentImageIndex));
+			target.view = lveSwapChain->getImageView(static_cast<int>(currentImageIndex));
+			target.format = lveSwapChain->getSwapChainImageFormat();
+			target.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		}
+		return target;
+	}
+
+	LVEPipelineTarget LVERenderer::getPipelineTarget() const {
+		LVEPipelineTarget target{};
+		if (!usesDynamicRendering()) {
+			target.renderPass = getSwapChainRenderPass();
+			return target;
+		}
+		if (isHeadless()) {
+			target.colorFormats = { offscreenTarget->getColorFormat() };
+			target.depthFormat = offscreenTarget->getDepthFormat();
+		}
+		else {
+			target.colorFormats = { lveSwapChain->getSwapChainImageFormat() };
+			target.depthFormat = lveSwapChain->getDepthFormat();
+		}
+		return target;
+	}
+
+	void LVERenderer::beginSwapChainRenderPass(VkCommandBuffer commandBuffer, RenderPassLoad load, RenderPassContents contents) {
 		assert(isFrameStarted && "Can't call beginSwapChainRenderPass if frame is not in progress");
 		assert(
-			//ȷǵǰ֡
+			//确保传入的命令缓冲区是当前帧的命令缓冲区。
 			commandBuffer == getCurrentCommandBuffer() &&
 			"Can't begin render pass on command buffer from a different frame");
 
-		VkRenderPassBeginInfo renderPassInfo{};
-		renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-		renderPassInfo.renderPass = lveSwapChain->getRenderPass();
-		renderPassInfo.framebuffer = lveSwapChain->getFrameBuffer(currentImageIndex);
-		//ȾƫΪ (0, 0)ʾϽǿʼȾ
-		renderPassInfo.renderArea.offset = { 0, 0 };
-		renderPassInfo.renderArea.extent = lveSwapChain->getSwapChainExtent();//ȾĴС
+		VkExtent2D extent = getExtent();
 
-		std::array<VkClearValue, 2> clearValues{};
-		clearValues[0].color = { 0.01f, 0.01f, 0.01f, 1.0f };
-		clearValues[1].depthStencil = { 1.0f, 0 };//ֵΪ 1.0ʾȫȻ
-		renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-		renderPassInfo.pClearValues = clearValues.data();
+		//时间戳写在渲染通道外面，整个通道（包括 load/store）都算进去
+		renderPassScope = gpuProfiler->beginScope(
+			commandBuffer, load == RenderPassLoad::Load ? "MainRenderPass(Load)" : "MainRenderPass");
+		if (usesDynamicRendering()) {
+			beginDynamicRendering(commandBuffer, load, contents);
+		}
+		else {
+			VkRenderPassBeginInfo renderPassInfo{};
+			renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+			if (load == RenderPassLoad::Load) {
+				renderPassInfo.renderPass = isHeadless() ? offscreenTarget->getLoadRenderPass() : lveSwapChain->getLoadRenderPass();
+			}
+			else {
+				renderPassInfo.renderPass = getSwapChainRenderPass();
+			}
+			renderPassInfo.framebuffer = isHeadless()
+				? offscreenTarget->getFrameBuffer(currentImageIndex)
+				: lveSwapChain->getFrameBuffer(currentImageIndex);
+			//设置渲染区域的偏移量为 (0, 0)，表示从左上角开始渲染。
+			renderPassInfo.renderArea.offset = { 0, 0 };
+			renderPassInfo.renderArea.extent = extent;//渲染区域的大小
 
-		vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+			std::array<VkClearValue, 2> clearValues{};
+			clearValues[0].color = CLEAR_COLOR;
+			clearValues[1].depthStencil = { 1.0f, 0 };//设置深度清除值为 1.0，表示完全清除深度缓冲区。
+			renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
+			renderPassInfo.pClearValues = clearValues.data();
+
+			//SECONDARY_COMMAND_BUFFERS 的子通道里只能执行次级命令缓冲区
+			vkCmdBeginRenderPass(
+				commandBuffer,
+				&renderPassInfo,
+				contents == RenderPassContents::SecondaryCommandBuffers
+					? VK_SUBPASS_CONTENTS_SECONDARY_COMMAND_BUFFERS
+					: VK_SUBPASS_CONTENTS_INLINE);
+		}
+		if (contents == RenderPassContents::SecondaryCommandBuffers) {
+			//视口和裁剪由次级命令缓冲区自己设置
+			return;
+		}
 
 		VkViewport viewport{};
 		viewport.x = 0.0f;
 		viewport.y = 0.0f;
-		viewport.width = static_cast<float>(lveSwapChain->getSwapChainExtent().width);
-		viewport.height = static_cast<float>(lveSwapChain->getSwapChainExtent().height);
+		viewport.width = static_cast<float>(extent.width);
+		viewport.height = static_cast<float>(extent.height);
 		viewport.minDepth = 0.0f;
 		viewport.maxDepth = 1.0f;
-		VkRect2D scissor{ {0, 0}, lveSwapChain->getSwapChainExtent() };
+		VkRect2D scissor{ {0, 0}, extent };
 		vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
 		vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
 	}
 
 	void LVERenderer::endSwapChainRenderPass(VkCommandBuffer commandBuffer) {
-		//ȷǰ֡Ѿʼ֡δʼ׳Ϣʾ֡δʼʱø÷
+		//确保当前帧已经开始。如果帧未开始，程序将抛出错误信息，提示不能在帧未开始时调用该方法。
 		assert(isFrameStarted && "Can't call endSwapChainRenderPass if frame is not in progress");
-		//ȷǵǰ֡ǣ׳Ϣ
+		//确保传入的命令缓冲区是当前帧的命令缓冲区。如果不是，程序将抛出错误信息。
 		assert(
 			commandBuffer == getCurrentCommandBuffer() &&
 			"Can't end render pass on command buffer from a different frame");
-		vkCmdEndRenderPass(commandBuffer);
+		if (usesDynamicRendering()) {
+			endDynamicRendering(commandBuffer);
+		}
+		else {
+			vkCmdEndRenderPass(commandBuffer);
+		}
+		gpuProfiler->endScope(commandBuffer, renderPassScope);
+		renderPassScope = LVEGpuProfiler::INVALID_SCOPE;
+	}
+
+	//与传统渲染通道的附件描述保持一致：颜色从 UNDEFINED（Clear）或上一个通道结束时的 finalLayout（Load）转换到附件布局，
+	//深度在两个通道之间一直处于 DEPTH_STENCIL_ATTACHMENT_OPTIMAL。布局转换和子通道依赖改成这里的显式屏障
+	void LVERenderer::beginDynamicRendering(VkCommandBuffer commandBuffer, RenderPassLoad load, RenderPassContents contents) {
+		LVEColorTarget color = getCurrentColorTarget();
+		LVEDepthTarget depth = getCurrentDepthTarget();
+		bool loadContents = load == RenderPassLoad::Load;
+
+		std::array<VkImageMemoryBarrier, 2> barriers{};
+		for (auto& barrier : barriers) {
+			barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+			barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+			barrier.subresourceRange.baseMipLevel = 0;
+			barrier.subresourceRange.levelCount = 1;
+			barrier.subresourceRange.baseArrayLayer = 0;
+			barrier.subresourceRange.layerCount = 1;
+		}
+		barriers[0].image = color.image;
+		barriers[0].subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barriers[0].oldLayout = loadContents ? color.finalLayout : VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[0].newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		barriers[0].srcAccessMask = loadContents ? VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT : 0;
+		barriers[0].dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | (loadContents ? VK_ACCESS_COLOR_ATTACHMENT_READ_BIT : 0);
+
+		barriers[1].image = depth.image;
+		barriers[1].subresourceRange.aspectMask = VK_IMAGE_ASPECT_DEPTH_BIT;
+		if (hasStencilComponent(depth.format)) {
+			barriers[1].subresourceRange.aspectMask |= VK_IMAGE_ASPECT_STENCIL_BIT;
+		}
+		barriers[1].oldLayout = loadContents ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
+		barriers[1].newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		barriers[1].srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		barriers[1].dstAccessMask =
+			VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+
+		//颜色附件要等获取信号量（COLOR_ATTACHMENT_OUTPUT）或上一帧的回读复制（TRANSFER），深度要等上一次使用它的深度测试
+		VkPipelineStageFlags attachmentStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+			VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+		VkPipelineStageFlags srcStages = attachmentStages;
+		if (isHeadless()) {
+			srcStages |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+		}
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			srcStages,
+			attachmentStages,
+			0,
+			0, nullptr,
+			0, nullptr,
+			static_cast<uint32_t>(barriers.size()), barriers.data());
+
+		VkRenderingAttachmentInfoKHR colorAttachment{};
+		colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		colorAttachment.imageView = color.view;
+		colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		colorAttachment.loadOp = loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		colorAttachment.clearValue.color = CLEAR_COLOR;
+
+		//深度结果之后还要用来生成深度金字塔，保存下来
+		VkRenderingAttachmentInfoKHR depthAttachment{};
+		depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+		depthAttachment.imageView = depth.view;
+		depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+		depthAttachment.loadOp = loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+		depthAttachment.clearValue.depthStencil = { 1.0f, 0 };
+
+		VkRenderingInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+		renderingInfo.renderArea.offset = { 0, 0 };
+		renderingInfo.renderArea.extent = color.extent;
+		renderingInfo.layerCount = 1;
+		renderingInfo.colorAttachmentCount = 1;
+		renderingInfo.pColorAttachments = &colorAttachment;
+		renderingInfo.pDepthAttachment = &depthAttachment;
+		if (contents == RenderPassContents::SecondaryCommandBuffers) {
+			renderingInfo.flags = VK_RENDERING_CONTENTS_SECONDARY_COMMAND_BUFFERS_BIT_KHR;
+		}
+		lveDevice.cmdBeginRendering(commandBuffer, renderingInfo);
+	}
+
+	//对应传统渲染通道的 finalLayout 和到外部的依赖：交换链图像交给呈现，离屏图像交给回读复制
+	void LVERenderer::endDynamicRendering(VkCommandBuffer commandBuffer) {
+		lveDevice.cmdEndRendering(commandBuffer);
+
+		LVEColorTarget color = getCurrentColorTarget();
+		bool presenting = color.finalLayout == VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+		VkImageMemoryBarrier barrier{};
+		barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+		barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+		barrier.image = color.image;
+		barrier.subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
+		barrier.subresourceRange.baseMipLevel = 0;
+		barrier.subresourceRange.levelCount = 1;
+		barrier.subresourceRange.baseArrayLayer = 0;
+		barrier.subresourceRange.layerCount = 1;
+		barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+		barrier.newLayout = color.finalLayout;
+		barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+		barrier.dstAccessMask = presenting ? 0 : VK_ACCESS_TRANSFER_READ_BIT;
+		vkCmdPipelineBarrier(
+			commandBuffer,
+			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+			presenting ? VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT : VK_PIPELINE_STAGE_TRANSFER_BIT,
+			0,
+			0, nullptr,
+			0, nullptr,
+			1, &barrier);
+	}
+
+	void LVERenderer::requestReadback(std::function<void(const LVEReadbackImage&)> callback) {
+		assert(isHeadless() && "Readback is only available in headless mode");
+		requestedReadback = std::move(callback);
+	}
+
+	void LVERenderer::flushReadbacks() {
+		if (pendingReadbacks.empty()) {
+			return;
+		}
+		lveDevice.waitForTimelineValue(pendingReadbacks.back().timelineValue);
+		deliverReadbacks(lveDevice.getCompletedTimelineValue());
+	}
+
+	//回读缓冲区按帧槽位复用，槽位被下一帧使用前（beginFrame 等待之后）一定会先走到这里
+	void LVERenderer::deliverReadbacks(uint64_t completedValue) {
+		while (!pendingReadbacks.empty() && pendingReadbacks.front().timelineValue <= completedValue) {
+			PendingReadback readback = std::move(pendingReadbacks.front());
+			pendingReadbacks.pop_front();
+
+			LVEBuffer& buffer = offscreenTarget->getReadbackBuffer(readback.imageIndex);
+			LVEReadbackImage image{};
+			image.width = offscreenTarget->getExtent().width;
+			image.height = offscreenTarget->getExtent().height;
+			image.format = offscreenTarget->getColorFormat();
+			image.timelineValue = readback.timelineValue;
+			image.pixels = static_cast<const uint8_t*>(buffer.getMappedMemory());
+			readback.callback(image);
+		}
 	}
 
 }  // namespace lve
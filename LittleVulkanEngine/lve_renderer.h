@@ -1,32 +1,127 @@
 #pragma once
 
 #include "lve_device.h"
+#include "lve_frame_pacer.h"
+#include "lve_frame_stats.h"
+#include "lve_gpu_profiler.h"
+#include "lve_offscreen_target.h"
+#include "lve_pipeline.h"
 #include "lve_swap_chain.h"
 #include "lve_window.h"
 
 // std
 #include <cassert>
+#include <deque>
+#include <functional>
 #include <memory>
 #include <vector>
 
 namespace lve {
+
+	//回读得到的一帧颜色数据，pixels 只在回调期间有效
+	struct LVEReadbackImage {
+		uint32_t width;
+		uint32_t height;
+		VkFormat format;
+		uint64_t timelineValue;
+		const uint8_t* pixels;	//每像素 4 字节，行与行之间紧密排列
+	};
+
+	//当前帧的深度附件，GPU 遮挡剔除从它生成深度金字塔
+	struct LVEDepthTarget {
+		VkImage image;
+		VkImageView view;
+		VkFormat format;
+		VkExtent2D extent;
+	};
+
+	//当前帧的颜色附件，finalLayout 是这一帧结束时它应处的布局（交换链图像用于呈现，离屏图像用于回读）
+	struct LVEColorTarget {
+		VkImage image;
+		VkImageView view;
+		VkFormat format;
+		VkExtent2D extent;
+		VkImageLayout finalLayout;
+	};
+
+	//开始渲染通道时如何处理附件：Clear 清空颜色和深度，Load 保留本帧之前渲染通道的结果接着画
+	enum class RenderPassLoad {
+		Clear,
+		Load,
+	};
+
+	//渲染通道里的命令：Inline 直接录制在主命令缓冲区中，SecondaryCommandBuffers 只能用 vkCmdExecuteCommands 执行次级命令缓冲区，
+	//视口和裁剪也需要由次级命令缓冲区自己设置
+	enum class RenderPassContents {
+		Inline,
+		SecondaryCommandBuffers,
+	};
+
 	class LVERenderer {
 	public:
-		LVERenderer(LVEWindow& window, LVEDevice& device);
+		LVERenderer(
+			LVEWindow& window,
+			LVEDevice& device,
+			uint32_t framesInFlight = LVESwapChain::DEFAULT_FRAMES_IN_FLIGHT);
+		//无窗口模式：渲染到离屏颜色/深度图像，需要配合无窗口的 LVEDevice 使用。
+		//beginFrame/endFrame/beginSwapChainRenderPass 等接口用法与窗口模式完全相同。
+		LVERenderer(
+			LVEDevice& device,
+			VkExtent2D extent,
+			uint32_t framesInFlight = LVESwapChain::DEFAULT_FRAMES_IN_FLIGHT);
 		~LVERenderer();
 
 		LVERenderer(const LVERenderer&) = delete;
 		LVERenderer& operator=(const LVERenderer&) = delete;
 
-		VkRenderPass getSwapChainRenderPass() const { return lveSwapChain->getRenderPass(); }
-		float getAspectRatio() const { return lveSwapChain->extentAspectRatio(); }
+		//动态渲染时为空，创建管线请用 getPipelineTarget
+		VkRenderPass getSwapChainRenderPass() const {
+			return isHeadless() ? offscreenTarget->getRenderPass() : lveSwapChain->getRenderPass();
+		}
+		float getAspectRatio() const {
+			return isHeadless() ? offscreenTarget->extentAspectRatio() : lveSwapChain->extentAspectRatio();
+		}
+		VkExtent2D getExtent() const {
+			return isHeadless() ? offscreenTarget->getExtent() : lveSwapChain->getSwapChainExtent();
+		}
+		bool isHeadless() const { return offscreenTarget != nullptr; }
+		//设备支持时用 vkCmdBeginRenderingKHR 代替渲染通道，交换链重建时不再创建帧缓冲
+		bool usesDynamicRendering() const { return lveDevice.supportsDynamicRendering(); }
+		//渲染到交换链（或离屏目标）的管线应该基于的目标：传统路径是渲染通道，动态渲染时是颜色和深度格式
+		LVEPipelineTarget getPipelineTarget() const;
+		//每次重建交换链时递增，缓存了渲染目标相关命令的系统用它判断是否失效
+		uint32_t getSwapChainGeneration() const { return swapChainGeneration; }
 		bool isFrameInProgress() const { return isFrameStarted; }
+		//每帧资源（uniform buffer、描述符集等）按这个数量分配，帧索引范围是 [0, getFramesInFlight())
+		uint32_t getFramesInFlight() const { return framesInFlight; }
+
+		//修改呈现策略会在下一次 beginFrame 时重建交换链
+		void setPresentPolicy(PresentPolicy policy);
+		PresentPolicy getPresentPolicy() const { return presentPolicy; }
+		//acquire 交换链图像的超时时间（纳秒），超时则 beginFrame 返回 nullptr 跳过这一帧
+		void setAcquireTimeout(uint64_t timeoutNs) { acquireTimeout = timeoutNs; }
+		//帧率上限和延迟统计：在采样输入前调用 waitForNextFrame，采样后调用 markInputSampled
+		LVEFramePacer& getFramePacer() { return framePacer; }
+		//GPU 时间戳分析：整帧和每个渲染通道自动记录，渲染系统可以通过 FrameInfo::gpuProfiler 添加自己的范围
+		LVEGpuProfiler& getGpuProfiler() { return *gpuProfiler; }
+		//帧时间、CPU/GPU 时间和上传字节数由渲染器自动填写，draw call 和三角形由渲染系统通过 FrameInfo::frameStats 记录
+		LVEFrameStats& getFrameStats() { return frameStats; }
+
+		//仅无窗口模式：请求把当前帧（如果还没开始则是下一帧）的颜色结果回读到 CPU。
+		//不会阻塞，GPU 完成后在之后的 beginFrame 或 flushReadbacks 中调用 callback。
+		void requestReadback(std::function<void(const LVEReadbackImage&)> callback);
+		//等待所有已提交的回读完成并调用回调，例如图像回归测试结束前
+		void flushReadbacks();
 
 		VkCommandBuffer getCurrentCommandBuffer() const {
 			assert(isFrameStarted && "Cannot get command buffer when frame not in progress");
 			return commandBuffers[currentFrameIndex];
 		}
 
+		//必须在渲染通道之外使用；渲染通道结束后深度图像处于 DEPTH_STENCIL_ATTACHMENT_OPTIMAL
+		LVEDepthTarget getCurrentDepthTarget() const;
+		LVEColorTarget getCurrentColorTarget() const;
+
 		int getFrameIndex() const {
 			assert(isFrameStarted && "Cannot get frame index when frame not in progress");
 			return currentFrameIndex;
@@ -34,18 +129,45 @@ namespace lve {
 
 		VkCommandBuffer beginFrame();
 		void endFrame();
-		void beginSwapChainRenderPass(VkCommandBuffer commandBuffer);
+		//同一帧可以多次开始渲染通道，第二次及之后用 RenderPassLoad::Load 保留已经画好的内容
+		void beginSwapChainRenderPass(
+			VkCommandBuffer commandBuffer,
+			RenderPassLoad load = RenderPassLoad::Clear,
+			RenderPassContents contents = RenderPassContents::Inline);
 		void endSwapChainRenderPass(VkCommandBuffer commandBuffer);
 
 	private:
 		void createCommandBuffers();
-		void freeCommandBuffers();
 		void recreateSwapChain();
+		void beginDynamicRendering(VkCommandBuffer commandBuffer, RenderPassLoad load, RenderPassContents contents);
+		void endDynamicRendering(VkCommandBuffer commandBuffer);
+		void deliverReadbacks(uint64_t completedValue);
 
-		LVEWindow& lveWindow;
+		LVEWindow* lveWindow = nullptr;
 		LVEDevice& lveDevice;
 		std::unique_ptr<LVESwapChain> lveSwapChain;
+		std::unique_ptr<LVEOffscreenTarget> offscreenTarget;
 		std::vector<VkCommandBuffer> commandBuffers;
+		uint32_t framesInFlight;
+		//每个帧槽位最后一次提交的时间线值，复用这个槽位前要等它完成
+		std::vector<uint64_t> frameTimelineValues;
+
+		PresentPolicy presentPolicy{ PresentPolicy::Mailbox };
+		bool presentPolicyChanged{ false };
+		uint64_t acquireTimeout{ UINT64_MAX };
+		LVEFramePacer framePacer;
+		std::unique_ptr<LVEGpuProfiler> gpuProfiler;
+		LVEFrameStats frameStats;
+		uint32_t renderPassScope = LVEGpuProfiler::INVALID_SCOPE;
+		uint32_t swapChainGeneration = 0;
+
+		struct PendingReadback {
+			uint64_t timelineValue;
+			int imageIndex;
+			std::function<void(const LVEReadbackImage&)> callback;
+		};
+		std::function<void(const LVEReadbackImage&)> requestedReadback;
+		std::deque<PendingReadback> pendingReadbacks;
 
 		uint32_t currentImageIndex;
 		int currentFrameIndex{0};
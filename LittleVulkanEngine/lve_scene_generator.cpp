@@ -0,0 +1,191 @@
+#include "lve_scene_generator.h"
+
+#include "lve_occlusion_culler.h"
+#include "lve_profiler.h"
+
+// libs
+#include <glm/gtc/constants.hpp>
+
+// std
+#include <algorithm>
+#include <cmath>
+#include <random>
+
+namespace lve {
+
+	std::unique_ptr<LVEModel> LVESceneGenerator::createCubeModel(LVEDevice& device, glm::vec3 offset) {
+		LVEModel::Builder modelBuilder{};
+		modelBuilder.vertices = {
+			// left face (white)
+			{{-.5f, -.5f, -.5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+			{{-.5f, .5f, .5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+			{{-.5f, -.5f, .5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+			{{-.5f, .5f, -.5f}, {.9f, .9f, .9f}, {-1.f, 0.f, 0.f}},
+
+			// right face (yellow)
+			{{.5f, -.5f, -.5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+			{{.5f, .5f, .5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+			{{.5f, -.5f, .5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+			{{.5f, .5f, -.5f}, {.8f, .8f, .1f}, {1.f, 0.f, 0.f}},
+
+			// top face (orange, remember y axis points down)
+			{{-.5f, -.5f, -.5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+			{{.5f, -.5f, .5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+			{{-.5f, -.5f, .5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+			{{.5f, -.5f, -.5f}, {.9f, .6f, .1f}, {0.f, -1.f, 0.f}},
+
+			// bottom face (red)
+			{{-.5f, .5f, -.5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+			{{.5f, .5f, .5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+			{{-.5f, .5f, .5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+			{{.5f, .5f, -.5f}, {.8f, .1f, .1f}, {0.f, 1.f, 0.f}},
+
+			// nose face (blue)
+			{{-.5f, -.5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+			{{.5f, .5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+			{{-.5f, .5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+			{{.5f, -.5f, 0.5f}, {.1f, .1f, .8f}, {0.f, 0.f, 1.f}},
+
+			// tail face (green)
+			{{-.5f, -.5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+			{{.5f, .5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+			{{-.5f, .5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+			{{.5f, -.5f, -0.5f}, {.1f, .8f, .1f}, {0.f, 0.f, -1.f}},
+		};
+		for (auto& v : modelBuilder.vertices) {
+			v.position += offset;
+		}
+
+		modelBuilder.indices = { 0,  1,  2,  0,  3,  1,  4,  5,  6,  4,  7,  5,  8,  9,  10, 8,  11, 9,
+								12, 13, 14, 12, 15, 13, 16, 17, 18, 16, 19, 17, 20, 21, 22, 20, 23, 21 };
+
+		return std::make_unique<LVEModel>(device, modelBuilder);
+	}
+
+	std::unique_ptr<LVEModel> LVESceneGenerator::createSphereModel(
+		LVEDevice& device, uint32_t targetTriangles, glm::vec3 color, float radiusNoise, uint32_t seed)
+	{
+		//UV 球有 2 * rings * segments 个三角形（两极的退化三角形也算在内），segments = 2 * rings
+		uint32_t rings = static_cast<uint32_t>(std::lround(std::sqrt(static_cast<double>(targetTriangles) / 4.0)));
+		rings = std::max(rings, 2u);
+		uint32_t segments = rings * 2;
+
+		std::mt19937 rng{ seed };
+		std::uniform_real_distribution<float> noise{ -radiusNoise, radiusNoise };
+
+		LVEModel::Builder modelBuilder{};
+		modelBuilder.vertices.reserve(static_cast<size_t>(rings + 1) * (segments + 1));
+		for (uint32_t ring = 0; ring <= rings; ring++) {
+			float phi = glm::pi<float>() * static_cast<float>(ring) / static_cast<float>(rings);
+			for (uint32_t segment = 0; segment <= segments; segment++) {
+				float theta = glm::two_pi<float>() * static_cast<float>(segment) / static_cast<float>(segments);
+				glm::vec3 normal{ std::sin(phi) * std::cos(theta), std::cos(phi), std::sin(phi) * std::sin(theta) };
+
+				//接缝处（第一列和最后一列）以及两极使用相同的半径，避免裂缝
+				bool seam = segment == segments || ring == 0 || ring == rings;
+				float radius = 0.5f * (1.f + (seam || radiusNoise <= 0.f ? 0.f : noise(rng)));
+
+				LVEModel::Vertex vertex{};
+				vertex.position = normal * radius;
+				vertex.color = color;
+				vertex.normal = normal;
+				vertex.uv = { static_cast<float>(segment) / segments, static_cast<float>(ring) / rings };
+				modelBuilder.vertices.push_back(vertex);
+			}
+		}
+		if (radiusNoise > 0.f) {
+			for (uint32_t ring = 1; ring < rings; ring++) {
+				auto& first = modelBuilder.vertices[ring * (segments + 1)];
+				modelBuilder.vertices[ring * (segments + 1) + segments].position = first.position;
+			}
+		}
+
+		modelBuilder.indices.reserve(static_cast<size_t>(rings) * segments * 6);
+		for (uint32_t ring = 0; ring < rings; ring++) {
+			for (uint32_t segment = 0; segment < segments; segment++) {
+				uint32_t a = ring * (segments + 1) + segment;
+				uint32_t b = a + segments + 1;
+				modelBuilder.indices.insert(modelBuilder.indices.end(), { a, b, a + 1, a + 1, b, b + 1 });
+			}
+		}
+
+		return std::make_unique<LVEModel>(device, modelBuilder);
+	}
+
+	void LVESceneGenerator::generate(
+		LVEDevice& device, const StressSceneConfig& config, LVEWorld& world, LVETransformSystem& transformSystem)
+	{
+		LVE_PROFILE_FUNCTION();
+		std::mt19937 rng{ config.seed };
+		std::uniform_real_distribution<float> unit{ 0.f, 1.f };
+
+		//网格：第 0 个是立方体，其余是三角形数量相同、表面起伏不同的球
+		uint32_t meshCount = std::max(config.uniqueMeshCount, 1u);
+		std::vector<std::shared_ptr<LVEModel>> meshes;
+		meshes.reserve(meshCount);
+		for (uint32_t i = 0; i < meshCount; i++) {
+			if (i == 0 && meshCount > 1) {
+				meshes.push_back(createCubeModel(device, glm::vec3{ 0.f }));
+				continue;
+			}
+			glm::vec3 color{ 0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng), 0.3f + 0.7f * unit(rng) };
+			meshes.push_back(createSphereModel(device, config.trianglesPerMesh, color, 0.15f, config.seed * 7919u + i));
+		}
+
+		std::vector<glm::vec3> clusterCenters;
+		if (config.distribution == SceneDistribution::Clustered) {
+			for (uint32_t i = 0; i < std::max(config.clusterCount, 1u); i++) {
+				clusterCenters.push_back(glm::vec3{ unit(rng), unit(rng), unit(rng) } * 2.f * config.extent - config.extent);
+			}
+		}
+		std::normal_distribution<float> clusterSpread{ 0.f, config.extent * 0.1f };
+		uint32_t gridSide = static_cast<uint32_t>(std::ceil(std::cbrt(static_cast<double>(config.objectCount))));
+		gridSide = std::max(gridSide, 1u);
+
+		for (uint32_t i = 0; i < config.objectCount; i++) {
+			glm::vec3 position{ 0.f };
+			switch (config.distribution) {
+			case SceneDistribution::Grid: {
+				glm::vec3 cell{ i % gridSide, (i / gridSide) % gridSide, i / (gridSide * gridSide) };
+				float step = gridSide > 1 ? 2.f * config.extent / static_cast<float>(gridSide - 1) : 0.f;
+				position = cell * step - (gridSide > 1 ? config.extent : 0.f);
+				break;
+			}
+			case SceneDistribution::UniformBox:
+				position = glm::vec3{ unit(rng), unit(rng), unit(rng) } * 2.f * config.extent - config.extent;
+				break;
+			case SceneDistribution::Clustered: {
+				const glm::vec3& center = clusterCenters[i % clusterCenters.size()];
+				position = center + glm::vec3{ clusterSpread(rng), clusterSpread(rng), clusterSpread(rng) };
+				break;
+			}
+			}
+
+			TransformComponent transform{};
+			transform.translation = position;
+			transform.rotation = glm::vec3{ unit(rng), unit(rng), unit(rng) } * glm::two_pi<float>();
+			transform.scale = glm::vec3{ config.objectScale * (0.75f + 0.5f * unit(rng)) };
+			const auto& model = meshes[i % meshes.size()];
+			world.createEntity(
+				ModelComponent{ model },
+				TransformSlotComponent{ transformSystem.add(transform) });
+		}
+
+		//墙体贯穿整个场景高度，在 xz 平面上随机摆放和旋转
+		if (config.occluderCount > 0) {
+			std::shared_ptr<LVEModel> wallModel = createCubeModel(device, glm::vec3{ 0.f });
+			auto wallOccluder = std::make_shared<const LVEOccluderMesh>(LVEOccluderMesh::createBox());
+			for (uint32_t i = 0; i < config.occluderCount; i++) {
+				TransformComponent transform{};
+				transform.translation = glm::vec3{ unit(rng) * 2.f - 1.f, 0.f, unit(rng) * 2.f - 1.f } * config.extent;
+				transform.rotation = glm::vec3{ 0.f, unit(rng) * glm::pi<float>(), 0.f };
+				transform.scale = glm::vec3{ config.extent * (0.3f + 0.4f * unit(rng)), config.extent * 2.2f, config.extent * 0.04f };
+				world.createEntity(
+					ModelComponent{ wallModel },
+					TransformSlotComponent{ transformSystem.add(transform) },
+					OccluderComponent{ wallOccluder });
+			}
+		}
+	}
+
+}  // namespace lve
@@ -0,0 +1,55 @@
+#pragma once
+
+#include "lve_device.h"
+#include "lve_ecs.h"
+#include "lve_game_object.h"
+#include "lve_model.h"
+#include "lve_transform_system.h"
+
+// std
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace lve {
+
+	//物体在场景中的分布方式
+	enum class SceneDistribution {
+		Grid,		//规则立方网格
+		UniformBox,	//在包围盒内均匀随机
+		Clustered,	//若干个正态分布的团簇，模拟物体密集的区域
+	};
+
+	struct StressSceneConfig {
+		uint32_t objectCount = 1000;
+		uint32_t uniqueMeshCount = 8;		//物体轮流使用这些网格
+		uint32_t trianglesPerMesh = 512;	//每个网格的目标三角形数量（实际值会取整到最接近的球面细分）
+		SceneDistribution distribution = SceneDistribution::Grid;
+		float extent = 20.f;				//场景半边长，物体分布在 [-extent, extent]^3 内
+		float objectScale = 0.5f;
+		uint32_t clusterCount = 8;
+		uint32_t occluderCount = 0;			//额外生成的竖直墙体（带 OccluderComponent），模拟室内或城市里大部分物体被挡住的场景
+		uint32_t seed = 1;					//相同的配置和种子总是生成相同的场景
+	};
+
+	//程序化生成压力测试场景，用于找出各个子系统在多少物体时开始撑不住
+	class LVESceneGenerator {
+	public:
+		//相同的种子和配置生成完全相同的物体和网格。每个物体是 world 中的一个实体，
+		//带 ModelComponent、TransformSlotComponent，变换只登记在 transformSystem 里。
+		//墙体在所有物体之后生成，额外带 OccluderComponent，不影响相同种子下其他物体的位置
+		static void generate(
+			LVEDevice& device, const StressSceneConfig& config, LVEWorld& world, LVETransformSystem& transformSystem);
+
+		//边长为 1 的立方体，每个面一种颜色，中心在 offset
+		static std::unique_ptr<LVEModel> createCubeModel(LVEDevice& device, glm::vec3 offset);
+		//UV 球，细分数按目标三角形数量选择，radiusNoise 大于 0 时表面随机起伏，让不同网格看起来不同
+		static std::unique_ptr<LVEModel> createSphereModel(
+			LVEDevice& device, uint32_t targetTriangles, glm::vec3 color, float radiusNoise = 0.f, uint32_t seed = 0);
+
+		//场景的中心和包围球半径，基准测试用它来摆放相机
+		static glm::vec3 sceneCenter() { return glm::vec3{ 0.f }; }
+		static float sceneRadius(const StressSceneConfig& config) { return config.extent * 1.7320508f; }
+	};
+
+}  // namespace lve
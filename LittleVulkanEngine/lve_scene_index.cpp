@@ -0,0 +1,110 @@
+#include "lve_scene_index.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+
+namespace lve {
+
+	LVESceneIndex::LVESceneIndex(LVEJobSystem* jobSystem) : bvh{ jobSystem } {}
+
+	void LVESceneIndex::add(uint32_t transformSlot, const LVEAabb& localBounds) {
+		if (transformSlot >= registered.size()) {
+			this->localBounds.resize(transformSlot + 1);
+			proxies.resize(transformSlot + 1, LVEBvh::INVALID_PROXY);
+			registered.resize(transformSlot + 1, 0);
+		}
+		this->localBounds[transformSlot] = localBounds;
+		if (!registered[transformSlot]) {
+			registered[transformSlot] = 1;
+			pendingSlots.push_back(transformSlot);
+		}
+	}
+
+	void LVESceneIndex::remove(uint32_t transformSlot) {
+		if (!contains(transformSlot)) {
+			return;
+		}
+		registered[transformSlot] = 0;
+		if (proxies[transformSlot] != LVEBvh::INVALID_PROXY) {
+			bvh.remove(proxies[transformSlot]);
+			proxies[transformSlot] = LVEBvh::INVALID_PROXY;
+		}
+	}
+
+	void LVESceneIndex::registerEntities(LVEWorld& world) {
+		LVE_PROFILE_FUNCTION();
+		world.forEachChunk<ModelComponent, TransformSlotComponent>(
+			[&](uint32_t count, const LVEEntity*, ModelComponent* models, TransformSlotComponent* slots) {
+				for (uint32_t i = 0; i < count; i++) {
+					if (slots[i].slot != INVALID_SLOT && models[i].model && !contains(slots[i].slot)) {
+						add(slots[i].slot, models[i].model->getBoundingBox());
+					}
+				}
+			});
+	}
+
+	void LVESceneIndex::refresh(const LVETransformSystem& transformSystem, uint32_t slot) {
+		if (!contains(slot) || slot >= transformSystem.size()) {
+			return;
+		}
+		LVEAabb worldBounds = localBounds[slot].transformed(transformSystem.getModelMatrix(slot));
+		if (proxies[slot] == LVEBvh::INVALID_PROXY) {
+			proxies[slot] = bvh.insert(worldBounds, slot);
+		}
+		else {
+			bvh.update(proxies[slot], worldBounds);
+		}
+	}
+
+	void LVESceneIndex::update(const LVETransformSystem& transformSystem) {
+		LVE_PROFILE_FUNCTION();
+		bool bulkInsert = pendingSlots.size() > bvh.getProxyCount();
+		for (uint32_t slot : pendingSlots) {
+			refresh(transformSystem, slot);
+		}
+		pendingSlots.clear();
+		for (uint32_t slot : transformSystem.getUpdatedSlots()) {
+			refresh(transformSystem, slot);
+		}
+		//一次插入了大半个场景（通常是刚加载完），直接同步重建，不让第一批帧用逐个插入得到的树
+		if (bulkInsert) {
+			bvh.rebuild();
+		}
+		else {
+			bvh.maintain();
+		}
+	}
+
+	uint32_t LVESceneIndex::cullFrustum(
+		const glm::mat4& projectionView, uint32_t slotCount, std::vector<uint8_t>& visibility)
+	{
+		LVE_PROFILE_FUNCTION();
+		queryResults.clear();
+		bvh.queryFrustum(LVEFrustum::fromMatrix(projectionView), queryResults);
+		visibility.assign(slotCount, 0);
+		uint32_t visibleCount = 0;
+		for (uint32_t slot : queryResults) {
+			if (slot < slotCount) {
+				visibility[slot] = 1;
+				visibleCount++;
+			}
+		}
+		return visibleCount;
+	}
+
+	uint32_t LVESceneIndex::pick(
+		const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance) const
+	{
+		LVEBvhRayHit hit{};
+		if (!bvh.raycast(origin, direction, maxDistance, hit)) {
+			return INVALID_SLOT;
+		}
+		if (distance != nullptr) {
+			*distance = hit.distance;
+		}
+		return hit.userData;
+	}
+
+}  // namespace lve
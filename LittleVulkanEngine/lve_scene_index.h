@@ -0,0 +1,73 @@
+#pragma once
+
+#include "lve_bounds.h"
+#include "lve_bvh.h"
+#include "lve_ecs.h"
+#include "lve_job_system.h"
+#include "lve_transform_system.h"
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace lve {
+
+	//场景的空间索引：按变换槽位登记物体的模型空间包围盒，用 LVEBvh 维护世界空间包围盒。
+	//每帧只刷新 LVETransformSystem 报告的变化槽位，可见性判断和编辑器拾取都从线性遍历变成 O(log n) 的树查询。
+	//查询结果都是变换槽位下标。
+	class LVESceneIndex {
+	public:
+		static constexpr uint32_t INVALID_SLOT = LVETransformSystem::INVALID_SLOT;
+
+		//jobSystem 用于后台重建 BVH，为空时同步重建
+		explicit LVESceneIndex(LVEJobSystem* jobSystem = nullptr);
+
+		LVESceneIndex(const LVESceneIndex&) = delete;
+		LVESceneIndex& operator=(const LVESceneIndex&) = delete;
+
+		//登记一个槽位，世界包围盒在下一次 update() 时计算
+		void add(uint32_t transformSlot, const LVEAabb& localBounds);
+		void remove(uint32_t transformSlot);
+		bool contains(uint32_t transformSlot) const {
+			return transformSlot < registered.size() && registered[transformSlot];
+		}
+		//登记 world 中所有还没有登记的可渲染实体（ModelComponent + TransformSlotComponent），加载场景后调用一次
+		void registerEntities(LVEWorld& world);
+
+		//每帧在 transformSystem.update() 之后调用一次：刷新世界矩阵变化了的物体，并在需要时后台重建
+		void update(const LVETransformSystem& transformSystem);
+
+		//按槽位下标写可见性（1 为可见），返回可见物体的数量。visibility 的长度设为 slotCount
+		uint32_t cullFrustum(const glm::mat4& projectionView, uint32_t slotCount, std::vector<uint8_t>& visibility);
+		void queryFrustum(const LVEFrustum& frustum, std::vector<uint32_t>& slots) const { bvh.queryFrustum(frustum, slots); }
+		void queryRadius(const glm::vec3& center, float radius, std::vector<uint32_t>& slots) const {
+			bvh.queryRadius(center, radius, slots);
+		}
+		//编辑器拾取：返回包围盒离射线起点最近的槽位，没有命中时返回 INVALID_SLOT
+		uint32_t pick(const glm::vec3& origin, const glm::vec3& direction, float maxDistance, float* distance = nullptr) const;
+
+		const LVEBvh& getBvh() const { return bvh; }
+		//世界空间包围盒，槽位必须已经登记并 update 过
+		const LVEAabb& getWorldBounds(uint32_t transformSlot) const { return bvh.getBounds(proxies[transformSlot]); }
+		//还没有登记或还没有 update 过时返回空
+		const LVEAabb* tryGetWorldBounds(uint32_t transformSlot) const {
+			if (transformSlot >= proxies.size() || proxies[transformSlot] == LVEBvh::INVALID_PROXY) {
+				return nullptr;
+			}
+			return &bvh.getBounds(proxies[transformSlot]);
+		}
+
+	private:
+		void refresh(const LVETransformSystem& transformSystem, uint32_t slot);
+
+		LVEBvh bvh;
+		//按槽位下标索引
+		std::vector<LVEAabb> localBounds;
+		std::vector<uint32_t> proxies;
+		std::vector<uint8_t> registered;
+		//已登记但还没有插入 BVH 的槽位
+		std::vector<uint32_t> pendingSlots;
+		std::vector<uint32_t> queryResults;
+	};
+
+}  // namespace lve
@@ -0,0 +1,147 @@
+#include "lve_static_command_cache.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <cassert>
+#include <stdexcept>
+
+namespace lve {
+
+	LVEStaticCommandCache::LVEStaticCommandCache(LVEDevice& device, LVERenderer& renderer)
+		: lveDevice{ device }, lveRenderer{ renderer }, entries(renderer.getFramesInFlight())
+	{
+		std::vector<VkCommandBuffer> commandBuffers(entries.size());
+		VkCommandBufferAllocateInfo allocInfo{};
+		allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+		allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+		allocInfo.commandPool = lveDevice.getCommandPool();
+		allocInfo.commandBufferCount = static_cast<uint32_t>(commandBuffers.size());
+		if (vkAllocateCommandBuffers(lveDevice.device(), &allocInfo, commandBuffers.data()) != VK_SUCCESS) {
+			throw std::runtime_error("failed to allocate secondary command buffers!");
+		}
+		for (size_t i = 0; i < entries.size(); i++) {
+			entries[i].commandBuffer = commandBuffers[i];
+		}
+	}
+
+	//次级命令缓冲区可能还在已提交的帧里，交给延迟销毁队列
+	LVEStaticCommandCache::~LVEStaticCommandCache() {
+		VkDevice device = lveDevice.device();
+		VkCommandPool commandPool = lveDevice.getCommandPool();
+		std::vector<VkCommandBuffer> commandBuffers;
+		for (const Entry& entry : entries) {
+			commandBuffers.push_back(entry.commandBuffer);
+		}
+		lveDevice.retire([device, commandPool, commandBuffers]() {
+			vkFreeCommandBuffers(device, commandPool, static_cast<uint32_t>(commandBuffers.size()), commandBuffers.data());
+		});
+	}
+
+	void LVEStaticCommandCache::invalidate() {
+		for (Entry& entry : entries) {
+			entry.valid = false;
+		}
+	}
+
+	bool LVEStaticCommandCache::isValid(const Entry& entry, const LVEStaticCommandKey& key) const {
+		VkExtent2D extent = lveRenderer.getExtent();
+		return entry.valid && entry.key == key &&
+			entry.renderPass == lveRenderer.getSwapChainRenderPass() &&
+			entry.extent.width == extent.width && entry.extent.height == extent.height &&
+			entry.swapChainGeneration == lveRenderer.getSwapChainGeneration();
+	}
+
+	void LVEStaticCommandCache::execute(
+		FrameInfo& frameInfo, const LVEStaticCommandKey& key, const std::function<void(FrameInfo&)>& recordCommands)
+	{
+		LVE_PROFILE_FUNCTION();
+		assert(frameInfo.frameIndex >= 0 && static_cast<size_t>(frameInfo.frameIndex) < entries.size() && "frame index out of range");
+		Entry& entry = entries[frameInfo.frameIndex];
+		if (isValid(entry, key)) {
+			replayCount++;
+			if (frameInfo.frameStats != nullptr) {
+				frameInfo.frameStats->addDrawCalls(entry.drawCalls, entry.triangles);
+			}
+		}
+		else {
+			record(entry, frameInfo, key, recordCommands);
+		}
+		vkCmdExecuteCommands(frameInfo.commandBuffer, 1, &entry.commandBuffer);
+	}
+
+	//帧槽位在 beginFrame 中已经等上一轮提交完成，次级命令缓冲区不再处于 pending 状态，可以直接重新录制
+	void LVEStaticCommandCache::record(
+		Entry& entry, FrameInfo& frameInfo, const LVEStaticCommandKey& key, const std::function<void(FrameInfo&)>& recordCommands)
+	{
+		LVE_PROFILE_FUNCTION();
+		entry.valid = false;
+		entry.renderPass = lveRenderer.getSwapChainRenderPass();
+		entry.extent = lveRenderer.getExtent();
+		entry.swapChainGeneration = lveRenderer.getSwapChainGeneration();
+		entry.key = key;
+
+		//帧缓冲在每帧之间变化（交换链图像），这里不指定，由执行它的渲染通道决定
+		VkCommandBufferInheritanceInfo inheritanceInfo{};
+		inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+		inheritanceInfo.renderPass = entry.renderPass;
+		inheritanceInfo.subpass = 0;
+		inheritanceInfo.framebuffer = VK_NULL_HANDLE;
+
+		//动态渲染没有渲染通道可以继承，改为给出附件格式；格式只在交换链重建时可能变化，已经包含在 swapChainGeneration 里
+		LVEPipelineTarget target = lveRenderer.getPipelineTarget();
+		VkCommandBufferInheritanceRenderingInfoKHR renderingInfo{};
+		renderingInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_RENDERING_INFO_KHR;
+		renderingInfo.colorAttachmentCount = static_cast<uint32_t>(target.colorFormats.size());
+		renderingInfo.pColorAttachmentFormats = target.colorFormats.data();
+		renderingInfo.depthAttachmentFormat = target.depthFormat;
+		renderingInfo.stencilAttachmentFormat = VK_FORMAT_UNDEFINED;
+		renderingInfo.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+		if (lveRenderer.usesDynamicRendering()) {
+			inheritanceInfo.pNext = &renderingInfo;
+		}
+
+		VkCommandBufferBeginInfo beginInfo{};
+		beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+		beginInfo.flags = VK_COMMAND_BUFFER_USAGE_RENDER_PASS_CONTINUE_BIT;
+		beginInfo.pInheritanceInfo = &inheritanceInfo;
+		if (vkBeginCommandBuffer(entry.commandBuffer, &beginInfo) != VK_SUCCESS) {
+			throw std::runtime_error("failed to begin recording secondary command buffer!");
+		}
+
+		//次级命令缓冲区不继承主命令缓冲区的动态状态
+		VkViewport viewport{};
+		viewport.x = 0.0f;
+		viewport.y = 0.0f;
+		viewport.width = static_cast<float>(entry.extent.width);
+		viewport.height = static_cast<float>(entry.extent.height);
+		viewport.minDepth = 0.0f;
+		viewport.maxDepth = 1.0f;
+		VkRect2D scissor{ {0, 0}, entry.extent };
+		vkCmdSetViewport(entry.commandBuffer, 0, 1, &viewport);
+		vkCmdSetScissor(entry.commandBuffer, 0, 1, &scissor);
+
+		FrameInfo recordInfo = frameInfo;
+		recordInfo.commandBuffer = entry.commandBuffer;
+		recordInfo.gpuProfiler = nullptr;
+		recordInfo.visibleSlots = nullptr;
+		uint32_t drawCallsBefore = 0;
+		uint64_t trianglesBefore = 0;
+		if (frameInfo.frameStats != nullptr) {
+			drawCallsBefore = frameInfo.frameStats->getCurrentDrawCalls();
+			trianglesBefore = frameInfo.frameStats->getCurrentTriangles();
+		}
+		recordCommands(recordInfo);
+		if (frameInfo.frameStats != nullptr) {
+			entry.drawCalls = frameInfo.frameStats->getCurrentDrawCalls() - drawCallsBefore;
+			entry.triangles = frameInfo.frameStats->getCurrentTriangles() - trianglesBefore;
+		}
+
+		if (vkEndCommandBuffer(entry.commandBuffer) != VK_SUCCESS) {
+			throw std::runtime_error("failed to record secondary command buffer!");
+		}
+		entry.valid = true;
+		recordCount++;
+	}
+
+}  // namespace lve
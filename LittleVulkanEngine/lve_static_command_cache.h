@@ -0,0 +1,77 @@
+#pragma once
+
+#include "lve_device.h"
+#include "lve_frame_info.h"
+#include "lve_renderer.h"
+
+// std
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace lve {
+
+	//录制内容依赖的状态，任何一项与录制时不同都要重新录制
+	struct LVEStaticCommandKey {
+		//录制时绑定的管线的 LVEPipeline::getSortId()（主管线编译完成后会从替代管线切换过来）。
+		//编号在进程内不会复用，管线销毁后新管线即使分配到相同的地址也会重新录制
+		uint32_t pipelineId = ~0u;
+		VkDescriptorSet globalDescriptorSet = VK_NULL_HANDLE;
+		uint64_t sceneVersion = 0;						//由调用者从场景的脏状态得到
+
+		bool operator==(const LVEStaticCommandKey& other) const {
+			return pipelineId == other.pipelineId && globalDescriptorSet == other.globalDescriptorSet &&
+				sceneVersion == other.sceneVersion;
+		}
+	};
+
+	//静态几何体的次级命令缓冲区缓存：每个帧槽位一个次级命令缓冲区，录制一次之后，
+	//只要场景、管线和渲染目标都没有变化，之后的帧只需要一条 vkCmdExecuteCommands。
+	//相机只改变 uniform 缓冲区的内容，不会让缓存失效。
+	//因此重放的绘制顺序是录制那一帧由 LVEDrawSorter 排好的顺序：管线和网格的分组始终正确（它们变化时键也会变化），
+	//但同一网格内由近到远的深度顺序是按录制时的相机算的，相机移动后只会降低 early-Z 的效率，不影响画面。
+	//渲染通道和尺寸由 LVERenderer 提供，交换链重建后自动重新录制。
+	//帧槽位在 beginFrame 中等待上一轮提交完成之后才会被重新录制，所以不需要 SIMULTANEOUS_USE。
+	class LVEStaticCommandCache {
+	public:
+		LVEStaticCommandCache(LVEDevice& device, LVERenderer& renderer);
+		~LVEStaticCommandCache();
+
+		LVEStaticCommandCache(const LVEStaticCommandCache&) = delete;
+		LVEStaticCommandCache& operator=(const LVEStaticCommandCache&) = delete;
+
+		//在以 RenderPassContents::SecondaryCommandBuffers 开始的主渲染通道中调用。
+		//这个帧槽位的缓存失效时先调用 recordCommands 录制：传给它的 FrameInfo 的 commandBuffer 是次级命令缓冲区，
+		//视口和裁剪已经设置好；gpuProfiler 为空（时间戳不能跟着缓存重放），visibleSlots 为空（缓存的内容不随相机剔除）。
+		//录制期间记下的 draw call 和三角形数量在之后重放时原样加回 frameStats
+		void execute(FrameInfo& frameInfo, const LVEStaticCommandKey& key, const std::function<void(FrameInfo&)>& recordCommands);
+		//让所有帧槽位在下一次 execute 时重新录制，例如直接修改了组件内容之后
+		void invalidate();
+
+		//累计的录制和重放次数，用于确认静态场景确实没有重新录制
+		uint64_t getRecordCount() const { return recordCount; }
+		uint64_t getReplayCount() const { return replayCount; }
+
+	private:
+		struct Entry {
+			VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+			bool valid = false;
+			LVEStaticCommandKey key{};
+			VkRenderPass renderPass = VK_NULL_HANDLE;
+			VkExtent2D extent{ 0, 0 };
+			uint32_t swapChainGeneration = 0;
+			uint32_t drawCalls = 0;
+			uint64_t triangles = 0;
+		};
+
+		bool isValid(const Entry& entry, const LVEStaticCommandKey& key) const;
+		void record(Entry& entry, FrameInfo& frameInfo, const LVEStaticCommandKey& key, const std::function<void(FrameInfo&)>& recordCommands);
+
+		LVEDevice& lveDevice;
+		LVERenderer& lveRenderer;
+		std::vector<Entry> entries;
+		uint64_t recordCount = 0;
+		uint64_t replayCount = 0;
+	};
+
+}  // namespace lve
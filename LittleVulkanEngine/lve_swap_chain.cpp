@@ -1,5 +1,7 @@
 #include "lve_swap_chain.h"
 
+#include "lve_profiler.h"
+
 // std
 #include <array>
 #include <cstdlib>
@@ -11,25 +13,58 @@
 
 namespace lve {
 
-	LVESwapChain::LVESwapChain(LVEDevice& deviceRef, VkExtent2D extent)
-		: device{ deviceRef }, windowExtent{ extent } {
+	LVESwapChain::LVESwapChain(
+		LVEDevice& deviceRef,
+		VkExtent2D extent,
+		uint32_t framesInFlight,
+		PresentPolicy presentPolicy)
+		: device{ deviceRef }, windowExtent{ extent }, framesInFlight{ framesInFlight }, presentPolicy{ presentPolicy } {
 		init();
 	}
 
-	LVESwapChain::LVESwapChain(LVEDevice& deviceRef, VkExtent2D extent, std::shared_ptr<LVESwapChain> previous)
-		: device{ deviceRef }, windowExtent{ extent }, oldSwapChain{ previous } {
+	LVESwapChain::LVESwapChain(
+		LVEDevice& deviceRef,
+		VkExtent2D extent,
+		std::shared_ptr<LVESwapChain> previous,
+		uint32_t framesInFlight,
+		PresentPolicy presentPolicy)
+		: device{ deviceRef },
+		windowExtent{ extent },
+		oldSwapChain{ previous },
+		framesInFlight{ framesInFlight },
+		presentPolicy{ presentPolicy } {
 		init();
 
-		// ɽʹ
+		// 清理旧交换链，如果不在使用
 		oldSwapChain = nullptr;
 	}
 
 	void LVESwapChain::init() {
+		if (framesInFlight < 1 || framesInFlight > MAX_FRAMES_IN_FLIGHT) {
+			throw std::runtime_error("frames in flight must be between 1 and MAX_FRAMES_IN_FLIGHT!");
+		}
 		createSwapChain();
 		createImageViews();
-		createRenderPass();
+		swapChainDepthFormat = findDepthFormat();
+		//动态渲染时渲染器直接使用图像视图，不需要渲染通道和帧缓冲，重建交换链只重建图像
+		bool useRenderPass = !device.supportsDynamicRendering();
+		if (useRenderPass) {
+			//渲染通道只取决于颜色/深度格式，与尺寸无关：格式没变就直接接管旧交换链的渲染通道，
+			//已经基于它编译好的管线也能继续使用。
+			if (oldSwapChain != nullptr && oldSwapChain->renderPass != VK_NULL_HANDLE && compareSwapFormats(*oldSwapChain)) {
+				renderPass = oldSwapChain->renderPass;
+				loadRenderPass = oldSwapChain->loadRenderPass;
+				oldSwapChain->renderPass = VK_NULL_HANDLE;
+				oldSwapChain->loadRenderPass = VK_NULL_HANDLE;
+			}
+			else {
+				createRenderPass();
+			}
+		}
 		createDepthResources();
-		createFramebuffers();
+		if (useRenderPass) {
+			createFramebuffers();
+		}
 		createSyncObjects();
 	}
 
@@ -54,29 +89,31 @@ namespace lve {
 			vkDestroyFramebuffer(device.device(), framebuffer, nullptr);
 		}
 
-		vkDestroyRenderPass(device.device(), renderPass, nullptr);
+		if (renderPass != VK_NULL_HANDLE) {
+			device.notifyHandleDestroyed(renderPass);
+			vkDestroyRenderPass(device.device(), renderPass, nullptr);
+		}
+		if (loadRenderPass != VK_NULL_HANDLE) {
+			device.notifyHandleDestroyed(loadRenderPass);
+			vkDestroyRenderPass(device.device(), loadRenderPass, nullptr);
+		}
 
 		// cleanup synchronization objects
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			vkDestroySemaphore(device.device(), renderFinishedSemaphores[i], nullptr);
-			vkDestroySemaphore(device.device(), imageAvailableSemaphores[i], nullptr);
-			vkDestroyFence(device.device(), inFlightFences[i], nullptr);
+		for (auto semaphore : renderFinishedSemaphores) {
+			vkDestroySemaphore(device.device(), semaphore, nullptr);
+		}
+		for (auto semaphore : imageAvailableSemaphores) {
+			vkDestroySemaphore(device.device(), semaphore, nullptr);
 		}
 	}
 
-	//÷ڻȡһõͼƬȴǰ֡ɲһͼƬڲʵͨź֤ͬԡ
-	VkResult LVESwapChain::acquireNextImage(uint32_t* imageIndex) {
-		vkWaitForFences(
-			device.device(),
-			1,
-			&inFlightFences[currentFrame],
-			VK_TRUE,
-			std::numeric_limits<uint64_t>::max());
-
+	//该方法用于获取下一个可用的图片索引。帧槽位的 CPU 等待已经移到渲染器里，通过时间线信号量完成。
+	VkResult LVESwapChain::acquireNextImage(uint32_t* imageIndex, uint64_t timeout) {
+		LVE_PROFILE_SCOPE("vkAcquireNextImageKHR");
 		VkResult result = vkAcquireNextImageKHR(
 			device.device(),
 			swapChain,
-			std::numeric_limits<uint64_t>::max(),
+			timeout,
 			imageAvailableSemaphores[currentFrame],  // must be a not signaled semaphore
 			VK_NULL_HANDLE,
 			imageIndex);
@@ -84,17 +121,15 @@ namespace lve {
 		return result;
 	}
 
-	//ύ GPUֽ˷Ҫ裺
+	//提交命令缓冲区到 GPU，并处理呈现结果。此方法包括三个主要步骤：
 	VkResult LVESwapChain::submitCommandBuffers(
-		const VkCommandBuffer* buffers, uint32_t* imageIndex)
+		const VkCommandBuffer* buffers, uint32_t* imageIndex, uint64_t timelineValue)
 	{
-		//1. ȴһͼƬɡ
-		if (imagesInFlight[*imageIndex] != VK_NULL_HANDLE) {
-			vkWaitForFences(device.device(), 1, &imagesInFlight[*imageIndex], VK_TRUE, UINT64_MAX);
-		}
-		imagesInFlight[*imageIndex] = inFlightFences[currentFrame];
+		//1. 等待上一次使用这张图像的帧完成（它的深度附件和帧缓冲会被本帧复用）。
+		device.waitForTimelineValue(imageTimelineValues[*imageIndex]);
+		imageTimelineValues[*imageIndex] = timelineValue;
 
-		//2. ύƶС
+		//2. 提交绘制命令到绘制队列，同时 signal 交换链的二值信号量和设备的时间线信号量。
 		VkSubmitInfo submitInfo = {};
 		submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
 
@@ -107,22 +142,35 @@ namespace lve {
 		submitInfo.commandBufferCount = 1;
 		submitInfo.pCommandBuffers = buffers;
 
-		VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[currentFrame] };
-		submitInfo.signalSemaphoreCount = 1;
+		VkSemaphore signalSemaphores[] = { renderFinishedSemaphores[*imageIndex], device.timelineSemaphore() };
+		submitInfo.signalSemaphoreCount = 2;
 		submitInfo.pSignalSemaphores = signalSemaphores;
 
-		vkResetFences(device.device(), 1, &inFlightFences[currentFrame]);
-
-		if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, inFlightFences[currentFrame]) != VK_SUCCESS) {
-			throw std::runtime_error("failed to submit draw command buffer!");
+		//二值信号量对应的值会被忽略
+		uint64_t waitValues[] = { 0 };
+		uint64_t signalValues[] = { 0, timelineValue };
+		VkTimelineSemaphoreSubmitInfo timelineInfo{};
+		timelineInfo.sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO;
+		timelineInfo.waitSemaphoreValueCount = 1;
+		timelineInfo.pWaitSemaphoreValues = waitValues;
+		timelineInfo.signalSemaphoreValueCount = 2;
+		timelineInfo.pSignalSemaphoreValues = signalValues;
+		submitInfo.pNext = &timelineInfo;
+
+		lastSubmitTime = std::chrono::steady_clock::now();
+		{
+			LVE_PROFILE_SCOPE("vkQueueSubmit");
+			if (vkQueueSubmit(device.graphicsQueue(), 1, &submitInfo, VK_NULL_HANDLE) != VK_SUCCESS) {
+				throw std::runtime_error("failed to submit draw command buffer!");
+			}
 		}
 
-		//3. ύֶʾ
+		//3. 提交给呈现队列以显示结果。
 		VkPresentInfoKHR presentInfo = {};
 		presentInfo.sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR;
 
 		presentInfo.waitSemaphoreCount = 1;
-		presentInfo.pWaitSemaphores = signalSemaphores;
+		presentInfo.pWaitSemaphores = &renderFinishedSemaphores[*imageIndex];
 
 		VkSwapchainKHR swapChains[] = { swapChain };
 		presentInfo.swapchainCount = 1;
@@ -130,20 +178,25 @@ namespace lve {
 
 		presentInfo.pImageIndices = imageIndex;
 
-		auto result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
+		VkResult result;
+		{
+			LVE_PROFILE_SCOPE("vkQueuePresentKHR");
+			result = vkQueuePresentKHR(device.presentQueue(), &presentInfo);
+		}
+		lastPresentTime = std::chrono::steady_clock::now();
 
-		currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+		currentFrame = (currentFrame + 1) % framesInFlight;
 
 		return result;
 	}
 
 	void LVESwapChain::createSwapChain() {
-		//ȡֵ֧ϢʽģʽԼչϢ
+		//获取支持的信息，如表面格式、呈现模式以及扩展信息。
 		SwapChainSupportDetails swapChainSupport = device.getSwapChainSupport();
-		//surfaceFormat: ɫʽɫռ䣬ѡɫʿռΪ sRGB  B8G8R8A8 ʽʾ.
+		//surfaceFormat: 描述颜色格式及其颜色空间，比如选择色彩空间为 sRGB 的 B8G8R8A8 格式表示.
 		VkSurfaceFormatKHR surfaceFormat = chooseSwapSurfaceFormat(swapChainSupport.formats);
-		//presentMode: ν׼õĻչʾĻѡ MAILBOX ģʽԼӳ.
-		VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
+		//presentMode: 描述如何将已准备好的画面展示到屏幕，比如选择 MAILBOX 模式可以减少延迟.
+		presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
 		VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
 		uint32_t imageCount = swapChainSupport.capabilities.minImageCount + 1;
@@ -185,14 +238,14 @@ namespace lve {
 
 		createInfo.oldSwapchain = oldSwapChain == nullptr ? VK_NULL_HANDLE : oldSwapChain->swapChain;
 
-		// vkCreateSwapchainKHR() ʵʴ swap chain
+		//调用 vkCreateSwapchainKHR() 来实际创建 swap chain
 		if (vkCreateSwapchainKHR(device.device(), &createInfo, nullptr, &swapChain) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create swap chain!");
 		}
 
-		// ָֻ˽ͼСʵཻ
-		// ΪʲôҪѯյʹ vkGetSwapchainImagesKHR ȡͼȻСٴεü
-		// ȡӦɵ swap chain images
+		// 我们只指定了交换链中图像的最小数量，所以实现是允许创建更多交换链。
+		// 这就是为什么我们首先要查询最终的数量使用 vkGetSwapchainImagesKHR 获取图像，然后调整容器大小，最后再次调用检索句柄。
+		// 取得相应生成的 swap chain images。
 		vkGetSwapchainImagesKHR(device.device(), swapChain, &imageCount, nullptr);
 		swapChainImages.resize(imageCount);
 		vkGetSwapchainImagesKHR(device.device(), swapChain, &imageCount, swapChainImages.data());
@@ -201,7 +254,7 @@ namespace lve {
 		swapChainExtent = extent;
 	}
 
-	//Ϊÿ swap chain ͼӦ image viewԱɫܹЩͼ.
+	//为每个 swap chain 图像创造对应的 image view，以便着色器能够访问这些图像.
 	void LVESwapChain::createImageViews() {
 		swapChainImageViews.resize(swapChainImages.size());
 		for (size_t i = 0; i < swapChainImages.size(); i++) {
@@ -223,16 +276,25 @@ namespace lve {
 		}
 	}
 
-	//һϵи˵ôɫȸԼ֮ϵ.
+	//定义了一系列附加说明，包括怎么处理颜色附件与深度附件，以及它们之间依赖关系.
 	void LVESwapChain::createRenderPass() {
+		renderPass = createRenderPass(false);
+		loadRenderPass = createRenderPass(true);
+	}
+
+	//loadContents 为 true 时保留附件里已有的内容，用于同一帧里的第二个渲染通道（两阶段遮挡剔除）。
+	//两个渲染通道只有 load 操作和初始布局不同，相互兼容，可以共用帧缓冲和管线。
+	VkRenderPass LVESwapChain::createRenderPass(bool loadContents) {
 		VkAttachmentDescription depthAttachment{};
-		depthAttachment.format = findDepthFormat();
+		depthAttachment.format = swapChainDepthFormat;
 		depthAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
-		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+		depthAttachment.loadOp = loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
+		//深度要留给后面的深度金字塔和第二个渲染通道使用
+		depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		depthAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
 		depthAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
-		depthAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		depthAttachment.initialLayout =
+			loadContents ? VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_UNDEFINED;
 		depthAttachment.finalLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
 
 		VkAttachmentReference depthAttachmentRef{};
@@ -242,11 +304,11 @@ namespace lve {
 		VkAttachmentDescription colorAttachment = {};
 		colorAttachment.format = getSwapChainImageFormat();
 		colorAttachment.samples = VK_SAMPLE_COUNT_1_BIT;
-		colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+		colorAttachment.loadOp = loadContents ? VK_ATTACHMENT_LOAD_OP_LOAD : VK_ATTACHMENT_LOAD_OP_CLEAR;
 		colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
 		colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
 		colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
-		colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+		colorAttachment.initialLayout = loadContents ? VK_IMAGE_LAYOUT_PRESENT_SRC_KHR : VK_IMAGE_LAYOUT_UNDEFINED;
 		colorAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
 
 		VkAttachmentReference colorAttachmentRef = {};
@@ -269,6 +331,12 @@ namespace lve {
 			VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
 		dependency.dstAccessMask =
 			VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+		if (loadContents) {
+			//上一个渲染通道写完颜色之后才能读取和继续写入
+			dependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+			dependency.dstAccessMask |=
+				VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT;
+		}
 
 		std::array<VkAttachmentDescription, 2> attachments = { colorAttachment, depthAttachment };
 		VkRenderPassCreateInfo renderPassInfo = {};
@@ -280,12 +348,14 @@ namespace lve {
 		renderPassInfo.dependencyCount = 1;
 		renderPassInfo.pDependencies = &dependency;
 
-		if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &renderPass) != VK_SUCCESS) {
+		VkRenderPass result = VK_NULL_HANDLE;
+		if (vkCreateRenderPass(device.device(), &renderPassInfo, nullptr, &result) != VK_SUCCESS) {
 			throw std::runtime_error("failed to create render pass!");
 		}
+		return result;
 	}
 
-	//һϵи˵ôɫȸԼ֮ϵ.
+	//定义了一系列附加说明，包括怎么处理颜色附件与深度附件，以及它们之间依赖关系.
 	void LVESwapChain::createFramebuffers() {
 		swapChainFramebuffers.resize(imageCount());
 		for (size_t i = 0; i < imageCount(); i++) {
@@ -311,10 +381,9 @@ namespace lve {
 		}
 	}
 
-	//Ϊÿ image view  depth attachment  framebufferջƽ.
+	//为每个 image view 和 depth attachment 创造 framebuffer，用于最终绘制结果.
 	void LVESwapChain::createDepthResources() {
-		VkFormat depthFormat = findDepthFormat();
-		swapChainDepthFormat = depthFormat;
+		VkFormat depthFormat = swapChainDepthFormat;
 		VkExtent2D swapChainExtent = getSwapChainExtent();
 
 		depthImages.resize(imageCount());
@@ -333,7 +402,8 @@ namespace lve {
 			imageInfo.format = depthFormat;
 			imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
 			imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-			imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT;
+			//SAMPLED 用于从深度生成 Hi-Z 深度金字塔
+			imageInfo.usage = VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_IMAGE_USAGE_SAMPLED_BIT;
 			imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
 			imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
 			imageInfo.flags = 0;
@@ -361,27 +431,23 @@ namespace lve {
 		}
 	}
 
-	//Ϊ Vulkan ͼӦó򴴽ͬԱڶ֡ȾЧعԴͬ
-	// ˵ÿһ֡źsemaphoresդfencesȷͼȾȷ˳ͬ
+	//为 Vulkan 图形应用程序创建同步对象。
+	//CPU 与 GPU 之间的帧跟踪统一交给设备的时间线信号量，这里只需要交换链 acquire/present 必须使用的二值信号量。
 	void LVESwapChain::createSyncObjects() {
-		imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-		inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-		imagesInFlight.resize(imageCount(), VK_NULL_HANDLE);
+		imageAvailableSemaphores.resize(framesInFlight);
+		renderFinishedSemaphores.resize(imageCount());
+		imageTimelineValues.resize(imageCount(), 0);
 
 		VkSemaphoreCreateInfo semaphoreInfo = {};
 		semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
 
-		VkFenceCreateInfo fenceInfo = {};
-		fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
-		fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT;
-
-		for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-			if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &imageAvailableSemaphores[i]) !=
-				VK_SUCCESS ||
-				vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &renderFinishedSemaphores[i]) !=
-				VK_SUCCESS ||
-				vkCreateFence(device.device(), &fenceInfo, nullptr, &inFlightFences[i]) != VK_SUCCESS) {
+		for (auto& semaphore : imageAvailableSemaphores) {
+			if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+				throw std::runtime_error("failed to create synchronization objects for a frame!");
+			}
+		}
+		for (auto& semaphore : renderFinishedSemaphores) {
+			if (vkCreateSemaphore(device.device(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
 				throw std::runtime_error("failed to create synchronization objects for a frame!");
 			}
 		}
@@ -402,20 +468,33 @@ namespace lve {
 	VkPresentModeKHR LVESwapChain::chooseSwapPresentMode(
 		const std::vector<VkPresentModeKHR>& availablePresentModes)
 	{
+		VkPresentModeKHR requested = VK_PRESENT_MODE_FIFO_KHR;
+		const char* name = "V-Sync";
+		switch (presentPolicy) {
+		case PresentPolicy::FifoRelaxed:
+			requested = VK_PRESENT_MODE_FIFO_RELAXED_KHR;
+			name = "FIFO relaxed";
+			break;
+		case PresentPolicy::Mailbox:
+			requested = VK_PRESENT_MODE_MAILBOX_KHR;
+			name = "Mailbox";
+			break;
+		case PresentPolicy::Immediate:
+			requested = VK_PRESENT_MODE_IMMEDIATE_KHR;
+			name = "Immediate";
+			break;
+		case PresentPolicy::Fifo:
+			break;
+		}
+
 		for (const auto& availablePresentMode : availablePresentModes) {
-			if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-				std::cout << "Present mode: Mailbox" << std::endl;
+			if (availablePresentMode == requested) {
+				std::cout << "Present mode: " << name << std::endl;
 				return availablePresentMode;
 			}
 		}
 
-		// for (const auto &availablePresentMode : availablePresentModes) {
-		//   if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-		//     std::cout << "Present mode: Immediate" << std::endl;
-		//     return availablePresentMode;
-		//   }
-		// }
-
+		//FIFO 是规范要求必须支持的模式
 		std::cout << "Present mode: V-Sync" << std::endl;
 		return VK_PRESENT_MODE_FIFO_KHR;
 	}
@@ -441,29 +520,29 @@ namespace lve {
 		return device.findSupportedFormat(
 			{ VK_FORMAT_D32_SFLOAT, VK_FORMAT_D32_SFLOAT_S8_UINT, VK_FORMAT_D24_UNORM_S8_UINT },
 			VK_IMAGE_TILING_OPTIMAL,
-			VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT);
+			VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT | VK_FORMAT_FEATURE_SAMPLED_IMAGE_BIT);
 	}
 
 }  // namespace lve
 
 
 /*
-`VK_FORMAT_B8G8R8A8_UNORM`  `VK_FORMAT_B8G8R8A8_SRGB`  Vulkan API жֲͬɫʽ֮Ҫɫռɫʴʽָʽϸͣ
+`VK_FORMAT_B8G8R8A8_UNORM` 和 `VK_FORMAT_B8G8R8A8_SRGB` 是 Vulkan API 中定义的两种不同的颜色格式。它们之间的主要区别在于颜色空间和色彩处理方式。下面是这两种格式的详细解释：
 
-1. **VK_FORMAT_B8G8R8A8_UNORM**
-   - ****һδɫʿռתĸʽlinear format
-   - **ɫʿռ**ԿռбʾɫֵɫĴԷʽеġζɫֱֵӶӦڹǿȣڼԲֵȲ
-   - **;**ʺҪɫĳϣȾPBRʱʽ½˺ͻϣֱӻڹߵǿȽм㡣
+1. **VK_FORMAT_B8G8R8A8_UNORM**：
+   - **类型**：这是一个未进行色彩空间转换的格式（linear format）。
+   - **色彩空间**：它在线性空间中表示颜色值，即颜色的处理是以线性方式进行的。这意味着颜色值直接对应于光强度，可以用于计算和线性插值等操作。
+   - **用途**：适合在需要线性颜色计算的场合，比如物理基础渲染（PBR）或纹理采样时。如果在这个格式下进行纹理过滤和混合，结果会直接基于光线的强度进行计算。
 
-2. **VK_FORMAT_B8G8R8A8_SRGB**
-   - ****һ׼RGBʽgamma-corrected format
-   - **ɫʿռ**ʹsRGBɫʿռ䣬һĽɫռ䣬ǵ۶Բͬȵĸ֪ռڽϵ½зԴϸڡ
-   - **;**ʺûʾ豸ΪṩõӾЧʹô˸ʽлƵĹ̿ʾʱԶӦgammaУ
+2. **VK_FORMAT_B8G8R8A8_SRGB**：
+   - **类型**：这是一个标准RGB格式（gamma-corrected format）。
+   - **色彩空间**：它使用sRGB色彩空间，这是一个改进的颜色空间，考虑到了人眼对不同亮度的感知。这个空间会在较低亮度下进行非线性处理，提升暗部细节。
+   - **用途**：适合用于用户界面或最终输出给显示设备的纹理，因为它可以提供更好的视觉效果。使用此格式进行绘制的过程可以让纹理在显示时自动应用gamma校正。
 
-### ܽ
-- **VK_FORMAT_B8G8R8A8_UNORM** ԿռдģʺҪȷĳ
-- **VK_FORMAT_B8G8R8A8_SRGB** sRGBռдģʺӾΪҪĳϣUIȾͼ
+### 总结
+- **VK_FORMAT_B8G8R8A8_UNORM** 是在线性空间中处理的，适合需要精确计算的场景。
+- **VK_FORMAT_B8G8R8A8_SRGB** 是在sRGB空间中处理的，更适合视觉尤为重要的场合，如UI渲染和最终图像输出。
 
-ѡʹָʽʱҪȾʹĸʱͬһȾУܻͬʱʹߣ`UNORM`ʽнм㣬ת`sRGB`ʽʾ
+在选择使用哪种格式时，需要根据你的渲染需求来决定使用哪个。有时，在同一个渲染过程中，可能会同时使用这两者，先在`UNORM`格式中进行计算，最后转换成`sRGB`格式进行显示。
 
 */
\ No newline at end of file
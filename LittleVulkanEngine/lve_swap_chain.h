@@ -6,28 +6,57 @@
 #include <vulkan/vulkan.h>
 
 // std lib headers
+#include <chrono>
 #include <string>
 #include <vector>
 #include <memory>
 
 namespace lve {
 
+	//呈现策略，设备不支持时退回 FIFO（规范保证一定支持）
+	enum class PresentPolicy {
+		Fifo,			//垂直同步，功耗最低，延迟最高
+		FifoRelaxed,	//垂直同步，但掉帧时立即呈现，减少卡顿
+		Mailbox,		//不撕裂，总是显示最新一帧，延迟低但 GPU 会一直满载
+		Immediate,		//立即呈现，延迟最低但可能撕裂
+	};
+
 	class LVESwapChain {
 	public:
-		static constexpr int MAX_FRAMES_IN_FLIGHT = 2;
-
-		LVESwapChain(LVEDevice& deviceRef, VkExtent2D windowExtent);
-		LVESwapChain(LVEDevice& deviceRef, VkExtent2D windowExtent, std::shared_ptr<LVESwapChain> previous);
+		//同时在飞的帧数在运行时配置，取值范围 [1, MAX_FRAMES_IN_FLIGHT]；
+		//越少延迟越低，越多 CPU/GPU 并行越充分。每帧资源请按上限或 getFramesInFlight() 分配。
+		static constexpr int MAX_FRAMES_IN_FLIGHT = 4;
+		static constexpr int DEFAULT_FRAMES_IN_FLIGHT = 2;
+
+		LVESwapChain(
+			LVEDevice& deviceRef,
+			VkExtent2D windowExtent,
+			uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT,
+			PresentPolicy presentPolicy = PresentPolicy::Mailbox);
+		LVESwapChain(
+			LVEDevice& deviceRef,
+			VkExtent2D windowExtent,
+			std::shared_ptr<LVESwapChain> previous,
+			uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT,
+			PresentPolicy presentPolicy = PresentPolicy::Mailbox);
 		~LVESwapChain();
 
 		LVESwapChain(const LVESwapChain&) = delete;
 		LVESwapChain& operator=(const LVESwapChain&) = delete;
 
+		//设备启用动态渲染时不创建渲染通道和帧缓冲，下面三个函数不可用
 		VkFramebuffer getFrameBuffer(int index) { return swapChainFramebuffers[index]; }
 		VkRenderPass getRenderPass() { return renderPass; }
+		//保留颜色和深度内容的渲染通道，与 getRenderPass() 兼容，用于同一帧里接着绘制
+		VkRenderPass getLoadRenderPass() { return loadRenderPass; }
 		VkImageView getImageView(int index) { return swapChainImageViews[index]; }
+		VkImage getImage(int index) { return swapChainImages[index]; }
 		size_t imageCount() { return swapChainImages.size(); }
 		VkFormat getSwapChainImageFormat() { return swapChainImageFormat; }
+		//渲染通道结束后深度图像处于 DEPTH_STENCIL_ATTACHMENT_OPTIMAL，可以被采样
+		VkImage getDepthImage(int index) { return depthImages[index]; }
+		VkImageView getDepthImageView(int index) { return depthImageViews[index]; }
+		VkFormat getDepthFormat() { return swapChainDepthFormat; }
 		VkExtent2D getSwapChainExtent() { return swapChainExtent; }
 		uint32_t width() { return swapChainExtent.width; }
 		uint32_t height() { return swapChainExtent.height; }
@@ -37,8 +66,18 @@ namespace lve {
 		}
 		VkFormat findDepthFormat();
 
-		VkResult acquireNextImage(uint32_t* imageIndex);
-		VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex);
+		uint32_t getFramesInFlight() const { return framesInFlight; }
+		PresentPolicy getPresentPolicy() const { return presentPolicy; }
+		VkPresentModeKHR getPresentMode() const { return presentMode; }
+
+		//调用者需要先通过设备的时间线信号量确认本帧槽位的上一轮提交已经完成。
+		//timeout 单位纳秒，超时返回 VK_TIMEOUT 或 VK_NOT_READY，此时本帧应该跳过。
+		VkResult acquireNextImage(uint32_t* imageIndex, uint64_t timeout = UINT64_MAX);
+		//提交时除了交换链需要的二值信号量，还会把设备时间线信号量 signal 到 timelineValue
+		VkResult submitCommandBuffers(const VkCommandBuffer* buffers, uint32_t* imageIndex, uint64_t timelineValue);
+		//最近一次 submitCommandBuffers 中 vkQueueSubmit 调用前和 vkQueuePresentKHR 返回后的时间，用于延迟统计
+		std::chrono::steady_clock::time_point getLastSubmitTime() const { return lastSubmitTime; }
+		std::chrono::steady_clock::time_point getLastPresentTime() const { return lastPresentTime; }
 
 		bool compareSwapFormats(const LVESwapChain& swapChain) const {
 			return	swapChain.swapChainDepthFormat == swapChainDepthFormat &&
@@ -51,6 +90,7 @@ namespace lve {
 		void createImageViews();
 		void createDepthResources();
 		void createRenderPass();
+		VkRenderPass createRenderPass(bool loadContents);
 		void createFramebuffers();
 		void createSyncObjects();
 
@@ -66,7 +106,8 @@ namespace lve {
 		VkExtent2D swapChainExtent;
 
 		std::vector<VkFramebuffer> swapChainFramebuffers;
-		VkRenderPass renderPass;
+		VkRenderPass renderPass = VK_NULL_HANDLE;
+		VkRenderPass loadRenderPass = VK_NULL_HANDLE;
 
 		std::vector<VkImage> depthImages;
 		std::vector<VkDeviceMemory> depthImageMemorys;
@@ -80,10 +121,17 @@ namespace lve {
 		VkSwapchainKHR swapChain;
 		std::shared_ptr<LVESwapChain> oldSwapChain;
 
+		uint32_t framesInFlight;
+		PresentPolicy presentPolicy;
+		VkPresentModeKHR presentMode;
+		std::chrono::steady_clock::time_point lastSubmitTime{};
+		std::chrono::steady_clock::time_point lastPresentTime{};
+		//acquire 用的信号量按帧槽位轮换；present 等待的信号量按图像索引分配，
+		//因为只有同一张图像再次被 acquire 时才能确定上一次 present 已经用完它。
 		std::vector<VkSemaphore> imageAvailableSemaphores;
 		std::vector<VkSemaphore> renderFinishedSemaphores;
-		std::vector<VkFence> inFlightFences;
-		std::vector<VkFence> imagesInFlight;
+		//每张交换链图像最后一次被使用时的时间线值，代替原来的 imagesInFlight 栅栏
+		std::vector<uint64_t> imageTimelineValues;
 		size_t currentFrame = 0;
 	};
 
@@ -0,0 +1,323 @@
+#include "lve_transform_system.h"
+
+#include "lve_profiler.h"
+
+// std
+#include <algorithm>
+#include <cassert>
+#include <stdexcept>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LVE_TRANSFORM_SIMD 1
+#include <emmintrin.h>
+#else
+#define LVE_TRANSFORM_SIMD 0
+#endif
+
+namespace lve {
+
+#if LVE_TRANSFORM_SIMD
+	//同时计算 4 个 float 的 sin 和 cos（Cephes 的多项式逼近，与 sse_mathfun 的 sincos_ps 相同），
+	//在 [-8192, 8192] 内误差约 1e-7，一次范围约简同时得到两个结果
+	static void sinCos4(__m128 x, __m128& outSin, __m128& outCos) {
+		const __m128 signMask = _mm_castsi128_ps(_mm_set1_epi32(static_cast<int>(0x80000000)));
+		const __m128 fourOverPi = _mm_set1_ps(1.27323954473516f);
+
+		__m128 signBitSin = _mm_and_ps(x, signMask);
+		x = _mm_andnot_ps(signMask, x);
+
+		//j = (int)(x * 4/π)，再向上取偶数，决定落在哪个八分之一周期
+		__m128i j = _mm_cvttps_epi32(_mm_mul_ps(x, fourOverPi));
+		j = _mm_add_epi32(j, _mm_set1_epi32(1));
+		j = _mm_and_si128(j, _mm_set1_epi32(~1));
+		__m128 y = _mm_cvtepi32_ps(j);
+
+		__m128 swapSignBitSin = _mm_castsi128_ps(_mm_slli_epi32(_mm_and_si128(j, _mm_set1_epi32(4)), 29));
+		__m128 polyMask = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(j, _mm_set1_epi32(2)), _mm_setzero_si128()));
+		__m128 signBitCos = _mm_castsi128_ps(
+			_mm_slli_epi32(_mm_andnot_si128(_mm_sub_epi32(j, _mm_set1_epi32(2)), _mm_set1_epi32(4)), 29));
+		signBitSin = _mm_xor_ps(signBitSin, swapSignBitSin);
+
+		//x = x - y * π/4，分三段减去以保持精度
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-0.78515625f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-2.4187564849853515625e-4f)));
+		x = _mm_add_ps(x, _mm_mul_ps(y, _mm_set1_ps(-3.77489497744594108e-8f)));
+		__m128 z = _mm_mul_ps(x, x);
+
+		//cos 的多项式
+		__m128 polyCos = _mm_set1_ps(2.443315711809948e-5f);
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(-1.388731625493765e-3f));
+		polyCos = _mm_add_ps(_mm_mul_ps(polyCos, z), _mm_set1_ps(4.166664568298827e-2f));
+		polyCos = _mm_mul_ps(_mm_mul_ps(polyCos, z), z);
+		polyCos = _mm_sub_ps(polyCos, _mm_mul_ps(z, _mm_set1_ps(0.5f)));
+		polyCos = _mm_add_ps(polyCos, _mm_set1_ps(1.f));
+
+		//sin 的多项式
+		__m128 polySin = _mm_set1_ps(-1.9515295891e-4f);
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(8.3321608736e-3f));
+		polySin = _mm_add_ps(_mm_mul_ps(polySin, z), _mm_set1_ps(-1.6666654611e-1f));
+		polySin = _mm_add_ps(_mm_mul_ps(_mm_mul_ps(polySin, z), x), x);
+
+		//按象限选择哪个多项式给 sin、哪个给 cos
+		__m128 sinFromSin = _mm_and_ps(polyMask, polySin);
+		__m128 sinFromCos = _mm_andnot_ps(polyMask, polyCos);
+		__m128 cosFromSin = _mm_sub_ps(polySin, sinFromSin);
+		__m128 cosFromCos = _mm_sub_ps(polyCos, sinFromCos);
+
+		outSin = _mm_xor_ps(_mm_add_ps(sinFromSin, sinFromCos), signBitSin);
+		outCos = _mm_xor_ps(_mm_add_ps(cosFromSin, cosFromCos), signBitCos);
+	}
+#endif
+
+	LVETransformSystem::LVETransformSystem(LVEJobSystem* jobSystem) : jobSystem{ jobSystem } {}
+
+	uint32_t LVETransformSystem::add(const TransformComponent& transform) {
+		uint32_t slot = count++;
+		//分量数组按 LANES 对齐扩容，尾部填充的缩放为 1，SIMD 批次读到填充值也不会除以 0
+		if (slot % LANES == 0) {
+			size_t capacity = static_cast<size_t>(slot) + LANES;
+			for (auto* component : { &translationX, &translationY, &translationZ, &rotationX, &rotationY, &rotationZ }) {
+				component->resize(capacity, 0.f);
+			}
+			for (auto* component : { &scaleX, &scaleY, &scaleZ }) {
+				component->resize(capacity, 1.f);
+			}
+		}
+		localMatrices.emplace_back(1.f);
+		localNormalMatrices.emplace_back(1.f);
+		modelMatrices.emplace_back(1.f);
+		normalMatrices.emplace_back(1.f);
+		dirtyFlags.push_back(0);
+		worldDirtyFlags.push_back(0);
+		parents.push_back(INVALID_SLOT);
+		set(slot, transform);
+		return slot;
+	}
+
+	void LVETransformSystem::set(uint32_t slot, const TransformComponent& transform) {
+		assert(slot < count && "transform slot out of range");
+		translationX[slot] = transform.translation.x;
+		translationY[slot] = transform.translation.y;
+		translationZ[slot] = transform.translation.z;
+		rotationX[slot] = transform.rotation.x;
+		rotationY[slot] = transform.rotation.y;
+		rotationZ[slot] = transform.rotation.z;
+		scaleX[slot] = transform.scale.x;
+		scaleY[slot] = transform.scale.y;
+		scaleZ[slot] = transform.scale.z;
+		markSlotDirty(slot);
+	}
+
+	TransformComponent LVETransformSystem::get(uint32_t slot) const {
+		assert(slot < count && "transform slot out of range");
+		TransformComponent transform{};
+		transform.translation = { translationX[slot], translationY[slot], translationZ[slot] };
+		transform.rotation = { rotationX[slot], rotationY[slot], rotationZ[slot] };
+		transform.scale = { scaleX[slot], scaleY[slot], scaleZ[slot] };
+		return transform;
+	}
+
+	void LVETransformSystem::markSlotDirty(uint32_t slot) {
+		if (!dirtyFlags[slot]) {
+			dirtyFlags[slot] = 1;
+			dirtySlots.push_back(slot);
+		}
+	}
+
+	void LVETransformSystem::setParent(uint32_t slot, uint32_t parentSlot) {
+		assert(slot < count && "transform slot out of range");
+		if (parentSlot != INVALID_SLOT) {
+			assert(parentSlot < count && "parent transform slot out of range");
+			for (uint32_t ancestor = parentSlot; ancestor != INVALID_SLOT; ancestor = parents[ancestor]) {
+				if (ancestor == slot) {
+					throw std::runtime_error("failed to set parent: transform hierarchy would contain a cycle!");
+				}
+			}
+		}
+		if (parents[slot] == parentSlot) {
+			return;
+		}
+		parents[slot] = parentSlot;
+		hierarchyChanged = true;
+		//局部矩阵不变，但世界矩阵（连同子树）需要在下一次 update() 中重算
+		markSlotDirty(slot);
+	}
+
+	void LVETransformSystem::setParent(const LVEGameObject& child, const LVEGameObject* parent) {
+		assert(child.transformSlot != INVALID_SLOT && "game object was not registered with the transform system");
+		setParent(child.transformSlot, parent != nullptr ? parent->transformSlot : INVALID_SLOT);
+	}
+
+	void LVETransformSystem::registerObject(LVEGameObject& gameObject) {
+		if (gameObject.transformSlot == INVALID_SLOT) {
+			gameObject.transformSlot = add(gameObject.transform);
+		}
+		else {
+			set(gameObject.transformSlot, gameObject.transform);
+		}
+	}
+
+	void LVETransformSystem::registerObjects(std::vector<LVEGameObject>& gameObjects) {
+		for (auto& gameObject : gameObjects) {
+			registerObject(gameObject);
+		}
+	}
+
+	void LVETransformSystem::markDirty(const LVEGameObject& gameObject) {
+		assert(gameObject.transformSlot != INVALID_SLOT && "game object was not registered with the transform system");
+		set(gameObject.transformSlot, gameObject.transform);
+	}
+
+	void LVETransformSystem::update() {
+		updatedSlots.clear();
+		if (dirtySlots.empty()) {
+			return;
+		}
+		LVE_PROFILE_FUNCTION();
+		if (hierarchyChanged) {
+			rebuildHierarchy();
+		}
+
+		//脏槽位映射到所在的 4 槽位批次，批次之间互不重叠，可以放心并行写矩阵
+		dirtyBlocks.clear();
+		for (uint32_t slot : dirtySlots) {
+			dirtyBlocks.push_back(slot / LANES);
+			dirtyFlags[slot] = 0;
+			worldDirtyFlags[slot] = 1;
+		}
+		std::sort(dirtyBlocks.begin(), dirtyBlocks.end());
+		dirtyBlocks.erase(std::unique(dirtyBlocks.begin(), dirtyBlocks.end()), dirtyBlocks.end());
+
+		uint32_t blockCount = static_cast<uint32_t>(dirtyBlocks.size());
+		if (jobSystem != nullptr && blockCount >= PARALLEL_BLOCK_THRESHOLD) {
+			jobSystem->parallelFor(blockCount, BLOCKS_PER_JOB, [this](uint32_t begin, uint32_t end) {
+				for (uint32_t i = begin; i < end; i++) {
+					computeBlock(dirtyBlocks[i]);
+				}
+			});
+		}
+		else {
+			for (uint32_t block : dirtyBlocks) {
+				computeBlock(block);
+			}
+		}
+
+		propagateWorldMatrices();
+		dirtySlots.clear();
+	}
+
+	void LVETransformSystem::rebuildHierarchy() {
+		LVE_PROFILE_FUNCTION();
+		hierarchyChanged = false;
+		//depths[slot] 为 INVALID_SLOT 表示还没算过，沿父链向上走到已知深度的节点再回填
+		std::vector<uint32_t> depths(count, INVALID_SLOT);
+		std::vector<uint32_t> chain;
+		hierarchy.clear();
+		for (uint32_t slot = 0; slot < count; slot++) {
+			uint32_t current = slot;
+			while (current != INVALID_SLOT && depths[current] == INVALID_SLOT) {
+				chain.push_back(current);
+				current = parents[current];
+			}
+			uint32_t depth = current == INVALID_SLOT ? 0 : depths[current] + 1;
+			while (!chain.empty()) {
+				depths[chain.back()] = depth++;
+				chain.pop_back();
+			}
+			if (parents[slot] != INVALID_SLOT) {
+				hierarchy.push_back({ slot, parents[slot] });
+			}
+		}
+		//同一深度内保持槽位顺序，遍历时对矩阵数组的访问基本是顺序的
+		std::stable_sort(hierarchy.begin(), hierarchy.end(), [&](const HierarchyNode& a, const HierarchyNode& b) {
+			return depths[a.slot] < depths[b.slot];
+		});
+	}
+
+	//根节点的世界矩阵就是局部矩阵；有父节点的按深度顺序遍历一次，
+	//自己或父节点的世界矩阵变了才重算，所以移动一个父节点只会重算它的子树
+	void LVETransformSystem::propagateWorldMatrices() {
+		for (uint32_t slot : dirtySlots) {
+			if (parents[slot] == INVALID_SLOT) {
+				modelMatrices[slot] = localMatrices[slot];
+				normalMatrices[slot] = localNormalMatrices[slot];
+				updatedSlots.push_back(slot);
+			}
+		}
+		for (const HierarchyNode& node : hierarchy) {
+			if (!worldDirtyFlags[node.slot] && !worldDirtyFlags[node.parent]) {
+				continue;
+			}
+			worldDirtyFlags[node.slot] = 1;
+			modelMatrices[node.slot] = modelMatrices[node.parent] * localMatrices[node.slot];
+			//(AB)^-T = A^-T * B^-T，法线矩阵可以直接相乘，第四行第四列保持单位矩阵
+			normalMatrices[node.slot] = normalMatrices[node.parent] * localNormalMatrices[node.slot];
+			updatedSlots.push_back(node.slot);
+		}
+		for (uint32_t slot : updatedSlots) {
+			worldDirtyFlags[slot] = 0;
+		}
+	}
+
+	//与 TransformComponent::mat4/normalMatrix 的公式相同：Translate * Ry * Rx * Rz * Scale。
+	//同一批次里干净的槽位也会被重算，结果与之前一致
+	void LVETransformSystem::computeBlock(uint32_t block) {
+		uint32_t base = block * LANES;
+		uint32_t lanes = std::min(LANES, count - base);
+#if LVE_TRANSFORM_SIMD
+		__m128 s1, c1, s2, c2, s3, c3;
+		sinCos4(_mm_loadu_ps(&rotationY[base]), s1, c1);
+		sinCos4(_mm_loadu_ps(&rotationX[base]), s2, c2);
+		sinCos4(_mm_loadu_ps(&rotationZ[base]), s3, c3);
+
+		__m128 s1s2 = _mm_mul_ps(s1, s2);
+		__m128 c1s2 = _mm_mul_ps(c1, s2);
+		__m128 r00 = _mm_add_ps(_mm_mul_ps(c1, c3), _mm_mul_ps(s1s2, s3));
+		__m128 r01 = _mm_mul_ps(c2, s3);
+		__m128 r02 = _mm_sub_ps(_mm_mul_ps(c1s2, s3), _mm_mul_ps(c3, s1));
+		__m128 r10 = _mm_sub_ps(_mm_mul_ps(c3, s1s2), _mm_mul_ps(c1, s3));
+		__m128 r11 = _mm_mul_ps(c2, c3);
+		__m128 r12 = _mm_add_ps(_mm_mul_ps(c1s2, c3), _mm_mul_ps(s1, s3));
+		__m128 r20 = _mm_mul_ps(c2, s1);
+		__m128 r21 = _mm_sub_ps(_mm_setzero_ps(), s2);
+		__m128 r22 = _mm_mul_ps(c1, c2);
+
+		const __m128 one = _mm_set1_ps(1.f);
+		__m128 sx = _mm_loadu_ps(&scaleX[base]);
+		__m128 sy = _mm_loadu_ps(&scaleY[base]);
+		__m128 sz = _mm_loadu_ps(&scaleZ[base]);
+		__m128 invSx = _mm_div_ps(one, sx);
+		__m128 invSy = _mm_div_ps(one, sy);
+		__m128 invSz = _mm_div_ps(one, sz);
+
+		//每个分量向量里是 4 个物体的同一元素，转置后每个向量是一个物体的一列，直接写进 glm::mat4
+		auto storeColumn = [&](std::vector<glm::mat4>& matrices, int column, __m128 x, __m128 y, __m128 z, __m128 w) {
+			_MM_TRANSPOSE4_PS(x, y, z, w);
+			const __m128 rows[LANES] = { x, y, z, w };
+			for (uint32_t lane = 0; lane < lanes; lane++) {
+				_mm_storeu_ps(&matrices[base + lane][column][0], rows[lane]);
+			}
+		};
+		const __m128 zero = _mm_setzero_ps();
+		storeColumn(localMatrices, 0, _mm_mul_ps(sx, r00), _mm_mul_ps(sx, r01), _mm_mul_ps(sx, r02), zero);
+		storeColumn(localMatrices, 1, _mm_mul_ps(sy, r10), _mm_mul_ps(sy, r11), _mm_mul_ps(sy, r12), zero);
+		storeColumn(localMatrices, 2, _mm_mul_ps(sz, r20), _mm_mul_ps(sz, r21), _mm_mul_ps(sz, r22), zero);
+		storeColumn(localMatrices, 3,
+			_mm_loadu_ps(&translationX[base]), _mm_loadu_ps(&translationY[base]), _mm_loadu_ps(&translationZ[base]), one);
+
+		storeColumn(localNormalMatrices, 0, _mm_mul_ps(invSx, r00), _mm_mul_ps(invSx, r01), _mm_mul_ps(invSx, r02), zero);
+		storeColumn(localNormalMatrices, 1, _mm_mul_ps(invSy, r10), _mm_mul_ps(invSy, r11), _mm_mul_ps(invSy, r12), zero);
+		storeColumn(localNormalMatrices, 2, _mm_mul_ps(invSz, r20), _mm_mul_ps(invSz, r21), _mm_mul_ps(invSz, r22), zero);
+		storeColumn(localNormalMatrices, 3, zero, zero, zero, one);
+#else
+		//没有 SSE2 的平台逐个调用原来的实现
+		for (uint32_t lane = 0; lane < lanes; lane++) {
+			uint32_t slot = base + lane;
+			TransformComponent transform = get(slot);
+			localMatrices[slot] = transform.mat4();
+			localNormalMatrices[slot] = glm::mat4{ transform.normalMatrix() };
+		}
+#endif
+	}
+
+}  // namespace lve
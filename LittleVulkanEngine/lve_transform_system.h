@@ -0,0 +1,107 @@
+#pragma once
+
+#include "lve_game_object.h"
+#include "lve_job_system.h"
+
+// libs
+#define GLM_FORCE_RADIANS
+#define GLM_FORCE_DEPTH_ZERO_TO_ONE
+#include <glm/glm.hpp>
+
+// std
+#include <cstdint>
+#include <vector>
+
+namespace lve {
+
+	//所有物体变换的结构数组（SoA）存储，同时也是场景图。
+	//平移/旋转/缩放按分量分开存放，update() 只重算被标记为脏的槽位，每 4 个一组用 SIMD 同时计算 sin/cos，
+	//脏槽位很多时再用 LVEJobSystem 并行。不再变化的物体每帧没有任何开销。
+	//有父节点的槽位按深度排序存放在一个数组里，世界矩阵在一次线性遍历中只为脏的子树重算。
+	class LVETransformSystem {
+	public:
+		static constexpr uint32_t INVALID_SLOT = LVEGameObject::INVALID_TRANSFORM_SLOT;
+
+		//jobSystem 为空时在调用线程上计算
+		explicit LVETransformSystem(LVEJobSystem* jobSystem = nullptr);
+
+		LVETransformSystem(const LVETransformSystem&) = delete;
+		LVETransformSystem& operator=(const LVETransformSystem&) = delete;
+
+		//分配一个槽位并标记为脏，返回槽位下标
+		uint32_t add(const TransformComponent& transform);
+		//修改后的变换在下一次 update() 时生效
+		void set(uint32_t slot, const TransformComponent& transform);
+		//槽位当前的局部变换，实体的平移/旋转/缩放只存放在这里，修改时先 get 再 set
+		TransformComponent get(uint32_t slot) const;
+		//parentSlot 为 INVALID_SLOT 时成为根节点。子节点的 transform 是相对父节点的局部变换，
+		//父节点移动时整个子树的世界矩阵会在下一次 update() 中重算。形成环时抛出异常
+		void setParent(uint32_t slot, uint32_t parentSlot);
+		uint32_t getParent(uint32_t slot) const { return parents[slot]; }
+
+		//把物体的 transform 放进系统，并把槽位记在 gameObject.transformSlot 上
+		void registerObject(LVEGameObject& gameObject);
+		void registerObjects(std::vector<LVEGameObject>& gameObjects);
+		//物体的 transform 被修改后调用，只有调用过的物体会在 update() 中重算
+		void markDirty(const LVEGameObject& gameObject);
+		//parent 为空时成为根节点，两个物体都必须已经注册
+		void setParent(const LVEGameObject& child, const LVEGameObject* parent);
+
+		//重算所有脏槽位及其子树的模型矩阵和法线矩阵，应当在录制绘制命令之前调用
+		void update();
+
+		//世界空间的模型矩阵（已经乘上所有祖先节点）
+		const glm::mat4& getModelMatrix(uint32_t slot) const { return modelMatrices[slot]; }
+		//世界空间的法线矩阵，左上角 3x3 有效，其余为单位矩阵，可以直接写进推送常量
+		const glm::mat4& getNormalMatrix(uint32_t slot) const { return normalMatrices[slot]; }
+		const glm::mat4& getLocalMatrix(uint32_t slot) const { return localMatrices[slot]; }
+
+		uint32_t size() const { return count; }
+		//上一次 update() 中世界矩阵发生变化的槽位（包括被父节点带动的子节点），剔除结构可以只刷新这些物体
+		const std::vector<uint32_t>& getUpdatedSlots() const { return updatedSlots; }
+		//上一次 update() 重算的槽位数量，用于确认静态物体没有被重算
+		uint32_t getLastUpdatedCount() const { return static_cast<uint32_t>(updatedSlots.size()); }
+
+	private:
+		//每个 SIMD 批次处理的槽位数，分量数组的容量总是它的整数倍
+		static constexpr uint32_t LANES = 4;
+		//脏的批次超过这个数量才分给工作线程
+		static constexpr uint32_t PARALLEL_BLOCK_THRESHOLD = 256;
+		static constexpr uint32_t BLOCKS_PER_JOB = 64;
+
+		//有父节点的槽位，按深度排序后父节点总在子节点之前
+		struct HierarchyNode {
+			uint32_t slot;
+			uint32_t parent;
+		};
+
+		void markSlotDirty(uint32_t slot);
+		void computeBlock(uint32_t block);
+		void rebuildHierarchy();
+		void propagateWorldMatrices();
+
+		LVEJobSystem* jobSystem;
+		uint32_t count = 0;
+
+		std::vector<float> translationX, translationY, translationZ;
+		std::vector<float> rotationX, rotationY, rotationZ;
+		std::vector<float> scaleX, scaleY, scaleZ;
+
+		//局部矩阵由 SIMD 批次写入，世界矩阵由 propagateWorldMatrices 写入
+		std::vector<glm::mat4> localMatrices;
+		std::vector<glm::mat4> localNormalMatrices;
+		std::vector<glm::mat4> modelMatrices;
+		std::vector<glm::mat4> normalMatrices;
+
+		std::vector<uint8_t> dirtyFlags;
+		std::vector<uint32_t> dirtySlots;
+		std::vector<uint32_t> dirtyBlocks;
+
+		std::vector<uint32_t> parents;
+		std::vector<uint8_t> worldDirtyFlags;
+		std::vector<HierarchyNode> hierarchy;
+		bool hierarchyChanged = false;
+		std::vector<uint32_t> updatedSlots;
+	};
+
+}  // namespace lve
@@ -14,16 +14,17 @@ namespace lve {
 	void LVEWindow::initWindow() {
 		glfwInit();
 
-		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);//һ GLFW ڵʾʾһκ OpenGL  OpenGL ES Ĵڡ
+		glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);//是一个用于设置 GLFW 窗口的提示，表示创建一个不与任何 OpenGL 或 OpenGL ES 上下文相关联的窗口。
 		glfwWindowHint(GLFW_RESIZABLE, GLFW_TRUE);
 
 		/*
-			nullptr: ĸָһеģеĻΪ nullptr ʾʹġ
-			nullptr: ָһģҲΪ nullptr
+			nullptr: 第四个参数是用于指定一个现有的上下文（如果有的话），在这里设置为 nullptr 表示不使用现有上下文。
+			nullptr: 第五个参数是用于指定一个共享的上下文，这里也设置为 nullptr。
 		*/
 		window = glfwCreateWindow(width, height, windowName.c_str(), nullptr, nullptr);
 		glfwSetWindowUserPointer(window, this);
 		glfwSetFramebufferSizeCallback(window, framebufferResizeCallback);
+		glfwSetWindowRefreshCallback(window, windowRefreshCallback);
 	}
 
 	void LVEWindow::createWindowSurface(VkInstance instance, VkSurfaceKHR* surface) {
@@ -39,4 +40,15 @@ namespace lve {
 		lveWindow->width = width;
 		lveWindow->height = height;
 	}
+
+	void LVEWindow::windowRefreshCallback(GLFWwindow* window) {
+		auto lveWindow = reinterpret_cast<LVEWindow*>(glfwGetWindowUserPointer(window));
+		lveWindow->redrawRequested = true;
+	}
+
+	void LVEWindow::requestRedraw() {
+		redrawRequested = true;
+		//唤醒 glfwWaitEventsTimeout，glfwPostEmptyEvent 可以在任意线程调用
+		glfwPostEmptyEvent();
+	}
 };
\ No newline at end of file
@@ -4,11 +4,87 @@
 #include <cstdlib>
 #include <iostream>
 #include <stdexcept>
+#include <string>
 
-int main() {
-    lve::FirstApp app{};
+static const char* USAGE =
+    "usage: LittleVulkanEngine [--record file] [--replay file] [--camera-path file] [--orbit] [--fixed-dt seconds] "
+    "[--gpu-culling on|off] [--static-commands on|off] [--idle on|off] [--render-thread on|off] [--render-graph on|off] "
+    "[--dynamic-rendering on|off]";
+
+// 参数值不是合法的数字时抛出，由 main 打印用法
+static float parseFloatValue(const std::string& arg, const std::string& value) {
+    size_t parsed = 0;
+    float result = 0.f;
+    try {
+        result = std::stof(value, &parsed);
+    }
+    catch (const std::logic_error&) {
+        parsed = 0;
+    }
+    if (parsed == 0 || parsed != value.size()) {
+        throw std::invalid_argument("invalid value for " + arg + ": " + value);
+    }
+    return result;
+}
+
+static lve::AppRunOptions parseRunOptions(int argc, char** argv) {
+    lve::AppRunOptions options{};
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        bool hasValue = i + 1 < argc;
+        if (arg == "--record" && hasValue) {
+            options.recordInputPath = argv[++i];
+        }
+        else if (arg == "--replay" && hasValue) {
+            options.replayInputPath = argv[++i];
+        }
+        else if (arg == "--camera-path" && hasValue) {
+            options.cameraPathFile = argv[++i];
+        }
+        else if (arg == "--orbit") {
+            options.orbitCamera = true;
+        }
+        else if (arg == "--fixed-dt" && hasValue) {
+            options.fixedTimestep = parseFloatValue(arg, argv[++i]);
+        }
+        else if (arg == "--gpu-culling" && hasValue) {
+            options.gpuOcclusionCulling = std::string(argv[++i]) == "on";
+        }
+        else if (arg == "--static-commands" && hasValue) {
+            options.cacheStaticCommands = std::string(argv[++i]) == "on";
+        }
+        else if (arg == "--idle" && hasValue) {
+            options.idleWhenStatic = std::string(argv[++i]) == "on";
+        }
+        else if (arg == "--render-thread" && hasValue) {
+            options.threadedRendering = std::string(argv[++i]) == "on";
+        }
+        else if (arg == "--render-graph" && hasValue) {
+            options.useRenderGraph = std::string(argv[++i]) == "on";
+        }
+        else if (arg == "--dynamic-rendering" && hasValue) {
+            options.dynamicRendering = std::string(argv[++i]) == "on";
+        }
+        else {
+            std::cerr << "unknown argument: " << arg << std::endl;
+        }
+    }
+    return options;
+}
+
+int main(int argc, char** argv) {
+    lve::AppRunOptions options{};
+    try {
+        options = parseRunOptions(argc, argv);
+    }
+    catch (const std::invalid_argument& e) {
+        std::cerr << e.what() << std::endl << USAGE << std::endl;
+        return EXIT_FAILURE;
+    }
 
+    //FirstApp 的构造函数会创建设备和管线，同样可能抛出异常
     try {
+        lve::FirstApp app{ options };
         app.run();
     }
     catch (const std::exception& e) {
@@ -1,2 +1,6 @@
 glslc.exe sample_shader.vert -o sample_shader.vert.spv
-glslc.exe sample_shader.frag -o sample_shader.frag.spv
\ No newline at end of file
+glslc.exe sample_shader.frag -o sample_shader.frag.spv
+glslc.exe hiz_indirect.vert -o hiz_indirect.vert.spv
+glslc.exe hiz_indirect.frag -o hiz_indirect.frag.spv
+glslc.exe hiz_reduce.comp -o hiz_reduce.comp.spv
+glslc.exe hiz_cull.comp -o hiz_cull.comp.spv
\ No newline at end of file
@@ -0,0 +1,37 @@
+#version 450
+
+layout(location = 0) in vec3 position;
+layout(location = 1) in vec3 color;
+layout(location = 2) in vec3 normal;
+layout(location = 3) in vec2 uv;
+
+layout(location = 0) out vec3 fragColor;
+
+layout(set = 0, binding = 0) uniform GlobalUbo {
+  mat4 projectionViewMatrix;
+  vec3 directionToLight;
+} ubo;
+
+// LVEHiZCuller::GpuObjectData һ
+struct ObjectData {
+	mat4 modelMatrix;
+	mat4 normalMatrix;
+	vec4 boundsMin;
+	vec4 boundsMax;
+	uvec4 info;
+};
+
+layout(std430, set = 1, binding = 0) readonly buffer ObjectBuffer {
+	ObjectData objects[];
+};
+
+const float AMBIENT = 0.02;
+
+void main(){
+	//ӻ firstInstance ±
+	ObjectData object = objects[gl_InstanceIndex];
+	gl_Position = ubo.projectionViewMatrix * object.modelMatrix * vec4(position, 1.0);
+	vec3 normalWorldSpace = normalize(mat3(object.normalMatrix) * normal);
+	float lightIntensity = AMBIENT + max(dot(normalWorldSpace, ubo.directionToLight), 0);
+	fragColor = lightIntensity * color;
+}
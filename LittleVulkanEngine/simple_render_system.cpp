@@ -1,5 +1,8 @@
 #include "simple_render_system.h"
 
+#include "lve_profiler.h"
+#include "lve_transform_system.h"
+
 // libs
 #define GLM_FORCE_RADIANS
 #define GLM_FORCE_DEPTH_ZERO_TO_ONE
@@ -19,18 +22,24 @@ namespace lve {
 	};
 
 	SimpleRenderSystem::SimpleRenderSystem(
-		LVEDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout)
-		: lveDevice{ device } 
+		LVEDevice& device,
+		LVEPipelineRegistry& pipelineRegistry,
+		const LVEPipelineTarget& target,
+		VkDescriptorSetLayout globalSetLayout)
+		: lveDevice{ device }, lvePipelineRegistry{ pipelineRegistry }
 	{
 		createPipelineLayout(globalSetLayout);
-		createPipeline(renderPass);
+		createPipeline(target);
 	}
 
 	SimpleRenderSystem::~SimpleRenderSystem() {
+		//管线可能还在工作线程里引用这个布局
+		lvePipeline.wait();
+		lveDevice.notifyHandleDestroyed(pipelineLayout);
 		vkDestroyPipelineLayout(lveDevice.device(), pipelineLayout, nullptr);
 	}
 
-	//һͳΧĹ߲֣Աɫ֮䴫ݶ̬ݡ
+	//创建了一个包含推送常量范围的管线布局，以便在着色器之间传递动态数据。
 	void SimpleRenderSystem::createPipelineLayout(VkDescriptorSetLayout globalSetLayout) {
 		VkPushConstantRange pushConstantRange{};
 		pushConstantRange.stageFlags = VK_SHADER_STAGE_VERTEX_BIT | VK_SHADER_STAGE_FRAGMENT_BIT;
@@ -51,41 +60,66 @@ namespace lve {
 		}
 	}
 
-	//òͼȾȾָܵɫļ·á
-	void SimpleRenderSystem::createPipeline(VkRenderPass renderPass) {
+	//配置渲染管道并提交给注册表异步编译，构造函数不会等待 vkCreateGraphicsPipelines。
+	void SimpleRenderSystem::createPipeline(const LVEPipelineTarget& target) {
 		assert(pipelineLayout != nullptr && "Cannot create pipeline before pipeline layout");
 
 		PipelineConfigInfo pipelineConfig{};
 		LVEPipeline::defaultPipelineConfigInfo(pipelineConfig);
-		pipelineConfig.renderPass = renderPass;
+		target.applyTo(pipelineConfig);
 		pipelineConfig.pipelineLayout = pipelineLayout;
-		lvePipeline = std::make_unique<LVEPipeline>(
-			lveDevice,
+		lvePipeline = lvePipelineRegistry.requestPipeline(
 			"E:/opengl/HalCG/LittleVulkanEngine/LittleVulkanEngine/shaders/sample_shader.vert.spv",
 			"E:/opengl/HalCG/LittleVulkanEngine/LittleVulkanEngine/shaders/sample_shader.frag.spv",
 			pipelineConfig);
 	}
 
-	void SimpleRenderSystem::renderGameObjects(FrameInfo& frameInfo, std::vector<LVEGameObject>& gameObjects)
-	{
-		lvePipeline->bind(frameInfo.commandBuffer);
+	//管线还没编译好时优先使用替代管线，都没有就跳过这一帧的绘制，避免主线程卡顿
+	LVEPipeline* SimpleRenderSystem::selectPipeline() {
+		LVEPipeline* pipeline = lvePipeline.tryGet();
+		if (pipeline == nullptr) {
+			pipeline = fallbackPipeline.tryGet();
+		}
+		return pipeline;
+	}
 
-		//һΪ globalDescriptorSet 󶨵ͼιߣԱںĻƵУɫܹжԴ
+	void SimpleRenderSystem::bindPipeline(FrameInfo& frameInfo, LVEPipeline& pipeline) {
+		pipeline.bind(frameInfo.commandBuffer);
+
+		//将一个名为 globalDescriptorSet 的描述集绑定到图形管线，以便在后续的绘制调用中，着色器能够访问其中定义的资源。
 		vkCmdBindDescriptorSets(
-			frameInfo.commandBuffer,			//ʾǽڸа
-			VK_PIPELINE_BIND_POINT_GRAPHICS,	//ʾڰͼιߣڻƲĹߣ
-			pipelineLayout,						//ֶ߲˹ƵĽṹָͼιȾʱİŷʽȷ GPU ֪Щжȡݡ
-			0,									//Ķ̬ƫ 0ʾûʹö̬ƫ
-			1,									//Ҫ󶨵
-			&frameInfo.globalDescriptorSet,		//ָָ룬ڰ󶨵ǰ globalDescriptorSet ͨɫеȫԴʡԴȣص
-			0,									//̬ƫΪ 0ʾûжĶ̬ƫҪӦá
+			frameInfo.commandBuffer,			//它表示我们将在该命令缓冲区中绑定描述集。
+			VK_PIPELINE_BIND_POINT_GRAPHICS,	//表示我们正在绑定描述集到图形管线（即用于绘制操作的管线）。
+			pipelineLayout,						//管线布局定义了关于描述集和推导常量的结构。它指定了在图形管线渲染时描述集的安排方式，确保 GPU 知道从哪些描述集中读取数据。
+			0,									//描述集的动态偏移量。传入的是 0，表示没有使用动态偏移
+			1,									//要绑定的描述集的数量。
+			&frameInfo.globalDescriptorSet,		//指向描述集的指针，用于绑定到当前的命令缓冲区。这里的 globalDescriptorSet 通常包含与着色器中的全局资源（如材质、光源等）相关的描述集。
+			0,									//动态偏移数量为 0，表示我们没有额外的动态偏移需要应用。
 			nullptr);
+	}
 
-		for (auto& obj : gameObjects) {
-			SimplePushConstantData push{};
-			push.modelMatrix = obj.transform.mat4();
-			push.normalMatrix = obj.transform.normalMatrix();
+	void SimpleRenderSystem::queueDraw(
+		const LVEPipeline& pipeline,
+		const glm::mat4& view,
+		LVEModel& model,
+		const glm::mat4& modelMatrix,
+		const glm::mat4& normalMatrix)
+	{
+		//用物体原点的视图空间深度排序；这个渲染系统还没有材质，材质位都是 0
+		float viewDepth = (view * modelMatrix[3]).z;
+		drawKeys.push_back({
+			LVEDrawSorter::makeOpaqueKey(pipeline.getSortId(), 0, model.getSortId(), viewDepth),
+			static_cast<uint32_t>(queuedDraws.size()) });
+		queuedDraws.push_back({ &model, modelMatrix, normalMatrix });
+	}
+
+	void SimpleRenderSystem::flushDraws(FrameInfo& frameInfo) {
+		drawSorter.sort(drawKeys);
 
+		LVEModel* boundModel = nullptr;
+		for (const LVEDrawKey& drawKey : drawKeys) {
+			const QueuedDraw& draw = queuedDraws[drawKey.index];
+			SimplePushConstantData push{ draw.modelMatrix, draw.normalMatrix };
 			vkCmdPushConstants(
 				frameInfo.commandBuffer,
 				pipelineLayout,
@@ -93,8 +127,115 @@ namespace lve {
 				0,
 				sizeof(SimplePushConstantData),
 				&push);
-			obj.model->bind(frameInfo.commandBuffer);
-			obj.model->draw(frameInfo.commandBuffer);
+			//排序键里的网格编号可能截断，是否重新绑定以实际的模型为准
+			if (draw.model != boundModel) {
+				draw.model->bind(frameInfo.commandBuffer);
+				boundModel = draw.model;
+			}
+			draw.model->draw(frameInfo.commandBuffer);
+			if (frameInfo.frameStats != nullptr) {
+				frameInfo.frameStats->addDrawCall(draw.model->getTriangleCount());
+			}
+		}
+		drawKeys.clear();
+		queuedDraws.clear();
+	}
+
+	void SimpleRenderSystem::renderGameObjects(FrameInfo& frameInfo, std::vector<LVEGameObject>& gameObjects)
+	{
+		LVE_PROFILE_FUNCTION();
+		LVEPipeline* pipeline = selectPipeline();
+		if (pipeline == nullptr) {
+			return;
+		}
+		LVEGpuScope gpuScope{ frameInfo.gpuProfiler, frameInfo.commandBuffer, "SimpleRenderSystem" };
+		bindPipeline(frameInfo, *pipeline);
+
+		const glm::mat4& view = frameInfo.camera.getView();
+		const LVETransformSystem* transformSystem = frameInfo.transformSystem;
+		const std::vector<uint8_t>* visibleSlots = frameInfo.visibleSlots;
+		for (auto& obj : gameObjects) {
+			if (visibleSlots != nullptr && obj.transformSlot < visibleSlots->size() && !(*visibleSlots)[obj.transformSlot]) {
+				continue;
+			}
+			if (transformSystem != nullptr && obj.transformSlot != LVEGameObject::INVALID_TRANSFORM_SLOT) {
+				//矩阵已经在 LVETransformSystem::update 中批量算好
+				queueDraw(
+					*pipeline,
+					view,
+					*obj.model,
+					transformSystem->getModelMatrix(obj.transformSlot),
+					transformSystem->getNormalMatrix(obj.transformSlot));
+			}
+			else {
+				queueDraw(*pipeline, view, *obj.model, obj.transform.mat4(), obj.transform.normalMatrix());
+			}
+		}
+		flushDraws(frameInfo);
+	}
+
+	void SimpleRenderSystem::renderEntities(FrameInfo& frameInfo, LVEWorld& world)
+	{
+		LVE_PROFILE_FUNCTION();
+		const LVETransformSystem* transformSystem = frameInfo.transformSystem;
+		assert(transformSystem != nullptr && "renderEntities requires frameInfo.transformSystem");
+		LVEPipeline* pipeline = selectPipeline();
+		if (pipeline == nullptr || transformSystem == nullptr) {
+			return;
+		}
+		LVEGpuScope gpuScope{ frameInfo.gpuProfiler, frameInfo.commandBuffer, "SimpleRenderSystem" };
+		bindPipeline(frameInfo, *pipeline);
+
+		const glm::mat4& view = frameInfo.camera.getView();
+		const std::vector<uint8_t>* visibleSlots = frameInfo.visibleSlots;
+		world.forEachChunk<ModelComponent, TransformSlotComponent>(
+			[&](uint32_t count, const LVEEntity*, ModelComponent* models, TransformSlotComponent* slots) {
+				for (uint32_t i = 0; i < count; i++) {
+					if (visibleSlots != nullptr && slots[i].slot < visibleSlots->size() && !(*visibleSlots)[slots[i].slot]) {
+						continue;
+					}
+					queueDraw(
+						*pipeline,
+						view,
+						*models[i].model,
+						transformSystem->getModelMatrix(slots[i].slot),
+						transformSystem->getNormalMatrix(slots[i].slot));
+				}
+			});
+		flushDraws(frameInfo);
+	}
+
+	void SimpleRenderSystem::renderEntitiesCached(FrameInfo& frameInfo, LVEWorld& world, LVEStaticCommandCache& cache, uint64_t sceneVersion)
+	{
+		LVE_PROFILE_FUNCTION();
+		LVEPipeline* pipeline = selectPipeline();
+		if (pipeline == nullptr) {
+			return;
+		}
+		//主管线编译完成、从替代管线切换过来时键随之变化，缓存会重新录制一次。
+		//绘制顺序在录制时排好，之后相机移动不会重新按深度排序（见 LVEStaticCommandCache）
+		LVEStaticCommandKey key{};
+		key.pipelineId = pipeline->getSortId();
+		key.globalDescriptorSet = frameInfo.globalDescriptorSet;
+		key.sceneVersion = sceneVersion;
+		cache.execute(frameInfo, key, [&](FrameInfo& recordInfo) { renderEntities(recordInfo, world); });
+	}
+
+	void SimpleRenderSystem::renderPacket(FrameInfo& frameInfo, const LVERenderPacket& packet)
+	{
+		LVE_PROFILE_FUNCTION();
+		LVEPipeline* pipeline = selectPipeline();
+		if (pipeline == nullptr) {
+			return;
+		}
+		LVEGpuScope gpuScope{ frameInfo.gpuProfiler, frameInfo.commandBuffer, "SimpleRenderSystem" };
+		bindPipeline(frameInfo, *pipeline);
+
+		//数据包里只有可见的绘制，剔除已经在游戏线程做完
+		const glm::mat4& view = frameInfo.camera.getView();
+		for (const LVERenderPacket::Draw& draw : packet.draws) {
+			queueDraw(*pipeline, view, *draw.model, draw.modelMatrix, draw.normalMatrix);
 		}
+		flushDraws(frameInfo);
 	}
 }  // namespace lve
@@ -2,9 +2,14 @@
 
 #include "lve_camera.h"
 #include "lve_device.h"
+#include "lve_draw_sort.h"
+#include "lve_ecs.h"
 #include "lve_frame_info.h"
 #include "lve_game_object.h"
 #include "lve_pipeline.h"
+#include "lve_pipeline_registry.h"
+#include "lve_render_thread.h"
+#include "lve_static_command_cache.h"
 
 // std
 #include <memory>
@@ -14,20 +19,63 @@ namespace lve {
 	class SimpleRenderSystem {
 	public:
 		SimpleRenderSystem(
-			LVEDevice& device, VkRenderPass renderPass, VkDescriptorSetLayout globalSetLayout);
+			LVEDevice& device,
+			LVEPipelineRegistry& pipelineRegistry,
+			const LVEPipelineTarget& target,
+			VkDescriptorSetLayout globalSetLayout);
 		~SimpleRenderSystem();
 
 		SimpleRenderSystem(const SimpleRenderSystem&) = delete;
 		SimpleRenderSystem& operator=(const SimpleRenderSystem&) = delete;
 
+		//两种绘制方式都先收集可见的绘制，按 LVEDrawSorter 的状态键排序后再提交
 		void renderGameObjects(FrameInfo& frameInfo, std::vector<LVEGameObject>& gameObjects);
+		//绘制 world 中所有带 ModelComponent 和 TransformSlotComponent 的实体，
+		//矩阵从 frameInfo.transformSystem 读取，只访问这两种组件的数组
+		void renderEntities(FrameInfo& frameInfo, LVEWorld& world);
+		//同 renderEntities，但绘制命令录制在 cache 的次级命令缓冲区中，sceneVersion 不变时直接重放。
+		//必须在以 RenderPassContents::SecondaryCommandBuffers 开始的渲染通道中调用，不做视锥和遮挡剔除
+		void renderEntitiesCached(FrameInfo& frameInfo, LVEWorld& world, LVEStaticCommandCache& cache, uint64_t sceneVersion);
+		//绘制游戏线程准备好的数据包，只读 packet，可以在渲染线程调用
+		void renderPacket(FrameInfo& frameInfo, const LVERenderPacket& packet);
+
+		//主管线还在编译时使用的替代管线（需要使用相同的管线布局），不设置则直接跳过绘制
+		void setFallbackPipeline(LVEPipelineHandle fallback) { fallbackPipeline = fallback; }
+		bool isPipelineReady() const { return lvePipeline.isReady(); }
+		VkPipelineLayout getPipelineLayout() const { return pipelineLayout; }
+
 	private:
 		void createPipelineLayout(VkDescriptorSetLayout globalSetLayout);
-		void createPipeline(VkRenderPass renderPass);
+		void createPipeline(const LVEPipelineTarget& target);
+		//选出可用的管线，都没编译好时返回空
+		LVEPipeline* selectPipeline();
+		void bindPipeline(FrameInfo& frameInfo, LVEPipeline& pipeline);
+
+		//排序前暂存的一次绘制
+		struct QueuedDraw {
+			LVEModel* model;
+			glm::mat4 modelMatrix;
+			glm::mat4 normalMatrix;
+		};
+		void queueDraw(
+			const LVEPipeline& pipeline,
+			const glm::mat4& view,
+			LVEModel& model,
+			const glm::mat4& modelMatrix,
+			const glm::mat4& normalMatrix);
+		//排序后提交所有暂存的绘制，相邻的绘制使用同一个模型时不重复绑定顶点和索引缓冲区
+		void flushDraws(FrameInfo& frameInfo);
 
 		LVEDevice& lveDevice;
+		LVEPipelineRegistry& lvePipelineRegistry;
 
-		std::unique_ptr<LVEPipeline> lvePipeline;
+		LVEPipelineHandle lvePipeline;
+		LVEPipelineHandle fallbackPipeline;
 		VkPipelineLayout pipelineLayout;
+
+		//每帧复用，避免重新分配
+		std::vector<QueuedDraw> queuedDraws;
+		std::vector<LVEDrawKey> drawKeys;
+		LVEDrawSorter drawSorter;
 	};
 }  // namespace lve